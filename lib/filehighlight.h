@@ -14,6 +14,12 @@ typedef struct mc_fhl_struct
 {
     mc_config_t *config;
     GPtrArray *filters;
+    /* extensions of MC_FLHGH_T_EXT filters: extension -> index of first filter + 1 */
+    GHashTable *extensions;
+    /* the same for case insensitive filters, extensions are in lower case */
+    GHashTable *extensions_nocase;
+    /* changed each time filters are parsed to invalidate colors cached in file entries */
+    unsigned int generation;
 } mc_fhl_t;
 
 /*** global variables defined in .c file *********************************************************/
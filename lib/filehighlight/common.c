@@ -61,6 +61,20 @@ mc_fhl_array_free (mc_fhl_t * fhl)
         g_ptr_array_foreach (fhl->filters, (GFunc) mc_fhl_filter_free, NULL);
         fhl->filters = (GPtrArray *) g_ptr_array_free (fhl->filters, TRUE);
     }
+
+    if (fhl->extensions != NULL)
+    {
+        g_hash_table_destroy (fhl->extensions);
+        fhl->extensions = NULL;
+    }
+
+    if (fhl->extensions_nocase != NULL)
+    {
+        g_hash_table_destroy (fhl->extensions_nocase);
+        fhl->extensions_nocase = NULL;
+    }
+
+    fhl->generation = 0;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -246,19 +246,52 @@ mc_fhl_get_color_regexp (mc_fhl_filter_t * mc_filter, mc_fhl_t * fhl, file_entry
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Look up all suffixes of file name started after a dot in the extension tables.
+ *
+ * @return index of first MC_FLHGH_T_EXT filter which matches file name, -1 if none
+ */
+
+static int
+mc_fhl_get_ext_index (mc_fhl_t * fhl, const char *fname)
+{
+    guint index = G_MAXUINT;
+    const char *dot;
+    char *fname_down = NULL;
+
+    for (dot = strchr (fname, '.'); dot != NULL; dot = strchr (dot + 1, '.'))
+    {
+        guint i;
+
+        i = GPOINTER_TO_UINT (g_hash_table_lookup (fhl->extensions, dot + 1));
+        if (i != 0 && i - 1 < index)
+            index = i - 1;
+
+        if (g_hash_table_size (fhl->extensions_nocase) != 0)
+        {
+            if (fname_down == NULL)
+                fname_down = g_ascii_strdown (fname, -1);
+
+            i = GPOINTER_TO_UINT (g_hash_table_lookup (fhl->extensions_nocase,
+                                                       fname_down + (dot - fname) + 1));
+            if (i != 0 && i - 1 < index)
+                index = i - 1;
+        }
+    }
+
+    g_free (fname_down);
+
+    return index == G_MAXUINT ? -1 : (int) index;
+}
 
-/* --------------------------------------------------------------------------------------------- */
-/*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
 
-int
-mc_fhl_get_color (mc_fhl_t * fhl, file_entry_t * fe)
+static int
+mc_fhl_get_color_uncached (mc_fhl_t * fhl, file_entry_t * fe)
 {
     guint i;
     int ret;
-
-    if (fhl == NULL)
-        return NORMAL_COLOR;
+    int ext_index = -2;         /* not looked up yet */
 
     for (i = 0; i < fhl->filters->len; i++)
     {
@@ -273,6 +306,12 @@ mc_fhl_get_color (mc_fhl_t * fhl, file_entry_t * fe)
                 return -ret;
             break;
         case MC_FLHGH_T_EXT:
+            /* all extensions are looked up at once */
+            if (ext_index == -2)
+                ext_index = mc_fhl_get_ext_index (fhl, fe->fname);
+            if (ext_index == (int) i)
+                return -mc_filter->color_pair_index;
+            break;
         case MC_FLHGH_T_FREGEXP:
             ret = mc_fhl_get_color_regexp (mc_filter, fhl, fe);
             if (ret > 0)
@@ -286,3 +325,23 @@ mc_fhl_get_color (mc_fhl_t * fhl, file_entry_t * fe)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+int
+mc_fhl_get_color (mc_fhl_t * fhl, file_entry_t * fe)
+{
+    if (fhl == NULL)
+        return NORMAL_COLOR;
+
+    /* file entries don't change while they are in panel, rules can be reread */
+    if (fhl->generation == 0 || fe->fhl_generation != fhl->generation)
+    {
+        fe->fhl_color = mc_fhl_get_color_uncached (fhl, fe);
+        fe->fhl_generation = fhl->generation;
+    }
+
+    return fe->fhl_color;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -44,6 +44,8 @@
 
 /*** file scope variables ************************************************************************/
 
+static unsigned int mc_fhl_generation = 0;
+
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
 
@@ -125,11 +127,29 @@ mc_fhl_parse_get_regexp (mc_fhl_t * fhl, const gchar * group_name)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static gboolean
+mc_fhl_parse_is_ascii (const char *str)
+{
+    for (; *str != '\0'; str++)
+        if ((unsigned char) *str >= 0x80)
+            return FALSE;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Extensions are looked up in hash tables by all suffixes of file name started after a dot.
+ * Case insensitive extensions with non-ASCII characters are matched by regexp.
+ */
+
 static gboolean
 mc_fhl_parse_get_extensions (mc_fhl_t * fhl, const gchar * group_name)
 {
     mc_fhl_filter_t *mc_filter;
     gchar **exts, **exts_orig;
+    gboolean case_sensitive;
+    GHashTable *table;
     GString *buf;
 
     exts_orig = mc_config_get_string_list (fhl->config, group_name, "extensions", NULL);
@@ -139,6 +159,38 @@ mc_fhl_parse_get_extensions (mc_fhl_t * fhl, const gchar * group_name)
         return FALSE;
     }
 
+    case_sensitive = mc_config_get_bool (fhl->config, group_name, "extensions_case", FALSE);
+    table = case_sensitive ? fhl->extensions : fhl->extensions_nocase;
+
+    for (exts = exts_orig; *exts != NULL && (case_sensitive || mc_fhl_parse_is_ascii (*exts));
+         exts++)
+        ;
+
+    if (*exts == NULL)
+    {
+        const gpointer index = GUINT_TO_POINTER (fhl->filters->len + 1);
+
+        mc_filter = g_new0 (mc_fhl_filter_t, 1);
+        mc_filter->type = MC_FLHGH_T_EXT;
+        mc_fhl_parse_fill_color_info (mc_filter, fhl, group_name);
+
+        /* first filter with color wins if extension is given in several ones */
+        for (exts = exts_orig; mc_filter->color_pair_index > 0 && *exts != NULL; exts++)
+        {
+            char *ext;
+
+            ext = case_sensitive ? g_strdup (*exts) : g_ascii_strdown (*exts, -1);
+            if (g_hash_table_lookup (table, ext) == NULL)
+                g_hash_table_insert (table, ext, index);
+            else
+                g_free (ext);
+        }
+        g_strfreev (exts_orig);
+
+        g_ptr_array_add (fhl->filters, (gpointer) mc_filter);
+        return TRUE;
+    }
+
     buf = g_string_sized_new (64);
 
     for (exts = exts_orig; *exts != NULL; exts++)
@@ -159,8 +211,7 @@ mc_fhl_parse_get_extensions (mc_fhl_t * fhl, const gchar * group_name)
     mc_filter = g_new0 (mc_fhl_filter_t, 1);
     mc_filter->type = MC_FLHGH_T_FREGEXP;
     mc_filter->search_condition = mc_search_new_len (buf->str, buf->len, DEFAULT_CHARSET);
-    mc_filter->search_condition->is_case_sensitive =
-        mc_config_get_bool (fhl->config, group_name, "extensions_case", FALSE);
+    mc_filter->search_condition->is_case_sensitive = case_sensitive;
     mc_filter->search_condition->search_type = MC_SEARCH_T_REGEX;
 
     mc_fhl_parse_fill_color_info (mc_filter, fhl, group_name);
@@ -225,6 +276,13 @@ mc_fhl_parse_ini_file (mc_fhl_t * fhl)
 
     mc_fhl_array_free (fhl);
     fhl->filters = g_ptr_array_new ();
+    fhl->extensions = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    fhl->extensions_nocase = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+    /* 0 is never used: it means "no cached color" in file entries */
+    if (++mc_fhl_generation == 0)
+        mc_fhl_generation++;
+    fhl->generation = mc_fhl_generation;
 
     orig_group_names = mc_config_get_groups (fhl->config, NULL);
     ok = (*orig_group_names != NULL);
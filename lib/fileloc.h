@@ -59,6 +59,8 @@
 #define MC_HOTLIST_FILE         "hotlist"
 #define MC_USERMENU_FILE        "menu"
 #define MC_TREESTORE_FILE       "Tree"
+#define MC_DIRSIZE_FILE         "dirsize"
+#define MC_FINDINDEX_FILE       "findindex"
 #define MC_PANELS_FILE          "panels.ini"
 #ifdef WITH_TABS
 #define MC_TABS_SESSION_SUBDIR  "tabs.sessions"
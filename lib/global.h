@@ -58,6 +58,14 @@
 #endif /* !O_NDELAY */
 #endif /* !O_NONBLOCK */
 
+/* O_DIRECTORY and O_CLOEXEC are not supported everywhere: ignore them there */
+#ifndef O_DIRECTORY
+#define O_DIRECTORY 0
+#endif
+#ifndef O_CLOEXEC
+#define O_CLOEXEC 0
+#endif
+
 #if defined(__QNX__) && !defined(__QNXNTO__)
 /* exec*() from <process.h> */
 #include <unix.h>
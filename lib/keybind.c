@@ -166,6 +166,7 @@ static name_keymap_t command_names[] = {
     {"ViewFile", CK_ViewFile},
     {"ViewFiltered", CK_ViewFiltered},
     {"Find", CK_Find},
+    {"ReplaceInFiles", CK_ReplaceInFiles},
     {"DirSize", CK_DirSize},
     {"CompareDirs", CK_CompareDirs},
 #ifdef USE_DIFF_VIEW
@@ -207,6 +207,7 @@ enum
     CK_Unselect,
     CK_SelectExt,
     CK_SelectInvert,
+    CK_ReplaceInFiles,
 
     /* panels */
     CK_PanelOtherCd = 200L,
@@ -93,6 +93,7 @@ static const struct
     /* cache */
     { "log",                                 &mc_cache_str, "mc.log" },
     { "Tree",                                &mc_cache_str, MC_TREESTORE_FILE },
+    { "dirsize",                             &mc_cache_str, MC_DIRSIZE_FILE },
     { "cedit" PATH_SEP_STR "cooledit.temp",  &mc_cache_str, EDIT_HOME_TEMP_FILE },
     { "cedit" PATH_SEP_STR "cooledit.block", &mc_cache_str, EDIT_HOME_BLOCK_FILE },
 
@@ -0,0 +1,425 @@
+/*
+   Run independent jobs on a shared worker pool.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file
+ *  \brief Source: run independent jobs on a shared worker pool
+ *
+ *  The whole MC is single-threaded, so the pool is only used for well isolated
+ *  pieces of work (system calls on local files, CPU bound loops over private data).
+ *  Caller starts a run of N jobs, keeps its own event loop alive with
+ *  mc_parallel_wait() with a timeout and can cancel the run at any time.
+ *
+ *  If threads are not available (too old GLib, pool can't be created) or
+ *  mc_parallel_run() is called from a worker thread, the jobs are executed
+ *  synchronously in the calling thread. Callers don't need to care about that.
+ */
+
+#include <config.h>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "lib/global.h"
+#include "lib/parallel.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+#if GLIB_CHECK_VERSION (2, 32, 0)
+#define MC_PARALLEL_THREADS 1
+#endif
+
+/* the pool is used for I/O bound jobs too, so don't go too low on small boxes */
+#define MC_PARALLEL_MIN_THREADS 4
+#define MC_PARALLEL_MAX_THREADS 64
+
+/* jobs per worker: smaller jobs give better balance, larger ones less overhead */
+#define MC_PARALLEL_JOBS_PER_WORKER 4
+
+/*** file scope type declarations ****************************************************************/
+
+typedef struct
+{
+    mc_parallel_t *run;
+    guint index;
+} mc_parallel_job_t;
+
+struct mc_parallel_t
+{
+    mc_parallel_job_fn job_fn;
+    gpointer user_data;
+    guint jobs;
+    mc_parallel_job_t *slots;
+    volatile gint cancelled;
+    guint done;                 /* protected by lock */
+#ifdef MC_PARALLEL_THREADS
+    GMutex lock;
+    GCond cond;
+#endif
+};
+
+/*** file scope variables ************************************************************************/
+
+static guint workers = 0;
+
+#ifdef MC_PARALLEL_THREADS
+G_LOCK_DEFINE_STATIC (pool);
+static GThreadPool *pool = NULL;
+/* the pool is useless in a forked child: its threads stay in the parent */
+static pid_t pool_pid = 0;
+
+/* set in pool threads to run nested jobs synchronously instead of deadlocking */
+static GPrivate in_worker = G_PRIVATE_INIT (NULL);
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+mc_parallel_job_done (mc_parallel_t * run)
+{
+#ifdef MC_PARALLEL_THREADS
+    g_mutex_lock (&run->lock);
+    run->done++;
+    if (run->done == run->jobs)
+        g_cond_broadcast (&run->cond);
+    g_mutex_unlock (&run->lock);
+#else
+    run->done++;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+mc_parallel_execute (mc_parallel_job_t * job)
+{
+    mc_parallel_t *run = job->run;
+
+    if (!mc_parallel_is_cancelled (run))
+        run->job_fn (run, job->index, run->user_data);
+
+    mc_parallel_job_done (run);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef MC_PARALLEL_THREADS
+static void
+mc_parallel_worker (gpointer data, gpointer user_data)
+{
+    (void) user_data;
+
+    g_private_set (&in_worker, GINT_TO_POINTER (1));
+    mc_parallel_execute ((mc_parallel_job_t *) data);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static GThreadPool *
+mc_parallel_get_pool (void)
+{
+    GThreadPool *p;
+
+    if (g_private_get (&in_worker) != NULL)
+        return NULL;
+
+    G_LOCK (pool);
+
+    if (pool != NULL && pool_pid != getpid ())
+    {
+        /* inherited via fork(): the threads are not here. Drop the pool without joining */
+        pool = NULL;
+    }
+
+    if (pool == NULL && mc_parallel_get_workers () > 1)
+    {
+        guint threads;
+
+        threads = CLAMP (mc_parallel_get_workers (), MC_PARALLEL_MIN_THREADS,
+                         MC_PARALLEL_MAX_THREADS);
+        pool = g_thread_pool_new (mc_parallel_worker, NULL, (gint) threads, FALSE, NULL);
+        pool_pid = getpid ();
+    }
+
+    p = pool;
+
+    G_UNLOCK (pool);
+
+    return p;
+}
+#endif /* MC_PARALLEL_THREADS */
+
+/* --------------------------------------------------------------------------------------------- */
+
+static mc_parallel_t *
+mc_parallel_new_run (guint jobs, gboolean background, mc_parallel_job_fn job_fn,
+                     gpointer user_data)
+{
+    mc_parallel_t *run;
+    guint i;
+#ifdef MC_PARALLEL_THREADS
+    GThreadPool *p = NULL;
+#endif
+
+    run = g_new0 (mc_parallel_t, 1);
+    run->job_fn = job_fn;
+    run->user_data = user_data;
+    run->jobs = jobs;
+    run->slots = g_new (mc_parallel_job_t, MAX (jobs, 1));
+
+#ifdef MC_PARALLEL_THREADS
+    g_mutex_init (&run->lock);
+    g_cond_init (&run->cond);
+
+    if (jobs > 1 || background)
+        p = mc_parallel_get_pool ();
+#else
+    (void) background;
+#endif
+
+    for (i = 0; i < jobs; i++)
+    {
+        run->slots[i].run = run;
+        run->slots[i].index = i;
+
+#ifdef MC_PARALLEL_THREADS
+        if (p != NULL && g_thread_pool_push (p, &run->slots[i], NULL))
+            continue;
+#endif
+        mc_parallel_execute (&run->slots[i]);
+    }
+
+    return run;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get number of available processors.
+ *
+ * @return number of jobs which can really run at the same time, at least 1
+ */
+
+guint
+mc_parallel_get_workers (void)
+{
+    if (workers == 0)
+    {
+#if GLIB_CHECK_VERSION (2, 36, 0)
+        workers = g_get_num_processors ();
+#elif defined (_SC_NPROCESSORS_ONLN)
+        long n;
+
+        n = sysconf (_SC_NPROCESSORS_ONLN);
+        workers = n > 0 ? (guint) n : 1;
+#else
+        workers = 1;
+#endif
+        workers = MAX (workers, 1);
+    }
+
+    return workers;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get number of jobs to split @items into.
+ *
+ * @param items number of work items
+ * @param min_chunk minimal number of items per job
+ *
+ * @return number of jobs, at least 1
+ */
+
+guint
+mc_parallel_count_jobs (gsize items, gsize min_chunk)
+{
+    gsize jobs;
+
+    min_chunk = MAX (min_chunk, 1);
+    jobs = items / min_chunk;
+    jobs = MIN (jobs, (gsize) mc_parallel_get_workers () * MC_PARALLEL_JOBS_PER_WORKER);
+
+    return (guint) MAX (jobs, 1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Start a run of jobs.
+ *
+ * @param jobs number of jobs
+ * @param job_fn job callback, called once for each job in range [0; jobs)
+ * @param user_data data passed to job_fn
+ *
+ * @return run handle which must be freed with mc_parallel_free(). If threads are not available,
+ *         all jobs are finished when this function returns.
+ */
+
+mc_parallel_t *
+mc_parallel_run (guint jobs, mc_parallel_job_fn job_fn, gpointer user_data)
+{
+    return mc_parallel_new_run (jobs, FALSE, job_fn, user_data);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Start one job in the background. Unlike mc_parallel_run() with one job, the job
+ * is not executed in the calling thread, so the caller can start more work meanwhile.
+ *
+ * @param job_fn job callback, called with job 0
+ * @param user_data data passed to job_fn
+ *
+ * @return run handle which must be freed with mc_parallel_free(). If threads are not available,
+ *         the job is finished when this function returns.
+ */
+
+mc_parallel_t *
+mc_parallel_start (mc_parallel_job_fn job_fn, gpointer user_data)
+{
+    return mc_parallel_new_run (1, TRUE, job_fn, user_data);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Wait for all jobs of the run.
+ *
+ * @param run run handle
+ * @param timeout_usec time to wait in microseconds. Negative value means wait infinitely
+ *
+ * @return TRUE if all jobs are finished, FALSE if timeout is expired
+ */
+
+gboolean
+mc_parallel_wait (mc_parallel_t * run, gint64 timeout_usec)
+{
+    gboolean ret;
+
+#ifdef MC_PARALLEL_THREADS
+    gint64 end_time;
+
+    end_time = g_get_monotonic_time () + timeout_usec;
+
+    g_mutex_lock (&run->lock);
+    while (run->done < run->jobs)
+    {
+        if (timeout_usec < 0)
+            g_cond_wait (&run->cond, &run->lock);
+        else if (!g_cond_wait_until (&run->cond, &run->lock, end_time))
+            break;
+    }
+    ret = run->done == run->jobs;
+    g_mutex_unlock (&run->lock);
+#else
+    (void) timeout_usec;
+
+    ret = run->done == run->jobs;
+#endif
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get number of finished jobs of the run.
+ */
+
+guint
+mc_parallel_get_done (mc_parallel_t * run)
+{
+    guint done;
+
+#ifdef MC_PARALLEL_THREADS
+    g_mutex_lock (&run->lock);
+    done = run->done;
+    g_mutex_unlock (&run->lock);
+#else
+    done = run->done;
+#endif
+
+    return done;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Cancel the run. Jobs which are not started yet are skipped, running jobs should
+ * poll mc_parallel_is_cancelled() and return as soon as possible.
+ */
+
+void
+mc_parallel_cancel (mc_parallel_t * run)
+{
+    g_atomic_int_set (&run->cancelled, 1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+gboolean
+mc_parallel_is_cancelled (mc_parallel_t * run)
+{
+    return (g_atomic_int_get (&run->cancelled) != 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Cancel the run, wait for jobs which are being executed and free the run handle.
+ */
+
+void
+mc_parallel_free (mc_parallel_t * run)
+{
+    if (run == NULL)
+        return;
+
+    mc_parallel_cancel (run);
+    mc_parallel_wait (run, -1);
+
+#ifdef MC_PARALLEL_THREADS
+    g_mutex_clear (&run->lock);
+    g_cond_clear (&run->cond);
+#endif
+
+    g_free (run->slots);
+    g_free (run);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Stop the worker pool. Should be called at exit when no runs are active.
+ */
+
+void
+mc_parallel_deinit (void)
+{
+#ifdef MC_PARALLEL_THREADS
+    G_LOCK (pool);
+    if (pool != NULL && pool_pid == getpid ())
+        g_thread_pool_free (pool, TRUE, TRUE);
+    pool = NULL;
+    G_UNLOCK (pool);
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,52 @@
+/** \file parallel.h
+ *  \brief Header: run independent jobs on a shared worker pool
+ */
+
+#ifndef MC_PARALLEL_H
+#define MC_PARALLEL_H
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/* don't bother the pool with less work than this per job */
+#define MC_PARALLEL_MIN_CHUNK 64
+
+struct mc_parallel_t;
+typedef struct mc_parallel_t mc_parallel_t;
+
+/* job callback. Runs in a worker thread: must not touch UI, VFS or other global state */
+typedef void (*mc_parallel_job_fn) (mc_parallel_t * run, guint job, gpointer user_data);
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+guint mc_parallel_get_workers (void);
+guint mc_parallel_count_jobs (gsize items, gsize min_chunk);
+
+mc_parallel_t *mc_parallel_run (guint jobs, mc_parallel_job_fn job_fn, gpointer user_data);
+mc_parallel_t *mc_parallel_start (mc_parallel_job_fn job_fn, gpointer user_data);
+gboolean mc_parallel_wait (mc_parallel_t * run, gint64 timeout_usec);
+guint mc_parallel_get_done (mc_parallel_t * run);
+void mc_parallel_cancel (mc_parallel_t * run);
+gboolean mc_parallel_is_cancelled (mc_parallel_t * run);
+void mc_parallel_free (mc_parallel_t * run);
+
+void mc_parallel_deinit (void);
+
+/*** inline functions ****************************************************************************/
+
+/**
+ * Get first item of the job when @items are split evenly into @jobs parts.
+ * Last item of the job is mc_parallel_job_start (items, jobs, job + 1) - 1.
+ */
+static inline gsize
+mc_parallel_job_start (gsize items, guint jobs, guint job)
+{
+    return (gsize) ((guint64) items * job / jobs);
+}
+
+#endif /* MC_PARALLEL_H */
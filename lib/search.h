@@ -11,18 +11,27 @@
 #include <pcre.h>
 #endif
 
+#ifdef SEARCH_TYPE_PCRE2
+#define PCRE2_CODE_UNIT_WIDTH 8
+#include <pcre2.h>
+#endif
+
 /*** typedefs(not structures) and defined constants **********************************************/
 
 typedef enum mc_search_cbret_t mc_search_cbret_t;
 
 typedef mc_search_cbret_t (*mc_search_fn) (const void *user_data, gsize char_offset,
                                            int *current_char);
+typedef mc_search_cbret_t (*mc_search_block_fn) (const void *user_data, gsize offset,
+                                                 const char **block, gsize * block_len);
 typedef mc_search_cbret_t (*mc_update_fn) (const void *user_data, gsize char_offset);
 
 #define MC_SEARCH__NUM_REPLACE_ARGS 64
 
 #ifdef SEARCH_TYPE_GLIB
 #define mc_search_matchinfo_t GMatchInfo
+#elif defined (SEARCH_TYPE_PCRE2)
+#define mc_search_matchinfo_t pcre2_match_data
 #else
 #define mc_search_matchinfo_t pcre_extra
 #endif
@@ -84,6 +93,12 @@ typedef struct mc_search_struct
     /* function, used for getting data. NULL if not used */
     mc_search_fn search_fn;
 
+    /* function, used for getting data by contiguous blocks. NULL if not used.
+     * Takes precedence over search_fn which is left for data that should be recoded on the fly.
+     * Returns MC_SEARCH_CB_OK and a non-empty block started at offset which must be valid
+     * until the next call, MC_SEARCH_CB_NOTFOUND at end of data, MC_SEARCH_CB_ABORT to abort. */
+    mc_search_block_fn block_fn;
+
     /* function, used for updatin current search status. NULL if not used */
     mc_update_fn update_fn;
 
@@ -146,6 +161,7 @@ mc_search_t *mc_search_new_len (const gchar * original, gsize original_len,
 void mc_search_free (mc_search_t * lc_mc_search);
 
 gboolean mc_search_prepare (mc_search_t * mc_search);
+void mc_search_cache_done (void);
 
 gboolean mc_search_run (mc_search_t * mc_search, const void *user_data, gsize start_search,
                         gsize end_search, gsize * found_len);
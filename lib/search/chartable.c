@@ -0,0 +1,414 @@
+/*
+   Search text engine.
+   Case mapping and word character tables of charsets
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file chartable.c
+ *  \brief Source: case mapping and word character tables of charsets
+ *
+ *  Case insensitive and whole word search looked at characters one by one through iconv and
+ *  str_* functions. Now the properties of every character of a charset are collected once:
+ *  a charset of single byte characters gets plain 256 entry tables, UTF-8 gets a two-level
+ *  table of BMP characters where pages with the same content are shared. Tables are kept
+ *  until mc_search_cache_done() and can be used by several threads.
+ */
+
+#include <config.h>
+
+#include <string.h>
+
+#include "lib/global.h"
+#include "lib/strutil.h"
+#include "lib/search.h"
+#ifdef HAVE_CHARSET
+#include "lib/charsets.h"
+#endif
+
+#include "internal.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/*** file scope type declarations ****************************************************************/
+
+/*** file scope variables ************************************************************************/
+
+G_LOCK_DEFINE_STATIC (mc_search_chartables);
+/* charset name -> mc_search_chartable_t, NULL value for charsets without table */
+static GHashTable *mc_search_chartables = NULL;
+
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+mc_search__chartable_free (mc_search_chartable_t * table)
+{
+    if (table != NULL)
+    {
+        if (table->page_list != NULL)
+            g_ptr_array_free (table->page_list, TRUE);
+        g_free (table);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static mc_search_chartable_t *
+mc_search__chartable_new_utf8 (void)
+{
+    mc_search_chartable_t *table;
+    mc_search_chartable_page_t *page;
+    guint hi;
+
+    table = g_new0 (mc_search_chartable_t, 1);
+    table->utf8 = TRUE;
+    table->page_list = g_ptr_array_new_with_free_func (g_free);
+
+    page = g_new (mc_search_chartable_page_t, 1);
+
+    for (hi = 0; hi < G_N_ELEMENTS (table->pages); hi++)
+    {
+        guint lo, i;
+
+        for (lo = 0; lo < 256; lo++)
+        {
+            const gunichar c = (hi << 8) | lo;
+
+            page->lower[lo] = (gint32) g_unichar_tolower (c) - (gint32) c;
+            page->upper[lo] = (gint32) g_unichar_toupper (c) - (gint32) c;
+            page->flags[lo] = mc_search__chartable_unichar_flags (c);
+        }
+
+        /* most of pages are the same: CJK ideographs, symbols, unassigned characters */
+        for (i = 0; i < table->page_list->len; i++)
+            if (memcmp (g_ptr_array_index (table->page_list, i), page, sizeof (*page)) == 0)
+                break;
+
+        if (i == table->page_list->len)
+        {
+            g_ptr_array_add (table->page_list, page);
+            page = g_new (mc_search_chartable_page_t, 1);
+        }
+
+        table->pages[hi] = (const mc_search_chartable_page_t *)
+            g_ptr_array_index (table->page_list, i);
+    }
+
+    g_free (page);
+
+    return table;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Convert character to the single byte charset.
+ *
+ * @return byte or -1 if character can't be represented by one byte
+ */
+
+static int
+mc_search__chartable_from_unichar (GIConv conv, gunichar c)
+{
+    gchar utf8[6];
+    gchar *converted;
+    gsize bytes_read, bytes_written = 0;
+    int ret = -1;
+
+    converted = g_convert_with_iconv (utf8, g_unichar_to_utf8 (c, utf8), conv, &bytes_read,
+                                      &bytes_written, NULL);
+    if (converted != NULL && bytes_written == 1)
+        ret = (unsigned char) converted[0];
+
+    g_free (converted);
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Create tables of charset of single byte characters.
+ *
+ * @return NULL if charset is unknown or contains multibyte characters
+ */
+
+static mc_search_chartable_t *
+mc_search__chartable_new_8bit (const char *charset)
+{
+    mc_search_chartable_t *table = NULL;
+    GIConv to_utf8, from_utf8;
+    gboolean multibyte = FALSE;
+    int c;
+
+    to_utf8 = g_iconv_open ("UTF-8", charset);
+    from_utf8 = g_iconv_open (charset, "UTF-8");
+
+    if (to_utf8 != INVALID_CONV && from_utf8 != INVALID_CONV)
+    {
+        table = g_new0 (mc_search_chartable_t, 1);
+
+        for (c = 0; c < 256 && !multibyte; c++)
+        {
+            const gchar byte = (gchar) c;
+            gchar *converted;
+            gsize bytes_read, bytes_written;
+            GError *error = NULL;
+
+            table->lower[c] = table->upper[c] = (guint8) c;
+
+            converted =
+                g_convert_with_iconv (&byte, 1, to_utf8, &bytes_read, &bytes_written, &error);
+
+            if (converted == NULL)
+            {
+                /* lead byte of multibyte character, undefined bytes just have no properties */
+                multibyte =
+                    g_error_matches (error, G_CONVERT_ERROR, G_CONVERT_ERROR_PARTIAL_INPUT);
+                g_error_free (error);
+            }
+            else
+            {
+                const gunichar uc = g_utf8_get_char (converted);
+                int b;
+
+                table->flags[c] = mc_search__chartable_unichar_flags (uc);
+
+                if (g_unichar_tolower (uc) != uc)
+                {
+                    b = mc_search__chartable_from_unichar (from_utf8, g_unichar_tolower (uc));
+                    if (b >= 0)
+                        table->lower[c] = (guint8) b;
+                }
+
+                if (g_unichar_toupper (uc) != uc)
+                {
+                    b = mc_search__chartable_from_unichar (from_utf8, g_unichar_toupper (uc));
+                    if (b >= 0)
+                        table->upper[c] = (guint8) b;
+                }
+
+                g_free (converted);
+            }
+        }
+
+        if (multibyte)
+            MC_PTR_FREE (table);
+    }
+
+    if (to_utf8 != INVALID_CONV)
+        g_iconv_close (to_utf8);
+    if (from_utf8 != INVALID_CONV)
+        g_iconv_close (from_utf8);
+
+    return table;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get properties of character not using tables.
+ * Word characters are the same as [\p{L}\p{N}_] of regex search.
+ */
+
+guint8
+mc_search__chartable_unichar_flags (gunichar c)
+{
+    if (c == '_')
+        return MC_SEARCH_CHAR_WORD;
+
+    switch (g_unichar_type (c))
+    {
+    case G_UNICODE_LOWERCASE_LETTER:
+    case G_UNICODE_MODIFIER_LETTER:
+    case G_UNICODE_OTHER_LETTER:
+    case G_UNICODE_TITLECASE_LETTER:
+    case G_UNICODE_UPPERCASE_LETTER:
+        return MC_SEARCH_CHAR_WORD | MC_SEARCH_CHAR_ALPHA;
+    case G_UNICODE_DECIMAL_NUMBER:
+    case G_UNICODE_LETTER_NUMBER:
+    case G_UNICODE_OTHER_NUMBER:
+        return MC_SEARCH_CHAR_WORD;
+    default:
+        return 0;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get tables of charset. Tables are created at the first request.
+ *
+ * @param charset charset name. If NULL then source codepage (or terminal charset without
+ *                charset support) is used
+ *
+ * @return tables or NULL if charset is unknown or is multibyte but not UTF-8
+ */
+
+const mc_search_chartable_t *
+mc_search__chartable_get (const char *charset)
+{
+    gpointer table;
+    char *key;
+
+    if (charset == NULL)
+#ifdef HAVE_CHARSET
+        charset = cp_source;
+#else
+        charset = str_detect_termencoding ();
+#endif
+
+    if (charset == NULL || *charset == '\0')
+        return NULL;
+
+    key = str_isutf8 (charset) ? g_strdup ("UTF-8") : g_ascii_strup (charset, -1);
+
+    G_LOCK (mc_search_chartables);
+
+    if (mc_search_chartables == NULL)
+        mc_search_chartables = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+                                                      (GDestroyNotify) mc_search__chartable_free);
+
+    if (g_hash_table_lookup_extended (mc_search_chartables, key, NULL, &table))
+        g_free (key);
+    else
+    {
+        if (strcmp (key, "UTF-8") == 0)
+            table = mc_search__chartable_new_utf8 ();
+        else
+            table = mc_search__chartable_new_8bit (key);
+
+        g_hash_table_insert (mc_search_chartables, key, table);
+    }
+
+    G_UNLOCK (mc_search_chartables);
+
+    return (const mc_search_chartable_t *) table;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Change case of string using tables. Bytes which aren't valid UTF-8 are kept as is.
+ *
+ * @param table tables of charset of string
+ * @param str string
+ * @param str_len length of string
+ * @param upper TRUE to convert to upper case, FALSE to lower case
+ *
+ * @return newly allocated string
+ */
+
+GString *
+mc_search__chartable_change_case (const mc_search_chartable_t * table, const char *str,
+                                  gsize str_len, gboolean upper)
+{
+    GString *ret;
+    gsize i;
+
+    ret = g_string_sized_new (str_len);
+
+    if (!table->utf8)
+    {
+        const guint8 *map = upper ? table->upper : table->lower;
+
+        g_string_set_size (ret, str_len);
+        for (i = 0; i < str_len; i++)
+            ret->str[i] = (char) map[(unsigned char) str[i]];
+
+        return ret;
+    }
+
+    for (i = 0; i < str_len;)
+    {
+        gunichar c;
+
+        c = g_utf8_get_char_validated (str + i, (gssize) (str_len - i));
+        if (c == (gunichar) (-1) || c == (gunichar) (-2))
+        {
+            g_string_append_c (ret, str[i]);
+            i++;
+        }
+        else
+        {
+            g_string_append_unichar (ret, upper ? mc_search__chartable_upper (table, c)
+                                     : mc_search__chartable_lower (table, c));
+            i += g_unichar_to_utf8 (c, NULL);
+        }
+    }
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Make regex character class of word characters of charset of single byte characters,
+ * e.g. "[0-9A-Z_a-z\xC0-\xFF]".
+ */
+
+GString *
+mc_search__chartable_word_class (const mc_search_chartable_t * table)
+{
+    GString *ret;
+    int c = 0;
+
+    ret = g_string_new ("[");
+
+    while (c < 256)
+    {
+        int last;
+
+        if ((table->flags[c] & MC_SEARCH_CHAR_WORD) == 0)
+        {
+            c++;
+            continue;
+        }
+
+        for (last = c; last < 255 && (table->flags[last + 1] & MC_SEARCH_CHAR_WORD) != 0; last++)
+            ;
+
+        g_string_append_printf (ret, "\\x%02X", (unsigned int) c);
+        if (last != c)
+            g_string_append_printf (ret, "-\\x%02X", (unsigned int) last);
+
+        c = last + 1;
+    }
+
+    g_string_append_c (ret, ']');
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+mc_search__chartable_done (void)
+{
+    G_LOCK (mc_search_chartables);
+
+    if (mc_search_chartables != NULL)
+    {
+        g_hash_table_destroy (mc_search_chartables);
+        mc_search_chartables = NULL;
+    }
+
+    G_UNLOCK (mc_search_chartables);
+}
+
+/* --------------------------------------------------------------------------------------------- */
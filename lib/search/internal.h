@@ -5,10 +5,25 @@
 
 #ifdef SEARCH_TYPE_GLIB
 #define mc_search_regex_t GRegex
+#elif defined (SEARCH_TYPE_PCRE2)
+#define mc_search_regex_t pcre2_code
 #else
 #define mc_search_regex_t pcre
 #endif
 
+/* conditions don't keep data of particular search and can be shared */
+#if defined (SEARCH_TYPE_GLIB) || defined (SEARCH_TYPE_PCRE2)
+#define MC_SEARCH_CACHE 1
+#endif
+
+/* lines of data got from block_fn which are longer are searched by literal search in parts
+   of this size, parts overlap by the length of pattern */
+#define MC_SEARCH_LINE_MAX (1024 * 1024)
+
+/* properties of characters in mc_search_chartable_t */
+#define MC_SEARCH_CHAR_WORD (1 << 0)    /* [\p{L}\p{N}_] */
+#define MC_SEARCH_CHAR_ALPHA (1 << 1)   /* letter */
+
 /*** enums ***************************************************************************************/
 
 typedef enum
@@ -23,12 +38,46 @@ typedef enum
 
 /*** structures declarations (and typedefs of structures)*****************************************/
 
+/* 256 characters of UTF-8 table: case mappings are differences from the character */
+typedef struct mc_search_chartable_page_struct
+{
+    gint32 lower[256];
+    gint32 upper[256];
+    guint8 flags[256];
+} mc_search_chartable_page_t;
+
+/* case mappings and properties of characters of charset */
+typedef struct mc_search_chartable_struct
+{
+    gboolean utf8;
+    /* charset of single byte characters */
+    guint8 lower[256];
+    guint8 upper[256];
+    guint8 flags[256];
+    /* UTF-8: two-level table of BMP, other characters are looked up by GLib */
+    const mc_search_chartable_page_t *pages[256];
+    GPtrArray *page_list;       /* different pages */
+} mc_search_chartable_t;
+
+/* fixed string matcher for normal search */
+typedef struct mc_search_literal_struct
+{
+    GString *pattern;           /* lowercase if search is case insensitive */
+    gboolean case_sensitive;
+    gboolean whole_words;
+    gboolean utf8;              /* text is UTF-8: used to find word boundaries */
+    const mc_search_chartable_t *table; /* word characters, NULL for Latin-1 */
+    guint8 fold[256];           /* lowercase of bytes for case insensitive search */
+    gsize shift[256];           /* bad character shifts of Horspool search */
+} mc_search_literal_t;
+
 typedef struct mc_search_cond_struct
 {
     GString *str;
     GString *upper;
     GString *lower;
     mc_search_regex_t *regex_handle;
+    mc_search_literal_t *literal;       /* used instead of regex_handle if not NULL */
     gchar *charset;
 } mc_search_cond_t;
 
@@ -46,6 +95,19 @@ GString *mc_search__tolower_case_str (const char *, const char *, gsize);
 
 GString *mc_search__toupper_case_str (const char *, const char *, gsize);
 
+/* search/chartable.c : */
+
+guint8 mc_search__chartable_unichar_flags (gunichar);
+
+const mc_search_chartable_t *mc_search__chartable_get (const char *);
+
+GString *mc_search__chartable_change_case (const mc_search_chartable_t *, const char *, gsize,
+                                           gboolean);
+
+GString *mc_search__chartable_word_class (const mc_search_chartable_t *);
+
+void mc_search__chartable_done (void);
+
 /* search/regex.c : */
 
 void mc_search__cond_struct_new_init_regex (const char *, mc_search_t *, mc_search_cond_t *);
@@ -60,6 +122,10 @@ void mc_search__cond_struct_new_init_normal (const char *, mc_search_t *, mc_sea
 
 gboolean mc_search__run_normal (mc_search_t *, const void *, gsize, gsize, gsize *);
 
+gboolean mc_search__literal_find (const mc_search_literal_t *, const char *, gsize, gsize *, gsize *);
+
+void mc_search__literal_free (mc_search_literal_t *);
+
 GString *mc_search_normal_prepare_replace_str (mc_search_t *, GString *);
 
 /* search/glob.c : */
@@ -80,4 +146,45 @@ GString *mc_search_hex_prepare_replace_str (mc_search_t *, GString *);
 
 /*** inline functions ****************************************************************************/
 
+/**
+ * Get properties of character of charset of table.
+ * Without table character is treated as Unicode one.
+ */
+
+static inline guint8
+mc_search__chartable_flags (const mc_search_chartable_t * table, gunichar c)
+{
+    if (table == NULL || (table->utf8 && c > 0xFFFF))
+        return mc_search__chartable_unichar_flags (c);
+    if (!table->utf8)
+        return table->flags[c & 0xFF];
+    return table->pages[c >> 8]->flags[c & 0xFF];
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline gunichar
+mc_search__chartable_lower (const mc_search_chartable_t * table, gunichar c)
+{
+    if (!table->utf8)
+        return table->lower[c & 0xFF];
+    if (c > 0xFFFF)
+        return g_unichar_tolower (c);
+    return (gunichar) ((gint32) c + table->pages[c >> 8]->lower[c & 0xFF]);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline gunichar
+mc_search__chartable_upper (const mc_search_chartable_t * table, gunichar c)
+{
+    if (!table->utf8)
+        return table->upper[c & 0xFF];
+    if (c > 0xFFFF)
+        return g_unichar_toupper (c);
+    return (gunichar) ((gint32) c + table->pages[c >> 8]->upper[c & 0xFF]);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 #endif
@@ -54,44 +54,13 @@ const char *STR_E_RPL_INVALID_TOKEN = N_("Invalid token number %d");
 /*** file scope variables ************************************************************************/
 
 /*** file scope functions ************************************************************************/
-
-/*** public functions ****************************************************************************/
-
-gchar *
-mc_search__recode_str (const char *str, gsize str_len,
-                       const char *charset_from, const char *charset_to, gsize * bytes_written)
-{
-    gchar *ret = NULL;
-
-    if (charset_from != NULL && charset_to != NULL
-        && g_ascii_strcasecmp (charset_to, charset_from) != 0)
-    {
-        GIConv conv;
-
-        conv = g_iconv_open (charset_to, charset_from);
-        if (conv != INVALID_CONV)
-        {
-            gsize bytes_read;
-
-            ret = g_convert_with_iconv (str, str_len, conv, &bytes_read, bytes_written, NULL);
-            g_iconv_close (conv);
-        }
-    }
-
-    if (ret == NULL)
-    {
-        *bytes_written = str_len;
-        ret = g_strndup (str, str_len);
-    }
-
-    return ret;
-}
-
 /* --------------------------------------------------------------------------------------------- */
 
-gchar *
-mc_search__get_one_symbol (const char *charset, const char *str, gsize str_len,
-                           gboolean * just_letters)
+/** Fallback for multibyte charsets other than UTF-8 which have no tables */
+
+static gchar *
+mc_search__get_one_symbol_recode (const char *charset, const char *str, gsize str_len,
+                                  gboolean * just_letters)
 {
     gchar *converted_str;
     const gchar *next_char;
@@ -133,8 +102,8 @@ mc_search__get_one_symbol (const char *charset, const char *str, gsize str_len,
 
 /* --------------------------------------------------------------------------------------------- */
 
-GString *
-mc_search__tolower_case_str (const char *charset, const char *str, gsize str_len)
+static GString *
+mc_search__tolower_case_str_recode (const char *charset, const char *str, gsize str_len)
 {
     GString *ret;
 #ifdef HAVE_CHARSET
@@ -183,8 +152,8 @@ mc_search__tolower_case_str (const char *charset, const char *str, gsize str_len
 
 /* --------------------------------------------------------------------------------------------- */
 
-GString *
-mc_search__toupper_case_str (const char *charset, const char *str, gsize str_len)
+static GString *
+mc_search__toupper_case_str_recode (const char *charset, const char *str, gsize str_len)
 {
     GString *ret;
 #ifdef HAVE_CHARSET
@@ -233,6 +202,101 @@ mc_search__toupper_case_str (const char *charset, const char *str, gsize str_len
 #endif
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+gchar *
+mc_search__recode_str (const char *str, gsize str_len,
+                       const char *charset_from, const char *charset_to, gsize * bytes_written)
+{
+    gchar *ret = NULL;
+
+    if (charset_from != NULL && charset_to != NULL
+        && g_ascii_strcasecmp (charset_to, charset_from) != 0)
+    {
+        GIConv conv;
+
+        conv = g_iconv_open (charset_to, charset_from);
+        if (conv != INVALID_CONV)
+        {
+            gsize bytes_read;
+
+            ret = g_convert_with_iconv (str, str_len, conv, &bytes_read, bytes_written, NULL);
+            g_iconv_close (conv);
+        }
+    }
+
+    if (ret == NULL)
+    {
+        *bytes_written = str_len;
+        ret = g_strndup (str, str_len);
+    }
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* --------------------------------------------------------------------------------------------- */
+
+gchar *
+mc_search__get_one_symbol (const char *charset, const char *str, gsize str_len,
+                           gboolean * just_letters)
+{
+    const mc_search_chartable_t *table;
+    gunichar c;
+    gsize len = 1;
+
+    table = mc_search__chartable_get (charset);
+    if (table == NULL)
+        return mc_search__get_one_symbol_recode (charset, str, str_len, just_letters);
+
+    c = (unsigned char) str[0];
+
+    if (table->utf8)
+    {
+        c = g_utf8_get_char_validated (str, (gssize) str_len);
+        if (c == (gunichar) (-1) || c == (gunichar) (-2))
+            c = 0xFFFD;         /* invalid byte is a symbol but not a letter */
+        else
+            len = g_unichar_to_utf8 (c, NULL);
+    }
+
+    if (just_letters != NULL)
+        *just_letters = (mc_search__chartable_flags (table, c) & MC_SEARCH_CHAR_ALPHA) != 0;
+
+    return g_strndup (str, len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+GString *
+mc_search__tolower_case_str (const char *charset, const char *str, gsize str_len)
+{
+    const mc_search_chartable_t *table;
+
+    table = mc_search__chartable_get (charset);
+    if (table == NULL)
+        return mc_search__tolower_case_str_recode (charset, str, str_len);
+
+    return mc_search__chartable_change_case (table, str, str_len, FALSE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+GString *
+mc_search__toupper_case_str (const char *charset, const char *str, gsize str_len)
+{
+    const mc_search_chartable_t *table;
+
+    table = mc_search__chartable_get (charset);
+    if (table == NULL)
+        return mc_search__toupper_case_str_recode (charset, str, str_len);
+
+    return mc_search__chartable_change_case (table, str, str_len, TRUE);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 gchar **
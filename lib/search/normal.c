@@ -26,6 +26,8 @@
 
 #include <config.h>
 
+#include <string.h>
+
 #include "lib/global.h"
 #include "lib/strutil.h"
 #include "lib/search.h"
@@ -42,6 +44,412 @@
 
 /*** file scope functions ************************************************************************/
 
+/**
+ * Check whether the pattern can be found as fixed string instead of regex: it shouldn't cross
+ * lines, and case insensitive search is done for ASCII patterns or in charsets of single byte
+ * characters only. Note that ASCII letters are folded as ASCII: Unicode caseless regex also
+ * matches "k" with KELVIN SIGN and "s" with LATIN SMALL LETTER LONG S.
+ */
+
+static gboolean
+mc_search__normal_is_literal (const mc_search_t * lc_mc_search, const GString * str,
+                              const mc_search_chartable_t * table)
+{
+    gsize i;
+
+    for (i = 0; i < str->len; i++)
+    {
+        const unsigned char c = (unsigned char) str->str[i];
+
+        if (c == '\n' || c == '\0' || (c >= 0x80 && !lc_mc_search->is_case_sensitive
+                                         && (table == NULL || table->utf8)))
+            return FALSE;
+    }
+
+    return (str->len != 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Create fixed string matcher.
+ *
+ * @param str pattern
+ * @param case_sensitive TRUE for case sensitive search
+ * @param whole_words TRUE to find whole words only
+ * @param utf8 TRUE if text is UTF-8
+ * @param table tables of charset of text, can be NULL
+ */
+
+static mc_search_literal_t *
+mc_search__literal_new (const GString * str, gboolean case_sensitive, gboolean whole_words,
+                        gboolean utf8, const mc_search_chartable_t * table)
+{
+    mc_search_literal_t *literal;
+    gsize fold_shift[256];
+    gsize i;
+
+    literal = g_new (mc_search_literal_t, 1);
+    literal->pattern = g_string_new_len (str->str, str->len);
+    literal->case_sensitive = case_sensitive;
+    literal->whole_words = whole_words;
+    literal->utf8 = utf8;
+
+    /* without UTF-8 bytes are Latin-1 characters like for regex search if charset is unknown */
+    literal->table = table != NULL && table->utf8 == utf8 ? table : NULL;
+
+    for (i = 0; i < G_N_ELEMENTS (literal->fold); i++)
+        literal->fold[i] = literal->table != NULL && !utf8 ? literal->table->lower[i]
+            : (guint8) g_ascii_tolower ((guchar) i);
+
+    if (!case_sensitive)
+        for (i = 0; i < str->len; i++)
+            literal->pattern->str[i] = (char) literal->fold[(unsigned char) str->str[i]];
+
+    /* Horspool shifts: all cases of letter have the same shift */
+    for (i = 0; i < G_N_ELEMENTS (fold_shift); i++)
+        fold_shift[i] = str->len;
+    for (i = 0; i + 1 < str->len; i++)
+        fold_shift[(unsigned char) literal->pattern->str[i]] = str->len - 1 - i;
+    for (i = 0; i < G_N_ELEMENTS (literal->shift); i++)
+        literal->shift[i] = fold_shift[case_sensitive ? i : literal->fold[i]];
+
+    return literal;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Check whether there is a word character before @pos or at @pos (if @before is FALSE).
+ */
+
+static gboolean
+mc_search__literal_word_at (const mc_search_literal_t * literal, const char *text, gsize len,
+                            gsize pos, gboolean before)
+{
+    gunichar c;
+
+    if (before ? pos == 0 : pos >= len)
+        return FALSE;
+
+    if (!literal->utf8)
+        c = (unsigned char) text[before ? pos - 1 : pos];
+    else
+    {
+        gsize start = pos;
+
+        if (before)
+        {
+            /* go back to the first byte of character */
+            for (start = pos - 1; start > 0 && pos - start < 4
+                 && ((unsigned char) text[start] & 0xC0) == 0x80; start--)
+                ;
+            len = pos;
+        }
+
+        c = g_utf8_get_char_validated (text + start, (gssize) (len - start));
+        if (c == (gunichar) (-1) || c == (gunichar) (-2))
+            return FALSE;
+    }
+
+    return (mc_search__chartable_flags (literal->table, c) & MC_SEARCH_CHAR_WORD) != 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Case sensitive search: memchr() of the first byte is filtered by the last byte. */
+
+static const char *
+mc_search__literal_find_cs (const mc_search_literal_t * literal, const char *text,
+                            const char *end)
+{
+    const char *p = literal->pattern->str;
+    const gsize m = literal->pattern->len;
+    const char *last;
+
+    if ((gsize) (end - text) < m)
+        return NULL;
+
+    /* last possible start of match */
+    last = end - m;
+
+    while (text <= last)
+    {
+        text = (const char *) memchr (text, p[0], (gsize) (last - text) + 1);
+        if (text == NULL)
+            return NULL;
+        if (text[m - 1] == p[m - 1] && memcmp (text + 1, p + 1, m - 1) == 0)
+            return text;
+        text++;
+    }
+
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Case insensitive search: Boyer-Moore-Horspool with folding of bytes by table. */
+
+static const char *
+mc_search__literal_find_ci (const mc_search_literal_t * literal, const char *text,
+                            const char *end)
+{
+    const guint8 *p = (const guint8 *) literal->pattern->str;
+    const guint8 *fold = literal->fold;
+    const gsize m = literal->pattern->len;
+
+    while ((gsize) (end - text) >= m)
+    {
+        const unsigned char c = (unsigned char) text[m - 1];
+
+        if (fold[c] == p[m - 1])
+        {
+            gsize i;
+
+            for (i = 0; i < m - 1 && fold[(unsigned char) text[i]] == p[i]; i++)
+                ;
+            if (i == m - 1)
+                return text;
+        }
+        text += literal->shift[c];
+    }
+
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+mc_search__normal_all_literal (const mc_search_t * lc_mc_search)
+{
+    gsize i;
+
+    for (i = 0; i < lc_mc_search->conditions->len; i++)
+        if (((mc_search_cond_t *) g_ptr_array_index (lc_mc_search->conditions, i))->literal == NULL)
+            return FALSE;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find the leftmost match of all conditions in the text.
+ *
+ * @param lc_mc_search search object
+ * @param text text to search in
+ * @param len length of text
+ * @param offset offset of text in the searched data
+ * @param found_len length of found string
+ *
+ * @return TRUE if found, normal_offset and start_buffer are set in this case
+ */
+
+static gboolean
+mc_search__normal_literal_found (mc_search_t * lc_mc_search, const char *text, gsize len,
+                                 gsize offset, gsize * found_len)
+{
+    gsize found_start = 0, found_end = 0;
+    gboolean found = FALSE;
+    gsize i;
+
+    for (i = 0; i < lc_mc_search->conditions->len; i++)
+    {
+        mc_search_cond_t *mc_search_cond;
+        gsize start, end;
+
+        mc_search_cond = (mc_search_cond_t *) g_ptr_array_index (lc_mc_search->conditions, i);
+
+        if (mc_search__literal_find (mc_search_cond->literal, text, len, &start, &end)
+            && (!found || start < found_start))
+        {
+            found_start = start;
+            found_end = end;
+            found = TRUE;
+        }
+    }
+
+    if (found)
+    {
+        lc_mc_search->start_buffer = offset;
+        lc_mc_search->normal_offset = offset + found_start;
+        if (found_len != NULL)
+            *found_len = found_end - found_start;
+    }
+
+    return found;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Search in the buffer in place. Like mc_search__run_regex() does for buffers, search is done
+ * in the first line of [start_search; end_search] until '\0'.
+ */
+
+static gboolean
+mc_search__run_literal (mc_search_t * lc_mc_search, const char *text, gsize start_search,
+                        gsize end_search, gsize * found_len)
+{
+    const char *line = text + start_search;
+    const char *p;
+    gsize len;
+
+    if (start_search > end_search)
+        len = 0;
+    else if (end_search - start_search < G_MAXSSIZE)
+        len = end_search - start_search + 1;    /* end_search is inclusive */
+    else
+        len = strlen (line);    /* end_search is "until '\0'" */
+
+    p = (const char *) memchr (line, '\0', len);
+    if (p != NULL)
+        len = (gsize) (p - line);
+    p = (const char *) memchr (line, '\n', len);
+    if (p != NULL)
+        len = (gsize) (p - line);
+
+    if (mc_search__normal_literal_found (lc_mc_search, line, len, start_search, found_len))
+        return TRUE;
+
+    MC_PTR_FREE (lc_mc_search->error_str);
+    lc_mc_search->error = MC_SEARCH_E_NOTFOUND;
+
+    return FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get size of the end of long line part which should be searched again with the next part
+ * to find matches crossing the cut.
+ */
+
+static gsize
+mc_search__normal_literal_overlap (const mc_search_t * lc_mc_search)
+{
+    gsize overlap = 0;
+    gsize i;
+
+    for (i = 0; i < lc_mc_search->conditions->len; i++)
+    {
+        const mc_search_literal_t *literal;
+        gsize len;
+
+        literal = ((mc_search_cond_t *) g_ptr_array_index (lc_mc_search->conditions, i))->literal;
+        len = literal->pattern->len > 0 ? literal->pattern->len - 1 : 0;
+        /* whole word: the character before match is checked too */
+        if (literal->whole_words)
+            len += 4;
+        overlap = MAX (overlap, len);
+    }
+
+    return overlap;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Search in the data got from block_fn. Complete lines are searched in place in the block,
+ * only a line which is split between blocks is collected in a buffer.
+ */
+
+static gboolean
+mc_search__run_literal_blocks (mc_search_t * lc_mc_search, const void *user_data,
+                               gsize start_search, gsize end_search, gsize * found_len)
+{
+    mc_search_cbret_t ret = MC_SEARCH_CB_OK;
+    GString *line;
+    gsize line_start = start_search;
+    gsize pos = start_search;
+    gsize overlap;
+    gboolean found = FALSE;
+
+    overlap = mc_search__normal_literal_overlap (lc_mc_search);
+    line = g_string_sized_new (64);
+
+    while (!found && pos <= end_search)
+    {
+        const char *block;
+        const char *eol;
+        gsize len = 0;
+        gsize done = 0;
+        gsize whole;
+
+        ret = lc_mc_search->block_fn (user_data, pos, &block, &len);
+        if (ret == MC_SEARCH_CB_OK && len == 0)
+            ret = MC_SEARCH_CB_NOTFOUND;
+        if (ret != MC_SEARCH_CB_OK)
+            break;
+
+        if (end_search - pos < len)
+            len = end_search - pos + 1;
+
+        if (line->len != 0)
+        {
+            /* finish the line started in previous blocks */
+            eol = (const char *) memchr (block, '\n', len);
+            done = eol == NULL ? len : (gsize) (eol - block) + 1;
+            g_string_append_len (line, block, done);
+
+            if (eol != NULL || pos + done > end_search)
+            {
+                found = mc_search__normal_literal_found (lc_mc_search, line->str, line->len,
+                                                         line_start, found_len);
+                g_string_set_size (line, 0);
+            }
+            else if (line->len >= MC_SEARCH_LINE_MAX)
+            {
+                gsize keep;
+
+                /* don't collect the whole binary file without line breaks: search the part
+                   of line, its end is searched again with the next part */
+                found = mc_search__normal_literal_found (lc_mc_search, line->str, line->len,
+                                                         line_start, found_len);
+                keep = MIN (overlap, line->len);
+                line_start += line->len - keep;
+                g_string_erase (line, 0, line->len - keep);
+            }
+        }
+
+        if (!found)
+        {
+            /* search up to the last line break in place: the pattern doesn't contain '\n' */
+            if (pos + len > end_search)
+                whole = len;
+            else
+                for (whole = len; whole > done && block[whole - 1] != '\n'; whole--)
+                    ;
+
+            if (whole > done)
+                found = mc_search__normal_literal_found (lc_mc_search, block + done, whole - done,
+                                                         pos + done, found_len);
+
+            if (!found && whole < len)
+            {
+                line_start = pos + whole;
+                g_string_append_len (line, block + whole, len - whole);
+            }
+
+            pos += len;
+
+            if (!found && lc_mc_search->update_fn != NULL
+                && lc_mc_search->update_fn (user_data, pos) == MC_SEARCH_CB_ABORT)
+                ret = MC_SEARCH_CB_ABORT;
+            if (ret == MC_SEARCH_CB_ABORT)
+                break;
+        }
+    }
+
+    if (!found && ret != MC_SEARCH_CB_ABORT && line->len != 0)
+        found = mc_search__normal_literal_found (lc_mc_search, line->str, line->len, line_start,
+                                                 found_len);
+
+    g_string_free (line, TRUE);
+
+    if (found)
+        return TRUE;
+
+    MC_PTR_FREE (lc_mc_search->error_str);
+    lc_mc_search->error = ret == MC_SEARCH_CB_ABORT ? MC_SEARCH_E_ABORT : MC_SEARCH_E_NOTFOUND;
+
+    return FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static GString *
 mc_search__normal_translate_to_regex (const GString * astr)
 {
@@ -86,8 +494,22 @@ void
 mc_search__cond_struct_new_init_normal (const char *charset, mc_search_t * lc_mc_search,
                                         mc_search_cond_t * mc_search_cond)
 {
+    const gboolean utf8 = str_isutf8 (charset) && mc_global.utf8_display;
+    const mc_search_chartable_t *table;
     GString *tmp;
 
+    table = mc_search__chartable_get (charset);
+
+    if (mc_search__normal_is_literal (lc_mc_search, mc_search_cond->str, table))
+    {
+        mc_search_cond->literal =
+            mc_search__literal_new (mc_search_cond->str, lc_mc_search->is_case_sensitive,
+                                    lc_mc_search->whole_words && !lc_mc_search->is_entire_line,
+                                    utf8, table);
+        lc_mc_search->is_utf8 = str_isutf8 (charset);
+        return;
+    }
+
     tmp = mc_search__normal_translate_to_regex (mc_search_cond->str);
     g_string_free (mc_search_cond->str, TRUE);
 
@@ -101,9 +523,82 @@ gboolean
 mc_search__run_normal (mc_search_t * lc_mc_search, const void *user_data,
                        gsize start_search, gsize end_search, gsize * found_len)
 {
+    if (mc_search__normal_all_literal (lc_mc_search))
+    {
+        if (lc_mc_search->block_fn != NULL)
+            return mc_search__run_literal_blocks (lc_mc_search, user_data, start_search,
+                                                  end_search, found_len);
+
+        /* data got by callback is collected line by line and searched there */
+        if (lc_mc_search->search_fn == NULL)
+            return mc_search__run_literal (lc_mc_search, (const char *) user_data, start_search,
+                                           end_search, found_len);
+    }
+
     return mc_search__run_regex (lc_mc_search, user_data, start_search, end_search, found_len);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find fixed string in the text.
+ *
+ * @param literal prepared matcher
+ * @param text text, can contain '\0'
+ * @param len length of text
+ * @param start offset of the match in the text
+ * @param end offset of the first byte after the match
+ *
+ * @return TRUE if the string is found
+ */
+
+gboolean
+mc_search__literal_find (const mc_search_literal_t * literal, const char *text, gsize len,
+                         gsize * start, gsize * end)
+{
+    const char *pos = text;
+    const char *text_end = text + len;
+    const gsize m = literal->pattern->len;
+
+    while (TRUE)
+    {
+        const char *found;
+        gsize offset;
+
+        if (literal->case_sensitive)
+            found = mc_search__literal_find_cs (literal, pos, text_end);
+        else
+            found = mc_search__literal_find_ci (literal, pos, text_end);
+
+        if (found == NULL)
+            return FALSE;
+
+        offset = (gsize) (found - text);
+
+        if (!literal->whole_words
+            || (!mc_search__literal_word_at (literal, text, len, offset, TRUE)
+                && !mc_search__literal_word_at (literal, text, len, offset + m, FALSE)))
+        {
+            *start = offset;
+            *end = offset + m;
+            return TRUE;
+        }
+
+        pos = found + 1;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+mc_search__literal_free (mc_search_literal_t * literal)
+{
+    if (literal != NULL)
+    {
+        g_string_free (literal->pattern, TRUE);
+        g_free (literal);
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 GString *
 mc_search_normal_prepare_replace_str (mc_search_t * lc_mc_search, GString * replace_str)
@@ -29,6 +29,7 @@
 #include <config.h>
 
 #include <stdlib.h>
+#include <string.h>             /* memchr() */
 
 #include "lib/global.h"
 #include "lib/strutil.h"
@@ -152,13 +153,101 @@ mc_search__cond_struct_new_regex_hex_add (const char *charset, GString * str_to,
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Append string where every letter is replaced by all its cases using tables of charset,
+ * e.g. "[\xC0\xE0]" for charset of single byte characters or "(?:\xD0\x96|\xD0\xB6)" for UTF-8.
+ */
+
+static void
+mc_search__cond_struct_new_regex_table_append (const mc_search_chartable_t * table,
+                                               GString * str_to, const GString * str_from)
+{
+    gsize loop = 0;
+
+    while (loop < str_from->len)
+    {
+        gunichar c, cases[3];
+        gsize char_len = 1;
+        int n = 1, i;
+
+        c = (unsigned char) str_from->str[loop];
+
+        if (table->utf8)
+        {
+            c = g_utf8_get_char_validated (str_from->str + loop,
+                                           (gssize) (str_from->len - loop));
+            if (c == (gunichar) (-1) || c == (gunichar) (-2))
+                c = 0xFFFD;     /* invalid byte is copied as is */
+            else
+                char_len = g_unichar_to_utf8 (c, NULL);
+        }
+
+        if (c == 0)
+        {
+            loop++;
+            continue;
+        }
+
+        cases[0] = c;
+        if ((mc_search__chartable_flags (table, c) & MC_SEARCH_CHAR_ALPHA) != 0)
+        {
+            cases[n] = mc_search__chartable_upper (table, c);
+            if (cases[n] != c)
+                n++;
+            cases[n] = mc_search__chartable_lower (table, c);
+            if (cases[n] != c && cases[n] != cases[1])
+                n++;
+        }
+
+        if (n == 1)
+            g_string_append_len (str_to, str_from->str + loop, char_len);
+        else if (!table->utf8)
+        {
+            g_string_append_c (str_to, '[');
+            for (i = 0; i < n; i++)
+                g_string_append_printf (str_to, "\\x%02X", (unsigned int) cases[i]);
+            g_string_append_c (str_to, ']');
+        }
+        else
+        {
+            g_string_append (str_to, "(?:");
+            for (i = 0; i < n; i++)
+            {
+                gchar utf8[6];
+                int len, j;
+
+                if (i != 0)
+                    g_string_append_c (str_to, '|');
+                len = g_unichar_to_utf8 (cases[i], utf8);
+                for (j = 0; j < len; j++)
+                    g_string_append_printf (str_to, "\\x%02X", (unsigned char) utf8[j]);
+            }
+            g_string_append_c (str_to, ')');
+        }
+
+        loop += char_len;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static void
 mc_search__cond_struct_new_regex_accum_append (const char *charset, GString * str_to,
                                                GString * str_from)
 {
+    const mc_search_chartable_t *table;
     GString *recoded_part;
     gsize loop = 0;
 
+    table = mc_search__chartable_get (charset);
+    if (table != NULL)
+    {
+        mc_search__cond_struct_new_regex_table_append (table, str_to, str_from);
+        g_string_set_size (str_from, 0);
+        return;
+    }
+
+    /* multibyte charset: symbols are recoded one by one */
     recoded_part = g_string_sized_new (32);
 
     while (loop < str_from->len)
@@ -320,13 +409,13 @@ mc_search__g_regex_match_full_safe (const GRegex * regex,
 
 static mc_search__found_cond_t
 mc_search__regex_found_cond_one (mc_search_t * lc_mc_search, mc_search_regex_t * regex,
-                                 GString * search_str)
+                                 GString * search_str, gsize start_offset)
 {
 #ifdef SEARCH_TYPE_GLIB
     GError *mcerror = NULL;
 
     if (!mc_search__g_regex_match_full_safe
-        (regex, search_str->str, search_str->len, 0, G_REGEX_MATCH_NEWLINE_ANY,
+        (regex, search_str->str, search_str->len, (gint) start_offset, G_REGEX_MATCH_NEWLINE_ANY,
          &lc_mc_search->regex_match_info, &mcerror))
     {
         g_match_info_free (lc_mc_search->regex_match_info);
@@ -343,9 +432,23 @@ mc_search__regex_found_cond_one (mc_search_t * lc_mc_search, mc_search_regex_t *
         return COND__NOT_FOUND;
     }
     lc_mc_search->num_results = g_match_info_get_match_count (lc_mc_search->regex_match_info);
-#else /* SEARCH_TYPE_GLIB */
+#elif defined (SEARCH_TYPE_PCRE2)
+    /* match data is reused by all searches of this object */
+    if (lc_mc_search->regex_match_info == NULL)
+        lc_mc_search->regex_match_info =
+            pcre2_match_data_create (MC_SEARCH__NUM_REPLACE_ARGS, NULL);
+
+    lc_mc_search->num_results =
+        pcre2_match (regex, (PCRE2_SPTR) search_str->str, search_str->len, start_offset, 0,
+                     lc_mc_search->regex_match_info, NULL);
+    if (lc_mc_search->num_results < 0)
+        return COND__NOT_FOUND;
+    /* ovector is too small to keep all groups */
+    if (lc_mc_search->num_results == 0)
+        lc_mc_search->num_results = MC_SEARCH__NUM_REPLACE_ARGS;
+#else /* SEARCH_TYPE_PCRE */
     lc_mc_search->num_results = pcre_exec (regex, lc_mc_search->regex_match_info,
-                                           search_str->str, search_str->len, 0, 0,
+                                           search_str->str, search_str->len, (int) start_offset, 0,
                                            lc_mc_search->iovector, MC_SEARCH__NUM_REPLACE_ARGS);
     if (lc_mc_search->num_results < 0)
     {
@@ -357,9 +460,14 @@ mc_search__regex_found_cond_one (mc_search_t * lc_mc_search, mc_search_regex_t *
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Match conditions against search_str from start_offset. Text before start_offset is
+ * the context of match only: it is seen by "^" and lookbehind assertions.
+ */
 
 static mc_search__found_cond_t
-mc_search__regex_found_cond (mc_search_t * lc_mc_search, GString * search_str)
+mc_search__regex_found_cond (mc_search_t * lc_mc_search, GString * search_str, gsize start_offset,
+                             gint * start_pos, gint * end_pos)
 {
     gsize loop1;
 
@@ -370,12 +478,41 @@ mc_search__regex_found_cond (mc_search_t * lc_mc_search, GString * search_str)
 
         mc_search_cond = (mc_search_cond_t *) g_ptr_array_index (lc_mc_search->conditions, loop1);
 
+        /* fixed string of normal search */
+        if (mc_search_cond->literal != NULL)
+        {
+            gsize start, end;
+
+            if (!mc_search__literal_find (mc_search_cond->literal, search_str->str + start_offset,
+                                          search_str->len - start_offset, &start, &end))
+                continue;
+
+            *start_pos = (gint) (start_offset + start);
+            *end_pos = (gint) (start_offset + end);
+            return COND__FOUND_OK;
+        }
+
         if (!mc_search_cond->regex_handle)
             continue;
 
         ret =
             mc_search__regex_found_cond_one (lc_mc_search, mc_search_cond->regex_handle,
-                                             search_str);
+                                             search_str, start_offset);
+        if (ret == COND__FOUND_OK)
+        {
+#ifdef SEARCH_TYPE_GLIB
+            g_match_info_fetch_pos (lc_mc_search->regex_match_info, 0, start_pos, end_pos);
+#elif defined (SEARCH_TYPE_PCRE2)
+            PCRE2_SIZE *ovector;
+
+            ovector = pcre2_get_ovector_pointer (lc_mc_search->regex_match_info);
+            *start_pos = (gint) ovector[0];
+            *end_pos = (gint) ovector[1];
+#else /* SEARCH_TYPE_PCRE */
+            *start_pos = lc_mc_search->iovector[0];
+            *end_pos = lc_mc_search->iovector[1];
+#endif /* SEARCH_TYPE_GLIB */
+        }
         if (ret != COND__NOT_FOUND)
             return ret;
     }
@@ -435,7 +572,13 @@ mc_search_regex__get_token_by_num (const mc_search_t * lc_mc_search, gsize lc_in
 
 #ifdef SEARCH_TYPE_GLIB
     g_match_info_fetch_pos (lc_mc_search->regex_match_info, lc_index, &fnd_start, &fnd_end);
-#else /* SEARCH_TYPE_GLIB */
+#elif defined (SEARCH_TYPE_PCRE2)
+    PCRE2_SIZE *ovector;
+
+    ovector = pcre2_get_ovector_pointer (lc_mc_search->regex_match_info);
+    fnd_start = (int) ovector[lc_index * 2 + 0];
+    fnd_end = (int) ovector[lc_index * 2 + 1];
+#else /* SEARCH_TYPE_PCRE */
     fnd_start = lc_mc_search->iovector[lc_index * 2 + 0];
     fnd_end = lc_mc_search->iovector[lc_index * 2 + 1];
 #endif /* SEARCH_TYPE_GLIB */
@@ -781,6 +924,54 @@ mc_search_regex__process_escape_sequence (GString * dest_str, const char *from,
     }
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Append the line started at pos to the regex buffer using blocks of data got from block_fn.
+ *
+ * @param lc_mc_search search object
+ * @param user_data data for block_fn
+ * @param pos offset of line start, it is moved to the start of next line
+ * @param end_search offset of last byte to search
+ *
+ * @return MC_SEARCH_CB_OK if line is got, MC_SEARCH_CB_NOTFOUND at end of data,
+ *         MC_SEARCH_CB_ABORT if search is aborted
+ */
+
+static mc_search_cbret_t
+mc_search__regex_get_line_by_blocks (mc_search_t * lc_mc_search, const void *user_data,
+                                     gsize * pos, gsize end_search)
+{
+    while (*pos <= end_search)
+    {
+        const char *block;
+        const char *eol;
+        gsize len = 0;
+        mc_search_cbret_t ret;
+
+        ret = lc_mc_search->block_fn (user_data, *pos, &block, &len);
+        if (ret != MC_SEARCH_CB_OK)
+            return ret;
+        if (len == 0)
+            return MC_SEARCH_CB_NOTFOUND;
+
+        if (end_search - *pos < len)
+            len = end_search - *pos + 1;
+
+        eol = (const char *) memchr (block, '\n', len);
+        if (eol != NULL)
+            len = (gsize) (eol - block) + 1;
+
+        /* the line is collected whole: a match of regex can be of any length */
+        g_string_append_len (lc_mc_search->regex_buffer, block, len);
+        *pos += len;
+
+        if (eol != NULL)
+            break;
+    }
+
+    return MC_SEARCH_CB_OK;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -791,11 +982,33 @@ mc_search__cond_struct_new_init_regex (const char *charset, mc_search_t * lc_mc_
 {
     if (lc_mc_search->whole_words && !lc_mc_search->is_entire_line)
     {
-        /* NOTE: \b as word boundary doesn't allow search
-         * whole words with non-ASCII symbols.
-         * Update: Is it still true nowadays? Probably not. #2396, #3524 */
-        g_string_prepend (mc_search_cond->str, "(?<![\\p{L}\\p{N}_])");
-        g_string_append (mc_search_cond->str, "(?![\\p{L}\\p{N}_])");
+        const mc_search_chartable_t *table = NULL;
+
+        /* without UTF-8 regex takes bytes as Latin-1 characters */
+        if (!(str_isutf8 (charset) && mc_global.utf8_display))
+            table = mc_search__chartable_get (charset);
+
+        if (table != NULL && !table->utf8)
+        {
+            GString *word;
+
+            word = mc_search__chartable_word_class (table);
+            g_string_prepend (mc_search_cond->str, ")");
+            g_string_prepend_len (mc_search_cond->str, word->str, word->len);
+            g_string_prepend (mc_search_cond->str, "(?<!");
+            g_string_append (mc_search_cond->str, "(?!");
+            g_string_append_len (mc_search_cond->str, word->str, word->len);
+            g_string_append (mc_search_cond->str, ")");
+            g_string_free (word, TRUE);
+        }
+        else
+        {
+            /* NOTE: \b as word boundary doesn't allow search
+             * whole words with non-ASCII symbols.
+             * Update: Is it still true nowadays? Probably not. #2396, #3524 */
+            g_string_prepend (mc_search_cond->str, "(?<![\\p{L}\\p{N}_])");
+            g_string_append (mc_search_cond->str, "(?![\\p{L}\\p{N}_])");
+        }
     }
 
     {
@@ -835,7 +1048,48 @@ mc_search__cond_struct_new_init_regex (const char *charset, mc_search_t * lc_mc_
             g_error_free (mcerror);
             return;
         }
-#else /* SEARCH_TYPE_GLIB */
+#elif defined (SEARCH_TYPE_PCRE2)
+        int errcode;
+        PCRE2_SIZE erroffset;
+        uint32_t pcre2_options = PCRE2_MULTILINE;
+
+        if (str_isutf8 (charset) && mc_global.utf8_display)
+        {
+            pcre2_options |= PCRE2_UTF;
+#ifdef PCRE2_MATCH_INVALID_UTF
+            /* search in files with broken UTF-8 instead of failing */
+            pcre2_options |= PCRE2_MATCH_INVALID_UTF;
+#endif
+            if (!lc_mc_search->is_case_sensitive)
+                pcre2_options |= PCRE2_CASELESS;
+        }
+        else
+        {
+            if (!lc_mc_search->is_case_sensitive)
+            {
+                GString *tmp;
+
+                tmp = mc_search_cond->str;
+                mc_search_cond->str = mc_search__cond_struct_new_regex_ci_str (charset, tmp);
+                g_string_free (tmp, TRUE);
+            }
+        }
+
+        mc_search_cond->regex_handle =
+            pcre2_compile ((PCRE2_SPTR) mc_search_cond->str->str, mc_search_cond->str->len,
+                           pcre2_options, &errcode, &erroffset, NULL);
+        if (mc_search_cond->regex_handle == NULL)
+        {
+            PCRE2_UCHAR error[256];
+
+            pcre2_get_error_message (errcode, error, sizeof (error));
+            mc_search_set_error (lc_mc_search, MC_SEARCH_E_REGEX_COMPILE, "%s", (char *) error);
+            return;
+        }
+
+        /* not fatal: without JIT (or if it is not built in PCRE2) the interpreter is used */
+        pcre2_jit_compile (mc_search_cond->regex_handle, PCRE2_JIT_COMPLETE);
+#else /* SEARCH_TYPE_PCRE */
         const char *error;
         int erroffset;
         int pcre_options = PCRE_EXTRA | PCRE_MULTILINE;
@@ -886,6 +1140,7 @@ mc_search__run_regex (mc_search_t * lc_mc_search, const void *user_data,
 {
     mc_search_cbret_t ret = MC_SEARCH_CB_NOTFOUND;
     gsize current_pos, virtual_pos;
+    gsize start_offset = 0;
     gint start_pos;
     gint end_pos;
 
@@ -900,7 +1155,17 @@ mc_search__run_regex (mc_search_t * lc_mc_search, const void *user_data,
         g_string_set_size (lc_mc_search->regex_buffer, 0);
         lc_mc_search->start_buffer = current_pos;
 
-        if (lc_mc_search->search_fn != NULL)
+        if (lc_mc_search->block_fn != NULL)
+        {
+            ret = mc_search__regex_get_line_by_blocks (lc_mc_search, user_data, &current_pos,
+                                                       end_search);
+            virtual_pos = current_pos;
+
+            if (ret == MC_SEARCH_CB_ABORT
+                || (ret == MC_SEARCH_CB_NOTFOUND && lc_mc_search->regex_buffer->len == 0))
+                break;
+        }
+        else if (lc_mc_search->search_fn != NULL)
         {
             while (TRUE)
             {
@@ -929,13 +1194,27 @@ mc_search__run_regex (mc_search_t * lc_mc_search, const void *user_data,
         }
         else
         {
+            const char *text = (const char *) user_data;
+
+            /* search started in the middle of line: "^" and lookbehind should see
+             * the beginning of line, but matches are looked for from start_search only */
+            if (virtual_pos == start_search)
+            {
+                while (virtual_pos != 0 && text[virtual_pos - 1] != '\n')
+                    virtual_pos--;
+                start_offset = start_search - virtual_pos;
+                lc_mc_search->start_buffer = virtual_pos;
+            }
+            else
+                start_offset = 0;
+
             /* optimization for standard case (for search from file manager)
              *  where there is no MC_SEARCH_CB_INVALID or MC_SEARCH_CB_SKIP
              *  return codes, so we can copy line at regex buffer all at once
              */
             while (TRUE)
             {
-                const char current_chr = ((const char *) user_data)[current_pos];
+                const char current_chr = text[current_pos];
 
                 if (current_chr == '\0')
                     break;
@@ -947,20 +1226,15 @@ mc_search__run_regex (mc_search_t * lc_mc_search, const void *user_data,
             }
 
             /* use virtual_pos as index of start of current chunk */
-            g_string_append_len (lc_mc_search->regex_buffer, (const char *) user_data + virtual_pos,
+            g_string_append_len (lc_mc_search->regex_buffer, text + virtual_pos,
                                  current_pos - virtual_pos);
             virtual_pos = current_pos;
         }
 
-        switch (mc_search__regex_found_cond (lc_mc_search, lc_mc_search->regex_buffer))
+        switch (mc_search__regex_found_cond (lc_mc_search, lc_mc_search->regex_buffer,
+                                             start_offset, &start_pos, &end_pos))
         {
         case COND__FOUND_OK:
-#ifdef SEARCH_TYPE_GLIB
-            g_match_info_fetch_pos (lc_mc_search->regex_match_info, 0, &start_pos, &end_pos);
-#else /* SEARCH_TYPE_GLIB */
-            start_pos = lc_mc_search->iovector[0];
-            end_pos = lc_mc_search->iovector[1];
-#endif /* SEARCH_TYPE_GLIB */
             if (found_len != NULL)
                 *found_len = end_pos - start_pos;
             lc_mc_search->normal_offset = lc_mc_search->start_buffer + start_pos;
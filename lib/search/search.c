@@ -45,8 +45,19 @@
 
 /*** file scope macro definitions ****************************************************************/
 
+/* max number of prepared conditions kept for reuse */
+#define MC_SEARCH_CACHE_SIZE 64
+
 /*** file scope type declarations ****************************************************************/
 
+/* prepared conditions shared by all searches with the same pattern and options */
+typedef struct
+{
+    GString *key;
+    GPtrArray *conditions;
+    gboolean is_utf8;
+} mc_search_cache_entry_t;
+
 /*** file scope variables ************************************************************************/
 
 static const mc_search_type_str_t mc_search__list_types[] = {
@@ -57,6 +68,14 @@ static const mc_search_type_str_t mc_search__list_types[] = {
     {NULL, MC_SEARCH_T_INVALID}
 };
 
+#ifdef MC_SEARCH_CACHE
+/* Conditions are not changed by search, so they are shared between searches and threads.
+ * The most recently used entry is in the head of queue. */
+G_LOCK_DEFINE_STATIC (mc_search_cache);
+static GHashTable *mc_search_cache = NULL;      /* key -> link in mc_search_cache_lru */
+static GQueue mc_search_cache_lru = G_QUEUE_INIT;
+#endif /* MC_SEARCH_CACHE */
+
 /*** file scope functions ************************************************************************/
 
 static mc_search_cond_t *
@@ -106,10 +125,14 @@ mc_search__cond_struct_free (mc_search_cond_t * mc_search_cond)
 #ifdef SEARCH_TYPE_GLIB
     if (mc_search_cond->regex_handle)
         g_regex_unref (mc_search_cond->regex_handle);
-#else /* SEARCH_TYPE_GLIB */
+#elif defined (SEARCH_TYPE_PCRE2)
+    pcre2_code_free (mc_search_cond->regex_handle);
+#else /* SEARCH_TYPE_PCRE */
     g_free (mc_search_cond->regex_handle);
 #endif /* SEARCH_TYPE_GLIB */
 
+    mc_search__literal_free (mc_search_cond->literal);
+
     g_free (mc_search_cond);
 }
 
@@ -118,10 +141,128 @@ mc_search__cond_struct_free (mc_search_cond_t * mc_search_cond)
 static void
 mc_search__conditions_free (GPtrArray * array)
 {
-    g_ptr_array_foreach (array, (GFunc) mc_search__cond_struct_free, NULL);
-    g_ptr_array_free (array, TRUE);
+    g_ptr_array_unref (array);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef MC_SEARCH_CACHE
+/* everything that changes the prepared conditions */
+static GString *
+mc_search__cache_key (const mc_search_t * lc_mc_search)
+{
+    GString *key;
+    int flags = 0;
+    const char *charset;
+
+    if (lc_mc_search->is_case_sensitive)
+        flags |= 1;
+    if (lc_mc_search->whole_words)
+        flags |= 2;
+    if (lc_mc_search->is_entire_line)
+        flags |= 4;
+    if (mc_global.utf8_display)
+        flags |= 8;
+#ifdef HAVE_CHARSET
+    if (lc_mc_search->is_all_charsets)
+        flags |= 16;
+    charset = lc_mc_search->original_charset;
+#else
+    charset = str_detect_termencoding ();
+#endif
+
+    key = g_string_sized_new (lc_mc_search->original_len + 32);
+    g_string_printf (key, "%d:%d:%s:", (int) lc_mc_search->search_type, flags, charset);
+    g_string_append_len (key, lc_mc_search->original, lc_mc_search->original_len);
+
+    return key;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+mc_search__cache_entry_free (mc_search_cache_entry_t * entry)
+{
+    g_string_free (entry->key, TRUE);
+    mc_search__conditions_free (entry->conditions);
+    g_free (entry);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Take prepared conditions from cache.
+ *
+ * @return TRUE if conditions are found and set to @lc_mc_search
+ */
+
+static gboolean
+mc_search__cache_lookup (mc_search_t * lc_mc_search, const GString * key)
+{
+    GList *link = NULL;
+
+    G_LOCK (mc_search_cache);
+
+    if (mc_search_cache != NULL)
+        link = (GList *) g_hash_table_lookup (mc_search_cache, key);
+
+    if (link != NULL)
+    {
+        mc_search_cache_entry_t *entry = (mc_search_cache_entry_t *) link->data;
+
+        g_queue_unlink (&mc_search_cache_lru, link);
+        g_queue_push_head_link (&mc_search_cache_lru, link);
+
+        lc_mc_search->conditions = g_ptr_array_ref (entry->conditions);
+        lc_mc_search->is_utf8 = entry->is_utf8;
+    }
+
+    G_UNLOCK (mc_search_cache);
+
+    return (link != NULL);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Put successfully prepared conditions to cache. Takes ownership of @key.
+ */
+
+static void
+mc_search__cache_add (const mc_search_t * lc_mc_search, GString * key)
+{
+    mc_search_cache_entry_t *entry;
+
+    G_LOCK (mc_search_cache);
+
+    if (mc_search_cache == NULL)
+        mc_search_cache = g_hash_table_new ((GHashFunc) g_string_hash, (GEqualFunc) g_string_equal);
+
+    if (g_hash_table_lookup (mc_search_cache, key) != NULL)
+    {
+        /* added by another thread in the meantime */
+        G_UNLOCK (mc_search_cache);
+        g_string_free (key, TRUE);
+        return;
+    }
+
+    entry = g_new (mc_search_cache_entry_t, 1);
+    entry->key = key;
+    entry->conditions = g_ptr_array_ref (lc_mc_search->conditions);
+    entry->is_utf8 = lc_mc_search->is_utf8;
+
+    g_queue_push_head (&mc_search_cache_lru, entry);
+    g_hash_table_insert (mc_search_cache, entry->key, mc_search_cache_lru.head);
+
+    while (mc_search_cache_lru.length > MC_SEARCH_CACHE_SIZE)
+    {
+        entry = (mc_search_cache_entry_t *) g_queue_pop_tail (&mc_search_cache_lru);
+        g_hash_table_remove (mc_search_cache, entry->key);
+        mc_search__cache_entry_free (entry);
+    }
+
+    G_UNLOCK (mc_search_cache);
+}
+#endif /* MC_SEARCH_CACHE */
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -194,7 +335,9 @@ mc_search_free (mc_search_t * lc_mc_search)
 #ifdef SEARCH_TYPE_GLIB
     if (lc_mc_search->regex_match_info != NULL)
         g_match_info_free (lc_mc_search->regex_match_info);
-#else /* SEARCH_TYPE_GLIB */
+#elif defined (SEARCH_TYPE_PCRE2)
+    pcre2_match_data_free (lc_mc_search->regex_match_info);
+#else /* SEARCH_TYPE_PCRE */
     g_free (lc_mc_search->regex_match_info);
 #endif /* SEARCH_TYPE_GLIB */
 
@@ -210,8 +353,18 @@ gboolean
 mc_search_prepare (mc_search_t * lc_mc_search)
 {
     GPtrArray *ret;
+#ifdef MC_SEARCH_CACHE
+    GString *key;
 
-    ret = g_ptr_array_new ();
+    key = mc_search__cache_key (lc_mc_search);
+    if (mc_search__cache_lookup (lc_mc_search, key))
+    {
+        g_string_free (key, TRUE);
+        return TRUE;
+    }
+#endif /* MC_SEARCH_CACHE */
+
+    ret = g_ptr_array_new_with_free_func ((GDestroyNotify) mc_search__cond_struct_free);
 #ifdef HAVE_CHARSET
     if (lc_mc_search->is_all_charsets)
     {
@@ -258,9 +411,42 @@ mc_search_prepare (mc_search_t * lc_mc_search)
 #endif
     lc_mc_search->conditions = ret;
 
+#ifdef MC_SEARCH_CACHE
+    if (lc_mc_search->error == MC_SEARCH_E_OK)
+        mc_search__cache_add (lc_mc_search, key);
+    else
+        g_string_free (key, TRUE);
+#endif /* MC_SEARCH_CACHE */
+
     return (lc_mc_search->error == MC_SEARCH_E_OK);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Free prepared conditions kept for reuse and tables of charsets.
+ */
+
+void
+mc_search_cache_done (void)
+{
+    mc_search__chartable_done ();
+
+#ifdef MC_SEARCH_CACHE
+    G_LOCK (mc_search_cache);
+
+    g_queue_foreach (&mc_search_cache_lru, (GFunc) mc_search__cache_entry_free, NULL);
+    g_queue_clear (&mc_search_cache_lru);
+
+    if (mc_search_cache != NULL)
+    {
+        g_hash_table_destroy (mc_search_cache);
+        mc_search_cache = NULL;
+    }
+
+    G_UNLOCK (mc_search_cache);
+#endif /* MC_SEARCH_CACHE */
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 /**
@@ -470,7 +656,9 @@ mc_search_getstart_result_by_num (mc_search_t * lc_mc_search, int lc_index)
         g_match_info_fetch_pos (lc_mc_search->regex_match_info, lc_index, &start_pos, &end_pos);
         return (int) start_pos;
     }
-#else /* SEARCH_TYPE_GLIB */
+#elif defined (SEARCH_TYPE_PCRE2)
+    return (int) pcre2_get_ovector_pointer (lc_mc_search->regex_match_info)[lc_index * 2];
+#else /* SEARCH_TYPE_PCRE */
     return lc_mc_search->iovector[lc_index * 2];
 #endif /* SEARCH_TYPE_GLIB */
 }
@@ -492,7 +680,9 @@ mc_search_getend_result_by_num (mc_search_t * lc_mc_search, int lc_index)
         g_match_info_fetch_pos (lc_mc_search->regex_match_info, lc_index, &start_pos, &end_pos);
         return (int) end_pos;
     }
-#else /* SEARCH_TYPE_GLIB */
+#elif defined (SEARCH_TYPE_PCRE2)
+    return (int) pcre2_get_ovector_pointer (lc_mc_search->regex_match_info)[lc_index * 2 + 1];
+#else /* SEARCH_TYPE_PCRE */
     return lc_mc_search->iovector[lc_index * 2 + 1];
 #endif /* SEARCH_TYPE_GLIB */
 }
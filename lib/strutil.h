@@ -151,6 +151,7 @@ struct str_class
       /*I*/ char *(*create_key_for_filename) (const char *text, gboolean case_sen);
       /*I*/ int (*key_collate) (const char *t1, const char *t2, gboolean case_sen);
       /*I*/ void (*release_key) (char *key, gboolean case_sen);
+      /*I*/ gboolean (*key_is_binary) (gboolean case_sen);
     /* *INDENT-ON* */
 };
 
@@ -529,6 +530,12 @@ int str_key_collate (const char *t1, const char *t2, gboolean case_sen);
  */
 void str_release_key (char *key, gboolean case_sen);
 
+/* return TRUE if str_key_collate is strcmp for keys created with case_sen,
+ * so keys can be compared byte by byte (e.g. by prefixes)
+ * I
+ */
+gboolean str_key_is_binary (gboolean case_sen);
+
 /* return TRUE if codeset_name is utf8 or utf-8
  * I
  */
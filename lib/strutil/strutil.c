@@ -920,6 +920,14 @@ str_release_key (char *key, gboolean case_sen)
 
 /* --------------------------------------------------------------------------------------------- */
 
+gboolean
+str_key_is_binary (gboolean case_sen)
+{
+    return used_class.key_is_binary (case_sen);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 void
 str_msg_term_size (const char *text, int *lines, int *columns)
 {
@@ -797,6 +797,14 @@ str_8bit_release_key (char *key, gboolean case_sen)
         g_free (key);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+str_8bit_key_is_binary (gboolean case_sen)
+{
+    return case_sen;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -853,6 +861,7 @@ str_8bit_init (void)
     result.create_key_for_filename = str_8bit_create_key;
     result.key_collate = str_8bit_key_collate;
     result.release_key = str_8bit_release_key;
+    result.key_is_binary = str_8bit_key_is_binary;
 
     return result;
 }
@@ -1449,6 +1449,15 @@ str_utf8_release_key (char *key, gboolean case_sen)
     g_free (key);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+str_utf8_key_is_binary (gboolean case_sen)
+{
+    (void) case_sen;
+    return TRUE;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -1511,6 +1520,7 @@ str_utf8_init (void)
 #endif
     result.key_collate = str_utf8_key_collate;
     result.release_key = str_utf8_release_key;
+    result.key_is_binary = str_utf8_key_is_binary;
 
     return result;
 }
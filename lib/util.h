@@ -108,6 +108,10 @@ typedef struct
     char *sort_key;
     /* key used for comparing extensions */
     char *second_sort_key;
+    /* color got from file highlighting rules */
+    int fhl_color;
+    /* generation of rules fhl_color is got from, 0 if not got yet */
+    unsigned int fhl_generation;
 
     /* Flags */
     struct
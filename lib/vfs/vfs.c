@@ -43,7 +43,13 @@
 #include <config.h>
 
 #include <errno.h>
+#include <inttypes.h>           /* uintmax_t */
+#include <signal.h>
 #include <stdlib.h>
+#include <unistd.h>
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 #ifdef __linux__
 #ifdef HAVE_LINUX_FS_H
@@ -52,6 +58,9 @@
 #ifdef HAVE_SYS_IOCTL_H
 #include <sys/ioctl.h>
 #endif /* HAVE_SYS_IOCTL_H */
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>
+#endif /* HAVE_SYS_SENDFILE_H */
 #endif /* __linux__ */
 
 #include "lib/global.h"
@@ -84,6 +93,23 @@ vfs_class *current_vfs = NULL;
 
 #define VFS_FIRST_HANDLE 100
 
+#ifdef HAVE_MMAP
+#ifndef MAP_FILE
+#define MAP_FILE 0
+#endif
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+/* files are mapped only if lost pages of truncated files can be replaced in SIGBUS handler.
+   mmap() isn't async-signal-safe by POSIX, but on Linux it is a plain system call which
+   doesn't take any lock of C library, so it can be called in the handler there only */
+#if defined(MAP_ANONYMOUS) && defined(SA_SIGINFO) && defined(__linux__)
+#define VFS_MAP_GUARD 1
+/* max number of files mapped at once */
+#define VFS_MAP_SLOTS 256
+#endif
+#endif /* HAVE_MMAP */
+
 /*** file scope type declarations ****************************************************************/
 
 struct vfs_openfile
@@ -101,8 +127,112 @@ static vfs_path_t *current_path = NULL;
 static GPtrArray *vfs_openfiles = NULL;
 static long vfs_free_handle_list = -1;
 
+#ifdef VFS_MAP_GUARD
+/* mapped files looked up by SIGBUS handler, see vfs_map_sigbus() */
+static vfs_file_map_t *vfs_map_slots[VFS_MAP_SLOTS];
+static struct sigaction vfs_map_old_sigbus;
+static size_t vfs_map_page_size = 0;
+#endif
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef VFS_MAP_GUARD
+/**
+ * Mapped file was truncated by another process: access to its pages beyond the new end
+ * of file raises SIGBUS. The lost page is replaced with zero-filled one and the access is
+ * repeated, so readers of mapped files see zeros instead of being killed.
+ * SIGBUS of any other address is handled as before.
+ */
+
+static void
+vfs_map_sigbus (int sig, siginfo_t * info, void *context)
+{
+    const char *addr = (const char *) info->si_addr;
+    size_t i;
+
+    (void) sig;
+    (void) context;
+
+    for (i = 0; i < VFS_MAP_SLOTS; i++)
+    {
+        vfs_file_map_t *map;
+
+        map = (vfs_file_map_t *) g_atomic_pointer_get (&vfs_map_slots[i]);
+        if (map != NULL && addr >= map->data && addr < map->data + map->size)
+        {
+            void *page;
+
+            page = (void *) ((uintptr_t) addr & ~(uintptr_t) (vfs_map_page_size - 1));
+            if (mmap (page, vfs_map_page_size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED,
+                      -1, 0) == MAP_FAILED)
+                break;
+
+            map->truncated = TRUE;
+            return;
+        }
+    }
+
+    /* not ours: the access is repeated and fails with the previous handler */
+    sigaction (SIGBUS, &vfs_map_old_sigbus, NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gpointer
+vfs_map_install_guard (gpointer data)
+{
+    struct sigaction sa;
+
+    (void) data;
+
+    vfs_map_page_size = (size_t) sysconf (_SC_PAGESIZE);
+
+    memset (&sa, 0, sizeof (sa));
+    sa.sa_sigaction = vfs_map_sigbus;
+    sa.sa_flags = SA_SIGINFO;
+    sigemptyset (&sa.sa_mask);
+
+    return GINT_TO_POINTER (sigaction (SIGBUS, &sa, &vfs_map_old_sigbus) == 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Register mapped file for SIGBUS handler.
+ *
+ * @return TRUE on success, FALSE if handler can't be installed or too many files are mapped
+ */
+
+static gboolean
+vfs_map_guard (vfs_file_map_t * map)
+{
+    static GOnce guard_once = G_ONCE_INIT;
+    size_t i;
+
+    if (g_once (&guard_once, vfs_map_install_guard, NULL) == NULL)
+        return FALSE;
+
+    for (i = 0; i < VFS_MAP_SLOTS; i++)
+        if (g_atomic_pointer_compare_and_exchange (&vfs_map_slots[i], NULL, map))
+            return TRUE;
+
+    return FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+vfs_map_unguard (vfs_file_map_t * map)
+{
+    size_t i;
+
+    for (i = 0; i < VFS_MAP_SLOTS; i++)
+        if (g_atomic_pointer_compare_and_exchange (&vfs_map_slots[i], map, NULL))
+            break;
+}
+#endif /* VFS_MAP_GUARD */
+
 /* --------------------------------------------------------------------------------------------- */
 /* now used only by vfs_translate_path, but could be used in other vfs 
  * plugin to automatic detect encoding
@@ -715,3 +845,242 @@ vfs_clone_file (int dest_vfs_fd, int src_vfs_fd)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Get system file descriptor of file opened in local file system.
+ *
+ * @param vfs_fd mc VFS file handler
+ *
+ * @return file descriptor or -1 if file is not local
+ */
+
+int
+vfs_get_local_fd (int vfs_fd)
+{
+    void *fsinfo = NULL;
+    struct vfs_class *vclass;
+
+    vclass = vfs_class_find_by_handle (vfs_fd, &fsinfo);
+    if (vclass == NULL || (vclass->flags & VFSF_LOCAL) == 0 || fsinfo == NULL)
+        return (-1);
+
+    return *(int *) fsinfo;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Copy data between local files in the kernel, without user space buffers.
+ * Data is copied from the current position of source file to the current position
+ * of destination file, both positions are advanced.
+ *
+ * Methods are tried from the fastest one, @method keeps the method which works for
+ * this pair of files between calls. If no method works, @method is set to VFS_COPY_NONE
+ * and the caller should continue with read()/write(): it reports errors too.
+ *
+ * Unlike other functions here, it only works with system descriptors and can be called
+ * from worker threads.
+ *
+ * @param dest_fd system file descriptor of destination file
+ * @param src_fd system file descriptor of source file
+ * @param count maximum number of bytes to copy
+ * @param sparse if TRUE, holes of source file are not copied but skipped in both files.
+ *               Destination must not be opened with O_APPEND
+ * @param method copy method, should be VFS_COPY_RANGE before the first call
+ *
+ * @return number of bytes by which source position is advanced, 0 at the end of file,
+ *         -1 if data can't be copied this way.
+ */
+
+ssize_t
+vfs_copy_local_data (int dest_fd, int src_fd, size_t count, gboolean sparse,
+                     vfs_copy_method_t * method)
+{
+#if defined (HAVE_COPY_FILE_RANGE) || defined (HAVE_SENDFILE)
+    ssize_t n = -1;
+
+    if (*method == VFS_COPY_NONE)
+        return (-1);
+
+#ifdef SEEK_DATA
+    if (sparse)
+    {
+        off_t pos, data;
+
+        pos = lseek (src_fd, 0, SEEK_CUR);
+        data = pos < 0 ? -1 : lseek (src_fd, pos, SEEK_DATA);
+        if (data < 0 && errno == ENXIO)
+            data = lseek (src_fd, 0, SEEK_END); /* only a hole up to the end of file */
+
+        if (data > pos)
+        {
+            off_t skip, dst_pos;
+
+            /* skip the hole in both files */
+            skip = MIN (data - pos, (off_t) count);
+            dst_pos = lseek (dest_fd, skip, SEEK_CUR);
+            if (dst_pos >= 0 && ftruncate (dest_fd, dst_pos) == 0
+                && lseek (src_fd, pos + skip, SEEK_SET) == pos + skip)
+                return (ssize_t) skip;
+
+            if (dst_pos >= 0)
+                (void) lseek (dest_fd, -skip, SEEK_CUR);
+            (void) lseek (src_fd, pos, SEEK_SET);
+            *method = VFS_COPY_NONE;
+            return (-1);
+        }
+
+        if (data == pos)
+        {
+            off_t hole;
+
+            /* copy data up to the next hole */
+            hole = lseek (src_fd, pos, SEEK_HOLE);
+            if (hole > pos)
+                count = (size_t) MIN ((off_t) count, hole - pos);
+        }
+
+        /* SEEK_DATA or SEEK_HOLE move the position, SEEK_DATA can be unsupported */
+        if (pos >= 0)
+            (void) lseek (src_fd, pos, SEEK_SET);
+    }
+#else
+    (void) sparse;
+#endif /* SEEK_DATA */
+
+#ifdef HAVE_COPY_FILE_RANGE
+    if (*method == VFS_COPY_RANGE)
+    {
+        while ((n = copy_file_range (src_fd, NULL, dest_fd, NULL, count, 0)) < 0 && errno == EINTR)
+            ;
+
+        /* some file systems don't support it (EXDEV, EINVAL, ENOSYS) or
+           report 0 for special files which have data */
+        if (n <= 0)
+            *method = VFS_COPY_SENDFILE;
+    }
+#else
+    if (*method == VFS_COPY_RANGE)
+        *method = VFS_COPY_SENDFILE;
+#endif /* HAVE_COPY_FILE_RANGE */
+
+#ifdef HAVE_SENDFILE
+    if (n <= 0 && *method == VFS_COPY_SENDFILE)
+    {
+        while ((n = sendfile (dest_fd, src_fd, NULL, count)) < 0 && errno == EINTR)
+            ;
+
+        if (n < 0)
+            *method = VFS_COPY_NONE;
+    }
+#else
+    if (*method == VFS_COPY_SENDFILE)
+        *method = VFS_COPY_NONE;
+#endif /* HAVE_SENDFILE */
+
+    return n;
+#else
+    (void) dest_fd;
+    (void) src_fd;
+    (void) count;
+    (void) sparse;
+
+    *method = VFS_COPY_NONE;
+    return (-1);
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Copy data between files of mc VFS in the kernel, see vfs_copy_local_data().
+ * Only local files can be copied this way, for others @method is set to VFS_COPY_NONE.
+ *
+ * @param dest_vfs_fd mc VFS file handler of destination file
+ * @param src_vfs_fd mc VFS file handler of source file
+ */
+
+ssize_t
+vfs_copy_data (int dest_vfs_fd, int src_vfs_fd, size_t count, gboolean sparse,
+               vfs_copy_method_t * method)
+{
+    int dest_fd, src_fd;
+
+    if (*method == VFS_COPY_NONE)
+        return (-1);
+
+    dest_fd = vfs_get_local_fd (dest_vfs_fd);
+    src_fd = vfs_get_local_fd (src_vfs_fd);
+    if (dest_fd < 0 || src_fd < 0)
+    {
+        *method = VFS_COPY_NONE;
+        return (-1);
+    }
+
+    return vfs_copy_local_data (dest_fd, src_fd, count, sparse, method);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Map local file to memory for sequential reading.
+ * If the file is truncated while it is mapped, lost pages are read as zeros and
+ * map->truncated is set.
+ *
+ * @param fd system file descriptor of regular file
+ * @param size size of file
+ *
+ * @return mapped file, NULL if file is empty or can't be mapped: read it in this case
+ */
+
+vfs_file_map_t *
+vfs_map_local_file (int fd, off_t size)
+{
+#ifdef VFS_MAP_GUARD
+    vfs_file_map_t *map;
+    void *data;
+
+    if (fd < 0 || size <= 0 || (uintmax_t) size > (uintmax_t) SIZE_MAX)
+        return NULL;
+
+    data = mmap (NULL, (size_t) size, PROT_READ, MAP_FILE | MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+        return NULL;
+
+#if defined(HAVE_MADVISE) && defined(MADV_SEQUENTIAL)
+    (void) madvise (data, (size_t) size, MADV_SEQUENTIAL);
+#endif
+
+    map = g_new (vfs_file_map_t, 1);
+    map->data = (const char *) data;
+    map->size = (size_t) size;
+    map->truncated = FALSE;
+
+    if (!vfs_map_guard (map))
+    {
+        munmap (data, (size_t) size);
+        g_free (map);
+        map = NULL;
+    }
+
+    return map;
+#else
+    (void) fd;
+    (void) size;
+
+    return NULL;
+#endif /* VFS_MAP_GUARD */
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+vfs_unmap_local_file (vfs_file_map_t * map)
+{
+    if (map == NULL)
+        return;
+
+#ifdef VFS_MAP_GUARD
+    vfs_map_unguard (map);
+    munmap ((void *) map->data, map->size);
+#endif
+    g_free (map);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -139,8 +139,25 @@ enum
     VFS_SETCTL_STALE_DATA
 };
 
+/* Ways to copy data between local files without user space buffers, see vfs_copy_data() */
+typedef enum
+{
+    VFS_COPY_RANGE = 0,         /* copy_file_range(): file system can share or offload data */
+    VFS_COPY_SENDFILE,          /* sendfile(): from page cache to page cache */
+    VFS_COPY_NONE               /* not available, use mc_read()/mc_write() */
+} vfs_copy_method_t;
+
 /*** structures declarations (and typedefs of structures)*****************************************/
 
+/* read-only local file mapped to memory */
+typedef struct
+{
+    const char *data;
+    size_t size;
+    /* set if file was truncated while it is mapped: lost pages are read as zeros */
+    volatile gboolean truncated;
+} vfs_file_map_t;
+
 typedef struct vfs_class
 {
     const char *name;           /* "FIles over SHell" */
@@ -298,6 +315,13 @@ char *_vfs_get_cwd (void);
 int vfs_preallocate (int dest_desc, off_t src_fsize, off_t dest_fsize);
 
 int vfs_clone_file (int dest_vfs_fd, int src_vfs_fd);
+int vfs_get_local_fd (int vfs_fd);
+ssize_t vfs_copy_local_data (int dest_fd, int src_fd, size_t count, gboolean sparse,
+                             vfs_copy_method_t * method);
+ssize_t vfs_copy_data (int dest_vfs_fd, int src_vfs_fd, size_t count, gboolean sparse,
+                       vfs_copy_method_t * method);
+vfs_file_map_t *vfs_map_local_file (int fd, off_t size);
+void vfs_unmap_local_file (vfs_file_map_t * map);
 
 /**
  * Interface functions described in interface.c
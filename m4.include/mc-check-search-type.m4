@@ -1,6 +1,6 @@
 dnl @synopsis mc_CHECK_SEARCH_TYPE
 dnl
-dnl Check search type in mc. Currently used glib-regexp or pcre
+dnl Check search type in mc. Currently used glib-regexp, pcre or pcre2
 dnl
 dnl @author Slava Zanko <slavazanko@gmail.com>
 dnl @version 2009-06-19
@@ -18,6 +18,21 @@ AC_DEFUN([mc_CHECK_SEARCH_TYPE_PCRE],[
 ])
 
 
+AC_DEFUN([mc_CHECK_SEARCH_TYPE_PCRE2],[
+    PKG_CHECK_MODULES(PCRE2, [libpcre2-8], [
+	SEARCH_TYPE="pcre2"
+	dnl Use the same variables as pcre: they are already in all Makefile.am's
+	PCRE_CPPFLAGS="$PCRE2_CFLAGS"
+	PCRE_LIBS="$PCRE2_LIBS"
+	AC_SUBST([PCRE_CPPFLAGS])
+	AC_SUBST([PCRE_LIBS])
+	AC_DEFINE(SEARCH_TYPE_PCRE2, 1, [Define to select 'pcre2' search type])
+    ], [
+	AC_MSG_ERROR([Your system don't have pcre2 library (or pcre2 devel stuff)])
+    ])
+])
+
+
 AC_DEFUN([mc_CHECK_SEARCH_TYPE_GLIB],[
     $PKG_CONFIG --max-version 2.14 glib-2.0
     if test $? -eq 0; then
@@ -33,7 +48,7 @@ AC_DEFUN([mc_CHECK_SEARCH_TYPE],[
 
     AC_ARG_WITH([search-engine],
         AS_HELP_STRING([--with-search-engine=type],
-        [Select low-level search engine (since glib >= 2.14) @<:@glib|pcre@:>@])
+        [Select low-level search engine (since glib >= 2.14) @<:@glib|pcre|pcre2@:>@])
       )
     case x$with_search_engine in
     xglib)
@@ -42,6 +57,9 @@ AC_DEFUN([mc_CHECK_SEARCH_TYPE],[
     xpcre)
 	mc_CHECK_SEARCH_TYPE_PCRE
 	;;
+    xpcre2)
+	mc_CHECK_SEARCH_TYPE_PCRE2
+	;;
     x)
 	SEARCH_TYPE="glib-regexp"
 	;;
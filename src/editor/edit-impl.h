@@ -197,8 +197,8 @@ void edit_set_markers (WEdit * edit, off_t m1, off_t m2, long c1, long c2);
 void edit_push_markers (WEdit * edit);
 void edit_replace_cmd (WEdit * edit, gboolean again);
 void edit_search_cmd (WEdit * edit, gboolean again);
-mc_search_cbret_t edit_search_cmd_callback (const void *user_data, gsize char_offset,
-                                            int *current_char);
+mc_search_cbret_t edit_search_cmd_callback (const void *user_data, gsize offset,
+                                            const char **block, gsize * block_len);
 mc_search_cbret_t edit_search_update_callback (const void *user_data, gsize char_offset);
 
 void edit_complete_word_cmd (WEdit * edit);
@@ -260,6 +260,9 @@ void edit_set_filename (WEdit * edit, const vfs_path_t * name_vpath);
 void edit_load_syntax (WEdit * edit, GPtrArray * pnames, const char *type);
 void edit_free_syntax_rules (WEdit * edit);
 int edit_get_syntax_color (WEdit * edit, off_t byte_index);
+void edit_syntax_invalidate (WEdit * edit, off_t offset);
+gboolean edit_syntax_idle_pending (const WEdit * edit);
+gboolean edit_syntax_idle (WEdit * edit);
 
 void book_mark_insert (WEdit * edit, long line, int c);
 gboolean book_mark_query_color (WEdit * edit, long line, int c);
@@ -98,6 +98,7 @@ gboolean show_right_margin = FALSE;
 
 char *option_backup_ext = NULL;
 char *option_filesize_threshold = NULL;
+char *option_rope_threshold = NULL;
 
 unsigned int edit_stack_iterator = 0;
 edit_stack_type edit_history_moveto[MAX_HISTORY_MOVETO];
@@ -136,6 +137,7 @@ static const struct edit_filters
 };
 
 static const off_t option_filesize_default_threshold = 64 * 1024 * 1024;        /* 64 MB */
+static const off_t option_rope_default_threshold = 16 * 1024 * 1024;    /* 16 MB */
 
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
@@ -426,7 +428,18 @@ edit_load_file (WEdit * edit)
 
     if (fast_load)
     {
-        edit_buffer_init (&edit->buffer, edit->stat1.st_size);
+        gboolean err = FALSE;
+        uintmax_t rope_threshold;
+
+        /* large files are kept in rope: line lookups don't depend on the file size there */
+        rope_threshold = parse_integer (option_rope_threshold, &err);
+        if (err)
+            rope_threshold = option_rope_default_threshold;
+
+        if ((uintmax_t) edit->stat1.st_size >= rope_threshold)
+            edit_buffer_init_rope (&edit->buffer, edit->stat1.st_size);
+        else
+            edit_buffer_init (&edit->buffer, edit->stat1.st_size);
 
         if (!edit_load_file_fast (&edit->buffer, edit->filename_vpath))
         {
@@ -620,6 +633,7 @@ static void
 edit_modification (WEdit * edit)
 {
     edit->caches_valid = FALSE;
+    edit_syntax_invalidate (edit, edit->buffer.curs1);
 
     /* raise lock when file modified */
     if (!edit->modified && !edit->delete_file)
@@ -2711,42 +2725,41 @@ edit_backspace (WEdit * edit, gboolean byte_delete)
 void
 edit_cursor_move (WEdit * edit, off_t increment)
 {
+    off_t i;
+    long lines;
+
     if (increment < 0)
     {
-        for (; increment < 0 && edit->buffer.curs1 != 0; increment++)
-        {
-            int c;
+        increment = MAX (increment, -edit->buffer.curs1);
 
+        for (i = increment; i < 0; i++)
             edit_push_undo_action (edit, CURS_RIGHT);
 
-            c = edit_buffer_get_previous_byte (&edit->buffer);
-            edit_buffer_insert_ahead (&edit->buffer, c);
-            c = edit_buffer_backspace (&edit->buffer);
-            if (c == '\n')
-            {
-                edit->buffer.curs_line--;
-                edit->force |= REDRAW_LINE_BELOW;
-            }
+        lines = edit_buffer_count_lines (&edit->buffer, edit->buffer.curs1 + increment,
+                                         edit->buffer.curs1);
+        if (lines != 0)
+        {
+            edit->buffer.curs_line -= lines;
+            edit->force |= REDRAW_LINE_BELOW;
         }
     }
     else
     {
-        for (; increment > 0 && edit->buffer.curs2 != 0; increment--)
-        {
-            int c;
+        increment = MIN (increment, edit->buffer.curs2);
 
+        for (i = increment; i > 0; i--)
             edit_push_undo_action (edit, CURS_LEFT);
 
-            c = edit_buffer_get_current_byte (&edit->buffer);
-            edit_buffer_insert (&edit->buffer, c);
-            c = edit_buffer_delete (&edit->buffer);
-            if (c == '\n')
-            {
-                edit->buffer.curs_line++;
-                edit->force |= REDRAW_LINE_ABOVE;
-            }
+        lines = edit_buffer_count_lines (&edit->buffer, edit->buffer.curs1,
+                                         edit->buffer.curs1 + increment);
+        if (lines != 0)
+        {
+            edit->buffer.curs_line += lines;
+            edit->force |= REDRAW_LINE_ABOVE;
         }
     }
+
+    edit_buffer_move_cursor (&edit->buffer, increment);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -49,6 +49,7 @@ extern gboolean option_syntax_highlighting;
 extern gboolean option_group_undo;
 extern char *option_backup_ext;
 extern char *option_filesize_threshold;
+extern char *option_rope_threshold;
 extern char *option_stop_format_chars;
 
 extern gboolean edit_confirm_save;
@@ -73,6 +73,11 @@
  * See also:
  * http://en.wikipedia.org/wiki/Gap_buffer
  * http://stackoverflow.com/questions/4199694/data-structure-for-text-editor
+ *
+ * Large files are kept in a balanced rope (see editrope.c) instead: the cursor is just an offset
+ * there, and line of offset and offset of line are found without looking through the text.
+ * If the local file can be mapped to memory, it isn't read at all: the rope refers to pages of
+ * the file, and only the edited parts of text are kept in own memory of rope.
  */
 
 /*** global variables ****************************************************************************/
@@ -118,6 +123,13 @@ edit_buffer_get_byte_ptr (const edit_buffer_t * buf, off_t byte_index)
     if (byte_index >= (buf->curs1 + buf->curs2) || byte_index < 0)
         return NULL;
 
+    if (buf->rope != NULL)
+    {
+        size_t len;
+
+        return (char *) edit_rope_get_block (buf->rope, byte_index, &len);
+    }
+
     if (byte_index >= buf->curs1)
     {
         off_t p;
@@ -131,6 +143,84 @@ edit_buffer_get_byte_ptr (const edit_buffer_t * buf, off_t byte_index)
     return (char *) b + (byte_index & M_EDIT_BUF_SIZE);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Load file into the rope of editor buffer. Local file is mapped to memory instead of reading.
+ *
+ * @param buf pointer to editor buffer
+ * @param fd file descriptor
+ * @param size file size
+ *
+ * @return number of read bytes
+ */
+
+static off_t
+edit_buffer_read_file_rope (edit_buffer_t * buf, int fd, off_t size,
+                            edit_buffer_read_file_status_msg_t * sm, gboolean * aborted)
+{
+    off_t ret = 0;
+    char *b = NULL;
+    status_msg_t *s = STATUS_MSG (sm);
+    unsigned short update_cnt = 0;
+
+    buf->map = vfs_map_local_file (vfs_get_local_fd (fd), size);
+    if (buf->map == NULL)
+        b = g_malloc (EDIT_BUF_SIZE);
+
+    while (ret < size)
+    {
+        ssize_t sz;
+
+        if (buf->map != NULL)
+        {
+            /* the file isn't copied, only line breaks are counted */
+            sz = (ssize_t) MIN (size - ret, EDIT_BUF_SIZE);
+            edit_rope_append_mapped (buf->rope, buf->map->data + ret, (size_t) sz);
+        }
+        else
+        {
+            sz = mc_read (fd, b, (size_t) MIN (size - ret, EDIT_BUF_SIZE));
+            if (sz <= 0)
+                break;
+
+            edit_rope_append (buf->rope, b, (size_t) sz);
+        }
+
+        ret += sz;
+
+        if (s != NULL && s->update != NULL)
+        {
+            update_cnt = (update_cnt + 1) & 0xf;
+            if (update_cnt == 0)
+            {
+                if (sm->buf == NULL)
+                    sm->buf = buf;
+
+                sm->loaded = ret;
+                if (s->update (s) == B_CANCEL)
+                {
+                    *aborted = TRUE;
+                    ret = -1;
+                    break;
+                }
+            }
+        }
+    }
+
+    g_free (b);
+
+    /* file was truncated while it was loaded: lost pages are read as zeros */
+    if (buf->map != NULL && buf->map->truncated && !*aborted)
+        ret = -1;
+
+    /* the whole text is after cursor */
+    buf->curs1 = 0;
+    buf->curs2 = edit_rope_size (buf->rope);
+    buf->lines = edit_rope_lines (buf->rope);
+
+    return ret;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -145,6 +235,8 @@ edit_buffer_init (edit_buffer_t * buf, off_t size)
 {
     buf->b1 = g_ptr_array_sized_new (32);
     buf->b2 = g_ptr_array_sized_new (32);
+    buf->rope = NULL;
+    buf->map = NULL;
 
     buf->curs1 = 0;
     buf->curs2 = 0;
@@ -153,6 +245,21 @@ edit_buffer_init (edit_buffer_t * buf, off_t size)
     buf->lines = 0;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Initialize editor buffer which keeps text in the rope. Cursor movement and line lookups don't
+ * depend on the file size there, but access to bytes is a bit slower.
+ *
+ * @param buf pointer to editor buffer
+ */
+
+void
+edit_buffer_init_rope (edit_buffer_t * buf, off_t size)
+{
+    edit_buffer_init (buf, size);
+    buf->rope = edit_rope_new ();
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Clean editor buffers.
@@ -174,6 +281,60 @@ edit_buffer_clean (edit_buffer_t * buf)
         g_ptr_array_foreach (buf->b2, (GFunc) g_free, NULL);
         g_ptr_array_free (buf->b2, TRUE);
     }
+
+    edit_rope_free (buf->rope);
+    buf->rope = NULL;
+    vfs_unmap_local_file (buf->map);
+    buf->map = NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Copy text which the rope takes from the mapped file to own memory of rope and unmap the file.
+ * Mapped file can be rewritten then.
+ *
+ * @param buf pointer to editor buffer
+ *
+ * @return FALSE if the file was truncated and the text is lost, the file is kept mapped then
+ */
+
+gboolean
+edit_buffer_unmap (edit_buffer_t * buf)
+{
+    edit_rope_t *rope;
+    off_t pos = 0;
+
+    if (buf->map == NULL)
+        return TRUE;
+
+    rope = edit_rope_new ();
+
+    while (TRUE)
+    {
+        const char *b;
+        size_t len;
+
+        b = edit_rope_get_block (buf->rope, pos, &len);
+        if (b == NULL)
+            break;
+
+        edit_rope_append (rope, b, len);
+        pos += (off_t) len;
+    }
+
+    /* don't replace the text with zeros of lost pages */
+    if (buf->map->truncated)
+    {
+        edit_rope_free (rope);
+        return FALSE;
+    }
+
+    edit_rope_free (buf->rope);
+    buf->rope = rope;
+    vfs_unmap_local_file (buf->map);
+    buf->map = NULL;
+
+    return TRUE;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -196,6 +357,42 @@ edit_buffer_get_byte (const edit_buffer_t * buf, off_t byte_index)
     return (p != NULL) ? *(unsigned char *) p : '\n';
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+  * Get contiguous block of bytes started at specified index. The block ends at the end
+  * of its buffer or at the cursor (at the end of rope leaf for the rope).
+  *
+  * @param buf pointer to editor buffer
+  * @param byte_index byte index
+  * @param len length of returned block
+  *
+  * @return NULL if byte_index is negative or larger than file size; pointer to block otherwise.
+  */
+
+const char *
+edit_buffer_get_block (const edit_buffer_t * buf, off_t byte_index, size_t * len)
+{
+    char *p;
+
+    if (buf->rope != NULL)
+        return edit_rope_get_block (buf->rope, byte_index, len);
+
+    p = edit_buffer_get_byte_ptr (buf, byte_index);
+    if (p == NULL)
+        return NULL;
+
+    if (byte_index >= buf->curs1)
+    {
+        /* bytes of b2 buffer are stored in forward order too */
+        *len = (size_t) ((buf->curs1 + buf->curs2 - byte_index - 1) & M_EDIT_BUF_SIZE) + 1;
+    }
+    else
+        *len = (size_t) MIN (EDIT_BUF_SIZE - (byte_index & M_EDIT_BUF_SIZE),
+                             buf->curs1 - byte_index);
+
+    return p;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 #ifdef HAVE_CHARSET
@@ -214,10 +411,11 @@ edit_buffer_get_byte (const edit_buffer_t * buf, off_t byte_index)
 int
 edit_buffer_get_utf (const edit_buffer_t * buf, off_t byte_index, int *char_length)
 {
-    gchar *str = NULL;
+    const gchar *str = NULL;
+    size_t len = 0;
     gunichar res;
     gunichar ch;
-    gchar *next_ch = NULL;
+    const gchar *next_ch = NULL;
 
     if (byte_index >= (buf->curs1 + buf->curs2) || byte_index < 0)
     {
@@ -225,14 +423,14 @@ edit_buffer_get_utf (const edit_buffer_t * buf, off_t byte_index, int *char_leng
         return '\n';
     }
 
-    str = edit_buffer_get_byte_ptr (buf, byte_index);
+    str = edit_buffer_get_block (buf, byte_index, &len);
     if (str == NULL)
     {
         *char_length = 0;
         return 0;
     }
 
-    res = g_utf8_get_char_validated (str, -1);
+    res = g_utf8_get_char_validated (str, (gssize) len);
     if (res == (gunichar) (-2) || res == (gunichar) (-1))
     {
         /* Retry with explicit bytes to make sure it's not a buffer boundary */
@@ -333,6 +531,10 @@ edit_buffer_count_lines (const edit_buffer_t * buf, off_t first, off_t last)
     first = MAX (first, 0);
     last = MIN (last, buf->size);
 
+    if (buf->rope != NULL)
+        return first < last ? edit_rope_count_lines (buf->rope, last)
+            - edit_rope_count_lines (buf->rope, first) : 0;
+
     while (first < last)
         if (edit_buffer_get_byte (buf, first++) == '\n')
             lines++;
@@ -356,6 +558,9 @@ edit_buffer_get_bol (const edit_buffer_t * buf, off_t current)
     if (current <= 0)
         return 0;
 
+    if (buf->rope != NULL && current <= buf->size)
+        return edit_rope_get_line_offset (buf->rope, edit_rope_count_lines (buf->rope, current));
+
     for (; edit_buffer_get_byte (buf, current - 1) != '\n'; current--)
         ;
 
@@ -378,6 +583,16 @@ edit_buffer_get_eol (const edit_buffer_t * buf, off_t current)
     if (current >= buf->size)
         return buf->size;
 
+    if (buf->rope != NULL && current >= 0)
+    {
+        long line;
+
+        /* the first line break after current */
+        line = edit_rope_count_lines (buf->rope, current) + 1;
+        return line > edit_rope_lines (buf->rope) ? buf->size
+            : edit_rope_get_line_offset (buf->rope, line) - 1;
+    }
+
     for (; edit_buffer_get_byte (buf, current) != '\n'; current++)
         ;
 
@@ -445,6 +660,14 @@ edit_buffer_insert (edit_buffer_t * buf, int c)
     void *b;
     off_t i;
 
+    if (buf->rope != NULL)
+    {
+        edit_rope_insert (buf->rope, buf->curs1, (char) c);
+        buf->curs1++;
+        buf->size++;
+        return;
+    }
+
     i = buf->curs1 & M_EDIT_BUF_SIZE;
 
     /* add a new buffer if we've reached the end of the last one */
@@ -477,6 +700,14 @@ edit_buffer_insert_ahead (edit_buffer_t * buf, int c)
     void *b;
     off_t i;
 
+    if (buf->rope != NULL)
+    {
+        edit_rope_insert (buf->rope, buf->curs1, (char) c);
+        buf->curs2++;
+        buf->size++;
+        return;
+    }
+
     i = buf->curs2 & M_EDIT_BUF_SIZE;
 
     /* add a new buffer if we've reached the end of the last one */
@@ -511,6 +742,13 @@ edit_buffer_delete (edit_buffer_t * buf)
     off_t prev;
     off_t i;
 
+    if (buf->rope != NULL)
+    {
+        buf->curs2--;
+        buf->size--;
+        return edit_rope_delete (buf->rope, buf->curs1);
+    }
+
     prev = buf->curs2 - 1;
 
     b = g_ptr_array_index (buf->b2, prev >> S_EDIT_BUF_SIZE);
@@ -552,6 +790,13 @@ edit_buffer_backspace (edit_buffer_t * buf)
     off_t prev;
     off_t i;
 
+    if (buf->rope != NULL)
+    {
+        buf->curs1--;
+        buf->size--;
+        return edit_rope_delete (buf->rope, buf->curs1);
+    }
+
     prev = buf->curs1 - 1;
 
     b = g_ptr_array_index (buf->b1, prev >> S_EDIT_BUF_SIZE);
@@ -576,6 +821,38 @@ edit_buffer_backspace (edit_buffer_t * buf)
     return c;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Move cursor without changing of text.
+ *
+ * @param buf pointer to editor buffer
+ * @param increment distance to move cursor, negative to move left; must not move the cursor
+ *                  out of the text
+ */
+
+void
+edit_buffer_move_cursor (edit_buffer_t * buf, off_t increment)
+{
+    if (buf->rope != NULL)
+    {
+        buf->curs1 += increment;
+        buf->curs2 -= increment;
+        return;
+    }
+
+    for (; increment < 0; increment++)
+    {
+        edit_buffer_insert_ahead (buf, edit_buffer_get_previous_byte (buf));
+        edit_buffer_backspace (buf);
+    }
+
+    for (; increment > 0; increment--)
+    {
+        edit_buffer_insert (buf, edit_buffer_get_current_byte (buf));
+        edit_buffer_delete (buf);
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Calculate forward offset with specified number of lines.
@@ -598,6 +875,18 @@ edit_buffer_get_forward_offset (const edit_buffer_t * buf, off_t current, long l
 
     lines = MAX (lines, 0);
 
+    if (buf->rope != NULL && current >= 0)
+    {
+        long line;
+
+        if (current >= buf->size)
+            return current;
+
+        line = edit_rope_count_lines (buf->rope, current);
+        lines = MIN (lines, edit_rope_lines (buf->rope) - line);
+        return lines == 0 ? current : edit_rope_get_line_offset (buf->rope, line + lines);
+    }
+
     while (lines-- != 0)
     {
         long next;
@@ -626,6 +915,15 @@ off_t
 edit_buffer_get_backward_offset (const edit_buffer_t * buf, off_t current, long lines)
 {
     lines = MAX (lines, 0);
+
+    if (buf->rope != NULL && current >= 0 && current <= buf->size)
+    {
+        long line;
+
+        line = edit_rope_count_lines (buf->rope, current);
+        return edit_rope_get_line_offset (buf->rope, MAX (line - lines, 0));
+    }
+
     current = edit_buffer_get_bol (buf, current);
 
     while (lines-- != 0 && current != 0)
@@ -658,6 +956,9 @@ edit_buffer_read_file (edit_buffer_t * buf, int fd, off_t size,
 
     *aborted = FALSE;
 
+    if (buf->rope != NULL)
+        return edit_buffer_read_file_rope (buf, fd, size, sm, aborted);
+
     buf->lines = 0;
     buf->curs2 = size;
     i = buf->curs2 >> S_EDIT_BUF_SIZE;
@@ -767,6 +1068,22 @@ edit_buffer_write_file (edit_buffer_t * buf, int fd)
     off_t data_size, sz;
     void *b;
 
+    if (buf->rope != NULL)
+    {
+        const char *block;
+        size_t len;
+
+        /* leaves of rope from begin to end */
+        for (; (block = edit_rope_get_block (buf->rope, ret, &len)) != NULL; ret += sz)
+        {
+            sz = mc_write (fd, block, len);
+            if (sz != (off_t) len)
+                return sz < 0 && ret == 0 ? sz : ret + MAX (sz, 0);
+        }
+
+        return ret;
+    }
+
     /* write all fulfilled parts of b1 from begin to end */
     if (buf->b1->len != 0)
     {
@@ -5,6 +5,8 @@
 #ifndef MC__EDIT_BUFFER_H
 #define MC__EDIT_BUFFER_H
 
+#include "editrope.h"
+
 /*** typedefs(not structures) and defined constants **********************************************/
 
 /*** enums ***************************************************************************************/
@@ -17,6 +19,8 @@ typedef struct edit_buffer_struct
     off_t curs2;                /* position from the end of the file */
     GPtrArray *b1;              /* all data up to curs1 */
     GPtrArray *b2;              /* all data from end of file down to curs2 */
+    edit_rope_t *rope;          /* all data if not NULL: used instead of b1 and b2 */
+    vfs_file_map_t *map;        /* mapped file which rope refers to, or NULL */
     off_t size;                 /* file size */
     long lines;                 /* total lines in the file */
     long curs_line;             /* line number of the cursor. */
@@ -36,9 +40,12 @@ typedef struct edit_buffer_read_file_status_msg_struct
 /*** declarations of public functions ************************************************************/
 
 void edit_buffer_init (edit_buffer_t * buf, off_t size);
+void edit_buffer_init_rope (edit_buffer_t * buf, off_t size);
 void edit_buffer_clean (edit_buffer_t * buf);
+gboolean edit_buffer_unmap (edit_buffer_t * buf);
 
 int edit_buffer_get_byte (const edit_buffer_t * buf, off_t byte_index);
+const char *edit_buffer_get_block (const edit_buffer_t * buf, off_t byte_index, size_t * len);
 #ifdef HAVE_CHARSET
 int edit_buffer_get_utf (const edit_buffer_t * buf, off_t byte_index, int *char_length);
 int edit_buffer_get_prev_utf (const edit_buffer_t * buf, off_t byte_index, int *char_length);
@@ -53,6 +60,7 @@ void edit_buffer_insert (edit_buffer_t * buf, int c);
 void edit_buffer_insert_ahead (edit_buffer_t * buf, int c);
 int edit_buffer_delete (edit_buffer_t * buf);
 int edit_buffer_backspace (edit_buffer_t * buf);
+void edit_buffer_move_cursor (edit_buffer_t * buf, off_t increment);
 
 off_t edit_buffer_get_forward_offset (const edit_buffer_t * buf, off_t current, long lines,
                                       off_t upto);
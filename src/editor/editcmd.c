@@ -169,6 +169,27 @@ edit_save_mode_callback (Widget * w, Widget * sender, widget_msg_t msg, int parm
 
 /* --------------------------------------------------------------------------------------------- */
 
+/**
+ * Check whether the file which text is taken from was truncated by another process.
+ * Lost pages of the file are read as zeros, so the text can't be saved.
+ *
+ * @return TRUE if the text is lost
+ */
+
+static gboolean
+edit_check_truncated (const WEdit * edit)
+{
+    if (edit->buffer.map == NULL || !edit->buffer.map->truncated)
+        return FALSE;
+
+    edit_error_dialog (_("Error"),
+                       _("The file has been truncated on disk in the meantime.\n"
+                         "Its text is lost and cannot be saved."));
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 /*  If 0 (quick save) then  a) create/truncate <filename> file,
    b) save to <filename>;
    if 1 (safe save) then   a) save to <tempnam>,
@@ -260,6 +281,18 @@ edit_save_file (WEdit * edit, const vfs_path_t * filename_vpath)
                 return -1;
             }
         }
+
+        /* text of large file is taken from the file itself: keep own copy before rewriting it */
+        if (this_save_mode == EDIT_QUICK_SAVE && edit->buffer.map != NULL
+            && vfs_file_is_local (real_filename_vpath) && sb.st_dev == edit->stat1.st_dev
+            && sb.st_ino == edit->stat1.st_ino)
+            (void) edit_buffer_unmap (&edit->buffer);
+    }
+
+    if (edit_check_truncated (edit))
+    {
+        vfs_path_free (real_filename_vpath);
+        return 0;
     }
 
     if (this_save_mode == EDIT_QUICK_SAVE)
@@ -374,7 +407,8 @@ edit_save_file (WEdit * edit, const vfs_path_t * filename_vpath)
         }
     }
 
-    if (filelen != edit->buffer.size)
+    /* file can be truncated while it is written: don't replace it with zeros of lost pages */
+    if (filelen != edit->buffer.size || edit_check_truncated (edit))
         goto error_save;
 
     if (this_save_mode == EDIT_DO_BACKUP)
@@ -1240,7 +1274,7 @@ edit_collect_completions (WEdit * edit, off_t word_start, gsize word_len,
 
     srch->search_type = MC_SEARCH_T_REGEX;
     srch->is_case_sensitive = TRUE;
-    srch->search_fn = edit_search_cmd_callback;
+    srch->block_fn = edit_search_cmd_callback;
     srch->update_fn = edit_search_update_callback;
 
     esm.first = TRUE;
@@ -2591,7 +2625,7 @@ edit_replace_cmd (WEdit * edit, gboolean again)
 #endif
         edit->search->is_case_sensitive = edit_search_options.case_sens;
         edit->search->whole_words = edit_search_options.whole_words;
-        edit->search->search_fn = edit_search_cmd_callback;
+        edit->search->block_fn = edit_search_cmd_callback;
         edit->search->update_fn = edit_search_update_callback;
         edit->search_line_type = edit_get_search_line_type (edit->search);
         edit_search_fix_search_start_if_selection (edit);
@@ -2749,12 +2783,21 @@ edit_replace_cmd (WEdit * edit, gboolean again)
 /* --------------------------------------------------------------------------------------------- */
 
 mc_search_cbret_t
-edit_search_cmd_callback (const void *user_data, gsize char_offset, int *current_char)
+edit_search_cmd_callback (const void *user_data, gsize offset, const char **block,
+                          gsize * block_len)
 {
     WEdit *edit = ((const edit_search_status_msg_t *) user_data)->edit;
+    size_t len = 0;
 
-    *current_char = edit_buffer_get_byte (&edit->buffer, (off_t) char_offset);
+    *block = edit_buffer_get_block (&edit->buffer, (off_t) offset, &len);
+    if (*block == NULL)
+    {
+        /* like edit_buffer_get_byte() does outside of text */
+        *block = "\n";
+        len = 1;
+    }
 
+    *block_len = len;
     return MC_SEARCH_CB_OK;
 }
 
@@ -2814,7 +2857,7 @@ edit_search_cmd (WEdit * edit, gboolean again)
 #endif
                 edit->search->is_case_sensitive = edit_search_options.case_sens;
                 edit->search->whole_words = edit_search_options.whole_words;
-                edit->search->search_fn = edit_search_cmd_callback;
+                edit->search->block_fn = edit_search_cmd_callback;
                 edit->search->update_fn = edit_search_update_callback;
                 edit->search_line_type = edit_get_search_line_type (edit->search);
                 edit_do_search (edit);
@@ -0,0 +1,804 @@
+/*
+   Editor text keep buffer: balanced rope.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file
+ *  \brief Source: balanced rope to keep text of large files.
+ *
+ * Text is kept in leaves of up to EDIT_ROPE_LEAF_SIZE bytes. Leaves are joined by inner nodes
+ * of AVL tree. Every node knows the number of bytes and line breaks in its subtree, so byte
+ * offset of line and line of byte offset are found in O(log n) time.
+ *
+ * Bytes of leaf are kept in [start; start + size) part of its buffer, so bytes can be added
+ * and removed at both ends of leaf without moving other bytes. If a byte is inserted or deleted
+ * in the middle of leaf, the leaf is split at this point first: editing at one place of text
+ * (typing, deleting by characters) doesn't move more than few bytes per character.
+ *
+ * Leaves can refer to the text of file mapped to memory instead of own buffer. Such leaves are
+ * never changed: before the first change at some place few bytes around it are copied to
+ * the new leaf, so only edited parts of file are kept in memory.
+ */
+
+#include <config.h>
+
+#include <string.h>
+
+#include "lib/global.h"
+
+#include "editrope.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/* Size of the leaf buffer */
+#define EDIT_ROPE_LEAF_SIZE (16 * 1024)
+
+/* Bytes which are moved inside of leaf on insertion or deletion instead of splitting it */
+#define EDIT_ROPE_MOVE_MAX 256
+
+/* Max size of the leaf which refers to the mapped file */
+#define EDIT_ROPE_MAP_LEAF_SIZE (1024 * 1024)
+
+#define EDIT_ROPE_IS_LEAF(node) ((node)->data != NULL)
+
+/*** file scope type declarations ****************************************************************/
+
+typedef struct edit_rope_node_struct
+{
+    struct edit_rope_node_struct *parent;
+    struct edit_rope_node_struct *left;
+    struct edit_rope_node_struct *right;
+    off_t size;                 /* bytes in the subtree */
+    long lines;                 /* line breaks in the subtree */
+    int height;                 /* height of the subtree, 1 for leaf */
+    /* leaf only */
+    char *data;                 /* buffer of EDIT_ROPE_LEAF_SIZE bytes */
+    size_t start;               /* offset of the first byte in the buffer */
+    gboolean mapped;            /* data is a part of mapped file, read only */
+} edit_rope_node_t;
+
+struct edit_rope_struct
+{
+    edit_rope_node_t *root;
+    /* the last found leaf: bytes are mostly read one by one in sequence */
+    edit_rope_node_t *cache_leaf;
+    off_t cache_offset;         /* offset of the first byte of cache_leaf in the text */
+};
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static long
+edit_rope_count_nl (const char *data, size_t len)
+{
+    const char *end = data + len;
+    long lines = 0;
+
+    while ((data = (const char *) memchr (data, '\n', (size_t) (end - data))) != NULL)
+    {
+        lines++;
+        data++;
+    }
+
+    return lines;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static edit_rope_node_t *
+edit_rope_leaf_new (const char *data, size_t len)
+{
+    edit_rope_node_t *leaf;
+
+    leaf = g_new0 (edit_rope_node_t, 1);
+    leaf->data = g_malloc (EDIT_ROPE_LEAF_SIZE);
+    leaf->height = 1;
+
+    if (len != 0)
+    {
+        memcpy (leaf->data, data, len);
+        leaf->size = (off_t) len;
+        leaf->lines = edit_rope_count_nl (data, len);
+    }
+
+    return leaf;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static edit_rope_node_t *
+edit_rope_leaf_new_mapped (const char *data, size_t len)
+{
+    edit_rope_node_t *leaf;
+
+    leaf = g_new0 (edit_rope_node_t, 1);
+    leaf->data = (char *) data;
+    leaf->mapped = TRUE;
+    leaf->height = 1;
+    leaf->size = (off_t) len;
+    leaf->lines = edit_rope_count_nl (data, len);
+
+    return leaf;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+edit_rope_leaf_free (edit_rope_node_t * leaf)
+{
+    if (!leaf->mapped)
+        g_free (leaf->data);
+    g_free (leaf);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+edit_rope_node_free (edit_rope_node_t * node)
+{
+    if (node != NULL)
+    {
+        if (EDIT_ROPE_IS_LEAF (node))
+            edit_rope_leaf_free (node);
+        else
+        {
+            edit_rope_node_free (node->left);
+            edit_rope_node_free (node->right);
+            g_free (node);
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+edit_rope_node_update (edit_rope_node_t * node)
+{
+    if (!EDIT_ROPE_IS_LEAF (node))
+    {
+        node->size = node->left->size + node->right->size;
+        node->lines = node->left->lines + node->right->lines;
+        node->height = MAX (node->left->height, node->right->height) + 1;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Put @new_node to the place of @node in the tree */
+
+static void
+edit_rope_replace (edit_rope_t * rope, edit_rope_node_t * node, edit_rope_node_t * new_node)
+{
+    edit_rope_node_t *parent = node->parent;
+
+    new_node->parent = parent;
+
+    if (parent == NULL)
+        rope->root = new_node;
+    else if (parent->left == node)
+        parent->left = new_node;
+    else
+        parent->right = new_node;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static edit_rope_node_t *
+edit_rope_rotate_left (edit_rope_t * rope, edit_rope_node_t * node)
+{
+    edit_rope_node_t *right = node->right;
+
+    edit_rope_replace (rope, node, right);
+
+    node->right = right->left;
+    node->right->parent = node;
+    right->left = node;
+    node->parent = right;
+
+    edit_rope_node_update (node);
+    edit_rope_node_update (right);
+
+    return right;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static edit_rope_node_t *
+edit_rope_rotate_right (edit_rope_t * rope, edit_rope_node_t * node)
+{
+    edit_rope_node_t *left = node->left;
+
+    edit_rope_replace (rope, node, left);
+
+    node->left = left->right;
+    node->left->parent = node;
+    left->right = node;
+    node->parent = left;
+
+    edit_rope_node_update (node);
+    edit_rope_node_update (left);
+
+    return left;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Update counters of nodes from @node up to the root and restore balance of the tree */
+
+static void
+edit_rope_rebalance (edit_rope_t * rope, edit_rope_node_t * node)
+{
+    for (; node != NULL; node = node->parent)
+    {
+        int balance;
+
+        if (EDIT_ROPE_IS_LEAF (node))
+            continue;
+
+        edit_rope_node_update (node);
+        balance = node->left->height - node->right->height;
+
+        if (balance > 1)
+        {
+            if (node->left->left->height < node->left->right->height)
+                edit_rope_rotate_left (rope, node->left);
+            node = edit_rope_rotate_right (rope, node);
+        }
+        else if (balance < -1)
+        {
+            if (node->right->right->height < node->right->left->height)
+                edit_rope_rotate_right (rope, node->right);
+            node = edit_rope_rotate_left (rope, node);
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Put @leaf right after @node (a leaf too) */
+
+static void
+edit_rope_add_after (edit_rope_t * rope, edit_rope_node_t * node, edit_rope_node_t * leaf)
+{
+    edit_rope_node_t *parent;
+
+    parent = g_new0 (edit_rope_node_t, 1);
+    edit_rope_replace (rope, node, parent);
+    parent->left = node;
+    parent->right = leaf;
+    node->parent = parent;
+    leaf->parent = parent;
+
+    edit_rope_rebalance (rope, parent);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Split leaf: bytes from @offset go to new leaf.
+ *
+ * @return new leaf
+ */
+
+static edit_rope_node_t *
+edit_rope_split (edit_rope_t * rope, edit_rope_node_t * leaf, size_t offset)
+{
+    const char *data = leaf->data + leaf->start + offset;
+    const size_t len = (size_t) leaf->size - offset;
+    edit_rope_node_t *right;
+
+    right = leaf->mapped ? edit_rope_leaf_new_mapped (data, len) : edit_rope_leaf_new (data, len);
+    leaf->size = (off_t) offset;
+    leaf->lines -= right->lines;
+
+    edit_rope_add_after (rope, leaf, right);
+
+    return right;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Prepare mapped leaf to change at @offset: copy bytes around @offset to own buffer of the new
+ * leaf. The rest of bytes are kept in the mapped file.
+ */
+
+static void
+edit_rope_unmap (edit_rope_t * rope, edit_rope_node_t * leaf, size_t offset)
+{
+    size_t start, end;
+    char *data;
+
+    end = MIN ((size_t) leaf->size, offset + EDIT_ROPE_MOVE_MAX);
+    if (end != (size_t) leaf->size)
+        edit_rope_split (rope, leaf, end);
+
+    start = offset > EDIT_ROPE_MOVE_MAX ? offset - EDIT_ROPE_MOVE_MAX : 0;
+    if (start != 0)
+        leaf = edit_rope_split (rope, leaf, start);
+
+    /* size and lines are the same, so counters of the tree are kept */
+    data = g_malloc (EDIT_ROPE_LEAF_SIZE);
+    memcpy (data, leaf->data + leaf->start, (size_t) leaf->size);
+    leaf->data = data;
+    leaf->start = 0;
+    leaf->mapped = FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Remove empty leaf from the tree */
+
+static void
+edit_rope_remove (edit_rope_t * rope, edit_rope_node_t * leaf)
+{
+    edit_rope_node_t *parent = leaf->parent;
+
+    if (parent == NULL)
+        rope->root = NULL;
+    else
+    {
+        edit_rope_node_t *sibling;
+
+        sibling = parent->left == leaf ? parent->right : parent->left;
+        edit_rope_replace (rope, parent, sibling);
+        g_free (parent);
+        edit_rope_rebalance (rope, sibling->parent);
+    }
+
+    edit_rope_leaf_free (leaf);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find leaf which contains byte at @pos.
+ *
+ * @param pos offset in the text, offset in the leaf on return
+ * @param prefer_left if @pos is the end of one leaf and the start of next one, take the first one
+ *
+ * @return leaf
+ */
+
+static edit_rope_node_t *
+edit_rope_find (const edit_rope_t * rope, off_t * pos, gboolean prefer_left)
+{
+    edit_rope_node_t *node = rope->root;
+
+    while (!EDIT_ROPE_IS_LEAF (node))
+    {
+        if (*pos < node->left->size || (prefer_left && *pos == node->left->size))
+            node = node->left;
+        else
+        {
+            *pos -= node->left->size;
+            node = node->right;
+        }
+    }
+
+    return node;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static edit_rope_node_t *
+edit_rope_last_leaf (const edit_rope_t * rope)
+{
+    edit_rope_node_t *node = rope->root;
+
+    while (node != NULL && !EDIT_ROPE_IS_LEAF (node))
+        node = node->right;
+
+    return node;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+edit_rope_t *
+edit_rope_new (void)
+{
+    return g_new0 (edit_rope_t, 1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+edit_rope_free (edit_rope_t * rope)
+{
+    if (rope != NULL)
+    {
+        edit_rope_node_free (rope->root);
+        g_free (rope);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+off_t
+edit_rope_size (const edit_rope_t * rope)
+{
+    return rope->root == NULL ? 0 : rope->root->size;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+long
+edit_rope_lines (const edit_rope_t * rope)
+{
+    return rope->root == NULL ? 0 : rope->root->lines;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get contiguous block of bytes started at specified offset. The block ends at the end
+ * of its leaf.
+ *
+ * @param rope rope
+ * @param pos byte offset
+ * @param len length of returned block
+ *
+ * @return NULL if pos is negative or not less than text size; pointer to block otherwise.
+ */
+
+const char *
+edit_rope_get_block (edit_rope_t * rope, off_t pos, size_t * len)
+{
+    edit_rope_node_t *leaf = rope->cache_leaf;
+    off_t offset;
+
+    if (pos < 0 || pos >= edit_rope_size (rope))
+        return NULL;
+
+    if (leaf == NULL || pos < rope->cache_offset || pos >= rope->cache_offset + leaf->size)
+    {
+        offset = pos;
+        leaf = edit_rope_find (rope, &offset, FALSE);
+        rope->cache_leaf = leaf;
+        rope->cache_offset = pos - offset;
+    }
+
+    offset = pos - rope->cache_offset;
+    *len = (size_t) (leaf->size - offset);
+
+    return leaf->data + leaf->start + offset;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Insert byte into the text.
+ *
+ * @param rope rope
+ * @param pos offset of the inserted byte, from 0 to text size
+ * @param c byte
+ */
+
+void
+edit_rope_insert (edit_rope_t * rope, off_t pos, char c)
+{
+    edit_rope_node_t *leaf;
+    off_t offset;
+    size_t size, tail;
+    char *p;
+
+    rope->cache_leaf = NULL;
+
+    if (rope->root == NULL)
+        rope->root = edit_rope_leaf_new (NULL, 0);
+
+    offset = pos;
+    leaf = edit_rope_find (rope, &offset, TRUE);
+
+    if (leaf->mapped)
+    {
+        edit_rope_unmap (rope, leaf, (size_t) offset);
+        offset = pos;
+        leaf = edit_rope_find (rope, &offset, TRUE);
+    }
+
+    size = (size_t) leaf->size;
+    tail = size - (size_t) offset;
+
+    if (size == EDIT_ROPE_LEAF_SIZE
+        || (offset > EDIT_ROPE_MOVE_MAX && tail > EDIT_ROPE_MOVE_MAX))
+    {
+        /* the byte is added at the end of left part or at the start of right one */
+        edit_rope_split (rope, leaf, size == EDIT_ROPE_LEAF_SIZE ? size / 2 : (size_t) offset);
+        offset = pos;
+        leaf = edit_rope_find (rope, &offset, TRUE);
+        size = (size_t) leaf->size;
+        tail = size - (size_t) offset;
+    }
+
+    p = leaf->data + leaf->start;
+
+    if (leaf->start != 0 && ((size_t) offset <= tail || leaf->start + size == EDIT_ROPE_LEAF_SIZE))
+    {
+        /* move head to left */
+        memmove (p - 1, p, (size_t) offset);
+        leaf->start--;
+        p--;
+    }
+    else
+        memmove (p + offset + 1, p + offset, tail);
+
+    p[offset] = c;
+    leaf->size++;
+    if (c == '\n')
+        leaf->lines++;
+
+    edit_rope_rebalance (rope, leaf->parent);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Add bytes at the end of the text.
+ *
+ * @param rope rope
+ * @param data bytes
+ * @param len number of bytes
+ */
+
+void
+edit_rope_append (edit_rope_t * rope, const char *data, size_t len)
+{
+    edit_rope_node_t *leaf;
+
+    rope->cache_leaf = NULL;
+
+    leaf = edit_rope_last_leaf (rope);
+
+    if (leaf != NULL && !leaf->mapped && leaf->start + (size_t) leaf->size < EDIT_ROPE_LEAF_SIZE)
+    {
+        size_t n;
+
+        n = MIN (len, EDIT_ROPE_LEAF_SIZE - leaf->start - (size_t) leaf->size);
+        memcpy (leaf->data + leaf->start + leaf->size, data, n);
+        leaf->size += (off_t) n;
+        leaf->lines += edit_rope_count_nl (data, n);
+        edit_rope_rebalance (rope, leaf->parent);
+
+        data += n;
+        len -= n;
+    }
+
+    while (len != 0)
+    {
+        edit_rope_node_t *next;
+        size_t n;
+
+        n = MIN (len, EDIT_ROPE_LEAF_SIZE);
+        next = edit_rope_leaf_new (data, n);
+
+        if (leaf == NULL)
+            rope->root = next;
+        else
+            edit_rope_add_after (rope, leaf, next);
+
+        leaf = next;
+        data += n;
+        len -= n;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Add bytes of mapped file at the end of the text. Bytes aren't copied.
+ *
+ * @param rope rope
+ * @param data bytes, must not be changed or unmapped until the rope is freed
+ * @param len number of bytes
+ */
+
+void
+edit_rope_append_mapped (edit_rope_t * rope, const char *data, size_t len)
+{
+    edit_rope_node_t *leaf;
+
+    rope->cache_leaf = NULL;
+
+    leaf = edit_rope_last_leaf (rope);
+
+    if (leaf != NULL && leaf->mapped && leaf->data + leaf->size == data
+        && (size_t) leaf->size < EDIT_ROPE_MAP_LEAF_SIZE)
+    {
+        /* continuation of the same file */
+        size_t n;
+
+        n = MIN (len, EDIT_ROPE_MAP_LEAF_SIZE - (size_t) leaf->size);
+        leaf->size += (off_t) n;
+        leaf->lines += edit_rope_count_nl (data, n);
+        edit_rope_rebalance (rope, leaf->parent);
+
+        data += n;
+        len -= n;
+    }
+
+    while (len != 0)
+    {
+        edit_rope_node_t *next;
+        size_t n;
+
+        n = MIN (len, EDIT_ROPE_MAP_LEAF_SIZE);
+        next = edit_rope_leaf_new_mapped (data, n);
+
+        if (leaf == NULL)
+            rope->root = next;
+        else
+            edit_rope_add_after (rope, leaf, next);
+
+        leaf = next;
+        data += n;
+        len -= n;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Delete byte from the text.
+ *
+ * @param rope rope
+ * @param pos offset of deleted byte, must be less than text size
+ *
+ * @return deleted byte
+ */
+
+int
+edit_rope_delete (edit_rope_t * rope, off_t pos)
+{
+    edit_rope_node_t *leaf;
+    off_t offset;
+    size_t size, tail;
+    char *p;
+    unsigned char c;
+
+    rope->cache_leaf = NULL;
+
+    offset = pos;
+    leaf = edit_rope_find (rope, &offset, FALSE);
+
+    if (leaf->mapped)
+    {
+        edit_rope_unmap (rope, leaf, (size_t) offset);
+        offset = pos;
+        leaf = edit_rope_find (rope, &offset, FALSE);
+    }
+
+    size = (size_t) leaf->size;
+    tail = size - (size_t) offset - 1;
+
+    if (offset > EDIT_ROPE_MOVE_MAX && tail > EDIT_ROPE_MOVE_MAX)
+    {
+        /* the byte is deleted from the start of right part */
+        edit_rope_split (rope, leaf, (size_t) offset);
+        offset = pos;
+        leaf = edit_rope_find (rope, &offset, FALSE);
+        size = (size_t) leaf->size;
+        tail = size - (size_t) offset - 1;
+    }
+
+    p = leaf->data + leaf->start;
+    c = (unsigned char) p[offset];
+
+    if ((size_t) offset < tail)
+    {
+        /* move head to right */
+        memmove (p + 1, p, (size_t) offset);
+        leaf->start++;
+    }
+    else
+        memmove (p + offset, p + offset + 1, tail);
+
+    leaf->size--;
+    if (c == '\n')
+        leaf->lines--;
+
+    if (leaf->size == 0)
+        edit_rope_remove (rope, leaf);
+    else
+        edit_rope_rebalance (rope, leaf->parent);
+
+    return c;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Count line breaks before specified offset.
+ *
+ * @param rope rope
+ * @param pos byte offset, from 0 to text size
+ *
+ * @return number of line breaks in [0; pos)
+ */
+
+long
+edit_rope_count_lines (const edit_rope_t * rope, off_t pos)
+{
+    const edit_rope_node_t *node = rope->root;
+    long lines = 0;
+
+    if (node == NULL)
+        return 0;
+
+    while (!EDIT_ROPE_IS_LEAF (node))
+    {
+        if (pos < node->left->size)
+            node = node->left;
+        else
+        {
+            pos -= node->left->size;
+            lines += node->left->lines;
+            node = node->right;
+        }
+    }
+
+    return lines + edit_rope_count_nl (node->data + node->start, (size_t) MIN (pos, node->size));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get offset of the beginning of line.
+ *
+ * @param rope rope
+ * @param line line number, from 0 to number of line breaks
+ *
+ * @return offset of byte after line break number @line
+ */
+
+off_t
+edit_rope_get_line_offset (const edit_rope_t * rope, long line)
+{
+    const edit_rope_node_t *node = rope->root;
+    const char *p, *end;
+    off_t offset = 0;
+
+    if (line <= 0 || node == NULL)
+        return 0;
+
+    if (line > node->lines)
+        return node->size;
+
+    while (!EDIT_ROPE_IS_LEAF (node))
+    {
+        if (line <= node->left->lines)
+            node = node->left;
+        else
+        {
+            line -= node->left->lines;
+            offset += node->left->size;
+            node = node->right;
+        }
+    }
+
+    p = node->data + node->start;
+    end = p + node->size;
+
+    for (; line > 0; line--)
+    {
+        p = (const char *) memchr (p, '\n', (size_t) (end - p));
+        /* mapped file was changed by someone else and counter of leaf is stale */
+        if (p == NULL)
+            return offset + node->size;
+        p++;
+    }
+
+    return offset + (p - (node->data + node->start));
+}
+
+/* --------------------------------------------------------------------------------------------- */
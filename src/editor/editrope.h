@@ -0,0 +1,39 @@
+/** \file
+ *  \brief Header: balanced rope to keep text of large files for WEdit
+ */
+
+#ifndef MC__EDIT_ROPE_H
+#define MC__EDIT_ROPE_H
+
+#include <sys/types.h>          /* off_t */
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+typedef struct edit_rope_struct edit_rope_t;
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+edit_rope_t *edit_rope_new (void);
+void edit_rope_free (edit_rope_t * rope);
+
+off_t edit_rope_size (const edit_rope_t * rope);
+long edit_rope_lines (const edit_rope_t * rope);
+
+const char *edit_rope_get_block (edit_rope_t * rope, off_t pos, size_t * len);
+void edit_rope_insert (edit_rope_t * rope, off_t pos, char c);
+void edit_rope_append (edit_rope_t * rope, const char *data, size_t len);
+void edit_rope_append_mapped (edit_rope_t * rope, const char *data, size_t len);
+int edit_rope_delete (edit_rope_t * rope, off_t pos);
+
+long edit_rope_count_lines (const edit_rope_t * rope, off_t pos);
+off_t edit_rope_get_line_offset (const edit_rope_t * rope, long line);
+
+/*** inline functions ****************************************************************************/
+
+#endif /* MC__EDIT_ROPE_H */
@@ -985,6 +985,7 @@ edit_callback (Widget * w, Widget * sender, widget_msg_t msg, int parm, void *da
         }
 
     case MSG_IDLE:
+        edit_syntax_idle (e);
         edit_update_screen (e);
         return MSG_HANDLED;
 
@@ -1330,6 +1331,10 @@ edit_update_screen (WEdit * e)
         edit_render_keypress (e);
     }
 
+    /* find syntax rules ahead of the screen while user does nothing */
+    if (edit_syntax_idle_pending (e))
+        widget_idle (WIDGET (WIDGET (e)->owner), TRUE);
+
     widget_draw (WIDGET (find_buttonbar (DIALOG (WIDGET (e)->owner))));
 }
 
@@ -151,10 +151,11 @@ struct WEdit
     unsigned int skip_detach_prompt:1;  /* Do not prompt whether to detach a file anymore */
 
     /* syntax higlighting */
-    GSList *syntax_marker;
+    GArray *syntax_marker;      /* rules found every few bytes, sorted by offset */
     GPtrArray *rules;
     off_t last_get_rule;
     edit_syntax_rule_t rule;
+    gboolean rule_is_guess;     /* rule is found not from the beginning of file */
     char *syntax_type;          /* description of syntax highlighting type being used */
     GTree *defines;             /* List of defines */
     gboolean is_case_insensitive;       /* selects language case sensitivity */
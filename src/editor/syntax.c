@@ -74,6 +74,19 @@ gboolean option_auto_syntax = TRUE;
 /* bytes */
 #define SYNTAX_MARKER_DENSITY 512
 
+/* if the nearest found rule is farther (bytes), the rule is guessed */
+#define SYNTAX_GUESS_DISTANCE (256 * 1024)
+/* rule is guessed from the beginning of line which is at least so many bytes above */
+#define SYNTAX_GUESS_BACK (16 * 1024)
+
+/* bytes processed at once in the idle time */
+#define SYNTAX_IDLE_CHUNK (64 * 1024)
+/* bytes below the screen for which rules are found in the idle time */
+#define SYNTAX_IDLE_AHEAD (64 * 1024)
+
+/* last_get_rule value if edit->rule doesn't belong to any offset */
+#define SYNTAX_RULE_UNKNOWN ((off_t) (-2))
+
 #define RULE_ON_LEFT_BORDER 1
 #define RULE_ON_RIGHT_BORDER 2
 
@@ -81,6 +94,8 @@ gboolean option_auto_syntax = TRUE;
 #define SYNTAX_TOKEN_PLUS       '\002'
 #define SYNTAX_TOKEN_BRACKET    '\003'
 #define SYNTAX_TOKEN_BRACE      '\004'
+/* bytes below are tokens or end of string */
+#define SYNTAX_TOKEN_FIRST_CHAR '\005'
 
 #define break_a { result = line; break; }
 #define check_a { if (*a == NULL) { result = line; break; } }
@@ -100,8 +115,19 @@ typedef struct
     char *whole_word_chars_right;
     gboolean line_start;
     int color;
+    /* colors as they are given in syntax file: color is allocated again when rules are reused */
+    char *fg;
+    char *bg;
+    char *attrs;
 } syntax_keyword_t;
 
+/* keyword which can start at some byte */
+typedef struct
+{
+    int keyword;                /* index of keyword, 0 ends the list */
+    int next;                   /* the second byte of keyword, -1 if it isn't a plain byte */
+} syntax_keyword_candidate_t;
+
 typedef struct
 {
     char *left;
@@ -113,10 +139,11 @@ typedef struct
     gboolean between_delimiters;
     char *whole_word_chars_left;
     char *whole_word_chars_right;
-    char *keyword_first_chars;
     gboolean spelling;
     /* first word is word[1] */
     GPtrArray *keyword;
+    /* keywords which can start at byte, in order of definition, NULL if there are no ones */
+    syntax_keyword_candidate_t *keyword_index[256];
 } context_rule_t;
 
 typedef struct
@@ -125,10 +152,31 @@ typedef struct
     edit_syntax_rule_t rule;
 } syntax_marker_t;
 
+typedef struct
+{
+    char *path;
+    time_t mtime;
+    gboolean missing;           /* file wasn't found and the next candidate was read instead */
+} syntax_file_stamp_t;
+
+/* rules of syntax type shared by editors */
+typedef struct
+{
+    GPtrArray *rules;
+    gboolean is_case_insensitive;
+    GPtrArray *files;           /* syntax_file_stamp_t: files which rules were read from */
+    int ref_count;              /* number of editors which use the rules */
+} syntax_definition_t;
+
 /*** file scope variables ************************************************************************/
 
 static char *error_file_name = NULL;
 
+/* syntax type -> syntax_definition_t */
+static GHashTable *syntax_definitions = NULL;
+/* files opened while syntax file is read, NULL if they aren't collected */
+static GPtrArray *syntax_files_read = NULL;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -141,6 +189,9 @@ syntax_keyword_free (gpointer keyword)
     g_free (k->keyword);
     g_free (k->whole_word_chars_left);
     g_free (k->whole_word_chars_right);
+    g_free (k->fg);
+    g_free (k->bg);
+    g_free (k->attrs);
     g_free (k);
 }
 
@@ -150,12 +201,15 @@ static void
 context_rule_free (gpointer rule)
 {
     context_rule_t *r = CONTEXT_RULE (rule);
+    size_t i;
 
     g_free (r->left);
     g_free (r->right);
     g_free (r->whole_word_chars_left);
     g_free (r->whole_word_chars_right);
-    g_free (r->keyword_first_chars);
+
+    for (i = 0; i < G_N_ELEMENTS (r->keyword_index); i++)
+        g_free (r->keyword_index[i]);
 
     if (r->keyword != NULL)
     {
@@ -168,6 +222,141 @@ context_rule_free (gpointer rule)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static void
+syntax_file_stamp_free (gpointer stamp)
+{
+    g_free (((syntax_file_stamp_t *) stamp)->path);
+    g_free (stamp);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Remember file to check whether rules read from it are still actual.
+ * File which can't be opened is remembered too: if it is created later, it shadows the file
+ * which was found further in the search path.
+ */
+
+static void
+syntax_files_add (const char *path, FILE * f)
+{
+    struct stat st;
+    syntax_file_stamp_t *stamp;
+
+    if (syntax_files_read == NULL || path == NULL || (f != NULL && fstat (fileno (f), &st) != 0))
+        return;
+
+    stamp = g_new (syntax_file_stamp_t, 1);
+    stamp->path = g_strdup (path);
+    stamp->mtime = f != NULL ? st.st_mtime : 0;
+    stamp->missing = f == NULL;
+    g_ptr_array_add (syntax_files_read, stamp);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+syntax_definition_free (gpointer definition)
+{
+    syntax_definition_t *def = (syntax_definition_t *) definition;
+
+    g_ptr_array_unref (def->rules);
+    g_ptr_array_free (def->files, TRUE);
+    g_free (def);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find rules of syntax type read before.
+ *
+ * @param type syntax type
+ *
+ * @return definition or NULL if there is no one or any of its files was changed
+ */
+
+static syntax_definition_t *
+syntax_definition_lookup (const char *type)
+{
+    syntax_definition_t *def;
+    guint i;
+
+    if (syntax_definitions == NULL)
+        return NULL;
+
+    def = (syntax_definition_t *) g_hash_table_lookup (syntax_definitions, type);
+    if (def == NULL)
+        return NULL;
+
+    for (i = 0; i < def->files->len; i++)
+    {
+        const syntax_file_stamp_t *stamp;
+        struct stat st;
+
+        stamp = (const syntax_file_stamp_t *) g_ptr_array_index (def->files, i);
+        if (stamp->missing ? stat (stamp->path, &st) == 0
+            : (stat (stamp->path, &st) != 0 || st.st_mtime != stamp->mtime))
+        {
+            /* editors which use old rules keep them */
+            g_hash_table_remove (syntax_definitions, type);
+            return NULL;
+        }
+    }
+
+    return def;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Share rules of editor with other editors which use the same syntax type */
+
+static void
+syntax_definition_add (const char *type, const WEdit * edit)
+{
+    syntax_definition_t *def;
+
+    if (syntax_files_read == NULL)
+        return;
+
+    if (syntax_definitions == NULL)
+        syntax_definitions =
+            g_hash_table_new_full (g_str_hash, g_str_equal, g_free, syntax_definition_free);
+
+    def = g_new (syntax_definition_t, 1);
+    def->rules = g_ptr_array_ref (edit->rules);
+    def->is_case_insensitive = edit->is_case_insensitive;
+    def->files = syntax_files_read;
+    def->ref_count = 1;
+    syntax_files_read = NULL;
+
+    g_hash_table_replace (syntax_definitions, g_strdup (type), def);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Editor doesn't use rules anymore: forget them if other editors don't use them too */
+
+static void
+syntax_definition_release (const char *type, const GPtrArray * rules)
+{
+    syntax_definition_t *def;
+
+    if (syntax_definitions == NULL || type == NULL)
+        return;
+
+    def = (syntax_definition_t *) g_hash_table_lookup (syntax_definitions, type);
+    if (def != NULL && def->rules == rules)
+    {
+        def->ref_count--;
+        if (def->ref_count == 0)
+            g_hash_table_remove (syntax_definitions, type);
+    }
+
+    if (g_hash_table_size (syntax_definitions) == 0)
+    {
+        g_hash_table_destroy (syntax_definitions);
+        syntax_definitions = NULL;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static gint
 mc_defines_destroy (gpointer key, gpointer value, gpointer data)
 {
@@ -348,13 +537,105 @@ compare_word_to_right (const WEdit * edit, off_t i, const char *text,
 
 /* --------------------------------------------------------------------------------------------- */
 
-static const char *
-xx_strchr (const WEdit * edit, const unsigned char *s, int char_byte)
+/**
+ * Make lists of keywords which can start at every byte, so apply_rules_going_right() doesn't
+ * look through all keywords of context at every byte. Keyword which starts with wildcard
+ * can start at any byte.
+ */
+
+static void
+context_rule_index_keywords (const WEdit * edit, context_rule_t * r)
 {
-    while (*s >= '\005' && xx_tolower (edit, *s) != char_byte)
-        s++;
+    int b;
+
+    for (b = 0; b < 256; b++)
+    {
+        GArray *list;
+        syntax_keyword_candidate_t k;
+        guint j;
+
+        list = g_array_new (FALSE, FALSE, sizeof (syntax_keyword_candidate_t));
+
+        for (j = 1; j < r->keyword->len; j++)
+        {
+            const syntax_keyword_t *keyword = SYNTAX_KEYWORD (g_ptr_array_index (r->keyword, j));
+            const unsigned char *kw = (const unsigned char *) keyword->keyword;
+
+            /* empty keyword hides the next ones */
+            if (kw[0] == '\0')
+                break;
+
+            if (kw[0] < SYNTAX_TOKEN_FIRST_CHAR)
+                k.next = -1;
+            else if (xx_tolower (edit, kw[0]) != b)
+                continue;
+            else
+                k.next = kw[1] < SYNTAX_TOKEN_FIRST_CHAR ? -1 : kw[1];
 
-    return (const char *) s;
+            k.keyword = (int) j;
+            g_array_append_val (list, k);
+        }
+
+        if (list->len == 0)
+            g_array_free (list, TRUE);
+        else
+        {
+            k.keyword = 0;
+            k.next = -1;
+            g_array_append_val (list, k);
+            r->keyword_index[b] = (syntax_keyword_candidate_t *) g_array_free (list, FALSE);
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find the first keyword of context which starts at offset @i.
+ *
+ * @param edit editor object
+ * @param r context
+ * @param i offset
+ * @param c byte at @i
+ * @param end offset after the keyword is returned here
+ *
+ * @return index of keyword or 0 if there is no keyword at @i
+ */
+
+static int
+context_rule_find_keyword (const WEdit * edit, const context_rule_t * r, off_t i, int c,
+                           off_t * end)
+{
+    const syntax_keyword_candidate_t *k;
+    int next = -1;
+
+    k = r->keyword_index[(unsigned char) c];
+    if (k == NULL)
+        return 0;
+
+    for (; k->keyword != 0; k++)
+    {
+        const syntax_keyword_t *kw;
+        off_t e;
+
+        if (k->next >= 0)
+        {
+            if (next < 0)
+                next = xx_tolower (edit, edit_buffer_get_byte (&edit->buffer, i + 1));
+            if (next != k->next)
+                continue;
+        }
+
+        kw = SYNTAX_KEYWORD (g_ptr_array_index (r->keyword, k->keyword));
+        e = compare_word_to_right (edit, i, kw->keyword, kw->whole_word_chars_left,
+                                   kw->whole_word_chars_right, kw->line_start);
+        if (e > 0)
+        {
+            *end = e;
+            return k->keyword;
+        }
+    }
+
+    return 0;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -425,42 +706,30 @@ apply_rules_going_right (WEdit * edit, off_t i)
     /* check to turn on a keyword */
     if (_rule.keyword == 0)
     {
-        const char *p;
+        int count;
+        off_t e;
 
         r = CONTEXT_RULE (g_ptr_array_index (edit->rules, _rule.context));
-        p = r->keyword_first_chars;
+        count = context_rule_find_keyword (edit, r, i, c, &e);
+        if (count != 0)
+        {
+            const syntax_keyword_t *k = SYNTAX_KEYWORD (g_ptr_array_index (r->keyword, count));
 
-        if (p != NULL)
-            while (*(p = xx_strchr (edit, (const unsigned char *) p + 1, c)) != '\0')
+            /* when both context and keyword terminate with a newline,
+               the context overflows to the next line and colorizes it incorrectly */
+            if (e > i + 1 && _rule._context != 0 && k->keyword[strlen (k->keyword) - 1] == '\n')
             {
-                syntax_keyword_t *k;
-                int count;
-                off_t e;
-
-                count = p - r->keyword_first_chars;
-                k = SYNTAX_KEYWORD (g_ptr_array_index (r->keyword, count));
-                e = compare_word_to_right (edit, i, k->keyword, k->whole_word_chars_left,
-                                           k->whole_word_chars_right, k->line_start);
-                if (e > 0)
-                {
-                    /* when both context and keyword terminate with a newline,
-                       the context overflows to the next line and colorizes it incorrectly */
-                    if (e > i + 1 && _rule._context != 0
-                        && k->keyword[strlen (k->keyword) - 1] == '\n')
-                    {
-                        r = CONTEXT_RULE (g_ptr_array_index (edit->rules, _rule._context));
-                        if (r->right != NULL && r->right[0] != '\0'
-                            && r->right[strlen (r->right) - 1] == '\n')
-                            e--;
-                    }
-
-                    end = e;
-                    _rule.end = e;
-                    _rule.keyword = count;
-                    keyword_foundright = TRUE;
-                    break;
-                }
+                r = CONTEXT_RULE (g_ptr_array_index (edit->rules, _rule._context));
+                if (r->right != NULL && r->right[0] != '\0'
+                    && r->right[strlen (r->right) - 1] == '\n')
+                    e--;
             }
+
+            end = e;
+            _rule.end = e;
+            _rule.keyword = count;
+            keyword_foundright = TRUE;
+        }
     }
 
     /* check to turn on a context */
@@ -538,27 +807,15 @@ apply_rules_going_right (WEdit * edit, off_t i)
     /* check again to turn on a keyword if the context switched */
     if (contextchanged && _rule.keyword == 0)
     {
-        const char *p;
+        int count;
+        off_t e;
 
         r = CONTEXT_RULE (g_ptr_array_index (edit->rules, _rule.context));
-        p = r->keyword_first_chars;
-
-        while (*(p = xx_strchr (edit, (const unsigned char *) p + 1, c)) != '\0')
+        count = context_rule_find_keyword (edit, r, i, c, &e);
+        if (count != 0)
         {
-            syntax_keyword_t *k;
-            int count;
-            off_t e;
-
-            count = p - r->keyword_first_chars;
-            k = SYNTAX_KEYWORD (g_ptr_array_index (r->keyword, count));
-            e = compare_word_to_right (edit, i, k->keyword, k->whole_word_chars_left,
-                                       k->whole_word_chars_right, k->line_start);
-            if (e > 0)
-            {
-                _rule.end = e;
-                _rule.keyword = count;
-                break;
-            }
+            _rule.end = e;
+            _rule.keyword = count;
         }
     }
 
@@ -567,61 +824,179 @@ apply_rules_going_right (WEdit * edit, off_t i)
 
 /* --------------------------------------------------------------------------------------------- */
 
-static void
-edit_get_rule (WEdit * edit, off_t byte_index)
+/**
+ * Count markers before or at @offset.
+ */
+
+static guint
+edit_syntax_count_markers (const WEdit * edit, off_t offset)
 {
-    off_t i;
+    guint lo = 0, hi;
+
+    if (edit->syntax_marker == NULL)
+        return 0;
+
+    hi = edit->syntax_marker->len;
 
-    if (byte_index > edit->last_get_rule)
+    /* markers are sorted by offset: find the first one after @offset */
+    while (lo < hi)
     {
-        for (i = edit->last_get_rule + 1; i <= byte_index; i++)
-        {
-            off_t d = SYNTAX_MARKER_DENSITY;
+        const guint mid = lo + (hi - lo) / 2;
 
-            apply_rules_going_right (edit, i);
+        if (g_array_index (edit->syntax_marker, syntax_marker_t, mid).offset <= offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
 
-            if (edit->syntax_marker != NULL)
-                d += ((syntax_marker_t *) edit->syntax_marker->data)->offset;
+    return lo;
+}
 
-            if (i > d)
-            {
-                syntax_marker_t *s;
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find the last marker before or at @offset.
+ *
+ * @return marker or NULL if there are no markers there
+ */
 
-                s = g_new (syntax_marker_t, 1);
-                s->offset = i;
-                s->rule = edit->rule;
-                edit->syntax_marker = g_slist_prepend (edit->syntax_marker, s);
-            }
-        }
+static const syntax_marker_t *
+edit_syntax_find_marker (const WEdit * edit, off_t offset)
+{
+    const guint n = edit_syntax_count_markers (edit, offset);
+
+    return n == 0 ? NULL : &g_array_index (edit->syntax_marker, syntax_marker_t, n - 1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static off_t
+edit_syntax_last_marker_offset (const WEdit * edit)
+{
+    const GArray *markers = edit->syntax_marker;
+
+    if (markers == NULL || markers->len == 0)
+        return -1;
+
+    return g_array_index (markers, syntax_marker_t, markers->len - 1).offset;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+edit_syntax_add_marker (WEdit * edit, off_t offset)
+{
+    syntax_marker_t s;
+
+    if (edit->syntax_marker == NULL)
+        edit->syntax_marker = g_array_new (FALSE, FALSE, sizeof (syntax_marker_t));
+
+    s.offset = offset;
+    s.rule = edit->rule;
+    g_array_append_val (edit->syntax_marker, s);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Set edit->rule to the rule of marker.
+ *
+ * @param m marker or NULL for the rule at the beginning of file (offset -1)
+ */
+
+static void
+edit_syntax_start (WEdit * edit, const syntax_marker_t * m)
+{
+    edit->rule_is_guess = FALSE;
+
+    if (m != NULL)
+        edit->rule = m->rule;
+    else
+    {
+        memset (&edit->rule, 0, sizeof (edit->rule));
+        apply_rules_going_right (edit, -1);
     }
-    else if (byte_index < edit->last_get_rule)
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Move edit->rule from offset @from to offset @to, leaving markers behind if rule is exact */
+
+static void
+edit_syntax_go_right (WEdit * edit, off_t from, off_t to)
+{
+    off_t i;
+
+    for (i = from + 1; i <= to; i++)
     {
-        while (TRUE)
-        {
-            syntax_marker_t *s;
+        apply_rules_going_right (edit, i);
 
-            if (edit->syntax_marker == NULL)
-            {
-                memset (&edit->rule, 0, sizeof (edit->rule));
-                for (i = -1; i <= byte_index; i++)
-                    apply_rules_going_right (edit, i);
-                break;
-            }
+        if (!edit->rule_is_guess
+            && i > MAX (edit_syntax_last_marker_offset (edit), 0) + SYNTAX_MARKER_DENSITY)
+            edit_syntax_add_marker (edit, i);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get offset up to which syntax rules are found in the idle time: SYNTAX_IDLE_AHEAD bytes after
+ * the screen.
+ *
+ * @return offset or -1 if syntax highlighting is off
+ */
 
-            s = (syntax_marker_t *) edit->syntax_marker->data;
+static off_t
+edit_syntax_idle_target (const WEdit * edit)
+{
+    off_t target;
 
-            if (byte_index >= s->offset)
-            {
-                edit->rule = s->rule;
-                for (i = s->offset + 1; i <= byte_index; i++)
-                    apply_rules_going_right (edit, i);
-                break;
-            }
+    if (edit->rules == NULL || !option_syntax_highlighting || !tty_use_colors ())
+        return -1;
 
-            g_free (s);
-            edit->syntax_marker = g_slist_delete_link (edit->syntax_marker, edit->syntax_marker);
-        }
+    target = edit_buffer_get_forward_offset (&edit->buffer, edit->start_display,
+                                             WIDGET (edit)->lines, 0) + SYNTAX_IDLE_AHEAD;
+
+    return MIN (target, edit->buffer.size - 1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Set edit->rule to the rule at @byte_index.
+ *
+ * Rules are found going right from the previous request or from the nearest marker before
+ * @byte_index. Markers are kept in array sorted by offset every SYNTAX_MARKER_DENSITY bytes and
+ * are valid until the text before them is changed.
+ *
+ * If there is no marker nearer than SYNTAX_GUESS_DISTANCE, the rule is guessed from the
+ * beginning of some line above: jump to the end of large file doesn't look through the whole
+ * text. Exact rules are found in the idle time then (see edit_syntax_idle()).
+ */
+
+static void
+edit_get_rule (WEdit * edit, off_t byte_index)
+{
+    const syntax_marker_t *m;
+    off_t known;
+
+    m = edit_syntax_find_marker (edit, byte_index);
+    known = m == NULL ? -1 : m->offset;
+
+    if (byte_index >= edit->last_get_rule && edit->last_get_rule >= known
+        && (!edit->rule_is_guess || byte_index - known > SYNTAX_GUESS_DISTANCE))
+        edit_syntax_go_right (edit, edit->last_get_rule, byte_index);
+    else if (byte_index - known <= SYNTAX_GUESS_DISTANCE)
+    {
+        edit_syntax_start (edit, m);
+        edit_syntax_go_right (edit, known, byte_index);
+    }
+    else
+    {
+        off_t from;
+
+        from = edit_buffer_get_bol (&edit->buffer, byte_index - SYNTAX_GUESS_BACK) - 1;
+        memset (&edit->rule, 0, sizeof (edit->rule));
+        edit->rule_is_guess = TRUE;
+        apply_rules_going_right (edit, from);
+        edit_syntax_go_right (edit, from, byte_index);
     }
+
     edit->last_get_rule = byte_index;
 }
 
@@ -871,6 +1246,42 @@ this_try_alloc_color_pair (const char *fg, const char *bg, const char *attrs)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static void
+syntax_keyword_set_color (syntax_keyword_t * k, const char *fg, const char *bg, const char *attrs)
+{
+    k->fg = g_strdup (fg);
+    k->bg = g_strdup (bg);
+    k->attrs = g_strdup (attrs);
+    k->color = this_try_alloc_color_pair (fg, bg, attrs);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Allocate colors of shared rules again: temporary colors could be freed and their numbers
+ * reused since the rules were read (e.g. skin was changed).
+ */
+
+static void
+context_rules_alloc_colors (GPtrArray * rules)
+{
+    guint i;
+
+    for (i = 0; i < rules->len; i++)
+    {
+        const context_rule_t *r = CONTEXT_RULE (g_ptr_array_index (rules, i));
+        guint j;
+
+        for (j = 0; j < r->keyword->len; j++)
+        {
+            syntax_keyword_t *k = SYNTAX_KEYWORD (g_ptr_array_index (r->keyword, j));
+
+            k->color = this_try_alloc_color_pair (k->fg, k->bg, k->attrs);
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static FILE *
 open_include_file (const char *filename)
 {
@@ -879,26 +1290,36 @@ open_include_file (const char *filename)
     g_free (error_file_name);
     error_file_name = g_strdup (filename);
     if (g_path_is_absolute (filename))
-        return fopen (filename, "r");
+        f = fopen (filename, "r");
+    else
+    {
+        g_free (error_file_name);
+        error_file_name =
+            g_build_filename (mc_config_get_data_path (), EDIT_HOME_DIR, filename, (char *) NULL);
+        f = fopen (error_file_name, "r");
+    }
 
-    g_free (error_file_name);
-    error_file_name =
-        g_build_filename (mc_config_get_data_path (), EDIT_HOME_DIR, filename, (char *) NULL);
-    f = fopen (error_file_name, "r");
-    if (f != NULL)
-        return f;
+    if (f == NULL && !g_path_is_absolute (filename))
+    {
+        syntax_files_add (error_file_name, NULL);
+        g_free (error_file_name);
+        error_file_name =
+            g_build_filename (mc_global.sysconfig_dir, "syntax", filename, (char *) NULL);
+        f = fopen (error_file_name, "r");
+    }
 
-    g_free (error_file_name);
-    error_file_name = g_build_filename (mc_global.sysconfig_dir, "syntax", filename, (char *) NULL);
-    f = fopen (error_file_name, "r");
-    if (f != NULL)
-        return f;
+    if (f == NULL && !g_path_is_absolute (filename))
+    {
+        syntax_files_add (error_file_name, NULL);
+        g_free (error_file_name);
+        error_file_name =
+            g_build_filename (mc_global.share_data_dir, "syntax", filename, (char *) NULL);
+        f = fopen (error_file_name, "r");
+    }
 
-    g_free (error_file_name);
-    error_file_name =
-        g_build_filename (mc_global.share_data_dir, "syntax", filename, (char *) NULL);
+    syntax_files_add (error_file_name, f);
 
-    return fopen (error_file_name, "r");
+    return f;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -938,7 +1359,7 @@ edit_read_syntax_rules (WEdit * edit, FILE * f, char **args, int args_size)
     strcpy (whole_left, "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_01234567890");
     strcpy (whole_right, "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_01234567890");
 
-    edit->rules = g_ptr_array_new ();
+    edit->rules = g_ptr_array_new_with_free_func (context_rule_free);
 
     if (edit->defines == NULL)
         edit->defines = g_tree_new ((GCompareFunc) strcmp);
@@ -1101,7 +1522,7 @@ edit_read_syntax_rules (WEdit * edit, FILE * f, char **args, int args_size)
             g_strlcpy (last_fg, fg != NULL ? fg : "", sizeof (last_fg));
             g_strlcpy (last_bg, bg != NULL ? bg : "", sizeof (last_bg));
             g_strlcpy (last_attrs, attrs != NULL ? attrs : "", sizeof (last_attrs));
-            k->color = this_try_alloc_color_pair (fg, bg, attrs);
+            syntax_keyword_set_color (k, fg, bg, attrs);
             k->keyword = g_strdup (" ");
             check_not_a;
         }
@@ -1168,7 +1589,7 @@ edit_read_syntax_rules (WEdit * edit, FILE * f, char **args, int args_size)
                 bg = last_bg;
             if (attrs == NULL)
                 attrs = last_attrs;
-            k->color = this_try_alloc_color_pair (fg, bg, attrs);
+            syntax_keyword_set_color (k, fg, bg, attrs);
             check_not_a;
         }
         else if (*(args[0]) == '#')
@@ -1216,34 +1637,12 @@ edit_read_syntax_rules (WEdit * edit, FILE * f, char **args, int args_size)
     if (result == 0)
     {
         size_t i;
-        GString *first_chars;
 
         if (edit->rules == NULL)
             return line;
 
-        first_chars = g_string_sized_new (32);
-
-        /* collect first character of keywords */
         for (i = 0; i < edit->rules->len; i++)
-        {
-            size_t j;
-
-            g_string_set_size (first_chars, 0);
-            c = CONTEXT_RULE (g_ptr_array_index (edit->rules, i));
-
-            g_string_append_c (first_chars, (char) 1);
-            for (j = 1; j < c->keyword->len; j++)
-            {
-                syntax_keyword_t *k;
-
-                k = SYNTAX_KEYWORD (g_ptr_array_index (c->keyword, j));
-                g_string_append_c (first_chars, k->keyword[0]);
-            }
-
-            c->keyword_first_chars = g_strndup (first_chars->str, first_chars->len);
-        }
-
-        g_string_free (first_chars, TRUE);
+            context_rule_index_keywords (edit, CONTEXT_RULE (g_ptr_array_index (edit->rules, i)));
     }
 
     return result;
@@ -1260,19 +1659,33 @@ edit_read_syntax_file (WEdit * edit, GPtrArray * pnames, const char *syntax_file
     char *args[ARGS_LEN], *l = NULL;
     long line = 0;
     int result = 0;
-    char *lib_file;
+    char *lib_file = NULL;
     gboolean found = FALSE;
+    /* rules read after global include can depend on it: don't share them */
+    gboolean global_include = FALSE;
 
     f = fopen (syntax_file, "r");
     if (f == NULL)
     {
         lib_file = g_build_filename (mc_global.share_data_dir, "syntax", "Syntax", (char *) NULL);
         f = fopen (lib_file, "r");
-        g_free (lib_file);
         if (f == NULL)
+        {
+            g_free (lib_file);
             return -1;
+        }
     }
 
+    if (pnames == NULL)
+    {
+        /* collect files which rules are read from */
+        syntax_files_read = g_ptr_array_new_with_free_func (syntax_file_stamp_free);
+        if (lib_file != NULL)
+            syntax_files_add (syntax_file, NULL);
+        syntax_files_add (lib_file != NULL ? lib_file : syntax_file, f);
+    }
+    g_free (lib_file);
+
     args[0] = NULL;
     while (TRUE)
     {
@@ -1295,6 +1708,7 @@ edit_read_syntax_file (WEdit * edit, GPtrArray * pnames, const char *syntax_file
                 result = line;
                 break;
             }
+            global_include = TRUE;
             goto found_type;
         }
 
@@ -1338,9 +1752,24 @@ edit_read_syntax_file (WEdit * edit, GPtrArray * pnames, const char *syntax_file
             {
                 int line_error;
                 char *syntax_type;
+                syntax_definition_t *def;
 
               found_type:
                 syntax_type = args[2];
+
+                if (g == NULL && !global_include
+                    && (def = syntax_definition_lookup (syntax_type)) != NULL)
+                {
+                    /* rules were read by another editor: don't parse them again */
+                    def->ref_count++;
+                    context_rules_alloc_colors (def->rules);
+                    edit->rules = g_ptr_array_ref (def->rules);
+                    edit->is_case_insensitive = def->is_case_insensitive;
+                    g_free (edit->syntax_type);
+                    edit->syntax_type = g_strdup (syntax_type);
+                    break;
+                }
+
                 line_error = edit_read_syntax_rules (edit, g ? g : f, args, ARGS_LEN - 1);
                 if (line_error != 0)
                 {
@@ -1365,6 +1794,9 @@ edit_read_syntax_file (WEdit * edit, GPtrArray * pnames, const char *syntax_file
                             break;
                         }
                     }
+
+                    if (g == NULL && !global_include)
+                        syntax_definition_add (syntax_type, edit);
                 }
 
                 if (g == NULL)
@@ -1377,6 +1809,13 @@ edit_read_syntax_file (WEdit * edit, GPtrArray * pnames, const char *syntax_file
     }
     g_free (l);
     fclose (f);
+
+    if (syntax_files_read != NULL)
+    {
+        g_ptr_array_free (syntax_files_read, TRUE);
+        syntax_files_read = NULL;
+    }
+
     return result;
 }
 
@@ -1428,6 +1867,95 @@ edit_get_syntax_color (WEdit * edit, off_t byte_index)
     return EDITOR_NORMAL_COLOR;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Forget syntax rules which can be changed by modification of text.
+ *
+ * @param edit editor object
+ * @param offset offset of inserted or deleted byte
+ */
+
+void
+edit_syntax_invalidate (WEdit * edit, off_t offset)
+{
+    if (edit->rules == NULL)
+        return;
+
+    /* keyword found at the end of previous line can look through the line break */
+    offset = edit_buffer_get_backward_offset (&edit->buffer, offset, 1);
+
+    if (edit->syntax_marker != NULL)
+        g_array_set_size (edit->syntax_marker, edit_syntax_count_markers (edit, offset - 1));
+
+    if (edit->last_get_rule >= offset)
+        edit->last_get_rule = SYNTAX_RULE_UNKNOWN;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Check whether syntax rules ahead of the screen are not found yet.
+ *
+ * @param edit editor object
+ *
+ * @return TRUE if edit_syntax_idle() has something to do
+ */
+
+gboolean
+edit_syntax_idle_pending (const WEdit * edit)
+{
+    return edit_syntax_idle_target (edit) > edit_syntax_last_marker_offset (edit);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find syntax rules ahead of the screen in the idle time, SYNTAX_IDLE_CHUNK bytes at once.
+ * If the screen was drawn with guessed rules and exact ones are found now, the screen is redrawn.
+ *
+ * @param edit editor object
+ *
+ * @return TRUE if there is more work
+ */
+
+gboolean
+edit_syntax_idle (WEdit * edit)
+{
+    off_t target, from, to;
+    edit_syntax_rule_t rule;
+    off_t last_get_rule;
+    gboolean guess;
+
+    target = edit_syntax_idle_target (edit);
+    from = edit_syntax_last_marker_offset (edit);
+    if (target <= from)
+        return FALSE;
+
+    /* keep the rule of the last request */
+    rule = edit->rule;
+    last_get_rule = edit->last_get_rule;
+    guess = edit->rule_is_guess;
+
+    to = MIN (target, from + SYNTAX_IDLE_CHUNK);
+    edit_syntax_start (edit, edit_syntax_find_marker (edit, from));
+    edit_syntax_go_right (edit, from, to);
+    if (to > edit_syntax_last_marker_offset (edit))
+        edit_syntax_add_marker (edit, to);
+
+    if (guess && to + SYNTAX_GUESS_DISTANCE >= edit->start_display)
+    {
+        /* screen can be drawn with exact rules now */
+        edit->last_get_rule = SYNTAX_RULE_UNKNOWN;
+        edit->force |= REDRAW_PAGE;
+    }
+    else
+    {
+        edit->rule = rule;
+        edit->last_get_rule = last_get_rule;
+        edit->rule_is_guess = guess;
+    }
+
+    return to < target;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 void
@@ -1443,13 +1971,20 @@ edit_free_syntax_rules (WEdit * edit)
         return;
 
     edit_get_rule (edit, -1);
+    syntax_definition_release (edit->syntax_type, edit->rules);
     MC_PTR_FREE (edit->syntax_type);
 
-    g_ptr_array_foreach (edit->rules, (GFunc) context_rule_free, NULL);
-    g_ptr_array_free (edit->rules, TRUE);
+    g_ptr_array_unref (edit->rules);
     edit->rules = NULL;
-    g_clear_slist (&edit->syntax_marker, g_free);
-    tty_color_free_all_tmp ();
+    if (edit->syntax_marker != NULL)
+    {
+        g_array_free (edit->syntax_marker, TRUE);
+        edit->syntax_marker = NULL;
+    }
+
+    /* colors of rules are not used anymore if no one editor has rules */
+    if (syntax_definitions == NULL)
+        tty_color_free_all_tmp ();
 }
 
 /* --------------------------------------------------------------------------------------------- */
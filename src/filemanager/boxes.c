@@ -699,7 +699,8 @@ panel_options_box (void)
                     QUICK_CHECKBOX (N_("Simple s&wap"), &simple_swap, NULL),
                     QUICK_CHECKBOX (N_("A&uto save panels setup"), &panels_options.auto_save_setup,
                                     NULL),
-                    QUICK_SEPARATOR (FALSE),
+                    QUICK_CHECKBOX (N_("Progressive &loading"), &panels_options.progressive_load,
+                                    NULL),
                     QUICK_SEPARATOR (FALSE),
                     QUICK_SEPARATOR (FALSE),
                 QUICK_STOP_GROUPBOX,
@@ -62,6 +62,7 @@
 #include "lib/widget.h"
 #include "lib/keybind.h"        /* CK_Down, CK_History */
 #include "lib/event.h"          /* mc_event_raise() */
+#include "lib/search.h"         /* mc_search_get_types_strings_array() */
 
 #include "src/setup.h"
 #include "src/execute.h"        /* toggle_panels() */
@@ -82,6 +83,8 @@
 #include "fileopctx.h"
 #include "file.h"               /* file operation routines */
 #include "filenot.h"
+#include "filegui.h"            /* file_op_context_create_ui() */
+#include "filereplace.h"        /* file_replace() */
 #include "hotlist.h"            /* hotlist_show() */
 #include "panel.h"              /* WPanel */
 #include "tree.h"               /* tree_chdir() */
@@ -113,8 +116,25 @@ enum CompareMode
     compare_thourough
 };
 
+/* progress window of replace in files */
+typedef struct
+{
+    file_op_context_t *ctx;
+    file_op_total_context_t *tctx;
+} replace_in_files_progress_t;
+
 /*** file scope variables ************************************************************************/
 
+/* options of replace in files are kept during session */
+static struct
+{
+    mc_search_type_t type;
+    gboolean case_sens;
+    gboolean whole_words;
+} replace_in_files_options = {
+    MC_SEARCH_T_NORMAL, TRUE, FALSE
+};
+
 #ifdef ENABLE_VFS_NET
 static const char *machine_str = N_("Enter machine name (F1 for details):");
 #endif /* ENABLE_VFS_NET */
@@ -514,6 +534,154 @@ switch_to_listing (int panel_index)
         create_panel (panel_index, view_listing);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Collect full paths of marked files (or the current file if nothing is marked).
+ * Directories are skipped.
+ *
+ * @return array of paths or NULL if there are non-local files
+ */
+
+static GPtrArray *
+replace_in_files_collect (const WPanel * panel, uintmax_t * total)
+{
+    GPtrArray *paths;
+    int i;
+
+    paths = g_ptr_array_new_with_free_func (g_free);
+    *total = 0;
+
+    for (i = 0; i < panel->dir.len; i++)
+    {
+        const file_entry_t *fe = &panel->dir.list[i];
+        vfs_path_t *vpath;
+
+        if (panel->marked != 0 ? !fe->f.marked : i != panel->selected)
+            continue;
+
+        if (S_ISDIR (fe->st.st_mode) || fe->f.link_to_dir)
+            continue;
+
+        /* panelized panel can contain absolute paths */
+        if (IS_PATH_SEP (fe->fname[0]))
+            vpath = vfs_path_from_str (fe->fname);
+        else
+            vpath = vfs_path_append_new (panel->cwd_vpath, fe->fname, (char *) NULL);
+
+        if (!vfs_file_is_local (vpath))
+        {
+            vfs_path_free (vpath);
+            g_ptr_array_free (paths, TRUE);
+            return NULL;
+        }
+
+        g_ptr_array_add (paths, g_strdup (vfs_path_get_last_path_str (vpath)));
+        *total += (uintmax_t) fe->st.st_size;
+        vfs_path_free (vpath);
+    }
+
+    return paths;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static FileProgressStatus
+replace_in_files_update_cb (const file_replace_status_t * status, void *data)
+{
+    replace_in_files_progress_t *progress = (replace_in_files_progress_t *) data;
+    file_op_context_t *ctx = progress->ctx;
+    file_op_total_context_t *tctx = progress->tctx;
+    struct timeval tv_current;
+    long dt;
+    char msg[BUF_SMALL];
+
+    if (status->current != NULL)
+    {
+        vfs_path_t *vpath;
+
+        vpath = vfs_path_from_str (status->current);
+        file_progress_show_source (ctx, vpath);
+        vfs_path_free (vpath);
+    }
+
+    gettimeofday (&tv_current, NULL);
+    dt = tv_current.tv_sec - tctx->transfer_start.tv_sec;
+
+    tctx->progress_count = status->files_done;
+    tctx->copied_bytes = status->bytes_done;
+    if (dt > 0)
+    {
+        tctx->bps = status->bytes_done / dt;
+        ctx->bps = (long) tctx->bps;
+        if (tctx->bps != 0 && ctx->progress_bytes > status->bytes_done)
+            ctx->eta_secs = tctx->eta_secs =
+                (double) (ctx->progress_bytes - status->bytes_done) / tctx->bps;
+        else
+            ctx->eta_secs = tctx->eta_secs = 0;
+    }
+
+    g_snprintf (msg, sizeof (msg), _("Replaced: %zu in %zu files"), status->replaced,
+                status->files_changed);
+    file_progress_show (ctx, status->bytes_done, ctx->progress_bytes, msg, TRUE);
+    file_progress_show_count (ctx, status->files_done, ctx->progress_count);
+    file_progress_show_total (tctx, ctx, status->bytes_done, TRUE);
+    mc_refresh ();
+
+    return check_progress_buttons (ctx);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+replace_in_files_dialog (char **search_text, char **replace_text)
+{
+    size_t num_of_types = 0;
+    gchar **list_of_types;
+    int ret;
+
+    list_of_types = mc_search_get_types_strings_array (&num_of_types);
+
+    {
+        quick_widget_t quick_widgets[] = {
+            /* *INDENT-OFF* */
+            QUICK_LABELED_INPUT (N_("Enter search string:"), input_label_above, INPUT_LAST_TEXT,
+                                 MC_HISTORY_SHARED_SEARCH, search_text, NULL, FALSE, FALSE,
+                                 INPUT_COMPLETE_NONE),
+            QUICK_LABELED_INPUT (N_("Enter replacement string:"), input_label_above,
+                                 INPUT_LAST_TEXT, "replace", replace_text, NULL, FALSE, FALSE,
+                                 INPUT_COMPLETE_NONE),
+            QUICK_SEPARATOR (TRUE),
+            QUICK_START_COLUMNS,
+                QUICK_RADIO (num_of_types, (const char **) list_of_types,
+                             (int *) &replace_in_files_options.type, NULL),
+            QUICK_NEXT_COLUMN,
+                QUICK_CHECKBOX (N_("Cas&e sensitive"), &replace_in_files_options.case_sens, NULL),
+                QUICK_CHECKBOX (N_("&Whole words"), &replace_in_files_options.whole_words, NULL),
+            QUICK_STOP_COLUMNS,
+            QUICK_BUTTONS_OK_CANCEL,
+            QUICK_END
+            /* *INDENT-ON* */
+        };
+
+        quick_dialog_t qdlg = {
+            -1, -1, 58,
+            N_("Replace in files"), "[Input Line Keys]",
+            quick_widgets, NULL, NULL
+        };
+
+        ret = quick_dialog (&qdlg);
+    }
+
+    g_strfreev (list_of_types);
+
+    if (ret != B_CANCEL && *search_text != NULL && **search_text != '\0')
+        return TRUE;
+
+    MC_PTR_FREE (*search_text);
+    MC_PTR_FREE (*replace_text);
+    return FALSE;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -1161,6 +1329,89 @@ compare_dirs_cmd (void)
                  _("Both panels should be in the listing mode\nto use this command"));
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Replace text in marked files of the current panel. Works in panelized panel too, so the
+ * results of find file can be processed at once.
+ */
+
+void
+replace_in_files_cmd (void)
+{
+    WPanel *panel = current_panel;
+    GPtrArray *paths;
+    uintmax_t total;
+    char *search_text = NULL, *replace_text = NULL;
+    file_replace_options_t options;
+    file_replace_status_t status;
+    replace_in_files_progress_t progress;
+    FileProgressStatus ret;
+
+    if (get_current_type () != view_listing || panel->dir.len == 0)
+        return;
+
+    paths = replace_in_files_collect (panel, &total);
+    if (paths == NULL)
+    {
+        message (D_ERROR, MSG_ERROR, _("Replace in files works with local files only"));
+        return;
+    }
+
+    if (paths->len == 0)
+    {
+        message (D_ERROR, MSG_ERROR, _("No files to replace in"));
+        g_ptr_array_free (paths, TRUE);
+        return;
+    }
+
+    if (!replace_in_files_dialog (&search_text, &replace_text))
+    {
+        g_ptr_array_free (paths, TRUE);
+        return;
+    }
+
+    options.search = search_text;
+    options.replace = replace_text;
+    options.type = replace_in_files_options.type;
+    options.case_sens = replace_in_files_options.case_sens;
+    options.whole_words = replace_in_files_options.whole_words;
+
+    file_op_names_init ();
+    progress.ctx = file_op_context_new (OP_REPLACE);
+    progress.ctx->progress_count = paths->len;
+    progress.ctx->progress_bytes = total;
+    progress.ctx->progress_totals_computed = TRUE;
+    progress.tctx = file_op_total_context_new ();
+    gettimeofday (&progress.tctx->transfer_start, NULL);
+    file_op_context_create_ui (progress.ctx, TRUE, FILEGUI_DIALOG_MULTI_ITEM);
+
+    ret = file_replace (paths, &options, &status, replace_in_files_update_cb, &progress);
+
+    file_op_context_destroy_ui (progress.ctx);
+    file_op_total_context_destroy (progress.tctx);
+    file_op_context_destroy (progress.ctx);
+
+    if (ret == FILE_ABORT && status.files_done == 0 && status.error != NULL)
+        message (D_ERROR, MSG_ERROR, "%s", status.error);
+    else if (status.errors != 0)
+        message (D_ERROR, MSG_ERROR,
+                 _("Replaced %zu occurrences in %zu files.\n"
+                   "%zu files were not processed:\n%s"), status.replaced, status.files_changed,
+                 status.errors, status.error != NULL ? status.error : "");
+    else
+        message (D_NORMAL, _("Replace in files"), _("Replaced %zu occurrences in %zu files."),
+                 status.replaced, status.files_changed);
+
+    file_replace_status_free (&status);
+    g_ptr_array_free (paths, TRUE);
+    g_free (search_text);
+    g_free (replace_text);
+
+    if (status.files_changed != 0)
+        update_panels (UP_OPTIMIZE, UP_KEEPSEL);
+    repaint_screen ();
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 #ifdef USE_DIFF_VIEW
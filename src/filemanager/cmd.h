@@ -72,6 +72,7 @@ void edit_mc_menu_cmd (void);
 void edit_fhl_cmd (void);
 void hotlist_cmd (void);
 void compare_dirs_cmd (void);
+void replace_in_files_cmd (void);
 #ifdef USE_DIFF_VIEW
 void diff_view_cmd (void);
 #endif
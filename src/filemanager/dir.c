@@ -34,6 +34,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #include "lib/global.h"
 #include "lib/tty/tty.h"
@@ -42,6 +43,7 @@
 #include "lib/fs.h"
 #include "lib/strutil.h"
 #include "lib/util.h"
+#include "lib/parallel.h"
 
 #include "src/setup.h"          /* panels_options */
 
@@ -58,8 +60,74 @@
         ? 1 \
         : ( (S_ISDIR (x->st.st_mode) || link_isdir (x)) ? 2 : 0) )
 
+/* how often the UI is kept alive while entries are stat'ed in worker threads */
+#define DIR_STAT_POLL_USEC (G_USEC_PER_SEC / 20)
+
+/* number of entries read by streaming loader at once */
+#define DIR_LIST_STREAM_CHUNK 1024
+
+/* don't split sorting of less entries than this into jobs */
+#define DIR_SORT_MIN_CHUNK 2048
+
 /*** file scope type declarations ****************************************************************/
 
+#ifdef HAVE_FSTATAT
+/* entries [first; first + count) of the list are stat'ed by jobs */
+typedef struct
+{
+    int dir_fd;
+    file_entry_t *list;
+    int first;
+    int count;
+    guint jobs;
+} dir_stat_job_t;
+#endif
+
+/* which key is packed into dir_sort_rec_t::prefix */
+typedef enum
+{
+    DIR_SORT_PREFIX_NONE = 0,
+    DIR_SORT_PREFIX_NAME,       /* sort_key, files started with dot are on top */
+    DIR_SORT_PREFIX_EXT         /* second_sort_key */
+} dir_sort_prefix_t;
+
+/* sort record of one list entry */
+typedef struct
+{
+    guint64 prefix;             /* first bytes of primary key, compared as unsigned big-endian */
+    int index;                  /* index of entry in the list */
+    int group;                  /* MY_ISDIR() of entry */
+} dir_sort_rec_t;
+
+/* state of dir_list_sort_entries() shared by jobs */
+typedef struct
+{
+    file_entry_t *list;
+    int len;
+    GCompareFunc sort;
+    gboolean make_key;          /* create sort_key of all entries */
+    gboolean make_second_key;   /* create second_sort_key of all entries */
+    dir_sort_prefix_t prefix;
+    dir_sort_rec_t *src;        /* sorted runs */
+    dir_sort_rec_t *dst;        /* merged runs */
+    int *bounds;                /* run i is [bounds[i]; bounds[i + 1]) */
+    guint runs;
+} dir_sort_t;
+
+/* streaming directory loader, see dir_list_load_start() */
+struct dir_list_loader_t
+{
+    dir_list *list;             /* sorted entries which are shown already */
+    dir_list pending;           /* entries which are read but not merged into list yet */
+    DIR *dirp;
+    vfs_path_t *vpath;
+    GCompareFunc sort;
+    dir_sort_options_t sort_op;
+    char *fltr;
+    gboolean eof;
+    gboolean ok;
+};
+
 /*** file scope variables ************************************************************************/
 
 /* Reverse flag */
@@ -116,6 +184,16 @@ key_collate (const char *t1, const char *t2)
     return ret;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+set_sort_options (const dir_sort_options_t * sort_op)
+{
+    reverse = sort_op->reverse ? -1 : 1;
+    case_sensitive = sort_op->case_sensitive ? 1 : 0;
+    exec_first = sort_op->exec_first;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * clear keys, should be call after sorting is finished.
@@ -138,9 +216,252 @@ clean_sort_keys (dir_list * list, int start, int count)
     }
 }
 
+/* --------------------------------------------------------------------------------------------- */
+
+static guint64
+dir_sort_key_prefix (const char *key)
+{
+    guint64 prefix = 0;
+    int i;
+
+    for (i = 0; i < 8; i++)
+    {
+        prefix <<= 8;
+        if (key[0] != '\0')
+            prefix |= (unsigned char) *key++;
+    }
+
+    return prefix;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
- * If you change handle_dirent then check also handle_path.
+ * Compare two sort records. Gives the same order as dir_sort_t::sort for the entries,
+ * but in most cases without looking into entries.
+ */
+
+static int
+dir_sort_rec_compare (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+    const dir_sort_rec_t *ra = (const dir_sort_rec_t *) a;
+    const dir_sort_rec_t *rb = (const dir_sort_rec_t *) b;
+    const dir_sort_t *ds = (const dir_sort_t *) user_data;
+
+    if (ra->group != rb->group && !panels_options.mix_all_files)
+        return rb->group - ra->group;
+
+    if (ra->prefix != rb->prefix)
+    {
+        if (ds->prefix == DIR_SORT_PREFIX_NAME)
+        {
+            gboolean adot = (ra->prefix >> 56) == '.';
+            gboolean bdot = (rb->prefix >> 56) == '.';
+
+            /* see key_collate() */
+            if (adot != bdot)
+                return adot ? -1 : 1;
+        }
+
+        return (ra->prefix < rb->prefix ? -1 : 1) * reverse;
+    }
+
+    return ds->sort (&ds->list[ra->index], &ds->list[rb->index]);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Create keys and sort records of entries and sort them within a run.
+ */
+
+static void
+dir_sort_job (mc_parallel_t * run, guint job, gpointer user_data)
+{
+    dir_sort_t *ds = (dir_sort_t *) user_data;
+    int i;
+
+    for (i = ds->bounds[job]; i < ds->bounds[job + 1]; i++)
+    {
+        file_entry_t *fentry = &ds->list[i];
+        dir_sort_rec_t *rec = &ds->src[i];
+
+        if ((i & 0xff) == 0 && mc_parallel_is_cancelled (run))
+            return;
+
+        if (ds->make_key && fentry->sort_key == NULL)
+            fentry->sort_key = str_create_key_for_filename (fentry->fname, case_sensitive);
+        if (ds->make_second_key && fentry->second_sort_key == NULL)
+            fentry->second_sort_key = str_create_key (extension (fentry->fname), case_sensitive);
+
+        rec->index = i;
+        rec->group = MY_ISDIR (fentry);
+
+        switch (ds->prefix)
+        {
+        case DIR_SORT_PREFIX_NAME:
+            rec->prefix = dir_sort_key_prefix (fentry->sort_key);
+            break;
+        case DIR_SORT_PREFIX_EXT:
+            rec->prefix = dir_sort_key_prefix (fentry->second_sort_key);
+            break;
+        default:
+            rec->prefix = 0;
+            break;
+        }
+    }
+
+    g_qsort_with_data (&ds->src[ds->bounds[job]], ds->bounds[job + 1] - ds->bounds[job],
+                       sizeof (dir_sort_rec_t), dir_sort_rec_compare, ds);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Merge runs 2 * job and 2 * job + 1 from src to dst.
+ */
+
+static void
+dir_sort_merge_job (mc_parallel_t * run, guint job, gpointer user_data)
+{
+    dir_sort_t *ds = (dir_sort_t *) user_data;
+    int i, j, k, i_end, j_end;
+
+    (void) run;
+
+    i = ds->bounds[2 * job];
+    i_end = ds->bounds[2 * job + 1];
+    j = i_end;
+    j_end = 2 * job + 2 <= ds->runs ? ds->bounds[2 * job + 2] : i_end;
+
+    /* take from the left run on equality to keep merge stable */
+    for (k = i; i < i_end && j < j_end; k++)
+        if (dir_sort_rec_compare (&ds->src[j], &ds->src[i], ds) < 0)
+            ds->dst[k] = ds->src[j++];
+        else
+            ds->dst[k] = ds->src[i++];
+
+    memcpy (&ds->dst[k], &ds->src[i], (i_end - i) * sizeof (dir_sort_rec_t));
+    k += i_end - i;
+    memcpy (&ds->dst[k], &ds->src[j], (j_end - j) * sizeof (dir_sort_rec_t));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Sort entries using current sort options (see set_sort_options()).
+ *
+ * Sort keys of all entries are created once and in parallel. Then short records
+ * (key prefix, index) are sorted by merge sort which is parallel too: runs are sorted by jobs
+ * and then merged pairwise by jobs. Entries are looked into only if key prefixes are equal.
+ * At last, entries are permuted once.
+ *
+ * Keys are left in entries, call clean_sort_keys() when they are not needed anymore.
+ * Comparators not known here can be not thread safe, they are used with qsort() as is.
+ */
+
+static void
+dir_list_sort_entries (file_entry_t * list, int len, GCompareFunc sort)
+{
+    dir_sort_t ds;
+    file_entry_t *sorted;
+    mc_parallel_t *run;
+    guint i;
+
+    if (len < 2 || sort == (GCompareFunc) unsorted)
+        return;
+
+    memset (&ds, 0, sizeof (ds));
+    ds.list = list;
+    ds.len = len;
+    ds.sort = sort;
+
+    if (sort == (GCompareFunc) sort_name)
+    {
+        ds.make_key = TRUE;
+        ds.prefix = DIR_SORT_PREFIX_NAME;
+    }
+    else if (sort == (GCompareFunc) sort_ext)
+    {
+        ds.make_key = TRUE;
+        ds.make_second_key = TRUE;
+        ds.prefix = DIR_SORT_PREFIX_EXT;
+    }
+    else if (sort == (GCompareFunc) sort_time || sort == (GCompareFunc) sort_ctime
+             || sort == (GCompareFunc) sort_atime || sort == (GCompareFunc) sort_size)
+        ds.make_key = TRUE;     /* for entries with equal primary keys */
+    else if (sort != (GCompareFunc) sort_vers && sort != (GCompareFunc) sort_inode)
+    {
+        qsort (list, len, sizeof (file_entry_t), sort);
+        return;
+    }
+
+    /* prefixes make sense only if keys are compared by strcmp() */
+    if (!str_key_is_binary (case_sensitive))
+        ds.prefix = DIR_SORT_PREFIX_NONE;
+
+    ds.runs = mc_parallel_count_jobs (len, DIR_SORT_MIN_CHUNK);
+    ds.bounds = g_new (int, ds.runs + 1);
+    for (i = 0; i <= ds.runs; i++)
+        ds.bounds[i] = (int) mc_parallel_job_start (len, ds.runs, i);
+
+    ds.src = g_new (dir_sort_rec_t, len);
+    ds.dst = g_new (dir_sort_rec_t, len);
+
+    run = mc_parallel_run (ds.runs, dir_sort_job, &ds);
+    mc_parallel_wait (run, -1);
+    mc_parallel_free (run);
+
+    while (ds.runs > 1)
+    {
+        dir_sort_rec_t *tmp;
+        guint pairs;
+
+        pairs = (ds.runs + 1) / 2;
+        run = mc_parallel_run (pairs, dir_sort_merge_job, &ds);
+        mc_parallel_wait (run, -1);
+        mc_parallel_free (run);
+
+        /* merged run i is former runs 2 * i and 2 * i + 1 */
+        for (i = 0; i < pairs; i++)
+            ds.bounds[i] = ds.bounds[2 * i];
+        ds.bounds[pairs] = len;
+        ds.runs = pairs;
+
+        tmp = ds.src;
+        ds.src = ds.dst;
+        ds.dst = tmp;
+    }
+
+    sorted = g_new (file_entry_t, len);
+    for (i = 0; i < (guint) len; i++)
+        sorted[i] = list[ds.src[i].index];
+    memcpy (list, sorted, len * sizeof (file_entry_t));
+
+    g_free (sorted);
+    g_free (ds.dst);
+    g_free (ds.src);
+    g_free (ds.bounds);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Check whether directory entry should be shown by its name only.
+ * @return FALSE = don't add, TRUE = add to the list if other checks are passed
+ */
+
+static gboolean
+handle_dirent_name (const char *name)
+{
+    if (DIR_IS_DOT (name) || DIR_IS_DOTDOT (name))
+        return FALSE;
+    if (!panels_options.show_dot_files && (name[0] == '.'))
+        return FALSE;
+    if (!panels_options.show_backups && name[strlen (name) - 1] == '~')
+        return FALSE;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * If you change handle_dirent then check also handle_path and dir_list_fill_local.
  * @return FALSE = don't add, TRUE = add to the list
  */
 
@@ -150,11 +471,7 @@ handle_dirent (struct dirent *dp, const char *fltr, struct stat *buf1, gboolean
 {
     vfs_path_t *vpath;
 
-    if (DIR_IS_DOT (dp->d_name) || DIR_IS_DOTDOT (dp->d_name))
-        return FALSE;
-    if (!panels_options.show_dot_files && (dp->d_name[0] == '.'))
-        return FALSE;
-    if (!panels_options.show_backups && dp->d_name[strlen (dp->d_name) - 1] == '~')
+    if (!handle_dirent_name (dp->d_name))
         return FALSE;
 
     vpath = vfs_path_from_str (dp->d_name);
@@ -206,6 +523,321 @@ dir_get_dotdot_stat (const vfs_path_t * vpath, struct stat *st)
     return ret;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read directory entries one by one: stat each entry via VFS right after it was read.
+ */
+
+static gboolean
+dir_list_fill_vfs (dir_list * list, DIR * dirp, const char *fltr, int limit, gboolean * eof)
+{
+    struct dirent *dp;
+    struct stat st;
+    gboolean ret = TRUE;
+
+    for (; ret && limit != 0; limit--)
+    {
+        gboolean link_to_dir, stale_link;
+
+        dp = mc_readdir (dirp);
+        if (dp == NULL)
+        {
+            *eof = TRUE;
+            break;
+        }
+
+        if (list->callback != NULL)
+            list->callback (DIR_READ, dp);
+
+        if (!handle_dirent (dp, fltr, &st, &link_to_dir, &stale_link))
+            continue;
+
+        if (!dir_list_append (list, dp->d_name, &st, link_to_dir, stale_link))
+            ret = FALSE;
+    }
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef HAVE_FSTATAT
+/**
+ * Can entries of directory be stat'ed directly by system calls outside of VFS?
+ */
+
+static gboolean
+dir_list_can_stat_local (const vfs_path_t * vpath)
+{
+    const vfs_path_element_t *path_element;
+
+    if (vfs_path_elements_count (vpath) != 1 || !vfs_file_is_local (vpath))
+        return FALSE;
+
+    path_element = vfs_path_get_by_index (vpath, 0);
+#ifdef HAVE_CHARSET
+    /* names are recoded by mc_readdir() */
+    if (path_element->encoding != NULL)
+        return FALSE;
+#endif
+
+    return (path_element->path != NULL && IS_PATH_SEP (path_element->path[0]));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Thread safe analogue of handle_dirent(): get stat info of entry in directory dir_fd.
+ */
+
+static void
+dir_stat_entry (int dir_fd, file_entry_t * fentry)
+{
+    if (fstatat (dir_fd, fentry->fname, &fentry->st, AT_SYMLINK_NOFOLLOW) != 0)
+        memset (&fentry->st, 0, sizeof (fentry->st));
+
+    if (S_ISLNK (fentry->st.st_mode))
+    {
+        struct stat st;
+
+        if (fstatat (dir_fd, fentry->fname, &st, 0) != 0)
+            fentry->f.stale_link = 1;
+        else
+            fentry->f.link_to_dir = S_ISDIR (st.st_mode) ? 1 : 0;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dir_stat_job (mc_parallel_t * run, guint job, gpointer user_data)
+{
+    const dir_stat_job_t *d = (const dir_stat_job_t *) user_data;
+    gsize i, end;
+
+    i = d->first + mc_parallel_job_start (d->count, d->jobs, job);
+    end = d->first + mc_parallel_job_start (d->count, d->jobs, job + 1);
+
+    for (; i < end && !mc_parallel_is_cancelled (run); i++)
+        dir_stat_entry (d->dir_fd, &d->list[i]);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read directory entries of local directory.
+ *
+ * All names are read at first, then entries are stat'ed in worker threads while
+ * the list callback is kept being called. At last, list is filtered in one pass.
+ * If user interrupts loading, entries that are not stat'ed yet are shown as
+ * entries with failed lstat().
+ */
+
+static gboolean
+dir_list_fill_local (dir_list * list, DIR * dirp, const vfs_path_t * vpath, const char *fltr,
+                     int limit, gboolean * eof)
+{
+    struct dirent *dp;
+    struct stat st;
+    int first, i, j;
+    gboolean ret = TRUE;
+
+    memset (&st, 0, sizeof (st));
+    first = list->len;
+
+    for (; ret && limit != 0; limit--)
+    {
+        dp = mc_readdir (dirp);
+        if (dp == NULL)
+        {
+            *eof = TRUE;
+            break;
+        }
+
+        if (list->callback != NULL)
+            list->callback (DIR_READ, dp);
+
+        if (handle_dirent_name (dp->d_name)
+            && !dir_list_append (list, dp->d_name, &st, FALSE, FALSE))
+            ret = FALSE;
+    }
+
+    if (ret && list->len > first)
+    {
+        dir_stat_job_t d;
+        mc_parallel_t *run;
+
+        d.dir_fd = open (vfs_path_get_last_path_str (vpath),
+                          O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        d.list = list->list;
+        d.first = first;
+        d.count = list->len - first;
+        d.jobs = mc_parallel_count_jobs (d.count, MC_PARALLEL_MIN_CHUNK);
+
+        if (d.dir_fd == -1)
+            d.dir_fd = AT_FDCWD;        /* directory is current one as in handle_dirent() */
+
+        tty_enable_interrupt_key ();
+
+        run = mc_parallel_run (d.jobs, dir_stat_job, &d);
+        while (!mc_parallel_wait (run, DIR_STAT_POLL_USEC))
+        {
+            if (list->callback != NULL)
+                list->callback (DIR_READ, NULL);
+            if (tty_got_interrupt ())
+                mc_parallel_cancel (run);
+        }
+        mc_parallel_free (run);
+
+        tty_disable_interrupt_key ();
+
+        if (d.dir_fd != AT_FDCWD)
+            close (d.dir_fd);
+    }
+
+    /* merge: filter out entries in one pass */
+    for (i = j = first; i < list->len; i++)
+    {
+        file_entry_t *fentry = &list->list[i];
+
+        if (S_ISDIR (fentry->st.st_mode))
+            tree_store_mark_checked (fentry->fname);
+
+        if (!S_ISDIR (fentry->st.st_mode) && !link_isdir (fentry) && fltr != NULL
+            && !mc_search (fltr, NULL, fentry->fname, MC_SEARCH_T_GLOB))
+        {
+            g_free (fentry->fname);
+            continue;
+        }
+
+        if (i != j)
+            list->list[j] = *fentry;
+        j++;
+    }
+
+    list->len = j;
+
+    return ret;
+}
+#endif /* HAVE_FSTATAT */
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read entries of opened directory and append them to the list.
+ *
+ * @param limit maximum number of entries to read, negative value means read all entries
+ * @param eof set to TRUE if all entries are read
+ *
+ * @return FALSE on failure, TRUE on success
+ */
+
+static gboolean
+dir_list_fill (dir_list * list, DIR * dirp, const vfs_path_t * vpath, const char *fltr, int limit,
+               gboolean * eof)
+{
+#ifdef HAVE_FSTATAT
+    if (dir_list_can_stat_local (vpath))
+        return dir_list_fill_local (list, dirp, vpath, fltr, limit, eof);
+#else
+    (void) vpath;
+#endif
+
+    return dir_list_fill_vfs (list, dirp, fltr, limit, eof);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Sort pending entries and merge them into the sorted list using current sort options.
+ * Pending list is empty after that.
+ *
+ * @param tracked index of list entry which position should be kept track of. Updated to
+ *        the new position of the same entry
+ * @param first set to the lowest index of merged entries in the list, may be NULL
+ *
+ * @return FALSE on failure, TRUE on success
+ */
+
+static gboolean
+dir_list_merge (dir_list * list, dir_list * pending, GCompareFunc sort, int *tracked, int *first)
+{
+    int lo, i, j, k, new_tracked;
+
+    if (first != NULL)
+        *first = list->len;
+
+    if (pending->len == 0)
+        return TRUE;
+
+    if (list->size < list->len + pending->len
+        && !dir_list_grow (list, list->len + pending->len - list->size))
+        return FALSE;
+
+    if (sort == (GCompareFunc) unsorted)
+    {
+        memcpy (&list->list[list->len], pending->list, pending->len * sizeof (file_entry_t));
+        list->len += pending->len;
+        pending->len = 0;
+        return TRUE;
+    }
+
+    dir_list_sort_entries (pending->list, pending->len, sort);
+
+    /* ".." must stay at top */
+    lo = (list->len != 0 && DIR_IS_DOTDOT (list->list[0].fname)) ? 1 : 0;
+    new_tracked = tracked != NULL ? *tracked : -1;
+
+    /* merge from the end: moved list entries never overwrite unmerged ones */
+    for (i = list->len - 1, j = pending->len - 1, k = list->len + pending->len - 1; j >= 0; k--)
+        if (i >= lo && sort (&list->list[i], &pending->list[j]) > 0)
+        {
+            if (tracked != NULL && i == *tracked)
+                new_tracked = k;
+            list->list[k] = list->list[i--];
+        }
+        else
+            list->list[k] = pending->list[j--];
+
+    if (tracked != NULL)
+        *tracked = new_tracked;
+    if (first != NULL)
+        *first = k + 1;
+
+    list->len += pending->len;
+    pending->len = 0;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Sort pending entries of the loader and merge them into the sorted list.
+ */
+
+static gboolean
+dir_list_loader_merge (dir_list_loader_t * loader, int *tracked)
+{
+    /* keys are kept in entries until loading is finished: don't create them again and again */
+    set_sort_options (&loader->sort_op);
+
+    return dir_list_merge (loader->list, &loader->pending, loader->sort, tracked, NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dir_list_loader_free (dir_list_loader_t * loader)
+{
+    set_sort_options (&loader->sort_op);
+    clean_sort_keys (loader->list, 0, loader->list->len);
+
+    if (loader->list->callback != NULL)
+        loader->list->callback (DIR_CLOSE, NULL);
+    mc_closedir (loader->dirp);
+
+    dir_list_free_list (&loader->pending);
+    vfs_path_free (loader->vpath);
+    g_free (loader->fltr);
+    g_free (loader);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static void
@@ -301,6 +933,7 @@ dir_list_append (dir_list * list, const char *fname, const struct stat * st,
     fentry->f.stale_link = stale_link ? 1 : 0;
     fentry->f.dir_size_computed = 0;
     fentry->st = *st;
+    fentry->fhl_generation = 0;
     fentry->sort_key = NULL;
     fentry->second_sort_key = NULL;
 
@@ -494,11 +1127,8 @@ dir_list_sort (dir_list * list, GCompareFunc sort, const dir_sort_options_t * so
         /* If there is an ".." entry the caller must take care to
            ensure that it occupies the first list element. */
         dot_dot_found = DIR_IS_DOTDOT (fentry->fname) ? 1 : 0;
-        reverse = sort_op->reverse ? -1 : 1;
-        case_sensitive = sort_op->case_sensitive ? 1 : 0;
-        exec_first = sort_op->exec_first;
-        qsort (&(list->list)[dot_dot_found], list->len - dot_dot_found, sizeof (file_entry_t),
-               sort);
+        set_sort_options (sort_op);
+        dir_list_sort_entries (&list->list[dot_dot_found], list->len - dot_dot_found, sort);
 
         clean_sort_keys (list, dot_dot_found, list->len - dot_dot_found);
     }
@@ -624,11 +1254,11 @@ dir_list_load (dir_list * list, const vfs_path_t * vpath, GCompareFunc sort,
                const dir_sort_options_t * sort_op, const char *fltr)
 {
     DIR *dirp;
-    struct dirent *dp;
     struct stat st;
     file_entry_t *fentry;
     const char *vpath_str;
-    gboolean ret = TRUE;
+    gboolean eof = FALSE;
+    gboolean ret;
 
     /* ".." (if any) must be the first entry in the list */
     if (!dir_list_init (list))
@@ -651,19 +1281,7 @@ dir_list_load (dir_list * list, const vfs_path_t * vpath, GCompareFunc sort,
     if (IS_PATH_SEP (vpath_str[0]) && vpath_str[1] == '\0')
         dir_list_clean (list);
 
-    while (ret && (dp = mc_readdir (dirp)) != NULL)
-    {
-        gboolean link_to_dir, stale_link;
-
-        if (list->callback != NULL)
-            list->callback (DIR_READ, dp);
-
-        if (!handle_dirent (dp, fltr, &st, &link_to_dir, &stale_link))
-            continue;
-
-        if (!dir_list_append (list, dp->d_name, &st, link_to_dir, stale_link))
-            ret = FALSE;
-    }
+    ret = dir_list_fill (list, dirp, vpath, fltr, -1, &eof);
 
     if (ret)
         dir_list_sort (list, sort, sort_op);
@@ -697,13 +1315,13 @@ dir_list_reload (dir_list * list, const vfs_path_t * vpath, GCompareFunc sort,
                  const dir_sort_options_t * sort_op, const char *fltr)
 {
     DIR *dirp;
-    struct dirent *dp;
-    int i;
+    int i, first;
     struct stat st;
     int marked_cnt;
     GHashTable *marked_files;
     const char *tmp_path;
-    gboolean ret = TRUE;
+    gboolean eof = FALSE;
+    gboolean ret;
 
     if (list->callback != NULL)
         list->callback (DIR_OPEN, (void *) vpath);
@@ -767,37 +1385,28 @@ dir_list_reload (dir_list * list, const vfs_path_t * vpath, GCompareFunc sort,
 
             fentry = &list->list[0];
             fentry->st = st;
+            fentry->fhl_generation = 0;
         }
     }
 
-    while (ret && (dp = mc_readdir (dirp)) != NULL)
-    {
-        gboolean link_to_dir, stale_link;
-
-        if (list->callback != NULL)
-            list->callback (DIR_READ, dp);
+    first = list->len;
+    ret = dir_list_fill (list, dirp, vpath, fltr, -1, &eof);
 
-        if (!handle_dirent (dp, fltr, &st, &link_to_dir, &stale_link))
-            continue;
+    for (i = first; i < list->len; i++)
+    {
+        file_entry_t *fentry;
 
-        if (!dir_list_append (list, dp->d_name, &st, link_to_dir, stale_link))
-            ret = FALSE;
-        else
-        {
-            file_entry_t *fentry;
+        fentry = &list->list[i];
 
-            fentry = &list->list[list->len - 1];
-
-            /*
-             * If we have marked files in the copy, scan through the copy
-             * to find matching file.  Decrease number of remaining marks if
-             * we copied one.
-             */
-            fentry->f.marked = (marked_cnt > 0
-                                && g_hash_table_lookup (marked_files, dp->d_name) != NULL);
-            if (fentry->f.marked)
-                marked_cnt--;
-        }
+        /*
+         * If we have marked files in the copy, scan through the copy
+         * to find matching file.  Decrease number of remaining marks if
+         * we copied one.
+         */
+        fentry->f.marked = (marked_cnt > 0
+                            && g_hash_table_lookup (marked_files, fentry->fname) != NULL);
+        if (fentry->f.marked)
+            marked_cnt--;
     }
 
     if (ret)
@@ -815,3 +1424,276 @@ dir_list_reload (dir_list * list, const vfs_path_t * vpath, GCompareFunc sort,
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Start loading of directory in streaming mode.
+ *
+ * Unlike dir_list_load(), this function returns as soon as directory is opened. Entries are
+ * read by dir_list_load_step() in portions: each portion is sorted and merged into
+ * the already sorted list, so the list can be shown and navigated while the directory
+ * is still being read.
+ *
+ * @return loader object or NULL if directory cannot be opened. In the latter case list
+ *         contains ".." entry only as after failed dir_list_load()
+ */
+
+dir_list_loader_t *
+dir_list_load_start (dir_list * list, const vfs_path_t * vpath, GCompareFunc sort,
+                     const dir_sort_options_t * sort_op, const char *fltr)
+{
+    DIR *dirp;
+    struct stat st;
+    const char *vpath_str;
+    dir_list_loader_t *loader;
+
+    /* ".." (if any) must be the first entry in the list */
+    if (!dir_list_init (list))
+        return NULL;
+
+    if (dir_get_dotdot_stat (vpath, &st))
+        list->list[0].st = st;
+
+    if (list->callback != NULL)
+        list->callback (DIR_OPEN, (void *) vpath);
+    dirp = mc_opendir (vpath);
+    if (dirp == NULL)
+        return NULL;
+
+    vpath_str = vfs_path_as_str (vpath);
+    /* Do not add a ".." entry to the root directory */
+    if (IS_PATH_SEP (vpath_str[0]) && vpath_str[1] == '\0')
+        dir_list_clean (list);
+
+    loader = g_new0 (dir_list_loader_t, 1);
+    loader->list = list;
+    loader->pending.callback = list->callback;
+    loader->dirp = dirp;
+    loader->vpath = vfs_path_clone (vpath);
+    loader->sort = sort;
+    loader->sort_op = *sort_op;
+    loader->fltr = g_strdup (fltr);
+    loader->ok = TRUE;
+
+    return loader;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read next portion of directory entries.
+ *
+ * Read entries are merged into the list when there are enough of them to make
+ * the merge worth it: the list is growing geometrically, so total cost of all merges
+ * is the same as cost of one sort.
+ *
+ * @param loader loader object
+ * @param budget_usec time to spend reading, in microseconds
+ * @param tracked index of list entry to keep track of (usually, the selected one), or NULL
+ *
+ * @return TRUE if directory is read completely (or reading is failed), FALSE otherwise
+ */
+
+gboolean
+dir_list_load_step (dir_list_loader_t * loader, gint64 budget_usec, int *tracked)
+{
+    gint64 end_time;
+
+    end_time = g_get_monotonic_time () + budget_usec;
+
+    while (loader->ok && !loader->eof)
+    {
+        loader->ok = dir_list_fill (&loader->pending, loader->dirp, loader->vpath, loader->fltr,
+                                    DIR_LIST_STREAM_CHUNK, &loader->eof);
+        if (g_get_monotonic_time () >= end_time)
+            break;
+    }
+
+    /* show first entries at once, then merge geometrically growing portions */
+    if (loader->ok && (loader->eof || loader->list->len <= 1
+                       || loader->pending.len >= MAX (DIR_LIST_STREAM_CHUNK,
+                                                      loader->list->len / 2)))
+        loader->ok = dir_list_loader_merge (loader, tracked);
+
+    return (loader->eof || !loader->ok);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read the rest of the directory and destroy the loader.
+ *
+ * @param loader loader object
+ * @param tracked index of list entry to keep track of, or NULL
+ *
+ * @return FALSE on failure, TRUE on success
+ */
+
+gboolean
+dir_list_load_finish (dir_list_loader_t * loader, int *tracked)
+{
+    gboolean ret;
+
+    while (!dir_list_load_step (loader, G_MAXINT64 / 2, tracked))
+        ;
+
+    ret = loader->ok;
+
+    if (ret)
+    {
+        /* entries were not checked while reading: loading can be aborted at any time */
+        if (tree_store_start_check (loader->vpath) != NULL)
+        {
+            int i;
+
+            for (i = 0; i < loader->list->len; i++)
+                if (S_ISDIR (loader->list->list[i].st.st_mode))
+                    tree_store_mark_checked (loader->list->list[i].fname);
+
+            tree_store_end_check ();
+        }
+    }
+
+    dir_list_loader_free (loader);
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Stop loading and destroy the loader. Already merged entries are kept in the list.
+ */
+
+void
+dir_list_load_abort (dir_list_loader_t * loader)
+{
+    if (loader != NULL)
+        dir_list_loader_free (loader);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Update sorted list incrementally: entries with given names are read again, added
+ * or removed. Marks of updated entries are kept.
+ *
+ * @param names names of changed entries (keys of hash table)
+ * @param tracked index of list entry which position should be kept track of. Updated to
+ *        the new position of the same entry (or the nearest one if the entry is removed)
+ * @param first set to the lowest index of changed entries in the list, may be NULL
+ *
+ * @return FALSE on failure (list is consistent but may be incomplete), TRUE on success
+ */
+
+gboolean
+dir_list_update (dir_list * list, const vfs_path_t * vpath, GHashTable * names,
+                 GCompareFunc sort, const dir_sort_options_t * sort_op, const char *fltr,
+                 int *tracked, int *first)
+{
+    dir_list pending = { NULL, 0, 0, NULL };
+    GHashTable *marked;
+    GHashTableIter iter;
+    gpointer key;
+    gboolean first_char[256];
+    char *tracked_name = NULL;
+    int i, k, lo, removed_first, inserted_first;
+    gboolean ret = TRUE;
+
+    memset (first_char, 0, sizeof (first_char));
+    g_hash_table_iter_init (&iter, names);
+    while (g_hash_table_iter_next (&iter, &key, NULL))
+        first_char[(unsigned char) ((const char *) key)[0]] = TRUE;
+
+    marked = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+    /* remove changed entries, keep the rest in order */
+    lo = (list->len != 0 && DIR_IS_DOTDOT (list->list[0].fname)) ? 1 : 0;
+    removed_first = list->len;
+
+    for (i = k = lo; i < list->len; i++)
+    {
+        file_entry_t *fentry = &list->list[i];
+
+        if (!first_char[(unsigned char) fentry->fname[0]]
+            || !g_hash_table_lookup_extended (names, fentry->fname, NULL, NULL))
+        {
+            if (tracked != NULL && i == *tracked)
+                *tracked = k;
+            if (k != i)
+                list->list[k] = *fentry;
+            k++;
+            continue;
+        }
+
+        removed_first = MIN (removed_first, k);
+
+        if (tracked != NULL && i == *tracked)
+        {
+            tracked_name = g_strdup (fentry->fname);
+            *tracked = k;
+        }
+
+        if (fentry->f.marked)
+            g_hash_table_insert (marked, fentry->fname, GINT_TO_POINTER (1));
+        else
+            g_free (fentry->fname);
+    }
+    list->len = k;
+
+    /* read changed entries which still exist */
+    g_hash_table_iter_init (&iter, names);
+    while (ret && g_hash_table_iter_next (&iter, &key, NULL))
+    {
+        const char *name = (const char *) key;
+        vfs_path_t *entry_vpath;
+        struct stat st;
+        gboolean link_to_dir, stale_link;
+
+        if (!handle_dirent_name (name))
+            continue;
+
+        entry_vpath = vfs_path_append_new (vpath, name, (char *) NULL);
+        if (mc_lstat (entry_vpath, &st) == 0)
+        {
+            link_to_dir = file_is_symlink_to_dir (entry_vpath, &st, &stale_link);
+
+            if (S_ISDIR (st.st_mode) || link_to_dir || fltr == NULL
+                || mc_search (fltr, NULL, name, MC_SEARCH_T_GLOB))
+            {
+                ret = dir_list_append (&pending, name, &st, link_to_dir, stale_link);
+                if (ret)
+                    pending.list[pending.len - 1].f.marked =
+                        g_hash_table_lookup (marked, name) != NULL ? 1 : 0;
+            }
+        }
+        vfs_path_free (entry_vpath);
+    }
+
+    g_hash_table_destroy (marked);
+
+    set_sort_options (sort_op);
+    if (ret)
+        ret = dir_list_merge (list, &pending, sort, tracked, &inserted_first);
+    else
+        inserted_first = list->len;
+    clean_sort_keys (list, 0, list->len);
+
+    if (first != NULL)
+        *first = MIN (removed_first, inserted_first);
+
+    if (tracked != NULL)
+    {
+        /* updated entry is moved to its new place */
+        if (tracked_name != NULL)
+            for (i = lo; i < list->len; i++)
+                if (strcmp (list->list[i].fname, tracked_name) == 0)
+                {
+                    *tracked = i;
+                    break;
+                }
+
+        *tracked = CLAMP (*tracked, 0, MAX (list->len - 1, 0));
+    }
+
+    g_free (tracked_name);
+    dir_list_free_list (&pending);
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -23,7 +23,8 @@ typedef enum
     DIR_CLOSE
 } dir_list_cb_state_t;
 
-/* dir_list callback */
+/* dir_list callback. On DIR_READ, data is struct dirent of entry being read
+   or NULL while read entries are being stat'ed */
 typedef void (*dir_list_cb_fn) (dir_list_cb_state_t state, void *data);
 
 /*** enums ***************************************************************************************/
@@ -51,6 +52,9 @@ typedef struct dir_sort_options_struct
     gboolean exec_first;        /**< executables are at top of list */
 } dir_sort_options_t;
 
+/* streaming directory loader */
+typedef struct dir_list_loader_t dir_list_loader_t;
+
 /*** global variables defined in .c file *********************************************************/
 
 /*** declarations of public functions ************************************************************/
@@ -64,6 +68,15 @@ gboolean dir_list_load (dir_list * list, const vfs_path_t * vpath, GCompareFunc
 gboolean dir_list_reload (dir_list * list, const vfs_path_t * vpath, GCompareFunc sort,
                           const dir_sort_options_t * sort_op, const char *fltr);
 void dir_list_sort (dir_list * list, GCompareFunc sort, const dir_sort_options_t * sort_op);
+dir_list_loader_t *dir_list_load_start (dir_list * list, const vfs_path_t * vpath,
+                                        GCompareFunc sort, const dir_sort_options_t * sort_op,
+                                        const char *fltr);
+gboolean dir_list_load_step (dir_list_loader_t * loader, gint64 budget_usec, int *tracked);
+gboolean dir_list_load_finish (dir_list_loader_t * loader, int *tracked);
+void dir_list_load_abort (dir_list_loader_t * loader);
+gboolean dir_list_update (dir_list * list, const vfs_path_t * vpath, GHashTable * names,
+                          GCompareFunc sort, const dir_sort_options_t * sort_op, const char *fltr,
+                          int *tracked, int *first);
 gboolean dir_list_init (dir_list * list);
 void dir_list_clean (dir_list * list);
 void dir_list_free_list (dir_list * list);
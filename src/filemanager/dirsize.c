@@ -0,0 +1,618 @@
+/*
+   Compute sizes of local directories with persistent cache.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file dirsize.c
+ *  \brief Source: compute sizes of local directories with persistent cache
+ *
+ *  Directory tree is scanned level by level: directories of one level are read by
+ *  parallel jobs, the main thread collects results and updates the status window.
+ *
+ *  For every directory the cache keeps number and total size of its files and names of
+ *  its subdirectories. The record is identified by device and inode of directory and is
+ *  valid while modification time of directory is the same, so a warm tree is revalidated
+ *  by one stat() per directory instead of one stat() per file. Changes of file sizes which
+ *  don't touch directory (file is rewritten in place) aren't noticed until the directory
+ *  is changed. The cache is kept in MC_DIRSIZE_FILE in the cache directory between runs.
+ *
+ *  The cache is used when symlinks aren't followed only: otherwise the same directory
+ *  can have other subdirectories.
+ */
+
+#include <config.h>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>              /* AT_SYMLINK_NOFOLLOW */
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "lib/global.h"
+#include "lib/fileloc.h"
+#include "lib/fs.h"             /* DIR_IS_DOT() */
+#include "lib/util.h"
+#include "lib/mcconfig.h"       /* mc_config_get_full_path() */
+#include "lib/parallel.h"
+
+#include "dirsize.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+#define DIR_SIZE_SIGNATURE "Midnight Commander dirsize cache v 1"
+
+/* if there are more records, records which weren't used in this session aren't saved */
+#define DIR_SIZE_CACHE_MAX 1000000
+
+/* directories changed so recently can be changed again without change of mtime */
+#define DIR_SIZE_RACY_SEC 2
+
+/* minimal number of directories per job */
+#define DIR_SIZE_MIN_CHUNK 8
+
+/* update status with 25 FPS rate */
+#define DIR_SIZE_WAIT_USEC (G_USEC_PER_SEC / 25)
+
+/*** file scope type declarations ****************************************************************/
+
+typedef struct
+{
+    dev_t dev;
+    ino_t ino;
+    time_t mtime;
+    uintmax_t size;             /* total size of files of directory itself */
+    size_t files;               /* number of files of directory itself */
+    GPtrArray *subdirs;         /* names of subdirectories */
+    gboolean used;              /* used in this session */
+} dir_size_node_t;
+
+typedef struct
+{
+    char *path;
+    dir_size_node_t *node;      /* NULL if directory can't be read */
+    gboolean is_new;            /* node isn't in the cache */
+} dir_size_item_t;
+
+/* directories of one level of tree */
+typedef struct
+{
+    GPtrArray *items;
+    guint jobs;
+    gboolean follow_symlinks;
+    GHashTable *cache;          /* read-only while jobs are running, NULL if not used */
+} dir_size_level_t;
+
+/*** file scope variables ************************************************************************/
+
+static GHashTable *dir_size_cache = NULL;
+static gboolean dir_size_cache_dirty = FALSE;
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static guint
+dir_size_node_hash (gconstpointer v)
+{
+    const dir_size_node_t *node = (const dir_size_node_t *) v;
+
+    return (guint) node->ino ^ ((guint) node->dev << 16) ^ (guint) ((guint64) node->ino >> 32);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+dir_size_node_equal (gconstpointer a, gconstpointer b)
+{
+    const dir_size_node_t *na = (const dir_size_node_t *) a;
+    const dir_size_node_t *nb = (const dir_size_node_t *) b;
+
+    return (na->ino == nb->ino && na->dev == nb->dev);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static dir_size_node_t *
+dir_size_node_new (dev_t dev, ino_t ino, time_t mtime)
+{
+    dir_size_node_t *node;
+
+    node = g_new0 (dir_size_node_t, 1);
+    node->dev = dev;
+    node->ino = ino;
+    node->mtime = mtime;
+    node->subdirs = g_ptr_array_new_with_free_func (g_free);
+
+    return node;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dir_size_node_free (gpointer data)
+{
+    dir_size_node_t *node = (dir_size_node_t *) data;
+
+    g_ptr_array_free (node->subdirs, TRUE);
+    g_free (node);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dir_size_cache_add (GHashTable * cache, dir_size_node_t * node)
+{
+    /* replace the key too: old node is freed */
+    g_hash_table_replace (cache, node, node);
+    dir_size_cache_dirty = TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Names of entries are saved as C strings: only control characters are escaped */
+
+static const char *
+dir_size_escape_exceptions (void)
+{
+    static char exceptions[129] = "\0";
+
+    if (exceptions[0] == '\0')
+    {
+        int i;
+
+        for (i = 0; i < 128; i++)
+            exceptions[i] = (char) (0x80 + i);
+        exceptions[128] = '\0';
+    }
+
+    return exceptions;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dir_size_cache_load (GHashTable * cache, const char *name)
+{
+    FILE *file;
+    char buffer[MC_MAXPATHLEN * 4 + 20];
+    dir_size_node_t *node = NULL;
+    guint subdirs = 0;
+
+    file = fopen (name, "r");
+    if (file == NULL)
+        return;
+
+    if (fgets (buffer, sizeof (buffer), file) == NULL
+        || strncmp (buffer, DIR_SIZE_SIGNATURE, strlen (DIR_SIZE_SIGNATURE)) != 0)
+    {
+        fclose (file);
+        return;
+    }
+
+    while (fgets (buffer, sizeof (buffer), file) != NULL)
+    {
+        char *nl;
+
+        nl = strchr (buffer, '\n');
+        if (nl == NULL)
+            break;
+        *nl = '\0';
+
+        if (subdirs != 0)
+        {
+            g_ptr_array_add (node->subdirs, g_strcompress (buffer));
+            subdirs--;
+        }
+        else
+        {
+            uintmax_t dev, ino, size;
+            intmax_t mtime;
+            size_t files;
+
+            if (node != NULL)
+                g_hash_table_replace (cache, node, node);
+            node = NULL;
+
+            if (sscanf (buffer, "%ju %ju %jd %ju %zu %u", &dev, &ino, &mtime, &size, &files,
+                        &subdirs) != 6)
+                break;
+
+            node = dir_size_node_new ((dev_t) dev, (ino_t) ino, (time_t) mtime);
+            node->size = size;
+            node->files = files;
+        }
+    }
+
+    /* drop incomplete record */
+    if (node != NULL && subdirs == 0)
+        g_hash_table_replace (cache, node, node);
+    else if (node != NULL)
+        dir_size_node_free (node);
+
+    fclose (file);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+dir_size_cache_save_to (GHashTable * cache, const char *name)
+{
+    FILE *file;
+    GHashTableIter iter;
+    gpointer value;
+    gboolean all;
+    const char *exceptions;
+
+    file = fopen (name, "w");
+    if (file == NULL)
+        return errno;
+
+    exceptions = dir_size_escape_exceptions ();
+    all = g_hash_table_size (cache) <= DIR_SIZE_CACHE_MAX;
+
+    fprintf (file, "%s\n", DIR_SIZE_SIGNATURE);
+
+    g_hash_table_iter_init (&iter, cache);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+        const dir_size_node_t *node = (const dir_size_node_t *) value;
+        guint i;
+
+        if (!all && !node->used)
+            continue;
+
+        fprintf (file, "%ju %ju %jd %ju %zu %u\n", (uintmax_t) node->dev, (uintmax_t) node->ino,
+                 (intmax_t) node->mtime, node->size, node->files, node->subdirs->len);
+
+        for (i = 0; i < node->subdirs->len; i++)
+        {
+            char *escaped;
+
+            escaped = g_strescape ((const char *) g_ptr_array_index (node->subdirs, i),
+                                   exceptions);
+            fprintf (file, "%s\n", escaped);
+            g_free (escaped);
+        }
+    }
+
+    if (fclose (file) != 0)
+        return errno;
+
+    return 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static GHashTable *
+dir_size_cache_get (void)
+{
+    if (dir_size_cache == NULL)
+    {
+        char *name;
+
+        dir_size_cache = g_hash_table_new_full (dir_size_node_hash, dir_size_node_equal, NULL,
+                                                dir_size_node_free);
+
+        name = mc_config_get_full_path (MC_DIRSIZE_FILE);
+        dir_size_cache_load (dir_size_cache, name);
+        g_free (name);
+
+        dir_size_cache_dirty = FALSE;
+    }
+
+    return dir_size_cache;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dir_size_item_free (gpointer data)
+{
+    dir_size_item_t *item = (dir_size_item_t *) data;
+
+    if (item->is_new)
+        dir_size_node_free (item->node);
+    g_free (item->path);
+    g_free (item);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline int
+dir_size_stat (DIR * dir, const char *path, const char *name, gboolean follow_symlinks,
+               struct stat *st)
+{
+#ifdef HAVE_FSTATAT
+    (void) path;
+
+    return fstatat (dirfd (dir), name, st, follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW);
+#else
+    char *full_name;
+    int res;
+
+    (void) dir;
+
+    full_name = g_build_filename (path, name, (char *) NULL);
+    res = follow_symlinks ? stat (full_name, st) : lstat (full_name, st);
+    g_free (full_name);
+
+    return res;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get sizes of files and names of subdirectories of one directory from the cache or read
+ * the directory. Runs in worker thread.
+ */
+
+static void
+dir_size_scan (const dir_size_level_t * level, dir_size_item_t * item)
+{
+    struct stat st;
+    dir_size_node_t *node;
+    DIR *dir;
+    struct dirent *dirent;
+
+    /* the directory is read by path, so the symlink to it is followed anyway */
+    if (stat (item->path, &st) != 0)
+        return;
+
+    if (level->cache != NULL)
+    {
+        dir_size_node_t key;
+
+        key.dev = st.st_dev;
+        key.ino = st.st_ino;
+        node = (dir_size_node_t *) g_hash_table_lookup (level->cache, &key);
+        if (node != NULL && node->mtime == st.st_mtime)
+        {
+            item->node = node;
+            return;
+        }
+    }
+
+    dir = opendir (item->path);
+    if (dir == NULL)
+        return;
+
+    node = dir_size_node_new (st.st_dev, st.st_ino, st.st_mtime);
+
+    while ((dirent = readdir (dir)) != NULL)
+    {
+        struct stat s;
+
+        if (DIR_IS_DOT (dirent->d_name) || DIR_IS_DOTDOT (dirent->d_name))
+            continue;
+
+        if (dir_size_stat (dir, item->path, dirent->d_name, level->follow_symlinks, &s) != 0)
+            continue;
+
+        if (S_ISDIR (s.st_mode))
+            g_ptr_array_add (node->subdirs, g_strdup (dirent->d_name));
+        else
+        {
+            node->files++;
+            node->size += (uintmax_t) s.st_size;
+        }
+    }
+
+    closedir (dir);
+
+    item->node = node;
+    item->is_new = TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dir_size_job (mc_parallel_t * run, guint job, gpointer user_data)
+{
+    const dir_size_level_t *level = (const dir_size_level_t *) user_data;
+    gsize i, end;
+
+    i = mc_parallel_job_start (level->items->len, level->jobs, job);
+    end = mc_parallel_job_start (level->items->len, level->jobs, job + 1);
+
+    for (; i < end && !mc_parallel_is_cancelled (run); i++)
+        dir_size_scan (level, (dir_size_item_t *) g_ptr_array_index (level->items, i));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static dir_size_item_t *
+dir_size_item_new (char *path)
+{
+    dir_size_item_t *item;
+
+    item = g_new0 (dir_size_item_t, 1);
+    item->path = path;
+
+    return item;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static FileProgressStatus
+dir_size_update (const dir_size_level_t * level, const dir_size_t * size,
+                 dir_size_update_fn update, void *data)
+{
+    vfs_path_t *vpath;
+    FileProgressStatus ret;
+
+    if (update == NULL || level->items->len == 0)
+        return FILE_CONT;
+
+    vpath = vfs_path_from_str (((dir_size_item_t *) g_ptr_array_index (level->items, 0))->path);
+    ret = update (vpath, size, data);
+    vfs_path_free (vpath);
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Take results of scanned level: count sizes, put new records to the cache and
+ * make list of directories of the next level.
+ */
+
+static GPtrArray *
+dir_size_collect (const dir_size_level_t * level, dir_size_t * size, time_t now)
+{
+    GPtrArray *next;
+    guint i;
+
+    next = g_ptr_array_new_with_free_func (dir_size_item_free);
+
+    for (i = 0; i < level->items->len; i++)
+    {
+        dir_size_item_t *item = (dir_size_item_t *) g_ptr_array_index (level->items, i);
+        dir_size_node_t *node = item->node;
+        guint j;
+
+        size->dir_count++;
+
+        if (node == NULL)
+            continue;
+
+        size->file_count += node->files;
+        size->total += node->size;
+        node->used = TRUE;
+
+        for (j = 0; j < node->subdirs->len; j++)
+        {
+            const char *name = (const char *) g_ptr_array_index (node->subdirs, j);
+
+            g_ptr_array_add (next, dir_size_item_new (g_build_filename (item->path, name,
+                                                                        (char *) NULL)));
+        }
+
+    }
+
+    /* other items can share cached node which is replaced here, so it's done after counting */
+    for (i = 0; level->cache != NULL && i < level->items->len; i++)
+    {
+        dir_size_item_t *item = (dir_size_item_t *) g_ptr_array_index (level->items, i);
+
+        if (item->is_new && item->node->mtime + DIR_SIZE_RACY_SEC <= now)
+        {
+            dir_size_cache_add (level->cache, item->node);
+            item->is_new = FALSE;
+        }
+    }
+
+    return next;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Compute size of local directory tree. Counters of @size are increased by number of
+ * directories (including @vpath itself), number of files and total size of files.
+ *
+ * @param vpath local directory
+ * @param follow_symlinks TRUE if symlinks to directories are counted as directories
+ * @param size counters
+ * @param update function to show progress, can be NULL
+ * @param data data for @update
+ *
+ * @return FILE_CONT or result of @update which has stopped the scan
+ */
+
+FileProgressStatus
+dir_size_compute (const vfs_path_t * vpath, gboolean follow_symlinks, dir_size_t * size,
+                  dir_size_update_fn update, void *data)
+{
+    dir_size_level_t level;
+    time_t now;
+    FileProgressStatus ret = FILE_CONT;
+
+    now = time (NULL);
+
+    level.follow_symlinks = follow_symlinks;
+    level.cache = follow_symlinks ? NULL : dir_size_cache_get ();
+    level.items = g_ptr_array_new_with_free_func (dir_size_item_free);
+    g_ptr_array_add (level.items,
+                     dir_size_item_new (g_strdup (vfs_path_get_last_path_str (vpath))));
+
+    while (ret == FILE_CONT && level.items->len != 0)
+    {
+        mc_parallel_t *run;
+
+        level.jobs = mc_parallel_count_jobs (level.items->len, DIR_SIZE_MIN_CHUNK);
+        run = mc_parallel_run (level.jobs, dir_size_job, &level);
+        while (ret == FILE_CONT && !mc_parallel_wait (run, DIR_SIZE_WAIT_USEC))
+            ret = dir_size_update (&level, size, update, data);
+        /* cancels jobs if scan is stopped */
+        mc_parallel_free (run);
+
+        if (ret == FILE_CONT)
+        {
+            GPtrArray *next;
+
+            next = dir_size_collect (&level, size, now);
+            g_ptr_array_free (level.items, TRUE);
+            level.items = next;
+            ret = dir_size_update (&level, size, update, data);
+        }
+    }
+
+    g_ptr_array_free (level.items, TRUE);
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Save the cache if it was changed and free it.
+ */
+
+void
+dir_size_cache_done (void)
+{
+    if (dir_size_cache == NULL)
+        return;
+
+    if (dir_size_cache_dirty)
+    {
+        char *name;
+
+        name = mc_config_get_full_path (MC_DIRSIZE_FILE);
+        mc_util_make_backup_if_possible (name, ".tmp");
+
+        if (dir_size_cache_save_to (dir_size_cache, name) != 0)
+            mc_util_restore_from_backup_if_possible (name, ".tmp");
+        else
+            mc_util_unlink_backup_if_possible (name, ".tmp");
+
+        g_free (name);
+    }
+
+    g_hash_table_destroy (dir_size_cache);
+    dir_size_cache = NULL;
+    dir_size_cache_dirty = FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,43 @@
+/** \file dirsize.h
+ *  \brief Header: compute sizes of local directories with persistent cache
+ */
+
+#ifndef MC__DIRSIZE_H
+#define MC__DIRSIZE_H
+
+#include <inttypes.h>           /* uintmax_t */
+
+#include "lib/global.h"
+#include "lib/vfs/vfs.h"        /* vfs_path_t */
+
+#include "fileopctx.h"          /* FileProgressStatus */
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/* counters are accumulated: several directories can be added to the same totals */
+typedef struct
+{
+    size_t dir_count;
+    size_t file_count;
+    uintmax_t total;
+} dir_size_t;
+
+/* called while directories are scanned, anything but FILE_CONT stops the scan */
+typedef FileProgressStatus (*dir_size_update_fn) (const vfs_path_t * vpath,
+                                                  const dir_size_t * size, void *data);
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+FileProgressStatus dir_size_compute (const vfs_path_t * vpath, gboolean follow_symlinks,
+                                     dir_size_t * size, dir_size_update_fn update, void *data);
+void dir_size_cache_done (void);
+
+/*** inline functions ****************************************************************************/
+
+#endif /* MC__DIRSIZE_H */
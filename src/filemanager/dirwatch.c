@@ -0,0 +1,401 @@
+/*
+   Follow changes of directories shown in panels.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file dirwatch.c
+ *  \brief Source: follow changes of directories shown in panels
+ *
+ *  A watch collects names of changed entries of one local directory. The panel takes
+ *  the names and updates its listing incrementally instead of reading the whole directory.
+ *  If changes can't be followed (events are lost, the directory itself is removed or
+ *  renamed, too many changes), the watch asks for a full rescan.
+ *
+ *  Watches are implemented with inotify. Without it, dir_watch_new() always returns NULL
+ *  and panels read directories as usual. Directories on network and FUSE file systems
+ *  are not watched: changes made on other hosts are not reported there.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#if defined (HAVE_SYS_INOTIFY_H) && defined (HAVE_INOTIFY_INIT1)
+#define DIR_WATCH_INOTIFY 1
+#include <sys/inotify.h>
+#include <sys/vfs.h>            /* statfs() */
+#endif
+
+#include "lib/global.h"
+#include "lib/vfs/vfs.h"
+#include "lib/tty/key.h"        /* add_select_channel(), delete_select_channel() */
+
+#include "dirwatch.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/* more changes than this are handled by full rescan */
+#define DIR_WATCH_MAX_CHANGES 16384
+
+#define DIR_WATCH_MASK (IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ATTRIB \
+                        | IN_MODIFY | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_EXCL_UNLINK)
+
+/*** file scope type declarations ****************************************************************/
+
+struct dir_watch_t
+{
+    vfs_path_t *vpath;
+    int wd;                     /* inotify watch descriptor, can be shared by several watches */
+    GHashTable *changes;        /* names of changed entries, NULL if there are no changes */
+    gboolean rescan;            /* changes can't be followed, directory should be read again */
+};
+
+/*** file scope variables ************************************************************************/
+
+static dir_watch_notify_fn notify_fn = NULL;
+
+#ifdef DIR_WATCH_INOTIFY
+static int inotify_fd = -1;
+static GSList *watches = NULL;
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef DIR_WATCH_INOTIFY
+/**
+ * Check whether inotify reports all changes of directory: it doesn't know about changes
+ * made by other hosts on network file systems.
+ */
+
+static gboolean
+dir_watch_fs_is_supported (const char *path)
+{
+    struct statfs sfs;
+
+    if (statfs (path, &sfs) != 0)
+        return FALSE;
+
+    switch ((unsigned long) sfs.f_type)
+    {
+    case 0x6969UL:             /* NFS */
+    case 0x517BUL:             /* SMB */
+    case 0xFF534D42UL:         /* CIFS */
+    case 0xFE534D42UL:         /* SMB2 */
+    case 0x65735546UL:         /* FUSE */
+    case 0x73757245UL:         /* CODA */
+    case 0x5346414FUL:         /* AFS */
+    case 0x01021997UL:         /* 9P */
+    case 0x00C36400UL:         /* CEPH */
+        return FALSE;
+    default:
+        return TRUE;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dir_watch_add_change (dir_watch_t * watch, const char *name)
+{
+    if (watch->rescan)
+        return;
+
+    if (watch->changes == NULL)
+        watch->changes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    else if (g_hash_table_size (watch->changes) >= DIR_WATCH_MAX_CHANGES)
+    {
+        dir_watch_set_rescan (watch);
+        return;
+    }
+
+    g_hash_table_replace (watch->changes, g_strdup (name), NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dir_watch_dispatch (const struct inotify_event *event)
+{
+    GSList *w;
+
+    for (w = watches; w != NULL; w = g_slist_next (w))
+    {
+        dir_watch_t *watch = (dir_watch_t *) w->data;
+
+        if ((event->mask & IN_Q_OVERFLOW) != 0)
+            dir_watch_set_rescan (watch);
+        else if (watch->wd != event->wd)
+            continue;
+        else if ((event->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT | IN_IGNORED)) != 0)
+            dir_watch_set_rescan (watch);
+        else if (event->len != 0)
+            dir_watch_add_change (watch, event->name);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+dir_watch_callback (int fd, void *info)
+{
+    (void) fd;
+    (void) info;
+
+    dir_watch_poll ();
+
+    return 0;
+}
+#endif /* DIR_WATCH_INOTIFY */
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Start watching of directory.
+ *
+ * @param vpath directory
+ *
+ * @return new watch or NULL if changes of this directory can't be followed
+ */
+
+dir_watch_t *
+dir_watch_new (const vfs_path_t * vpath)
+{
+#ifdef DIR_WATCH_INOTIFY
+    dir_watch_t *watch;
+    const char *path;
+    int wd;
+
+    if (vpath == NULL || !vfs_file_is_local (vpath))
+        return NULL;
+
+    path = vfs_path_get_last_path_str (vpath);
+    if (path == NULL || !dir_watch_fs_is_supported (path))
+        return NULL;
+
+    if (inotify_fd < 0)
+    {
+        inotify_fd = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+        if (inotify_fd < 0)
+            return NULL;
+        add_select_channel (inotify_fd, dir_watch_callback, NULL);
+    }
+
+    /* the same directory gets the same descriptor */
+    wd = inotify_add_watch (inotify_fd, path, DIR_WATCH_MASK);
+    if (wd < 0)
+        return NULL;
+
+    watch = g_new0 (dir_watch_t, 1);
+    watch->vpath = vfs_path_clone (vpath);
+    watch->wd = wd;
+    watches = g_slist_prepend (watches, watch);
+
+    return watch;
+#else
+    (void) vpath;
+
+    return NULL;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+dir_watch_free (dir_watch_t * watch)
+{
+#ifdef DIR_WATCH_INOTIFY
+    GSList *w;
+    gboolean shared = FALSE;
+
+    if (watch == NULL)
+        return;
+
+    watches = g_slist_remove (watches, watch);
+
+    for (w = watches; w != NULL && !shared; w = g_slist_next (w))
+        shared = ((dir_watch_t *) w->data)->wd == watch->wd;
+
+    if (!shared)
+        (void) inotify_rm_watch (inotify_fd, watch->wd);
+
+    if (watches == NULL)
+    {
+        delete_select_channel (inotify_fd);
+        close (inotify_fd);
+        inotify_fd = -1;
+    }
+
+    dir_watch_reset (watch);
+    vfs_path_free (watch->vpath);
+    g_free (watch);
+#else
+    (void) watch;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+const vfs_path_t *
+dir_watch_get_path (const dir_watch_t * watch)
+{
+    return watch->vpath;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Set function which is called when some watch gets new changes. It is called
+ * from the event loop while any dialog can be on top, so it shouldn't do more than
+ * to schedule the update.
+ */
+
+void
+dir_watch_set_notify (dir_watch_notify_fn notify)
+{
+    notify_fn = notify;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Collect events which are already reported by the system.
+ * Changes made by MC itself are reported synchronously, so they are all here after the poll.
+ */
+
+void
+dir_watch_poll (void)
+{
+#ifdef DIR_WATCH_INOTIFY
+    union
+    {
+        struct inotify_event event;     /* for alignment */
+        char data[16 * 1024];
+    } buf;
+    gboolean got = FALSE;
+
+    if (inotify_fd < 0)
+        return;
+
+    while (TRUE)
+    {
+        ssize_t len;
+        char *p;
+
+        len = read (inotify_fd, buf.data, sizeof (buf.data));
+        if (len <= 0)
+        {
+            if (len < 0 && errno == EINTR)
+                continue;
+            break;
+        }
+
+        for (p = buf.data; p < buf.data + len;)
+        {
+            const struct inotify_event *event = (const struct inotify_event *) p;
+
+            dir_watch_dispatch (event);
+            p += sizeof (struct inotify_event) + event->len;
+        }
+
+        got = TRUE;
+    }
+
+    if (got && notify_fn != NULL)
+        notify_fn ();
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+gboolean
+dir_watch_has_changes (const dir_watch_t * watch)
+{
+    return (watch->changes != NULL || watch->rescan);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Take changes collected by watch. Watch has no changes after that.
+ *
+ * @param rescan set to TRUE if directory should be read again instead of incremental update
+ *
+ * @return names of changed entries or NULL if there are no changes. Should be freed by
+ *         g_hash_table_destroy()
+ */
+
+GHashTable *
+dir_watch_take_changes (dir_watch_t * watch, gboolean * rescan)
+{
+    GHashTable *changes;
+
+    *rescan = watch->rescan;
+
+    if (watch->rescan)
+    {
+        dir_watch_reset (watch);
+        return NULL;
+    }
+
+    changes = watch->changes;
+    watch->changes = NULL;
+
+    return changes;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Request full rescan of watched directory.
+ */
+
+void
+dir_watch_set_rescan (dir_watch_t * watch)
+{
+    if (watch->changes != NULL)
+    {
+        g_hash_table_destroy (watch->changes);
+        watch->changes = NULL;
+    }
+
+    watch->rescan = TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Drop collected changes. Should be called before the directory is read completely.
+ */
+
+void
+dir_watch_reset (dir_watch_t * watch)
+{
+    if (watch->changes != NULL)
+    {
+        g_hash_table_destroy (watch->changes);
+        watch->changes = NULL;
+    }
+
+    watch->rescan = FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
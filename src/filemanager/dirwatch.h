@@ -0,0 +1,41 @@
+/** \file dirwatch.h
+ *  \brief Header: follow changes of directories shown in panels
+ */
+
+#ifndef MC__DIRWATCH_H
+#define MC__DIRWATCH_H
+
+#include "lib/global.h"
+#include "lib/vfs/vfs.h"        /* vfs_path_t */
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+struct dir_watch_t;
+typedef struct dir_watch_t dir_watch_t;
+
+/* called when some watch gets new changes */
+typedef void (*dir_watch_notify_fn) (void);
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+dir_watch_t *dir_watch_new (const vfs_path_t * vpath);
+void dir_watch_free (dir_watch_t * watch);
+const vfs_path_t *dir_watch_get_path (const dir_watch_t * watch);
+
+void dir_watch_set_notify (dir_watch_notify_fn notify);
+void dir_watch_poll (void);
+
+gboolean dir_watch_has_changes (const dir_watch_t * watch);
+GHashTable *dir_watch_take_changes (dir_watch_t * watch, gboolean * rescan);
+void dir_watch_set_rescan (dir_watch_t * watch);
+void dir_watch_reset (dir_watch_t * watch);
+
+/*** inline functions ****************************************************************************/
+
+#endif /* MC__DIRWATCH_H */
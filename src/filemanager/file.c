@@ -53,6 +53,7 @@
 
 #include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -61,6 +62,7 @@
 #include <unistd.h>
 
 #include "lib/global.h"
+#include "lib/parallel.h"
 #include "lib/tty/tty.h"
 #include "lib/tty/key.h"
 #include "lib/search.h"
@@ -77,6 +79,7 @@
 
 /* Needed for current_panel, other_panel and WTree */
 #include "dir.h"
+#include "dirsize.h"          /* dir_size_compute() */
 #include "filegui.h"
 #include "filenot.h"
 #include "tree.h"
@@ -91,16 +94,35 @@
 /*** global variables ****************************************************************************/
 
 /* TRANSLATORS: no need to translate 'DialogTitle', it's just a context prefix  */
-const char *op_names[3] = {
+const char *op_names[4] = {
     N_("DialogTitle|Copy"),
     N_("DialogTitle|Move"),
-    N_("DialogTitle|Delete")
+    N_("DialogTitle|Delete"),
+    N_("DialogTitle|Replace")
 };
 
 /*** file scope macro definitions ****************************************************************/
 
 #define FILEOP_UPDATE_INTERVAL 2
 #define FILEOP_STALLING_INTERVAL 4
+/* amount of data copied in the kernel between progress updates */
+#define FILEOP_KERNEL_COPY_CHUNK (8 * 1024 * 1024)
+
+/* files up to this size are copied on worker threads, larger ones show their own progress */
+#define COPY_JOB_MAX_SIZE (1024 * 1024)
+/* maximum number of files being copied at the same time */
+#define COPY_JOBS_MAX 32
+/* how often the progress dialog is checked while waiting for copy jobs */
+#define COPY_JOBS_WAIT_USEC (100 * 1000)
+
+#if GLIB_CHECK_VERSION (2, 32, 0)
+#define COPY_PIPE_THREADS 1
+#endif
+
+/* number of buffers between reader and writer of copied file */
+#define COPY_PIPE_BUFFERS 4
+/* smaller files are not worth a writer thread */
+#define COPY_PIPE_MIN_SIZE (1024 * 1024)
 
 /*** file scope type declarations ****************************************************************/
 
@@ -135,6 +157,49 @@ typedef enum
     HARDLINK_ABORT              /**< Stop file operation after hardlink creation error */
 } hardlink_status_t;
 
+/* Small file which is copied on a worker thread, or attributes of target directory
+ * which are set when all files queued before are copied */
+typedef struct
+{
+    mc_parallel_t *run;         /* NULL for directory */
+    char *src_path;             /* as passed to copy_file_file() */
+    char *dst_path;
+    char *src;                  /* paths in local file system, for the worker */
+    char *dst;
+    off_t size;
+    gboolean dst_exists;
+    mode_t open_mode;
+    gboolean set_owner;
+    uid_t uid;
+    gid_t gid;
+    gboolean set_mode;
+    mode_t mode;
+    gboolean set_times;
+    mc_timesbuf_t times;
+    int error;                  /* errno of failed step, 0 if the file is copied */
+} copy_job_t;
+
+/* Ring of buffers between reading of source file in the main thread and writing
+ * of local target file in another thread */
+typedef struct
+{
+    int fd;                     /* system descriptor of target file */
+    char *buf[COPY_PIPE_BUFFERS];
+    size_t len[COPY_PIPE_BUFFERS];      /* size of data in the buffer */
+    size_t done[COPY_PIPE_BUFFERS];     /* size of data which is already written */
+    guint head;                 /* first filled buffer */
+    guint filled;               /* number of filled buffers */
+    gboolean eof;               /* all data is read */
+    gboolean stop;              /* stop writing as soon as possible */
+    gboolean finished;          /* writer has stopped */
+    gboolean failed;            /* writer has stopped because of error */
+#ifdef COPY_PIPE_THREADS
+    GThread *thread;
+    GMutex lock;
+    GCond cond;
+#endif
+} copy_pipe_t;
+
 /*
  * This array introduced to avoid translation problems. The former (op_names)
  * is assumed to be nouns, suitable in dialog box titles; this one should
@@ -194,6 +259,19 @@ static GSList *erase_list = NULL;
  */
 static GSList *dest_dirs = NULL;
 
+/*
+ * Files of directories are copied on worker threads by copy_dir_dir(), up to COPY_JOBS_MAX
+ * at the same time, to hide latency of opening and closing them on slow file systems.
+ * Everything which needs a user decision (overwrite query, hard links, errors) is done by
+ * the main thread. The queue also holds attributes of target directories, they are set when
+ * all files queued before are copied.
+ */
+static GQueue copy_jobs = G_QUEUE_INIT;
+/* depth of copy_dir_dir() recursion: files are only queued inside directories */
+static int copy_jobs_depth = 0;
+/* TRUE while a failed job is copied again in the main thread */
+static gboolean copy_jobs_sync = FALSE;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -604,6 +682,27 @@ make_symlink (file_op_context_t * ctx, const char *src_path, const char *dst_pat
     return return_status;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+
+static FileProgressStatus
+dir_size_update_cb (const vfs_path_t * vpath, const dir_size_t * size, void *data)
+{
+    static guint64 timestamp = 0;
+    /* update with 25 FPS rate */
+    static const guint64 delay = G_USEC_PER_SEC / 25;
+
+    dirsize_status_msg_t *dsm = (dirsize_status_msg_t *) data;
+    status_msg_t *sm = STATUS_MSG (dsm);
+
+    if (sm->update == NULL || !mc_time_elapsed (&timestamp, delay))
+        return FILE_CONT;
+
+    dsm->dirname_vpath = vpath;
+    dsm->dir_count = size->dir_count;
+    dsm->total_size = size->total;
+    return sm->update (sm);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * do_compute_dir_size:
@@ -627,6 +726,24 @@ do_compute_dir_size (const vfs_path_t * dirname_vpath, dirsize_status_msg_t * ds
     struct dirent *dirent;
     FileProgressStatus ret = FILE_CONT;
 
+    /* local trees are scanned in parallel and sizes are cached */
+    if (vfs_file_is_local (dirname_vpath))
+    {
+        dir_size_t size;
+
+        size.dir_count = *dir_count;
+        size.file_count = *ret_marked;
+        size.total = *ret_total;
+
+        ret = dir_size_compute (dirname_vpath, stat_func == mc_stat, &size, dir_size_update_cb,
+                                dsm);
+
+        *dir_count = size.dir_count;
+        *ret_marked = size.file_count;
+        *ret_total = size.total;
+        return ret;
+    }
+
     (*dir_count)++;
 
     dir = mc_opendir (dirname_vpath);
@@ -895,6 +1012,512 @@ get_times (const struct stat *sb, mc_timesbuf_t * times)
 #endif
 }
 
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef COPY_PIPE_THREADS
+static gpointer
+copy_pipe_writer (gpointer data)
+{
+    copy_pipe_t *cp = (copy_pipe_t *) data;
+
+    g_mutex_lock (&cp->lock);
+
+    while (!cp->stop && (cp->filled != 0 || !cp->eof))
+    {
+        guint slot = cp->head;
+
+        if (cp->filled == 0)
+        {
+            g_cond_wait (&cp->cond, &cp->lock);
+            continue;
+        }
+
+        /* the reader doesn't touch filled buffers */
+        g_mutex_unlock (&cp->lock);
+
+        while (cp->done[slot] < cp->len[slot])
+        {
+            ssize_t n;
+
+            n = write (cp->fd, cp->buf[slot] + cp->done[slot], cp->len[slot] - cp->done[slot]);
+            if (n > 0)
+                cp->done[slot] += (size_t) n;
+            else if (n == 0 || errno != EINTR)
+                break;
+        }
+
+        g_mutex_lock (&cp->lock);
+
+        if (cp->done[slot] < cp->len[slot])
+        {
+            /* the main thread will write the rest and report the error */
+            cp->failed = TRUE;
+            break;
+        }
+
+        cp->head = (slot + 1) % COPY_PIPE_BUFFERS;
+        cp->filled--;
+        g_cond_broadcast (&cp->cond);
+    }
+
+    cp->finished = TRUE;
+    g_cond_broadcast (&cp->cond);
+    g_mutex_unlock (&cp->lock);
+
+    return NULL;
+}
+#endif /* COPY_PIPE_THREADS */
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Wait for the writer thread.
+ *
+ * @param stop if TRUE, don't write the rest of data
+ *
+ * @return FALSE if writing failed
+ */
+
+static gboolean
+copy_pipe_finish (copy_pipe_t * cp, gboolean stop)
+{
+#ifdef COPY_PIPE_THREADS
+    if (cp->thread != NULL)
+    {
+        g_mutex_lock (&cp->lock);
+        if (stop)
+            cp->stop = TRUE;
+        else
+            cp->eof = TRUE;
+        g_cond_broadcast (&cp->cond);
+        g_mutex_unlock (&cp->lock);
+
+        g_thread_join (cp->thread);
+        cp->thread = NULL;
+    }
+#else
+    (void) stop;
+#endif
+
+    return !cp->failed;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+copy_pipe_free (copy_pipe_t * cp)
+{
+    guint i;
+
+    if (cp == NULL)
+        return;
+
+    copy_pipe_finish (cp, TRUE);
+
+#ifdef COPY_PIPE_THREADS
+    g_mutex_clear (&cp->lock);
+    g_cond_clear (&cp->cond);
+#endif
+
+    for (i = 0; i < COPY_PIPE_BUFFERS; i++)
+        g_free (cp->buf[i]);
+    g_free (cp);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Start writing of target file in another thread.
+ *
+ * @return new pipe or NULL if target file is not local or threads are not available
+ */
+
+static copy_pipe_t *
+copy_pipe_new (int dest_desc, size_t bufsize)
+{
+#ifdef COPY_PIPE_THREADS
+    copy_pipe_t *cp;
+    int fd;
+    guint i;
+
+    fd = vfs_get_local_fd (dest_desc);
+    if (fd < 0)
+        return NULL;
+
+    cp = g_new0 (copy_pipe_t, 1);
+    cp->fd = fd;
+    for (i = 0; i < COPY_PIPE_BUFFERS; i++)
+        cp->buf[i] = g_malloc (bufsize);
+    g_mutex_init (&cp->lock);
+    g_cond_init (&cp->cond);
+
+    cp->thread = g_thread_try_new ("copy", copy_pipe_writer, cp, NULL);
+    if (cp->thread == NULL)
+    {
+        copy_pipe_free (cp);
+        cp = NULL;
+    }
+
+    return cp;
+#else
+    (void) dest_desc;
+    (void) bufsize;
+
+    return NULL;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get empty buffer to read data into. Waits while all buffers are being written.
+ *
+ * @return buffer or NULL if the writer has failed
+ */
+
+static char *
+copy_pipe_get_buffer (copy_pipe_t * cp)
+{
+    char *buf = NULL;
+
+#ifdef COPY_PIPE_THREADS
+    g_mutex_lock (&cp->lock);
+    while (cp->filled == COPY_PIPE_BUFFERS && !cp->finished)
+        g_cond_wait (&cp->cond, &cp->lock);
+    if (!cp->finished)
+        buf = cp->buf[(cp->head + cp->filled) % COPY_PIPE_BUFFERS];
+    g_mutex_unlock (&cp->lock);
+#else
+    (void) cp;
+#endif
+
+    return buf;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Pass the buffer got by copy_pipe_get_buffer() to the writer.
+ */
+
+static void
+copy_pipe_put (copy_pipe_t * cp, size_t len)
+{
+#ifdef COPY_PIPE_THREADS
+    guint slot;
+
+    g_mutex_lock (&cp->lock);
+    slot = (cp->head + cp->filled) % COPY_PIPE_BUFFERS;
+    cp->len[slot] = len;
+    cp->done[slot] = 0;
+    cp->filled++;
+    g_cond_broadcast (&cp->cond);
+    g_mutex_unlock (&cp->lock);
+#else
+    (void) cp;
+    (void) len;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+copy_job_free (copy_job_t * cj)
+{
+    mc_parallel_free (cj->run);
+    g_free (cj->src_path);
+    g_free (cj->dst_path);
+    g_free (cj->src);
+    g_free (cj->dst);
+    g_free (cj);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+copy_job_copy_data (int dst_fd, int src_fd)
+{
+    vfs_copy_method_t method = VFS_COPY_RANGE;
+    char *buf;
+    ssize_t n;
+
+    while ((n = vfs_copy_local_data (dst_fd, src_fd, COPY_JOB_MAX_SIZE, FALSE, &method)) > 0)
+        ;
+
+    if (n == 0)
+        return 0;
+
+    buf = g_malloc (IO_BUFSIZE);
+
+    while ((n = read (src_fd, buf, IO_BUFSIZE)) != 0)
+    {
+        char *t = buf;
+
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        while (n > 0)
+        {
+            ssize_t n_written;
+
+            n_written = write (dst_fd, t, (size_t) n);
+            if (n_written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+            n -= n_written;
+            t += n_written;
+        }
+
+        if (n != 0)
+            break;
+    }
+
+    g_free (buf);
+
+    return (n == 0 ? 0 : -1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Copy small file. Runs in a worker thread: only system calls, no VFS and UI.
+ * Steps and their order are the same as in copy_file_file().
+ */
+
+static void
+copy_job_run (mc_parallel_t * run, guint job, gpointer user_data)
+{
+    copy_job_t *cj = (copy_job_t *) user_data;
+    int src_fd, dst_fd = -1;
+    gboolean ok;
+
+    (void) run;
+    (void) job;
+
+    src_fd = open (cj->src, O_RDONLY);
+    if (src_fd >= 0)
+        dst_fd = open (cj->dst, O_WRONLY | O_CREAT | (cj->dst_exists ? O_TRUNC : O_EXCL),
+                       cj->open_mode);
+
+    ok = dst_fd >= 0 && copy_job_copy_data (dst_fd, src_fd) == 0;
+
+    if (src_fd >= 0)
+        close (src_fd);
+    if (dst_fd >= 0 && close (dst_fd) != 0)
+        ok = FALSE;
+
+    ok = ok && (!cj->set_owner || chown (cj->dst, cj->uid, cj->gid) == 0);
+    ok = ok && (!cj->set_mode || chmod (cj->dst, cj->mode) == 0);
+#ifdef HAVE_UTIMENSAT
+    ok = ok && (!cj->set_times || utimensat (AT_FDCWD, cj->dst, cj->times, 0) == 0);
+#else
+    ok = ok && (!cj->set_times || utime (cj->dst, &cj->times) == 0);
+#endif
+
+    if (!ok)
+    {
+        cj->error = errno != 0 ? errno : EIO;
+
+        /* the main thread will copy it again */
+        if (dst_fd >= 0 && !cj->dst_exists)
+            unlink (cj->dst);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+copy_job_set_dir_attrs (copy_job_t * cj)
+{
+    vfs_path_t *vpath;
+
+    vpath = vfs_path_from_str (cj->dst_path);
+    if (cj->set_mode)
+        mc_chmod (vpath, cj->mode);
+    if (cj->set_times)
+        mc_utime (vpath, &cj->times);
+    vfs_path_free (vpath);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static FileProgressStatus
+copy_job_finish (file_op_total_context_t * tctx, file_op_context_t * ctx, copy_job_t * cj)
+{
+    FileProgressStatus status;
+    gboolean ask_overwrite;
+
+    if (cj->run == NULL)
+    {
+        copy_job_set_dir_attrs (cj);
+        return FILE_CONT;
+    }
+
+    if (cj->error == 0)
+    {
+        tctx->copied_bytes = tctx->progress_bytes + (uintmax_t) cj->size;
+        return progress_update_one (tctx, ctx, cj->size);
+    }
+
+    /* copy it in the usual way to report the error and let user decide.
+       Overwriting is already confirmed */
+    ask_overwrite = tctx->ask_overwrite;
+    tctx->ask_overwrite = FALSE;
+    copy_jobs_sync = TRUE;
+    status = copy_file_file (tctx, ctx, cj->src_path, cj->dst_path);
+    copy_jobs_sync = FALSE;
+    tctx->ask_overwrite = ask_overwrite;
+
+    return status;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Stop copy jobs which are not started yet and wait for running ones.
+ */
+
+static void
+copy_jobs_cancel (void)
+{
+    copy_job_t *cj;
+
+    while ((cj = (copy_job_t *) g_queue_pop_head (&copy_jobs)) != NULL)
+    {
+        if (cj->run == NULL)
+            copy_job_set_dir_attrs (cj);
+        copy_job_free (cj);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Finish copy jobs in the order they were queued.
+ *
+ * @param max_jobs wait until no more than this number of jobs are queued
+ *
+ * @return FILE_ABORT if user aborted the operation, FILE_CONT otherwise
+ */
+
+static FileProgressStatus
+copy_jobs_reap (file_op_total_context_t * tctx, file_op_context_t * ctx, guint max_jobs)
+{
+    FileProgressStatus status = FILE_CONT;
+    copy_job_t *cj;
+
+    while (status != FILE_ABORT && (cj = (copy_job_t *) g_queue_peek_head (&copy_jobs)) != NULL)
+    {
+        if (cj->run != NULL && !mc_parallel_wait (cj->run, 0))
+        {
+            if (g_queue_get_length (&copy_jobs) <= max_jobs)
+                break;
+
+            /* wait for the oldest job, but keep the progress dialog alive */
+            if (!mc_parallel_wait (cj->run, COPY_JOBS_WAIT_USEC))
+            {
+                status = check_progress_buttons (ctx);
+                continue;
+            }
+        }
+
+        g_queue_pop_head (&copy_jobs);
+        status = copy_job_finish (tctx, ctx, cj);
+        copy_job_free (cj);
+    }
+
+    if (status != FILE_ABORT)
+        return FILE_CONT;
+
+    copy_jobs_cancel ();
+    return FILE_ABORT;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+copy_job_is_possible (const file_op_context_t * ctx, const vfs_path_t * src_vpath,
+                      const vfs_path_t * dst_vpath, const struct stat *src_stat)
+{
+    return (copy_jobs_depth > 0 && !copy_jobs_sync && ctx->operation == OP_COPY
+            && !ctx->do_append && ctx->do_reget == 0 && !mc_global.vfs.preallocate_space
+            && S_ISREG (src_stat->st_mode) && src_stat->st_size <= COPY_JOB_MAX_SIZE
+            && (ctx->follow_links || src_stat->st_nlink < 2)
+            && vfs_file_is_local (src_vpath) && vfs_file_is_local (dst_vpath));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+copy_job_start (const file_op_context_t * ctx, const char *src_path, const char *dst_path,
+                const vfs_path_t * src_vpath, const vfs_path_t * dst_vpath,
+                const struct stat *src_stat, gboolean dst_exists)
+{
+    copy_job_t *cj;
+
+    cj = g_new0 (copy_job_t, 1);
+    cj->src_path = g_strdup (src_path);
+    cj->dst_path = g_strdup (dst_path);
+    cj->src = g_strdup (vfs_path_get_by_index (src_vpath, -1)->path);
+    cj->dst = g_strdup (vfs_path_get_by_index (dst_vpath, -1)->path);
+    cj->size = src_stat->st_size;
+    cj->dst_exists = dst_exists;
+    cj->open_mode = src_stat->st_mode & 07777;
+    cj->set_owner = ctx->preserve_uidgid;
+    cj->uid = src_stat->st_uid;
+    cj->gid = src_stat->st_gid;
+
+    if (ctx->preserve)
+    {
+        cj->set_mode = TRUE;
+        cj->mode = src_stat->st_mode & ctx->umask_kill;
+    }
+    else if (!dst_exists)
+    {
+        mode_t mask;
+
+        mask = umask (-1);
+        umask (mask);
+        cj->set_mode = TRUE;
+        cj->mode = (0100666 & ~mask) & ctx->umask_kill;
+    }
+
+    cj->set_times = TRUE;
+    get_times (src_stat, &cj->times);
+
+    g_queue_push_tail (&copy_jobs, cj);
+    cj->run = mc_parallel_start (copy_job_run, cj);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Set attributes of target directory after all its files are copied.
+ *
+ * @param times new times or NULL to keep them
+ */
+
+static void
+copy_jobs_add_dir (const vfs_path_t * dst_vpath, mode_t mode, mc_timesbuf_t * times)
+{
+    copy_job_t *cj;
+
+    cj = g_new0 (copy_job_t, 1);
+    cj->dst_path = g_strdup (vfs_path_as_str (dst_vpath));
+    cj->set_mode = TRUE;
+    cj->mode = mode;
+    cj->set_times = times != NULL;
+    if (times != NULL)
+        memcpy (&cj->times, times, sizeof (cj->times));
+
+    if (!g_queue_is_empty (&copy_jobs))
+        g_queue_push_tail (&copy_jobs, cj);
+    else
+    {
+        copy_job_set_dir_attrs (cj);
+        copy_job_free (cj);
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /* {{{ Query/status report routines */
 
@@ -2149,6 +2772,75 @@ end_bg_process (file_op_context_t * ctx, enum OperationMode mode)
 #endif
 /* }}} */
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Write data to target file, ask user what to do on errors.
+ *
+ * @return FALSE if copying should be stopped, TRUE if data is written or skipped
+ */
+
+static gboolean
+copy_file_file_write (file_op_context_t * ctx, int dest_desc, const char *buf, ssize_t len,
+                      const char *dst_path, FileProgressStatus * status)
+{
+    ssize_t n_written;
+
+    while ((n_written = mc_write (dest_desc, buf, (size_t) len)) < len)
+    {
+        gboolean write_errno_nospace;
+
+        if (n_written > 0)
+        {
+            len -= n_written;
+            buf += n_written;
+            continue;
+        }
+
+        write_errno_nospace = (n_written < 0 && errno == ENOSPC);
+
+        if (ctx->skip_all)
+            *status = FILE_SKIPALL;
+        else
+            *status = file_error (TRUE, _("Cannot write target file \"%s\"\n%s"), dst_path);
+
+        if (*status == FILE_SKIP)
+            return !write_errno_nospace;
+        if (*status == FILE_SKIPALL)
+            ctx->skip_all = TRUE;
+        if (*status != FILE_RETRY)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Stop the writer and write data left in the pipe, ask user what to do on errors.
+ *
+ * @return FALSE if copying should be stopped
+ */
+
+static gboolean
+copy_pipe_drain (file_op_context_t * ctx, copy_pipe_t * cp, int dest_desc, const char *dst_path,
+                 FileProgressStatus * status)
+{
+    copy_pipe_finish (cp, TRUE);
+
+    for (; cp->filled != 0; cp->filled--)
+    {
+        const guint slot = cp->head;
+
+        if (!copy_file_file_write (ctx, dest_desc, cp->buf[slot] + cp->done[slot],
+                                   (ssize_t) (cp->len[slot] - cp->done[slot]), dst_path, status))
+            return FALSE;
+
+        cp->head = (slot + 1) % COPY_PIPE_BUFFERS;
+    }
+
+    return TRUE;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -2214,6 +2906,7 @@ copy_file_file (file_op_total_context_t * tctx, file_op_context_t * ctx,
     int open_flags;
     vfs_path_t *src_vpath = NULL, *dst_vpath = NULL;
     char *buf = NULL;
+    copy_pipe_t *pipe = NULL;
 
     /* FIXME: We should not be using global variables! */
     ctx->do_reget = 0;
@@ -2370,6 +3063,15 @@ copy_file_file (file_op_total_context_t * tctx, file_op_context_t * ctx,
         }
     }
 
+    /* small files of directories are copied on worker threads */
+    if (copy_job_is_possible (ctx, src_vpath, dst_vpath, &src_stat))
+    {
+        return_status = copy_jobs_reap (tctx, ctx, COPY_JOBS_MAX - 1);
+        if (return_status == FILE_CONT)
+            copy_job_start (ctx, src_path, dst_path, src_vpath, dst_vpath, &src_stat, dst_exists);
+        goto ret_fast;
+    }
+
     gettimeofday (&tv_transfer_start, (struct timezone *) NULL);
 
     while ((src_desc = mc_open (src_vpath, O_RDONLY | O_LINEAR)) < 0 && !ctx->skip_all)
@@ -2532,19 +3234,54 @@ copy_file_file (file_op_total_context_t * tctx, file_op_context_t * ctx,
         int secs, update_secs;
         const char *stalled_msg = "";
         gboolean is_first_time = TRUE;
+        vfs_copy_method_t copy_method = VFS_COPY_RANGE;
+        gboolean sparse;
+        gboolean pipe_tried = FALSE;
 
         tv_last_update = tv_transfer_start;
 
         bufsize = io_blksize (dst_stat);
         buf = g_malloc (bufsize);
 
+        /* holes are kept unless the file is appended or its space is allocated already */
+        sparse = !appending && !mc_global.vfs.preallocate_space && S_ISREG (src_stat.st_mode)
+            && S_ISREG (dst_stat.st_mode);
+
         while (TRUE)
         {
-            ssize_t n_read = -1, n_written;
+            ssize_t n_read = -1;
+            gboolean copied = FALSE;
+            char *rbuf;
+
+            /* copy in the kernel while it is possible, then with our buffer */
+            if (copy_method != VFS_COPY_NONE && S_ISREG (src_stat.st_mode))
+            {
+                n_read = vfs_copy_data (dest_desc, src_desc, FILEOP_KERNEL_COPY_CHUNK, sparse,
+                                        &copy_method);
+                copied = n_read >= 0;
+            }
+
+            /* read while the previous data is being written in another thread */
+            if (!copied && !pipe_tried && file_size - n_read_total >= COPY_PIPE_MIN_SIZE)
+            {
+                pipe = copy_pipe_new (dest_desc, bufsize);
+                pipe_tried = TRUE;
+            }
+
+            rbuf = (!copied && pipe != NULL) ? copy_pipe_get_buffer (pipe) : buf;
+            if (rbuf == NULL)
+            {
+                /* writer has failed: write the rest here and report errors */
+                if (!copy_pipe_drain (ctx, pipe, dest_desc, dst_path, &return_status))
+                    goto ret;
+                copy_pipe_free (pipe);
+                pipe = NULL;
+                rbuf = buf;
+            }
 
             /* src_read */
-            if (mc_ctl (src_desc, VFS_CTL_IS_NOTREADY, 0) == 0)
-                while ((n_read = mc_read (src_desc, buf, bufsize)) < 0 && !ctx->skip_all)
+            if (!copied && mc_ctl (src_desc, VFS_CTL_IS_NOTREADY, 0) == 0)
+                while ((n_read = mc_read (src_desc, rbuf, bufsize)) < 0 && !ctx->skip_all)
                 {
                     return_status =
                         file_error (TRUE, _("Cannot read source file \"%s\"\n%s"), src_path);
@@ -2562,8 +3299,6 @@ copy_file_file (file_op_total_context_t * tctx, file_op_context_t * ctx,
 
             if (n_read > 0)
             {
-                char *t = buf;
-
                 n_read_total += n_read;
 
                 /* Windows NT ftp servers report that files have no
@@ -2575,40 +3310,12 @@ copy_file_file (file_op_total_context_t * tctx, file_op_context_t * ctx,
                 gettimeofday (&tv_last_input, NULL);
 
                 /* dst_write */
-                while ((n_written = mc_write (dest_desc, t, (size_t) n_read)) < n_read)
-                {
-                    gboolean write_errno_nospace;
-
-                    if (n_written > 0)
-                    {
-                        n_read -= n_written;
-                        t += n_written;
-                        continue;
-                    }
-
-                    write_errno_nospace = (n_written < 0 && errno == ENOSPC);
-
-                    if (ctx->skip_all)
-                        return_status = FILE_SKIPALL;
-                    else
-                        return_status =
-                            file_error (TRUE, _("Cannot write target file \"%s\"\n%s"), dst_path);
-
-                    if (return_status == FILE_SKIP)
-                    {
-                        if (write_errno_nospace)
-                            goto ret;
-                        break;
-                    }
-                    if (return_status == FILE_SKIPALL)
-                    {
-                        ctx->skip_all = TRUE;
-                        if (write_errno_nospace)
-                            goto ret;
-                    }
-                    if (return_status != FILE_RETRY)
-                        goto ret;
-                }
+                if (!copied && pipe != NULL)
+                    copy_pipe_put (pipe, (size_t) n_read);
+                else if (!copied
+                         && !copy_file_file_write (ctx, dest_desc, rbuf, n_read, dst_path,
+                                                   &return_status))
+                    goto ret;
             }
 
             tctx->copied_bytes = tctx->progress_bytes + n_read_total + ctx->do_reget;
@@ -2656,10 +3363,16 @@ copy_file_file (file_op_total_context_t * tctx, file_op_context_t * ctx,
             }
         }
 
+        /* wait for the writer */
+        if (pipe != NULL && !copy_pipe_finish (pipe, FALSE)
+            && !copy_pipe_drain (ctx, pipe, dest_desc, dst_path, &return_status))
+            goto ret;
+
         dst_status = DEST_FULL; /* copy successful, don't remove target file */
     }
 
   ret:
+    copy_pipe_free (pipe);
     g_free (buf);
 
     rotate_dash (FALSE);
@@ -2952,6 +3665,8 @@ copy_dir_dir (file_op_total_context_t * tctx, file_op_context_t * ctx, const cha
     if (reading == NULL)
         goto ret;
 
+    copy_jobs_depth++;
+
     while ((next = mc_readdir (reading)) && return_status != FILE_ABORT)
     {
         char *path;
@@ -3013,20 +3728,30 @@ copy_dir_dir (file_op_total_context_t * tctx, file_op_context_t * ctx, const cha
     }
     mc_closedir (reading);
 
+    /* attributes are set when files queued before are copied */
     if (ctx->preserve)
     {
         mc_timesbuf_t times;
 
-        mc_chmod (dst_vpath, src_stat.st_mode & ctx->umask_kill);
         get_times (&src_stat, &times);
-        mc_utime (dst_vpath, &times);
+        copy_jobs_add_dir (dst_vpath, src_stat.st_mode & ctx->umask_kill, &times);
     }
     else
     {
         src_stat.st_mode = umask (-1);
         umask (src_stat.st_mode);
         src_stat.st_mode = 0100777 & ~src_stat.st_mode;
-        mc_chmod (dst_vpath, src_stat.st_mode & ctx->umask_kill);
+        copy_jobs_add_dir (dst_vpath, src_stat.st_mode & ctx->umask_kill, NULL);
+    }
+
+    copy_jobs_depth--;
+    if (copy_jobs_depth == 0)
+    {
+        /* the whole tree is copied: wait for the rest of files */
+        if (return_status == FILE_ABORT)
+            copy_jobs_cancel ();
+        else if (copy_jobs_reap (tctx, ctx, 0) == FILE_ABORT)
+            return_status = FILE_ABORT;
     }
 
   ret:
@@ -3193,6 +3918,26 @@ compute_dir_size (const vfs_path_t * dirname_vpath, dirsize_status_msg_t * sm,
                                 follow_symlinks ? mc_stat : mc_lstat);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Translate names of operations. Must be called before op_names is used.
+ */
+
+void
+file_op_names_init (void)
+{
+    static gboolean i18n_flag = FALSE;
+
+    if (!i18n_flag)
+    {
+        size_t i;
+
+        for (i = G_N_ELEMENTS (op_names); i-- != 0;)
+            op_names[i] = Q_ (op_names[i]);
+        i18n_flag = TRUE;
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * panel_operate:
@@ -3229,13 +3974,7 @@ panel_operate (void *source_panel, FileOperation operation, gboolean force_singl
 
     gboolean do_bg = FALSE;     /* do background operation? */
 
-    static gboolean i18n_flag = FALSE;
-    if (!i18n_flag)
-    {
-        for (i = G_N_ELEMENTS (op_names); i-- != 0;)
-            op_names[i] = Q_ (op_names[i]);
-        i18n_flag = TRUE;
-    }
+    file_op_names_init ();
 
     linklist = free_linklist (linklist);
     dest_dirs = free_linklist (dest_dirs);
@@ -52,6 +52,7 @@ FileProgressStatus copy_dir_dir (file_op_total_context_t * tctx, file_op_context
 FileProgressStatus erase_dir (file_op_total_context_t * tctx, file_op_context_t * ctx,
                               const vfs_path_t * vpath);
 
+void file_op_names_init (void);
 gboolean panel_operate (void *source_panel, FileOperation op, gboolean force_single);
 
 /* Error reporting routines */
@@ -34,7 +34,8 @@ typedef enum
 {
     OP_COPY = 0,
     OP_MOVE = 1,
-    OP_DELETE = 2
+    OP_DELETE = 2,
+    OP_REPLACE = 3
 } FileOperation;
 
 typedef enum
@@ -179,7 +180,7 @@ typedef struct
 
 /*** global variables defined in .c file *********************************************************/
 
-extern const char *op_names[3];
+extern const char *op_names[4];
 
 /*** declarations of public functions ************************************************************/
 
@@ -0,0 +1,609 @@
+/*
+   Search and replace in many local files at once.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file filereplace.c
+ *  \brief Source: search and replace in many local files at once
+ *
+ *  Files are processed by parallel jobs, the main thread only updates the progress window.
+ *  Every job takes the next file from the list, reads it by blocks and searches it line by
+ *  line like find file does, so memory usage is bounded by the longest line. The result is
+ *  written to a temporary file in the same directory which replaces the original one by
+ *  rename(), so other programs never see half-written file. Files without matches are left
+ *  untouched.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>             /* realpath() */
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lib/global.h"
+#include "lib/parallel.h"
+#include "lib/search.h"
+
+#include "filereplace.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/* size of read and write buffers */
+#define FILE_REPLACE_BUF_SIZE (64 * 1024)
+
+/* files with longer lines are skipped */
+#define FILE_REPLACE_LINE_MAX (1024 * 1024)
+
+/* files are mostly read, so more jobs than processors don't help */
+#define FILE_REPLACE_MAX_JOBS 16
+
+/* update status with 25 FPS rate */
+#define FILE_REPLACE_WAIT_USEC (G_USEC_PER_SEC / 25)
+
+/*** file scope type declarations ****************************************************************/
+
+typedef struct
+{
+    /* read-only while jobs are running */
+    const GPtrArray *paths;
+    GString *replace_str;
+    mc_search_t **searches;     /* search handles aren't thread-safe: one per job */
+    guint jobs;
+
+    /* protected by the lock */
+    guint next;                 /* index of the next file to process */
+    file_replace_status_t status;
+} file_replace_run_t;
+
+/* buffers of one job */
+typedef struct
+{
+    char *in;
+    GString *line;
+    GString *out;
+} file_replace_buf_t;
+
+/*** file scope variables ************************************************************************/
+
+G_LOCK_DEFINE_STATIC (file_replace);
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+file_replace_write (int fd, const GString * buf)
+{
+    gsize written = 0;
+
+    while (written < buf->len)
+    {
+        ssize_t n;
+
+        n = write (fd, buf->str + written, buf->len - written);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return FALSE;
+        }
+        written += (gsize) n;
+    }
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Replace all matches in one line.
+ *
+ * @return number of replacements or -1 if replacement can't be made
+ */
+
+static int
+file_replace_line (const file_replace_run_t * fr, mc_search_t * search, const GString * line,
+                   GString * out)
+{
+    gsize pos = 0;
+    int count = 0;
+
+    while (pos < line->len)
+    {
+        gsize found_len = 0;
+        gsize start;
+        GString *repl;
+
+        if (!mc_search_run (search, line->str, pos, line->len, &found_len))
+        {
+            if (search->error != MC_SEARCH_E_NOTFOUND)
+                return -1;
+            break;
+        }
+
+        start = (gsize) search->normal_offset;
+
+        repl = mc_search_prepare_replace_str (search, fr->replace_str);
+        if (repl == NULL || search->error != MC_SEARCH_E_OK)
+        {
+            if (repl != NULL)
+                g_string_free (repl, TRUE);
+            return -1;
+        }
+
+        g_string_append_len (out, line->str + pos, start - pos);
+        g_string_append_len (out, repl->str, repl->len);
+        g_string_free (repl, TRUE);
+        count++;
+
+        pos = start + found_len;
+
+        /* empty match: step over one byte to avoid endless loop */
+        if (found_len == 0 && pos < line->len)
+            g_string_append_c (out, line->str[pos++]);
+    }
+
+    if (pos < line->len)
+        g_string_append_len (out, line->str + pos, line->len - pos);
+
+    return count;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Copy first @len bytes of file which contain nothing to replace */
+
+static gboolean
+file_replace_copy_head (int fd, int tmp_fd, off_t len)
+{
+    char buffer[BUF_8K];
+    off_t offset = 0;
+
+    while (offset < len)
+    {
+        ssize_t n;
+        gsize written = 0;
+
+        n = pread (fd, buffer, MIN ((off_t) sizeof (buffer), len - offset), offset);
+        if (n <= 0)
+        {
+            if (n < 0 && errno == EINTR)
+                continue;
+            /* file is shorter than it was */
+            if (n == 0)
+                errno = EIO;
+            return FALSE;
+        }
+
+        while (written < (gsize) n)
+        {
+            ssize_t w;
+
+            w = write (tmp_fd, buffer + written, (gsize) n - written);
+            if (w < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return FALSE;
+            }
+            written += (gsize) w;
+        }
+
+        offset += n;
+    }
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+file_replace_add_bytes (file_replace_run_t * fr, gsize bytes)
+{
+    G_LOCK (file_replace);
+    fr->status.bytes_done += bytes;
+    G_UNLOCK (file_replace);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Process one file. Runs in worker thread.
+ *
+ * @return number of replacements made in the file, -1 if file can't be processed. In the last
+ *         case @error is set to the error message.
+ */
+
+static int
+file_replace_file (file_replace_run_t * fr, mc_parallel_t * run, mc_search_t * search,
+                   file_replace_buf_t * buf, const char *path, char **error)
+{
+    struct stat st, st2;
+    char *real_path, *tmp_path = NULL;
+    char *base;
+    int fd, tmp_fd = -1;
+    off_t line_offset = 0;      /* offset of the current line in the file */
+    int count = 0;
+    const char *msg = NULL;
+
+    /* replace target of symlink rather than symlink itself */
+    real_path = realpath (path, NULL);
+    if (real_path == NULL)
+    {
+        *error = g_strdup_printf ("%s: %s", path, g_strerror (errno));
+        return -1;
+    }
+
+    fd = open (real_path, O_RDONLY);
+    if (fd == -1 || fstat (fd, &st) != 0)
+    {
+        *error = g_strdup_printf ("%s: %s", path, g_strerror (errno));
+        if (fd != -1)
+            close (fd);
+        free (real_path);
+        return -1;
+    }
+
+    if (!S_ISREG (st.st_mode))
+    {
+        /* nothing to do */
+        close (fd);
+        free (real_path);
+        return 0;
+    }
+
+    if (st.st_nlink > 1)
+    {
+        /* rename() would break the link */
+        *error = g_strdup_printf (_("%s: file has hard links"), path);
+        close (fd);
+        free (real_path);
+        return -1;
+    }
+
+    g_string_set_size (buf->line, 0);
+    g_string_set_size (buf->out, 0);
+
+    while (msg == NULL)
+    {
+        ssize_t n;
+        char *p, *end;
+
+        if (mc_parallel_is_cancelled (run))
+        {
+            count = 0;
+            break;
+        }
+
+        n = read (fd, buf->in, FILE_REPLACE_BUF_SIZE);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            msg = g_strerror (errno);
+            break;
+        }
+
+        file_replace_add_bytes (fr, (gsize) n);
+
+        p = buf->in;
+        end = buf->in + n;
+
+        while (msg == NULL && (p < end || (n == 0 && buf->line->len != 0)))
+        {
+            char *eol = NULL;
+            int c;
+
+            if (p < end)
+            {
+                eol = memchr (p, '\n', end - p);
+                if (eol != NULL)
+                    eol++;
+                g_string_append_len (buf->line, p, (eol != NULL ? eol : end) - p);
+                p = eol != NULL ? eol : end;
+
+                if (eol == NULL)
+                {
+                    /* line continues in the next block */
+                    if (buf->line->len > FILE_REPLACE_LINE_MAX)
+                        msg = _("line is too long");
+                    continue;
+                }
+            }
+
+            /* whole line or the last line without newline */
+            c = file_replace_line (fr, search, buf->line, buf->out);
+
+            if (c < 0)
+                msg = search->error_str != NULL ? search->error_str : _("replacement failed");
+            else if (c != 0 && count == 0)
+            {
+                /* the first replacement: create temporary file and copy lines before */
+                base = g_path_get_basename (real_path);
+                tmp_path = g_strdup_printf ("%.*s.%s.XXXXXX",
+                                            (int) (strlen (real_path) - strlen (base)),
+                                            real_path, base);
+                g_free (base);
+
+                tmp_fd = g_mkstemp_full (tmp_path, O_WRONLY, S_IRUSR | S_IWUSR);
+                if (tmp_fd == -1 || !file_replace_copy_head (fd, tmp_fd, line_offset))
+                    msg = g_strerror (errno);
+            }
+            else if (count == 0)
+            {
+                /* nothing to write yet: the head is copied from file if needed */
+                g_string_set_size (buf->out, 0);
+            }
+
+            if (c > 0)
+                count += c;
+
+            line_offset += (off_t) buf->line->len;
+            g_string_set_size (buf->line, 0);
+
+            if (msg == NULL && tmp_fd != -1 && buf->out->len >= FILE_REPLACE_BUF_SIZE)
+            {
+                if (!file_replace_write (tmp_fd, buf->out))
+                    msg = g_strerror (errno);
+                g_string_set_size (buf->out, 0);
+            }
+        }
+
+        if (n == 0)
+            break;
+    }
+
+    if (msg == NULL && count != 0)
+    {
+        if (!file_replace_write (tmp_fd, buf->out))
+            msg = g_strerror (errno);
+        /* don't replace file which was changed by someone else meanwhile */
+        else if (fstat (fd, &st2) != 0 || st2.st_size != st.st_size
+                 || st2.st_mtime != st.st_mtime)
+            msg = _("file was changed while replacing");
+        else
+        {
+            /* ordinary user can't give file away: keep at least the group */
+            if (fchown (tmp_fd, st.st_uid, st.st_gid) != 0
+                && fchown (tmp_fd, (uid_t) (-1), st.st_gid) != 0)
+            {
+                /* not an error: file is owned by the user now */
+            }
+
+            if (fchmod (tmp_fd, st.st_mode & 07777) != 0)
+                msg = g_strerror (errno);
+        }
+
+        if (close (tmp_fd) != 0 && msg == NULL)
+            msg = g_strerror (errno);
+        tmp_fd = -1;
+
+        if (msg == NULL && rename (tmp_path, real_path) != 0)
+            msg = g_strerror (errno);
+    }
+
+    if (tmp_fd != -1)
+        close (tmp_fd);
+    close (fd);
+
+    if (msg != NULL)
+    {
+        *error = g_strdup_printf ("%s: %s", path, msg);
+        count = -1;
+    }
+
+    /* cancelled or failed: keep the original file */
+    if (tmp_path != NULL && count <= 0)
+        unlink (tmp_path);
+
+    g_free (tmp_path);
+    free (real_path);
+
+    return count;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+file_replace_job (mc_parallel_t * run, guint job, gpointer user_data)
+{
+    file_replace_run_t *fr = (file_replace_run_t *) user_data;
+    file_replace_buf_t buf;
+
+    buf.in = g_malloc (FILE_REPLACE_BUF_SIZE);
+    buf.line = g_string_sized_new (BUF_LARGE);
+    buf.out = g_string_sized_new (FILE_REPLACE_BUF_SIZE + BUF_LARGE);
+
+    while (!mc_parallel_is_cancelled (run))
+    {
+        const char *path;
+        char *error = NULL;
+        int count;
+
+        G_LOCK (file_replace);
+        if (fr->next >= fr->paths->len)
+        {
+            G_UNLOCK (file_replace);
+            break;
+        }
+        path = (const char *) g_ptr_array_index (fr->paths, fr->next++);
+        g_free (fr->status.current);
+        fr->status.current = g_strdup (path);
+        G_UNLOCK (file_replace);
+
+        count = file_replace_file (fr, run, fr->searches[job], &buf, path, &error);
+
+        G_LOCK (file_replace);
+        fr->status.files_done++;
+        if (count > 0)
+        {
+            fr->status.files_changed++;
+            fr->status.replaced += (size_t) count;
+        }
+        else if (count < 0)
+        {
+            fr->status.errors++;
+            if (fr->status.error == NULL)
+            {
+                fr->status.error = error;
+                error = NULL;
+            }
+        }
+        G_UNLOCK (file_replace);
+
+        g_free (error);
+    }
+
+    g_string_free (buf.out, TRUE);
+    g_string_free (buf.line, TRUE);
+    g_free (buf.in);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static FileProgressStatus
+file_replace_update (file_replace_run_t * fr, file_replace_update_fn update, void *data)
+{
+    file_replace_status_t status;
+    FileProgressStatus ret;
+
+    if (update == NULL)
+        return FILE_CONT;
+
+    /* jobs don't wait while the status is shown */
+    G_LOCK (file_replace);
+    status = fr->status;
+    status.current = g_strdup (fr->status.current);
+    status.error = NULL;
+    G_UNLOCK (file_replace);
+
+    ret = update (&status, data);
+    g_free (status.current);
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Replace all matches of the pattern in local files.
+ *
+ * @param paths full local paths of files. Anything but regular files and symlinks to them is
+ *              skipped
+ * @param options search and replace strings and search options
+ * @param status result counters, must be freed by file_replace_status_free()
+ * @param update function to show progress, can be NULL
+ * @param data data for @update
+ *
+ * @return FILE_CONT, FILE_ABORT if pattern is invalid (status->error is set) or result of
+ *         @update which has stopped processing
+ */
+
+FileProgressStatus
+file_replace (const GPtrArray * paths, const file_replace_options_t * options,
+              file_replace_status_t * status, file_replace_update_fn update, void *data)
+{
+    file_replace_run_t fr;
+    mc_parallel_t *run;
+    FileProgressStatus ret = FILE_CONT;
+    guint i;
+
+    memset (status, 0, sizeof (*status));
+
+    if (paths->len == 0)
+        return FILE_CONT;
+
+    memset (&fr, 0, sizeof (fr));
+    fr.paths = paths;
+    fr.replace_str = g_string_new (options->replace != NULL ? options->replace : "");
+
+    fr.jobs = MIN (paths->len, MIN (mc_parallel_get_workers (), FILE_REPLACE_MAX_JOBS));
+    /* one job would be run synchronously without updates of status */
+    if (paths->len > 1)
+        fr.jobs = MAX (fr.jobs, 2);
+
+    /* search handles are prepared here, jobs only run them */
+    fr.searches = g_new0 (mc_search_t *, fr.jobs);
+    for (i = 0; i < fr.jobs && ret == FILE_CONT; i++)
+    {
+        mc_search_t *search;
+
+        search = mc_search_new (options->search, NULL);
+        fr.searches[i] = search;
+
+        if (search == NULL)
+        {
+            status->error = g_strdup (_("Search string is empty"));
+            ret = FILE_ABORT;
+            break;
+        }
+
+        search->search_type = options->type;
+        search->is_case_sensitive = options->case_sens;
+        search->whole_words = options->whole_words;
+
+        if (!mc_search_prepare (search))
+        {
+            status->error = g_strdup (search->error_str);
+            ret = FILE_ABORT;
+        }
+    }
+
+    if (ret == FILE_CONT)
+    {
+        run = mc_parallel_run (fr.jobs, file_replace_job, &fr);
+        while (!mc_parallel_wait (run, FILE_REPLACE_WAIT_USEC))
+            if (ret == FILE_CONT)
+            {
+                ret = file_replace_update (&fr, update, data);
+                /* let jobs finish current blocks and leave files untouched */
+                if (ret != FILE_CONT)
+                    mc_parallel_cancel (run);
+            }
+        mc_parallel_free (run);
+
+        if (ret == FILE_CONT)
+            ret = file_replace_update (&fr, update, data);
+
+        *status = fr.status;
+    }
+
+    for (i = 0; i < fr.jobs; i++)
+        mc_search_free (fr.searches[i]);
+    g_free (fr.searches);
+    g_string_free (fr.replace_str, TRUE);
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+file_replace_status_free (file_replace_status_t * status)
+{
+    MC_PTR_FREE (status->current);
+    MC_PTR_FREE (status->error);
+}
+
+/* --------------------------------------------------------------------------------------------- */
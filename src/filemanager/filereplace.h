@@ -0,0 +1,56 @@
+/** \file filereplace.h
+ *  \brief Header: search and replace in many local files at once
+ */
+
+#ifndef MC__FILEREPLACE_H
+#define MC__FILEREPLACE_H
+
+#include <inttypes.h>           /* uintmax_t */
+
+#include "lib/global.h"
+#include "lib/search.h"         /* mc_search_type_t */
+
+#include "fileopctx.h"          /* FileProgressStatus */
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+typedef struct
+{
+    const char *search;
+    const char *replace;
+    mc_search_type_t type;
+    gboolean case_sens;
+    gboolean whole_words;
+} file_replace_options_t;
+
+typedef struct
+{
+    size_t files_done;          /* processed files */
+    size_t files_changed;       /* files where something was replaced */
+    size_t replaced;            /* number of replacements */
+    uintmax_t bytes_done;       /* read bytes */
+    size_t errors;              /* files which couldn't be processed */
+    char *current;              /* last started file */
+    char *error;                /* message about the first error */
+} file_replace_status_t;
+
+/* called while files are processed, anything but FILE_CONT stops processing */
+typedef FileProgressStatus (*file_replace_update_fn) (const file_replace_status_t * status,
+                                                      void *data);
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+FileProgressStatus file_replace (const GPtrArray * paths, const file_replace_options_t * options,
+                                 file_replace_status_t * status, file_replace_update_fn update,
+                                 void *data);
+void file_replace_status_free (file_replace_status_t * status);
+
+/*** inline functions ****************************************************************************/
+
+#endif /* MC__FILEREPLACE_H */
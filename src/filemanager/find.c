@@ -37,6 +37,9 @@
 #include <string.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include "lib/global.h"
 
@@ -49,6 +52,7 @@
 #include "lib/strutil.h"
 #include "lib/widget.h"
 #include "lib/util.h"           /* canonicalize_pathname() */
+#include "lib/parallel.h"
 
 #include "src/setup.h"          /* verbose */
 #include "src/history.h"        /* MC_HISTORY_SHARED_SEARCH */
@@ -58,6 +62,8 @@
 #include "midnight.h"           /* current_panel */
 #include "boxes.h"
 #include "panelize.h"
+#include "findignore.h"
+#include "findindex.h"
 
 /*** global variables ****************************************************************************/
 
@@ -66,6 +72,17 @@
 #define MAX_REFRESH_INTERVAL (G_USEC_PER_SEC / 20)      /* 50 ms */
 #define MIN_REFRESH_FILE_SIZE (256 * 1024)      /* 256 KB */
 
+/* local trees are searched by worker threads, see find_engine_new() */
+#if GLIB_CHECK_VERSION (2, 32, 0)
+#define FIND_THREADS 1
+#endif
+
+/* workers are long-running jobs: leave threads of the pool for others */
+#define FIND_MAX_JOBS 32
+
+/* mapped files are given to the matcher by parts to check for events between them */
+#define FIND_GREP_BLOCK (1024 * 1024)
+
 /*** file scope type declarations ****************************************************************/
 
 /* A couple of extra messages we need */
@@ -101,6 +118,8 @@ typedef struct
     gboolean content_first_hit;
     gboolean content_whole_words;
     gboolean content_all_charsets;
+    /* skip files which can't contain the content pattern according to the index */
+    gboolean content_use_index;
 
     /* whether use ignore dirs or not */
     gboolean ignore_dirs_enable;
@@ -115,6 +134,100 @@ typedef struct
     gsize end;
 } find_match_location_t;
 
+/* local file mapped to memory and searched in place, see find_grep_map_next() */
+typedef struct
+{
+    vfs_file_map_t *map;
+    gsize pos;                  /* offset to search from, always at start of line */
+    int line;                   /* number of line at pos */
+
+    /* last match */
+    int found_line;
+    gsize found_start;
+    gsize found_len;
+
+    /* called periodically during search, anything but FIND_CONT stops it */
+    FindProgressStatus (*check) (void *data);
+    void *check_data;
+    gsize next_check;
+    FindProgressStatus status;
+} find_grep_map_t;
+
+/* file read line by line, see find_grep_read_next() */
+typedef struct
+{
+    int fd;
+    ssize_t (*read) (int fd, void *buf, size_t count);
+    char buffer[BUF_4K];        /* raw input buffer */
+    int n_read;                 /* size of data in buffer */
+    int pos;                    /* position of next char in buffer */
+    off_t off;                  /* fd's offset corresponding to strbuf[0] */
+    int i;                      /* length of current line */
+    int line;                   /* number of current line */
+    gboolean line_found;        /* binary line is searched once */
+    char *strbuf;               /* buffer for fetched string */
+    int strbuf_size;
+
+    /* last match */
+    int found_line;
+    gsize found_start;
+    gsize found_len;
+
+    /* called every 256 lines, anything but FIND_CONT stops search */
+    FindProgressStatus (*check) (void *data);
+    void *check_data;
+    FindProgressStatus status;
+} find_grep_read_t;
+
+#ifdef FIND_THREADS
+/* match found by worker thread */
+typedef struct
+{
+    char *dir;
+    char *text;                 /* file name, "line:file name" for content search */
+    gsize start;
+    gsize end;
+} find_result_t;
+
+/* file which name is matched, its content should be searched */
+typedef struct
+{
+    char *dir;
+    char *name;
+} find_file_t;
+
+typedef struct
+{
+    mc_parallel_t *run;
+    GMutex lock;
+    GCond cond;
+
+    /* protected by lock */
+    GQueue dirs;                /* directories to read */
+    GQueue files;               /* files to grep, taken before directories */
+    guint busy;                 /* workers which process something */
+    gboolean paused;            /* search is suspended by user */
+    size_t ignore_count;
+    char *current;              /* last directory or file taken by some worker */
+    gboolean current_is_file;
+
+    /* arrays of find_result_t, one per directory or file */
+    GAsyncQueue *results;
+
+    /* every job has own search handles */
+    mc_search_t **file_handles;
+    mc_search_t **content_handles;
+    guint jobs;
+} find_engine_t;
+
+/* check_data of find_grep_map_t in worker thread */
+typedef struct
+{
+    find_engine_t *e;
+    mc_parallel_t *run;
+} find_engine_grep_check_t;
+#endif /* FIND_THREADS */
+
 /*** file scope variables ************************************************************************/
 
 /* button callbacks */
@@ -122,8 +235,8 @@ static int start_stop (WButton * button, int action);
 static int find_do_view_file (WButton * button, int action);
 static int find_do_edit_file (WButton * button, int action);
 
-/* Parsed ignore dirs */
-static char **find_ignore_dirs = NULL;
+/* Parsed ignore dirs: set of canonicalized paths */
+static GHashTable *find_ignore_dirs = NULL;
 
 /* static variables to remember find parameters */
 static WInput *in_start;        /* Start path */
@@ -173,6 +286,11 @@ static WLabel *found_num_label; /* Number of found items */
 /* This keeps track of the directory stack */
 static GQueue dir_queue = G_QUEUE_INIT;
 
+#ifdef FIND_THREADS
+/* search of local directory tree in worker threads */
+static find_engine_t *engine = NULL;
+#endif
+
 /* *INDENT-OFF* */
 static struct
 {
@@ -205,13 +323,14 @@ static WListbox *find_list;     /* Listbox with the file list */
 static find_file_options_t options = {
     TRUE, TRUE, TRUE, FALSE, FALSE,
     TRUE, FALSE, FALSE, FALSE, FALSE,
-    FALSE, NULL
+    FALSE, FALSE, NULL
 };
 
 static char *in_start_dir = INPUT_LAST_TEXT;
 
 static mc_search_t *search_file_handle = NULL;
 static mc_search_t *search_content_handle = NULL;
+static find_index_query_t *content_index_query = NULL;
 
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
@@ -228,50 +347,6 @@ max (int a, int b)
 
 /* --------------------------------------------------------------------------------------------- */
 
-static void
-parse_ignore_dirs (const char *ignore_dirs)
-{
-    size_t r = 0, w = 0;        /* read and write iterators */
-
-    if (!options.ignore_dirs_enable || ignore_dirs == NULL || ignore_dirs[0] == '\0')
-        return;
-
-    find_ignore_dirs = g_strsplit (ignore_dirs, ":", -1);
-
-    /* Values like '/foo::/bar: produce holes in list.
-     * Find and remove them */
-    for (; find_ignore_dirs[r] != NULL; r++)
-    {
-        if (find_ignore_dirs[r][0] == '\0')
-        {
-            /* empty entry -- skip it */
-            MC_PTR_FREE (find_ignore_dirs[r]);
-            continue;
-        }
-
-        if (r != w)
-        {
-            /* copy entry to the previous free array cell */
-            find_ignore_dirs[w] = find_ignore_dirs[r];
-            find_ignore_dirs[r] = NULL;
-        }
-
-        canonicalize_pathname (find_ignore_dirs[w]);
-        if (find_ignore_dirs[w][0] != '\0')
-            w++;
-        else
-            MC_PTR_FREE (find_ignore_dirs[w]);
-    }
-
-    if (find_ignore_dirs[0] == NULL)
-    {
-        g_strfreev (find_ignore_dirs);
-        find_ignore_dirs = NULL;
-    }
-}
-
-/* --------------------------------------------------------------------------------------------- */
-
 static void
 find_load_options (void)
 {
@@ -302,6 +377,8 @@ find_load_options (void)
         mc_config_get_bool (mc_global.main_config, "FindFile", "content_whole_words", FALSE);
     options.content_all_charsets =
         mc_config_get_bool (mc_global.main_config, "FindFile", "content_all_charsets", FALSE);
+    options.content_use_index =
+        mc_config_get_bool (mc_global.main_config, "FindFile", "content_use_index", FALSE);
     options.ignore_dirs_enable =
         mc_config_get_bool (mc_global.main_config, "FindFile", "ignore_dirs_enable", TRUE);
     options.ignore_dirs =
@@ -334,6 +411,8 @@ find_save_options (void)
                         options.content_whole_words);
     mc_config_set_bool (mc_global.main_config, "FindFile", "content_all_charsets",
                         options.content_all_charsets);
+    mc_config_set_bool (mc_global.main_config, "FindFile", "content_use_index",
+                        options.content_use_index);
     mc_config_set_bool (mc_global.main_config, "FindFile", "ignore_dirs_enable",
                         options.ignore_dirs_enable);
     mc_config_set_string (mc_global.main_config, "FindFile", "ignore_dirs", options.ignore_dirs);
@@ -973,6 +1052,329 @@ check_find_events (WDialog * h)
     return FIND_CONT;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+
+static mc_search_cbret_t
+find_grep_map_block (const void *user_data, gsize offset, const char **block, gsize * block_len)
+{
+    const find_grep_map_t *g = (const find_grep_map_t *) user_data;
+
+    if (offset >= g->map->size)
+        return MC_SEARCH_CB_NOTFOUND;
+
+    *block = g->map->data + offset;
+    *block_len = MIN (g->map->size - offset, FIND_GREP_BLOCK);
+    return MC_SEARCH_CB_OK;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static mc_search_cbret_t
+find_grep_map_update (const void *user_data, gsize offset)
+{
+    find_grep_map_t *g = (find_grep_map_t *) user_data;
+
+    if (offset < g->next_check || g->check == NULL)
+        return MC_SEARCH_CB_OK;
+
+    g->next_check = offset + FIND_GREP_BLOCK;
+    g->status = g->check (g->check_data);
+
+    return (g->status == FIND_CONT ? MC_SEARCH_CB_OK : MC_SEARCH_CB_ABORT);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find next line of mapped file which matches the content pattern. The matcher runs over
+ * the whole rest of file, line numbers are counted only up to found matches.
+ *
+ * @return TRUE if found: found_line, found_start and found_len are set,
+ *         FALSE if not found or stopped by check callback (status is set in this case)
+ */
+
+static gboolean
+find_grep_map_next (find_grep_map_t * g, mc_search_t * search)
+{
+    const char *data = g->map->data;
+    const char *p;
+    gboolean found;
+
+    if (g->pos >= g->map->size)
+        return FALSE;
+
+    search->block_fn = find_grep_map_block;
+    search->update_fn = find_grep_map_update;
+    found = mc_search_run (search, g, g->pos, g->map->size - 1, &g->found_len);
+    search->block_fn = NULL;
+    search->update_fn = NULL;
+
+    if (!found)
+        return FALSE;
+
+    g->found_start = (gsize) search->normal_offset;
+    g->found_line = g->line;
+    for (p = data + g->pos; (p = memchr (p, '\n', g->found_start - (gsize) (p - data))) != NULL;
+         p++)
+        g->found_line++;
+
+    /* one match per line is reported: continue from the next line */
+    p = memchr (data + g->found_start, '\n', g->map->size - g->found_start);
+    g->pos = p == NULL ? g->map->size : (gsize) (p - data) + 1;
+    g->line = g->found_line + 1;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find next line of file which matches the content pattern. File is read by portions and
+ * split to lines, lines are searched one by one.
+ *
+ * @return TRUE if found: found_line, found_start and found_len are set,
+ *         FALSE if not found or stopped by check callback (status is set in this case)
+ */
+
+static gboolean
+find_grep_read_next (find_grep_read_t * g, mc_search_t * search)
+{
+    while (g->status == FIND_CONT)
+    {
+        char ch = '\0';
+        gboolean found = FALSE;
+
+        g->off += g->i + 1;     /* the previous line, plus a newline character */
+        g->i = 0;
+
+        /* read to buffer and get line from there */
+        while (TRUE)
+        {
+            if (g->pos >= g->n_read)
+            {
+                g->pos = 0;
+                g->n_read = g->read (g->fd, g->buffer, sizeof (g->buffer));
+                if (g->n_read <= 0)
+                    break;
+            }
+
+            ch = g->buffer[g->pos++];
+            if (ch == '\0')
+            {
+                /* skip possible leading zero(s) */
+                if (g->i == 0)
+                {
+                    g->off++;
+                    continue;
+                }
+                break;
+            }
+
+            if (g->i >= g->strbuf_size - 1)
+            {
+                g->strbuf_size += 128;
+                g->strbuf = g_realloc (g->strbuf, g->strbuf_size);
+            }
+
+            /* Strip newline */
+            if (ch == '\n')
+                break;
+
+            g->strbuf[g->i++] = ch;
+        }
+
+        if (g->i == 0)
+        {
+            if (ch == '\0')
+                break;
+            /* if (ch == '\n'): do not search in empty strings */
+        }
+        else
+        {
+            g->strbuf[g->i] = '\0';
+
+            if (!g->line_found  /* Search in binary line once */
+                && mc_search_run (search, (const void *) g->strbuf, 0, g->i, &g->found_len))
+            {
+                g->found_line = g->line;
+                g->found_start = (gsize) g->off + (gsize) search->normal_offset;
+                g->line_found = TRUE;
+                found = TRUE;
+            }
+        }
+
+        if (ch == '\n')
+        {
+            g->line_found = FALSE;
+            g->line++;
+        }
+
+        if ((g->line & 0xff) == 0 && g->check != NULL)
+            g->status = g->check (g->check_data);
+
+        if (found)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static FindProgressStatus
+search_content_check (void *data)
+{
+    return check_find_events ((WDialog *) data);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Search the content pattern in the mapped local file like search_content() does.
+ *
+ * returns FALSE if do_search should look for another file
+ *         TRUE if do_search should exit and proceed to the event handler
+ */
+
+static gboolean
+search_content_map (WDialog * h, const char *directory, const char *filename,
+                    vfs_file_map_t * map, gboolean status_updated, const struct timeval *tv)
+{
+    find_grep_map_t g;
+
+    memset (&g, 0, sizeof (g));
+    g.map = map;
+    g.line = 1;
+    g.check = search_content_check;
+    g.check_data = h;
+    g.status = FIND_CONT;
+
+    if (resuming)
+    {
+        /* We've been previously suspended, start from the previous position */
+        resuming = FALSE;
+        g.line = last_line;
+        g.pos = (gsize) last_off;
+    }
+
+    while (find_grep_map_next (&g, search_content_handle))
+    {
+        char result[BUF_MEDIUM];
+        gsize found_start;
+
+        /* file is truncated during the scan: skip the rest of it, the match can be in lost data */
+        if (map->truncated)
+            break;
+
+        if (!status_updated)
+        {
+            /* if we add results for a file, we have to ensure that
+               name of this file is shown in status bar */
+            g_snprintf (result, sizeof (result), _("Grepping in %s"), filename);
+            status_update (str_trunc (result, WIDGET (h)->cols - 8));
+            mc_refresh ();
+            last_refresh = *tv;
+            status_updated = TRUE;
+        }
+
+        g_snprintf (result, sizeof (result), "%d:%s", g.found_line, filename);
+        found_start = g.found_start + 1;        /* off by one: ticket 3280 */
+        find_add_match (directory, result, found_start, found_start + g.found_len);
+
+        if (options.content_first_hit)
+            break;
+    }
+
+    switch (g.status)
+    {
+    case FIND_ABORT:
+        stop_idle (h);
+        return TRUE;
+    case FIND_SUSPEND:
+        /* the interrupted search is restarted from the line it was started from */
+        resuming = TRUE;
+        last_line = g.line;
+        last_off = (off_t) g.pos;
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Search the content pattern in the file which can't be mapped, reading it line by line.
+ *
+ * returns FALSE if do_search should look for another file
+ *         TRUE if do_search should exit and proceed to the event handler
+ */
+
+static gboolean
+search_content_read (WDialog * h, const char *directory, const char *filename, int file_fd,
+                     gboolean status_updated, const struct timeval *tv)
+{
+    find_grep_read_t g;
+
+    memset (&g, 0, sizeof (g));
+    g.fd = file_fd;
+    g.read = mc_read;
+    g.line = 1;
+    /* compensate for a newline we'll add when we first enter the loop */
+    g.i = -1;
+    g.check = search_content_check;
+    g.check_data = h;
+    g.status = FIND_CONT;
+
+    if (resuming)
+    {
+        /* We've been previously suspended, start from the previous position */
+        resuming = FALSE;
+        g.line = last_line;
+        g.pos = last_pos;
+        g.off = last_off;
+        g.i = last_i;
+    }
+
+    while (find_grep_read_next (&g, search_content_handle))
+    {
+        char result[BUF_MEDIUM];
+        gsize found_start;
+
+        if (!status_updated)
+        {
+            /* if we add results for a file, we have to ensure that
+               name of this file is shown in status bar */
+            g_snprintf (result, sizeof (result), _("Grepping in %s"), filename);
+            status_update (str_trunc (result, WIDGET (h)->cols - 8));
+            mc_refresh ();
+            last_refresh = *tv;
+            status_updated = TRUE;
+        }
+
+        g_snprintf (result, sizeof (result), "%d:%s", g.found_line, filename);
+        found_start = g.found_start + 1;        /* off by one: ticket 3280 */
+        find_add_match (directory, result, found_start, found_start + g.found_len);
+
+        if (options.content_first_hit)
+            break;
+    }
+
+    g_free (g.strbuf);
+
+    switch (g.status)
+    {
+    case FIND_ABORT:
+        stop_idle (h);
+        return TRUE;
+    case FIND_SUSPEND:
+        resuming = TRUE;
+        last_line = g.line;
+        last_pos = g.pos;
+        last_off = g.off;
+        last_i = g.i;
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * search_content:
@@ -988,8 +1390,9 @@ static gboolean
 search_content (WDialog * h, const char *directory, const char *filename)
 {
     struct stat s;
-    char buffer[BUF_4K];        /* raw input buffer */
+    char buffer[BUF_MEDIUM];
     int file_fd;
+    vfs_file_map_t *map;
     gboolean ret_val = FALSE;
     vfs_path_t *vpath;
     struct timeval tv;
@@ -999,7 +1402,9 @@ search_content (WDialog * h, const char *directory, const char *filename)
 
     vpath = vfs_path_build_filename (directory, filename, (char *) NULL);
 
-    if (mc_stat (vpath, &s) != 0 || !S_ISREG (s.st_mode))
+    if (mc_stat (vpath, &s) != 0 || !S_ISREG (s.st_mode)
+        || (vfs_file_is_local (vpath)
+            && !find_index_may_match (content_index_query, vfs_path_as_str (vpath), &s)))
     {
         vfs_path_free (vpath);
         return FALSE;
@@ -1038,223 +1443,647 @@ search_content (WDialog * h, const char *directory, const char *filename)
     tty_enable_interrupt_key ();
     tty_got_interrupt ();
 
+    /* local files are searched in place */
+    map = vfs_map_local_file (vfs_get_local_fd (file_fd), s.st_size);
+    if (map != NULL)
     {
-        int line = 1;
-        int pos = 0;
-        int n_read = 0;
-        off_t off = 0;          /* file_fd's offset corresponding to strbuf[0] */
-        gboolean found = FALSE;
-        gsize found_len;
-        gsize found_start;
-        char result[BUF_MEDIUM];
-        char *strbuf = NULL;    /* buffer for fetched string */
-        int strbuf_size = 0;
-        int i = -1;             /* compensate for a newline we'll add when we first enter the loop */
+        ret_val = search_content_map (h, directory, filename, map, status_updated, &tv);
+        vfs_unmap_local_file (map);
+    }
+    else
+        ret_val = search_content_read (h, directory, filename, file_fd, status_updated, &tv);
 
-        if (resuming)
-        {
-            /* We've been previously suspended, start from the previous position */
-            resuming = FALSE;
-            line = last_line;
-            pos = last_pos;
-            off = last_off;
-            i = last_i;
-        }
+    tty_disable_interrupt_key ();
+    mc_close (file_fd);
+    return ret_val;
+}
 
-        while (!ret_val)
-        {
-            char ch = '\0';
+/* --------------------------------------------------------------------------------------------- */
 
-            off += i + 1;       /* the previous line, plus a newline character */
-            i = 0;
+static void
+find_rotate_dash (const WDialog * h, gboolean show)
+{
+    static size_t pos = 0;
+    static const char rotating_dash[4] = "|/-\\";
+    const Widget *w = CONST_WIDGET (h);
+    const int *colors;
 
-            /* read to buffer and get line from there */
-            while (TRUE)
-            {
-                if (pos >= n_read)
-                {
-                    pos = 0;
-                    n_read = mc_read (file_fd, buffer, sizeof (buffer));
-                    if (n_read <= 0)
-                        break;
-                }
+    colors = widget_get_colors (w);
+    tty_setcolor (colors[DLG_COLOR_NORMAL]);
+    widget_gotoyx (h, w->lines - 7, w->cols - 4);
+    tty_print_char (show ? rotating_dash[pos] : ' ');
+    pos = (pos + 1) % sizeof (rotating_dash);
+    mc_refresh ();
+}
 
-                ch = buffer[pos++];
-                if (ch == '\0')
-                {
-                    /* skip possible leading zero(s) */
-                    if (i == 0)
-                    {
-                        off++;
-                        continue;
-                    }
-                    break;
-                }
+/* --------------------------------------------------------------------------------------------- */
 
-                if (i >= strbuf_size - 1)
-                {
-                    strbuf_size += 128;
-                    strbuf = g_realloc (strbuf, strbuf_size);
-                }
+static void
+find_set_finished_status (void)
+{
+    if (ignore_count == 0)
+        status_update (_("Finished"));
+    else
+    {
+        char msg[BUF_SMALL];
 
-                /* Strip newline */
-                if (ch == '\n')
-                    break;
+        g_snprintf (msg, sizeof (msg),
+                    ngettext ("Finished (ignored %zu directory)",
+                              "Finished (ignored %zu directories)", ignore_count), ignore_count);
+        status_update (msg);
+    }
+}
 
-                strbuf[i++] = ch;
-            }
+/* --------------------------------------------------------------------------------------------- */
 
-            if (i == 0)
-            {
-                if (ch == '\0')
-                    break;
+static mc_search_t *
+find_new_file_search (void)
+{
+    mc_search_t *search;
 
-                /* if (ch == '\n'): do not search in empty strings */
-                goto skip_search;
-            }
+    search = mc_search_new (find_pattern, NULL);
+    search->search_type = options.file_pattern ? MC_SEARCH_T_GLOB : MC_SEARCH_T_REGEX;
+    search->is_case_sensitive = options.file_case_sens;
+#ifdef HAVE_CHARSET
+    search->is_all_charsets = options.file_all_charsets;
+#endif
+    search->is_entire_line = options.file_pattern;
 
-            strbuf[i] = '\0';
+    return search;
+}
 
-            if (!found          /* Search in binary line once */
-                && mc_search_run (search_content_handle, (const void *) strbuf, 0, i, &found_len))
-            {
-                if (!status_updated)
-                {
-                    /* if we add results for a file, we have to ensure that
-                       name of this file is shown in status bar */
-                    g_snprintf (result, sizeof (result), _("Grepping in %s"), filename);
-                    status_update (str_trunc (result, WIDGET (h)->cols - 8));
-                    mc_refresh ();
-                    last_refresh = tv;
-                    status_updated = TRUE;
-                }
+/* --------------------------------------------------------------------------------------------- */
 
-                g_snprintf (result, sizeof (result), "%d:%s", line, filename);
-                found_start = off + search_content_handle->normal_offset + 1;   /* off by one: ticket 3280 */
-                find_add_match (directory, result, found_start, found_start + found_len);
-                found = TRUE;
-            }
+static mc_search_t *
+find_new_content_search (void)
+{
+    mc_search_t *search;
 
-            if (found && options.content_first_hit)
-                break;
+    search = mc_search_new (content_pattern, NULL);
+    if (search != NULL)
+    {
+        search->search_type = options.content_regexp ? MC_SEARCH_T_REGEX : MC_SEARCH_T_NORMAL;
+        search->is_case_sensitive = options.content_case_sens;
+        search->whole_words = options.content_whole_words;
+#ifdef HAVE_CHARSET
+        search->is_all_charsets = options.content_all_charsets;
+#endif
+    }
 
-            if (ch == '\n')
-            {
-              skip_search:
-                found = FALSE;
-                line++;
-            }
+    return search;
+}
 
-            if ((line & 0xff) == 0)
-            {
-                FindProgressStatus res;
+/* --------------------------------------------------------------------------------------------- */
 
-                res = check_find_events (h);
-                switch (res)
-                {
-                case FIND_ABORT:
-                    stop_idle (h);
-                    ret_val = TRUE;
-                    break;
-                case FIND_SUSPEND:
-                    resuming = TRUE;
-                    last_line = line;
-                    last_pos = pos;
-                    last_off = off;
-                    last_i = i;
-                    ret_val = TRUE;
-                    break;
-                default:
-                    break;
-                }
-            }
-        }
+#ifdef FIND_THREADS
+static void
+find_result_free (gpointer data)
+{
+    find_result_t *result = (find_result_t *) data;
 
-        g_free (strbuf);
-    }
+    g_free (result->dir);
+    g_free (result->text);
+    g_free (result);
+}
 
-    tty_disable_interrupt_key ();
-    mc_close (file_fd);
-    return ret_val;
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+find_add_result (GPtrArray * results, const char *dir, char *text, gsize start, gsize end)
+{
+    find_result_t *result;
+
+    result = g_new (find_result_t, 1);
+    result->dir = g_strdup (dir);
+    result->text = text;
+    result->start = start;
+    result->end = end;
+    g_ptr_array_add (results, result);
 }
 
 /* --------------------------------------------------------------------------------------------- */
 
+static void
+find_file_free (gpointer data)
+{
+    find_file_t *file = (find_file_t *) data;
+
+    g_free (file->dir);
+    g_free (file->name);
+    g_free (file);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Pass results to the main thread. Results of one directory or file are kept together. */
+
+static GPtrArray *
+find_engine_flush (find_engine_t * e, GPtrArray * results)
+{
+    if (results->len == 0)
+        return results;
+
+    g_async_queue_push (e->results, results);
+    return g_ptr_array_new_with_free_func (find_result_free);
+}
+
+/* --------------------------------------------------------------------------------------------- */
 /**
-  If dir is absolute, this means we're within dir and searching file here.
-  If dir is relative, this means we're going to add dir to the directory stack.
-**/
+ * Wait while search is suspended.
+ *
+ * @return FALSE if search is stopped
+ */
+
 static gboolean
-find_ignore_dir_search (const char *dir)
+find_engine_check (find_engine_t * e, mc_parallel_t * run)
 {
-    if (find_ignore_dirs != NULL)
+    g_mutex_lock (&e->lock);
+    while (e->paused && !mc_parallel_is_cancelled (run))
+        g_cond_wait (&e->cond, &e->lock);
+    g_mutex_unlock (&e->lock);
+
+    return !mc_parallel_is_cancelled (run);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static FindProgressStatus
+find_engine_grep_check (void *data)
+{
+    find_engine_grep_check_t *c = (find_engine_grep_check_t *) data;
+
+    return (find_engine_check (c->e, c->run) ? FIND_CONT : FIND_ABORT);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Search the content pattern in the mapped file. Runs in worker thread.
+ */
+
+static GPtrArray *
+find_engine_grep_map (find_engine_t * e, mc_parallel_t * run, mc_search_t * search,
+                      const find_file_t * file, vfs_file_map_t * map, GPtrArray * results)
+{
+    find_engine_grep_check_t check = { e, run };
+    find_grep_map_t g;
+
+    memset (&g, 0, sizeof (g));
+    g.map = map;
+    g.line = 1;
+    g.check = find_engine_grep_check;
+    g.check_data = &check;
+    g.status = FIND_CONT;
+
+    while (find_grep_map_next (&g, search))
     {
-        const size_t dlen = strlen (dir);
-        const unsigned char dabs = g_path_is_absolute (dir) ? 1 : 0;
+        gsize found_start;
+
+        /* file is truncated during the scan: skip the rest of it, the match can be in lost data */
+        if (map->truncated)
+            break;
 
-        char **ignore_dir;
+        found_start = g.found_start + 1;        /* off by one: ticket 3280 */
+        find_add_result (results, file->dir, g_strdup_printf ("%d:%s", g.found_line, file->name),
+                         found_start, found_start + g.found_len);
 
-        for (ignore_dir = find_ignore_dirs; *ignore_dir != NULL; ignore_dir++)
+        if (options.content_first_hit)
+            break;
+
+        if (results->len >= 64)
         {
-            const size_t ilen = strlen (*ignore_dir);
-            const unsigned char iabs = g_path_is_absolute (*ignore_dir) ? 2 : 0;
+            results = find_engine_flush (e, results);
+            if (!find_engine_check (e, run))
+                break;
+        }
+    }
+
+    return results;
+}
 
-            /* ignore dir is too long -- skip it */
-            if (dlen < ilen)
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Search the content pattern in the file like search_content() does, but without UI.
+ * Runs in worker thread.
+ */
+
+static void
+find_engine_grep (find_engine_t * e, mc_parallel_t * run, mc_search_t * search,
+                  const find_file_t * file)
+{
+    find_engine_grep_check_t check = { e, run };
+    struct stat s;
+    char *path;
+    int file_fd;
+    vfs_file_map_t *map;
+    GPtrArray *results;
+    find_grep_read_t g;
+
+    if (search == NULL)
+        return;
+
+    path = g_build_filename (file->dir, file->name, (char *) NULL);
+    if (stat (path, &s) == 0 && S_ISREG (s.st_mode)
+        && find_index_may_match (content_index_query, path, &s))
+        file_fd = open (path, O_RDONLY);
+    else
+        file_fd = -1;
+    g_free (path);
+
+    if (file_fd == -1)
+        return;
+
+    results = g_ptr_array_new_with_free_func (find_result_free);
+
+    /* search in place if file can be mapped */
+    map = vfs_map_local_file (file_fd, s.st_size);
+    if (map != NULL)
+    {
+        results = find_engine_grep_map (e, run, search, file, map, results);
+        vfs_unmap_local_file (map);
+        close (file_fd);
+
+        find_engine_flush (e, results);
+        g_ptr_array_free (results, TRUE);
+        return;
+    }
+
+    memset (&g, 0, sizeof (g));
+    g.fd = file_fd;
+    g.read = read;
+    g.line = 1;
+    /* compensate for a newline we'll add when we first enter the loop */
+    g.i = -1;
+    g.check = find_engine_grep_check;
+    g.check_data = &check;
+    g.status = FIND_CONT;
+
+    while (find_grep_read_next (&g, search))
+    {
+        gsize found_start;
+
+        found_start = g.found_start + 1;        /* off by one: ticket 3280 */
+        find_add_result (results, file->dir, g_strdup_printf ("%d:%s", g.found_line, file->name),
+                         found_start, found_start + g.found_len);
+
+        if (options.content_first_hit)
+            break;
+
+        if (results->len >= 64)
+        {
+            results = find_engine_flush (e, results);
+            if (!find_engine_check (e, run))
+                break;
+        }
+    }
+
+    g_free (g.strbuf);
+    close (file_fd);
+
+    find_engine_flush (e, results);
+    g_ptr_array_free (results, TRUE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read the directory like do_search() does, but without UI. Runs in worker thread.
+ */
+
+static void
+find_engine_read_dir (find_engine_t * e, mc_parallel_t * run, mc_search_t * search,
+                      const char *directory)
+{
+    DIR *dirp;
+    struct dirent *dp;
+    GPtrArray *results;
+    GQueue dirs = G_QUEUE_INIT;
+    GQueue files = G_QUEUE_INIT;
+    size_t ignored = 0;
+
+    /* handle absolute ignore dirs here */
+    if (find_ignore_dirs_match (find_ignore_dirs, directory))
+        ignored++;
+    else if ((dirp = opendir (directory)) != NULL)
+    {
+        results = g_ptr_array_new_with_free_func (find_result_free);
+
+        while ((dp = readdir (dirp)) != NULL && !mc_parallel_is_cancelled (run))
+        {
+            gsize bytes_found;
+
+            if (DIR_IS_DOT (dp->d_name) || DIR_IS_DOTDOT (dp->d_name)
+                || !str_is_valid_string (dp->d_name)
+                || (options.skip_hidden && dp->d_name[0] == '.'))
                 continue;
 
-            /* handle absolute and relative paths */
-            switch (iabs | dabs)
+            if (options.find_recurs)
             {
-            case 0:            /* both paths are relative */
-            case 3:            /* both paths are abolute */
-                /* if ignore dir is not a path  of dir -- skip it */
-                if (strncmp (dir, *ignore_dir, ilen) == 0)
+                /* handle relative ignore dirs here */
+                if (options.ignore_dirs_enable
+                    && find_ignore_dirs_match (find_ignore_dirs, dp->d_name))
+                    ignored++;
+                else
                 {
-                    /* be sure that ignore dir is not a part of dir like:
-                       ignore dir is "h", dir is "home" */
-                    if (dir[ilen] == '\0' || IS_PATH_SEP (dir[ilen]))
-                        return TRUE;
+                    char *path;
+                    struct stat st;
+
+                    path = g_build_filename (directory, dp->d_name, (char *) NULL);
+                    if (lstat (path, &st) == 0 && S_ISDIR (st.st_mode))
+                        g_queue_push_tail (&dirs, path);
+                    else
+                        g_free (path);
                 }
-                break;
-            case 1:            /* dir is absolute, ignore_dir is relative */
+            }
+
+            if (mc_search_run (search, dp->d_name, 0, strlen (dp->d_name), &bytes_found))
+            {
+                if (content_pattern == NULL)
+                    find_add_result (results, directory, g_strdup (dp->d_name), 0, 0);
+                else
                 {
-                    char *d;
+                    find_file_t *file;
 
-                    d = strstr (dir, *ignore_dir);
-                    if (d != NULL && IS_PATH_SEP (d[-1])
-                        && (d[ilen] == '\0' || IS_PATH_SEP (d[ilen])))
-                        return TRUE;
+                    file = g_new (find_file_t, 1);
+                    file->dir = g_strdup (directory);
+                    file->name = g_strdup (dp->d_name);
+                    g_queue_push_tail (&files, file);
                 }
+            }
+        }
+
+        closedir (dirp);
+
+        find_engine_flush (e, results);
+        g_ptr_array_free (results, TRUE);
+    }
+
+    g_mutex_lock (&e->lock);
+    e->ignore_count += ignored;
+    while (!g_queue_is_empty (&dirs))
+        g_queue_push_head (&e->dirs, g_queue_pop_tail (&dirs));
+    while (!g_queue_is_empty (&files))
+        g_queue_push_tail (&e->files, g_queue_pop_head (&files));
+    g_mutex_unlock (&e->lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Worker: take files and directories from the shared queues while there is something to do.
+ * Files are taken first to keep the queue of them short.
+ */
+
+static void
+find_engine_job (mc_parallel_t * run, guint job, gpointer user_data)
+{
+    find_engine_t *e = (find_engine_t *) user_data;
+
+    g_mutex_lock (&e->lock);
+
+    while (TRUE)
+    {
+        find_file_t *file;
+        char *dir = NULL;
+
+        while (!mc_parallel_is_cancelled (run)
+               && (e->paused || (g_queue_is_empty (&e->files) && g_queue_is_empty (&e->dirs)
+                                 && e->busy != 0)))
+            g_cond_wait (&e->cond, &e->lock);
+
+        if (mc_parallel_is_cancelled (run))
+            break;
+
+        file = (find_file_t *) g_queue_pop_head (&e->files);
+        if (file == NULL)
+        {
+            dir = (char *) g_queue_pop_head (&e->dirs);
+            /* nothing to do and nobody can add more */
+            if (dir == NULL)
                 break;
-            case 2:            /* dir is relative, ignore_dir is absolute */
-                /* FIXME: skip this case */
+        }
+
+        e->busy++;
+        g_free (e->current);
+        e->current = g_strdup (file != NULL ? file->name : dir);
+        e->current_is_file = file != NULL;
+        g_mutex_unlock (&e->lock);
+
+        if (file != NULL)
+        {
+            find_engine_grep (e, run, e->content_handles[job], file);
+            find_file_free (file);
+        }
+        else
+        {
+            find_engine_read_dir (e, run, e->file_handles[job], dir);
+            g_free (dir);
+        }
+
+        g_mutex_lock (&e->lock);
+        e->busy--;
+        g_cond_broadcast (&e->cond);
+    }
+
+    /* wake up other workers to let them finish too */
+    g_cond_broadcast (&e->cond);
+    g_mutex_unlock (&e->lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Start search of local directory tree with worker threads. Name and content of files are
+ * searched by the same workers: grep of found files has priority over reading of directories.
+ * Results are passed to the main thread through the queue and shown by find_engine_poll().
+ *
+ * @param start_dir start directory, should be local
+ *
+ * @return engine or NULL if there aren't several processors to run workers on
+ */
+
+static find_engine_t *
+find_engine_new (const char *start_dir)
+{
+    find_engine_t *e;
+    guint i;
+
+    if (mc_parallel_get_workers () < 2)
+        return NULL;
+
+    e = g_new0 (find_engine_t, 1);
+    g_mutex_init (&e->lock);
+    g_cond_init (&e->cond);
+    g_queue_init (&e->dirs);
+    g_queue_init (&e->files);
+    e->results = g_async_queue_new_full ((GDestroyNotify) g_ptr_array_unref);
+
+    /* at least two jobs: one job would be run synchronously */
+    e->jobs = CLAMP (mc_parallel_get_workers () - 1, 2, FIND_MAX_JOBS);
+
+    /* search handles aren't thread-safe: prepare them here, workers only run them */
+    e->file_handles = g_new0 (mc_search_t *, e->jobs);
+    e->content_handles = g_new0 (mc_search_t *, e->jobs);
+    for (i = 0; i < e->jobs; i++)
+    {
+        e->file_handles[i] = find_new_file_search ();
+        mc_search_prepare (e->file_handles[i]);
+        e->content_handles[i] = find_new_content_search ();
+        if (e->content_handles[i] != NULL)
+            mc_search_prepare (e->content_handles[i]);
+    }
+
+    g_queue_push_tail (&e->dirs, g_strdup (start_dir));
+    e->run = mc_parallel_run (e->jobs, find_engine_job, e);
+
+    return e;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+find_engine_free (find_engine_t * e)
+{
+    guint i;
+
+    g_mutex_lock (&e->lock);
+    mc_parallel_cancel (e->run);
+    e->paused = FALSE;
+    g_cond_broadcast (&e->cond);
+    g_mutex_unlock (&e->lock);
+
+    mc_parallel_free (e->run);
+
+    g_async_queue_unref (e->results);
+    g_queue_clear_full (&e->dirs, g_free);
+    g_queue_clear_full (&e->files, find_file_free);
+    g_free (e->current);
+
+    for (i = 0; i < e->jobs; i++)
+    {
+        mc_search_free (e->file_handles[i]);
+        mc_search_free (e->content_handles[i]);
+    }
+    g_free (e->file_handles);
+    g_free (e->content_handles);
+
+    g_mutex_clear (&e->lock);
+    g_cond_clear (&e->cond);
+    g_free (e);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Suspend or continue the search */
+
+static void
+find_engine_set_paused (find_engine_t * e, gboolean paused)
+{
+    g_mutex_lock (&e->lock);
+    e->paused = paused;
+    g_cond_broadcast (&e->cond);
+    g_mutex_unlock (&e->lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Show results found by workers. Called on idle instead of do_search(): waits for results
+ * not longer than refresh interval to keep the dialog responsive without busy loop.
+ */
+
+static void
+find_engine_poll (WDialog * h)
+{
+    gint64 end_time;
+    gboolean finished = FALSE;
+
+    end_time = g_get_monotonic_time () + MAX_REFRESH_INTERVAL;
+
+    do
+    {
+        gint64 timeout;
+        GPtrArray *results;
+
+        timeout = MAX (end_time - g_get_monotonic_time (), 0);
+        results = (GPtrArray *) g_async_queue_timeout_pop (engine->results, (guint64) timeout);
+        if (results == NULL)
+        {
+            /* workers could push last results after the timeout */
+            if (mc_parallel_wait (engine->run, 0))
+            {
+                finished = g_async_queue_length (engine->results) == 0;
                 break;
-            default:           /* this cannot occurs */
-                return FALSE;
             }
         }
+        else
+        {
+            guint i;
+
+            for (i = 0; i < results->len; i++)
+            {
+                find_result_t *result = (find_result_t *) g_ptr_array_index (results, i);
+
+                find_add_match (result->dir, result->text, result->start, result->end);
+            }
+            g_ptr_array_unref (results);
+        }
     }
+    while (g_get_monotonic_time () < end_time);
 
-    return FALSE;
+    g_mutex_lock (&engine->lock);
+    ignore_count = engine->ignore_count;
+    if (!finished && engine->current != NULL && (verbose || engine->current_is_file))
+    {
+        char buffer[BUF_MEDIUM];
+
+        if (engine->current_is_file)
+            g_snprintf (buffer, sizeof (buffer), _("Grepping in %s"), engine->current);
+        else
+            g_strlcpy (buffer, engine->current, sizeof (buffer));
+        status_update (str_trunc (buffer, WIDGET (h)->cols - 8));
+    }
+    g_mutex_unlock (&engine->lock);
+
+    if (finished)
+    {
+        running = FALSE;
+        find_set_finished_status ();
+        if (verbose)
+            find_rotate_dash (h, FALSE);
+        stop_idle (h);
+    }
+    else if (verbose)
+        find_rotate_dash (h, TRUE);
 }
+#endif /* FIND_THREADS */
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Start search of the directory from the stack in worker threads if possible.
+ */
 
 static void
-find_rotate_dash (const WDialog * h, gboolean show)
+find_engine_start (void)
 {
-    static size_t pos = 0;
-    static const char rotating_dash[4] = "|/-\\";
-    const Widget *w = CONST_WIDGET (h);
-    const int *colors;
+#ifdef FIND_THREADS
+    const vfs_path_t *vpath;
 
-    colors = widget_get_colors (w);
-    tty_setcolor (colors[DLG_COLOR_NORMAL]);
-    widget_gotoyx (h, w->lines - 7, w->cols - 4);
-    tty_print_char (show ? rotating_dash[pos] : ' ');
-    pos = (pos + 1) % sizeof (rotating_dash);
-    mc_refresh ();
+    vpath = (const vfs_path_t *) g_queue_peek_head (&dir_queue);
+    if (vpath == NULL || !vfs_file_is_local (vpath))
+        return;
+
+    engine = find_engine_new (vfs_path_as_str (vpath));
+    if (engine != NULL)
+        clear_stack ();
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+find_engine_stop (void)
+{
+#ifdef FIND_THREADS
+    if (engine != NULL)
+    {
+        find_engine_free (engine);
+        engine = NULL;
+    }
+#endif
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -1281,6 +2110,14 @@ do_search (WDialog * h)
         return 1;
     }
 
+#ifdef FIND_THREADS
+    if (engine != NULL)
+    {
+        find_engine_poll (h);
+        return 1;
+    }
+#endif
+
     for (count = 0; count < 32; count++)
     {
         while (dp == NULL)
@@ -1303,18 +2140,7 @@ do_search (WDialog * h)
                     if (tmp_vpath == NULL)
                     {
                         running = FALSE;
-                        if (ignore_count == 0)
-                            status_update (_("Finished"));
-                        else
-                        {
-                            char msg[BUF_SMALL];
-
-                            g_snprintf (msg, sizeof (msg),
-                                        ngettext ("Finished (ignored %zu directory)",
-                                                  "Finished (ignored %zu directories)",
-                                                  ignore_count), ignore_count);
-                            status_update (msg);
-                        }
+                        find_set_finished_status ();
                         if (verbose)
                             find_rotate_dash (h, FALSE);
                         stop_idle (h);
@@ -1325,7 +2151,7 @@ do_search (WDialog * h)
                     {
                         gboolean ok;
 
-                        ok = find_ignore_dir_search (vfs_path_as_str (tmp_vpath));
+                        ok = find_ignore_dirs_match (find_ignore_dirs, vfs_path_as_str (tmp_vpath));
                         if (!ok)
                             break;
                     }
@@ -1370,7 +2196,8 @@ do_search (WDialog * h)
             if (options.find_recurs && (directory != NULL))
             {                   /* Can directory be NULL ? */
                 /* handle relative ignore dirs here */
-                if (options.ignore_dirs_enable && find_ignore_dir_search (dp->d_name))
+                if (options.ignore_dirs_enable
+                    && find_ignore_dirs_match (find_ignore_dirs, dp->d_name))
                     ignore_count++;
                 else
                 {
@@ -1420,8 +2247,11 @@ init_find_vars (void)
     /* Remove all the items from the stack */
     clear_stack ();
 
-    g_strfreev (find_ignore_dirs);
-    find_ignore_dirs = NULL;
+    if (find_ignore_dirs != NULL)
+    {
+        g_hash_table_destroy (find_ignore_dirs);
+        find_ignore_dirs = NULL;
+    }
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -1604,6 +2434,10 @@ start_stop (WButton * button, int action)
 
     running = is_start;
     widget_idle (WIDGET (find_dlg), running);
+#ifdef FIND_THREADS
+    if (engine != NULL)
+        find_engine_set_paused (engine, !running);
+#endif
     is_start = !is_start;
 
     status_update (is_start ? _("Stopped") : _("Searching"));
@@ -1720,34 +2554,30 @@ run_process (void)
 {
     int ret;
 
-    search_content_handle = mc_search_new (content_pattern, NULL);
-    if (search_content_handle)
-    {
-        search_content_handle->search_type =
-            options.content_regexp ? MC_SEARCH_T_REGEX : MC_SEARCH_T_NORMAL;
-        search_content_handle->is_case_sensitive = options.content_case_sens;
-        search_content_handle->whole_words = options.content_whole_words;
-#ifdef HAVE_CHARSET
-        search_content_handle->is_all_charsets = options.content_all_charsets;
-#endif
-    }
-    search_file_handle = mc_search_new (find_pattern, NULL);
-    search_file_handle->search_type = options.file_pattern ? MC_SEARCH_T_GLOB : MC_SEARCH_T_REGEX;
-    search_file_handle->is_case_sensitive = options.file_case_sens;
-#ifdef HAVE_CHARSET
-    search_file_handle->is_all_charsets = options.file_all_charsets;
-#endif
-    search_file_handle->is_entire_line = options.file_pattern;
+    search_content_handle = find_new_content_search ();
+    search_file_handle = find_new_file_search ();
+    if (search_content_handle != NULL && options.content_use_index)
+        content_index_query =
+            find_index_query_new (content_pattern, options.content_regexp,
+                                  options.content_case_sens, options.content_all_charsets);
 
     resuming = FALSE;
+    find_engine_start ();
 
     widget_idle (WIDGET (find_dlg), TRUE);
     ret = dlg_run (find_dlg);
 
+    find_engine_stop ();
+
     mc_search_free (search_file_handle);
     search_file_handle = NULL;
     mc_search_free (search_content_handle);
     search_content_handle = NULL;
+    find_index_query_free (content_index_query);
+    content_index_query = NULL;
+
+    /* index files which weren't filtered by the index */
+    find_index_update ();
 
     return ret;
 }
@@ -1773,7 +2603,8 @@ do_find (const char *start_dir, ssize_t start_dir_len, const char *ignore_dirs,
     setup_gui ();
 
     init_find_vars ();
-    parse_ignore_dirs (ignore_dirs);
+    if (options.ignore_dirs_enable)
+        find_ignore_dirs = find_ignore_dirs_new (ignore_dirs);
     push_directory (vfs_path_from_str (start_dir));
 
     return_value = run_process ();
@@ -1854,6 +2685,7 @@ do_find (const char *start_dir, ssize_t start_dir_len, const char *ignore_dirs,
             list->list[list->len].f.stale_link = stale_link ? 1 : 0;
             list->list[list->len].f.dir_size_computed = 0;
             list->list[list->len].st = st;
+            list->list[list->len].fhl_generation = 0;
             list->list[list->len].sort_key = NULL;
             list->list[list->len].second_sort_key = NULL;
             list->len++;
@@ -0,0 +1,149 @@
+/*
+   Directories which are skipped by find file.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file findignore.c
+ *  \brief Source: directories which are skipped by find file
+ */
+
+#include <config.h>
+
+#include <string.h>
+
+#include "lib/global.h"
+#include "lib/util.h"           /* canonicalize_pathname() */
+
+#include "findignore.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/*** file scope type declarations ****************************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/*** file scope functions ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Make set of ignore dirs.
+ *
+ * @param ignore_dirs list of directories separated by colons
+ *
+ * @return set of canonicalized directories or NULL if list has no directories.
+ *         Should be freed by g_hash_table_destroy()
+ */
+
+GHashTable *
+find_ignore_dirs_new (const char *ignore_dirs)
+{
+    GHashTable *set;
+    char **dirs;
+    size_t i;
+
+    if (ignore_dirs == NULL || ignore_dirs[0] == '\0')
+        return NULL;
+
+    dirs = g_strsplit (ignore_dirs, ":", -1);
+    set = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+    for (i = 0; dirs[i] != NULL; i++)
+    {
+        /* values like '/foo::/bar: produce empty entries -- skip them */
+        if (dirs[i][0] != '\0')
+            canonicalize_pathname (dirs[i]);
+
+        if (dirs[i][0] == '\0')
+            g_free (dirs[i]);
+        else
+            g_hash_table_replace (set, dirs[i], dirs[i]);
+    }
+
+    /* strings are owned by hash table now */
+    g_free (dirs);
+
+    if (g_hash_table_size (set) == 0)
+    {
+        g_hash_table_destroy (set);
+        set = NULL;
+    }
+
+    return set;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+  If dir is absolute, this means we're within dir and searching file here.
+  If dir is relative, this means we're going to add dir to the directory stack.
+
+  Every part of dir between path separators that can be an ignore dir is looked up
+  in the set of ignore dirs:
+    relative dir: its beginning is compared with relative ignore dirs;
+    absolute dir: its beginning is compared with absolute ignore dirs and any part of it
+                  started after a path separator is compared with relative ignore dirs.
+
+  @param ignore_dirs set made by find_ignore_dirs_new(), can be NULL
+**/
+
+gboolean
+find_ignore_dirs_match (GHashTable * ignore_dirs, const char *dir)
+{
+    const size_t dlen = strlen (dir);
+    const gboolean dabs = g_path_is_absolute (dir);
+    char *buf = NULL;
+    gboolean found = FALSE;
+    size_t start;
+
+    if (ignore_dirs == NULL)
+        return FALSE;
+
+    for (start = 0; !found && start < dlen; start++)
+    {
+        size_t end;
+
+        if (start != 0 && (!dabs || !IS_PATH_SEP (dir[start - 1])))
+            continue;
+
+        for (end = start + 1; !found && end <= dlen; end++)
+        {
+            if (end == dlen)
+                found = g_hash_table_lookup (ignore_dirs, dir + start) != NULL;
+            else if (IS_PATH_SEP (dir[end]))
+            {
+                /* look up the part of dir up to separator */
+                if (buf == NULL)
+                    buf = g_strdup (dir);
+                buf[end] = '\0';
+                found = g_hash_table_lookup (ignore_dirs, buf + start) != NULL;
+                buf[end] = dir[end];
+            }
+        }
+    }
+
+    g_free (buf);
+
+    return found;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,25 @@
+/** \file findignore.h
+ *  \brief Header: directories which are skipped by find file
+ */
+
+#ifndef MC__FINDIGNORE_H
+#define MC__FINDIGNORE_H
+
+#include "lib/global.h"
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+GHashTable *find_ignore_dirs_new (const char *ignore_dirs);
+gboolean find_ignore_dirs_match (GHashTable * ignore_dirs, const char *dir);
+
+/*** inline functions ****************************************************************************/
+
+#endif /* MC__FINDIGNORE_H */
@@ -0,0 +1,837 @@
+/*
+   Index of content of local files for find file.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** \file findindex.c
+ *  \brief Source: index of content of local files for find file
+ *
+ *  For every indexed file the index keeps a Bloom filter of trigrams (three byte
+ *  sequences) of its content. ASCII letters are folded to lower case, so the same
+ *  filter serves case sensitive and insensitive searches.
+ *
+ *  A content pattern is turned into a query: trigrams of literal strings which any
+ *  matched text must contain. If some of them are not in the filter of file, the file
+ *  can't match and isn't read at all. Filters give false positives only, so a file
+ *  which isn't skipped is searched as usual and results are the same as without index.
+ *
+ *  A record is valid while size and modification time of file are the same, this is
+ *  checked with stat() which find does anyway. Files which aren't in the index or
+ *  were changed are queued during search and indexed by a background job after it.
+ *  The index is kept in MC_FINDINDEX_FILE in the cache directory between runs.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "lib/global.h"
+#include "lib/fileloc.h"
+#include "lib/util.h"
+#include "lib/mcconfig.h"       /* mc_config_get_full_path() */
+#include "lib/parallel.h"
+#include "lib/vfs/vfs.h"        /* vfs_map_local_file() */
+
+#include "findindex.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+#define FIND_INDEX_SIGNATURE "Midnight Commander find index v 2"
+
+/* if there are more records, records which weren't used in this session aren't saved */
+#define FIND_INDEX_MAX 200000
+
+/* bigger files aren't indexed */
+#define FIND_INDEX_FILE_MAX (64 * 1024 * 1024)
+
+/* files with more different trigrams (usually binary ones) would pass any filter */
+#define FIND_INDEX_TRIGRAMS_MAX 50000
+
+/* bits of filter per trigram and number of hash functions: about 2% of false positives */
+#define FIND_INDEX_BITS_PER_TRIGRAM 10
+#define FIND_INDEX_HASHES 3
+#define FIND_INDEX_BITS_MIN 64
+#define FIND_INDEX_BITS_MAX (1 << 20)
+
+/* files changed so recently can be changed again without change of mtime */
+#define FIND_INDEX_RACY_SEC 2
+
+#define FIND_INDEX_TRIGRAM(a, b, c) \
+    (((guint32) (a) << 16) | ((guint32) (b) << 8) | (guint32) (c))
+
+/*** file scope type declarations ****************************************************************/
+
+typedef struct
+{
+    char *path;
+    off_t size;
+    time_t mtime;
+    time_t ctime;               /* file replaced with the same size and mtime has other ctime */
+    ino_t ino;                  /* or other inode */
+    guint32 bits;               /* size of filter in bits, 0 if file can't be filtered */
+    guint8 *filter;
+    gboolean used;              /* used in this session */
+} find_index_node_t;
+
+struct find_index_query_t
+{
+    GArray *trigrams;           /* different guint32 trigrams */
+};
+
+/* state of trigram collection of one file */
+typedef struct
+{
+    guint8 *seen;               /* bitmap of all 2^24 trigrams */
+    GArray *trigrams;           /* trigrams set in seen */
+    guint32 last;               /* last bytes of data */
+    gsize count;                /* number of bytes */
+} find_index_scan_t;
+
+/*** file scope variables ************************************************************************/
+
+/* index and queue are used by find workers and by indexing job */
+G_LOCK_DEFINE_STATIC (find_index);
+static GHashTable *find_index = NULL;   /* path -> find_index_node_t */
+static gboolean find_index_dirty = FALSE;
+static GQueue find_index_pending = G_QUEUE_INIT;        /* paths to index */
+static GHashTable *find_index_pending_set = NULL;
+
+/* background job: created and freed by main thread only */
+static mc_parallel_t *find_index_job = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static inline guint8
+find_index_fold (guint8 c)
+{
+    return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline guint32
+find_index_hash (guint32 trigram, guint i)
+{
+    guint32 h;
+
+    h = (trigram + i * 0x9E3779B9u) * 0x85EBCA6Bu;
+    h ^= h >> 15;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 13;
+
+    return h;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+find_index_node_free (gpointer data)
+{
+    find_index_node_t *node = (find_index_node_t *) data;
+
+    g_free (node->path);
+    g_free (node->filter);
+    g_free (node);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+find_index_node_test (const find_index_node_t * node, const find_index_query_t * query)
+{
+    guint i, j;
+
+    if (node->bits == 0)
+        return TRUE;
+
+    for (i = 0; i < query->trigrams->len; i++)
+    {
+        guint32 trigram;
+
+        trigram = g_array_index (query->trigrams, guint32, i);
+
+        for (j = 0; j < FIND_INDEX_HASHES; j++)
+        {
+            guint32 bit;
+
+            bit = find_index_hash (trigram, j) & (node->bits - 1);
+            if ((node->filter[bit >> 3] & (1 << (bit & 7))) == 0)
+                return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+find_index_load (GHashTable * index, const char *name)
+{
+    FILE *file;
+    char buffer[BUF_MEDIUM];
+
+    file = fopen (name, "r");
+    if (file == NULL)
+        return;
+
+    if (fgets (buffer, sizeof (buffer), file) == NULL
+        || strncmp (buffer, FIND_INDEX_SIGNATURE, strlen (FIND_INDEX_SIGNATURE)) != 0)
+    {
+        fclose (file);
+        return;
+    }
+
+    while (fgets (buffer, sizeof (buffer), file) != NULL)
+    {
+        intmax_t size, mtime, ctime;
+        uintmax_t ino;
+        unsigned int bits;
+        size_t path_len;
+        find_index_node_t *node;
+
+        if (sscanf (buffer, "%jd %jd %jd %ju %u %zu", &size, &mtime, &ctime, &ino, &bits,
+                    &path_len) != 6
+            || path_len == 0 || path_len > MC_MAXPATHLEN * 4 || bits > FIND_INDEX_BITS_MAX
+            || (bits & (bits - 1)) != 0 || (bits != 0 && bits < FIND_INDEX_BITS_MIN))
+            break;
+
+        node = g_new0 (find_index_node_t, 1);
+        node->size = (off_t) size;
+        node->mtime = (time_t) mtime;
+        node->ctime = (time_t) ctime;
+        node->ino = (ino_t) ino;
+        node->bits = bits;
+        node->path = g_malloc (path_len + 1);
+        node->path[path_len] = '\0';
+        if (bits != 0)
+            node->filter = g_malloc (bits / 8);
+
+        if (fread (node->path, 1, path_len, file) != path_len
+            || (bits != 0 && fread (node->filter, 1, bits / 8, file) != bits / 8)
+            || fgetc (file) != '\n')
+        {
+            /* drop incomplete record */
+            find_index_node_free (node);
+            break;
+        }
+
+        g_hash_table_replace (index, node->path, node);
+    }
+
+    fclose (file);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+find_index_save_to (GHashTable * index, const char *name)
+{
+    FILE *file;
+    GHashTableIter iter;
+    gpointer value;
+    gboolean all;
+
+    file = fopen (name, "w");
+    if (file == NULL)
+        return errno;
+
+    all = g_hash_table_size (index) <= FIND_INDEX_MAX;
+
+    fprintf (file, "%s\n", FIND_INDEX_SIGNATURE);
+
+    g_hash_table_iter_init (&iter, index);
+    while (g_hash_table_iter_next (&iter, NULL, &value))
+    {
+        const find_index_node_t *node = (const find_index_node_t *) value;
+        size_t path_len;
+
+        if (!all && !node->used)
+            continue;
+
+        path_len = strlen (node->path);
+        fprintf (file, "%jd %jd %jd %ju %u %zu\n", (intmax_t) node->size, (intmax_t) node->mtime,
+                 (intmax_t) node->ctime, (uintmax_t) node->ino, (unsigned int) node->bits,
+                 path_len);
+        fwrite (node->path, 1, path_len, file);
+        if (node->bits != 0)
+            fwrite (node->filter, 1, node->bits / 8, file);
+        fputc ('\n', file);
+    }
+
+    if (fclose (file) != 0)
+        return errno;
+
+    return 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Called with the lock held */
+
+static GHashTable *
+find_index_get (void)
+{
+    if (find_index == NULL)
+    {
+        char *name;
+
+        find_index = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, find_index_node_free);
+        find_index_pending_set = g_hash_table_new (g_str_hash, g_str_equal);
+
+        name = mc_config_get_full_path (MC_FINDINDEX_FILE);
+        find_index_load (find_index, name);
+        g_free (name);
+
+        find_index_dirty = FALSE;
+    }
+
+    return find_index;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+find_index_query_add (GArray * trigrams, const char *str, gsize len, gboolean case_sens)
+{
+    gsize i;
+
+    for (i = 0; i + 2 < len; i++)
+    {
+        const guint8 *s = (const guint8 *) str + i;
+        guint32 trigram;
+        guint j;
+
+        if (!case_sens)
+        {
+            gboolean skip = FALSE;
+
+            /* non-ASCII chars have other case forms of other length;
+             * Kelvin sign and long s are caseless equal to 'k' and 's' */
+            for (j = 0; j < 3 && !skip; j++)
+            {
+                const guint8 c = find_index_fold (s[j]);
+
+                skip = c >= 0x80 || c == 'k' || c == 's';
+            }
+            if (skip)
+                continue;
+        }
+
+        trigram = FIND_INDEX_TRIGRAM (find_index_fold (s[0]), find_index_fold (s[1]),
+                                      find_index_fold (s[2]));
+
+        for (j = 0; j < trigrams->len && g_array_index (trigrams, guint32, j) != trigram; j++)
+            ;
+        if (j == trigrams->len)
+            g_array_append_val (trigrams, trigram);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Split regular expression into literal strings which any match contains.
+ * Only strings outside of groups which aren't repeated optionally are taken.
+ *
+ * @return FALSE if expression is too complex to be analyzed
+ */
+
+static gboolean
+find_index_regex_literals (const char *pattern, gboolean case_sens, GArray * trigrams)
+{
+    GString *run;
+    const char *p;
+    int depth = 0;
+    gboolean ok = TRUE;
+
+    run = g_string_new ("");
+
+    for (p = pattern; ok && *p != '\0'; p++)
+    {
+        gboolean end_run = TRUE;
+
+        switch (*p)
+        {
+        case '|':
+            /* any alternative can match */
+            ok = FALSE;
+            break;
+
+        case '(':
+            /* options, lookarounds etc. */
+            if (p[1] == '?')
+                ok = FALSE;
+            depth++;
+            break;
+
+        case ')':
+            depth--;
+            break;
+
+        case '[':
+            /* skip class: ']' right after '[' or '[^' is a member of class */
+            p++;
+            if (*p == '^')
+                p++;
+            if (*p == ']')
+                p++;
+            for (; ok && *p != '\0' && *p != ']'; p++)
+            {
+                if (*p == '\\' && p[1] != '\0')
+                    p++;
+                else if (*p == '[' && (p[1] == ':' || p[1] == '=' || p[1] == '.'))
+                {
+                    /* [:alpha:], [=a=] and [.a.] can contain ']' */
+                    const char *e;
+
+                    for (e = p + 2; *e != '\0' && (e[0] != p[1] || e[1] != ']'); e++)
+                        ;
+                    if (*e == '\0')
+                        ok = FALSE;
+                    else
+                        p = e + 1;
+                }
+            }
+            if (*p == '\0')
+                ok = FALSE;
+            break;
+
+        case '{':
+            /* skip bounds of repetition */
+            if (strchr (p, '}') == NULL)
+            {
+                ok = FALSE;
+                break;
+            }
+            p = strchr (p, '}');
+            MC_FALLTHROUGH;
+        case '*':
+        case '?':
+            /* previous char is optional: drop all bytes of multibyte char */
+            if (run->len != 0)
+            {
+                const char *prev;
+
+                prev = g_utf8_find_prev_char (run->str, run->str + run->len);
+                g_string_truncate (run, prev == NULL ? 0 : (gsize) (prev - run->str));
+            }
+            break;
+
+        case '+':
+            /* previous char is required, but can be followed by itself */
+            break;
+
+        case '.':
+        case '^':
+        case '$':
+            break;
+
+        case '\\':
+            p++;
+            if (*p == '\0')
+                ok = FALSE;
+            else if (g_ascii_isalnum (*p))
+            {
+                /* char types and assertions of one char, others can be longer */
+                ok = strchr ("dDwWsSbBhHvVRNAzZG", *p) != NULL;
+            }
+            else
+            {
+                /* escaped punctuation is literal char */
+                if (depth == 0)
+                    g_string_append_c (run, *p);
+                end_run = FALSE;
+            }
+            break;
+
+        default:
+            if (depth == 0)
+                g_string_append_c (run, *p);
+            end_run = FALSE;
+            break;
+        }
+
+        /* literal which is followed by quantifier is handled by the quantifier */
+        if (!end_run && (p[1] == '*' || p[1] == '?' || p[1] == '{'))
+            continue;
+
+        if (end_run || depth != 0)
+        {
+            find_index_query_add (trigrams, run->str, run->len, case_sens);
+            g_string_truncate (run, 0);
+        }
+    }
+
+    if (ok)
+        find_index_query_add (trigrams, run->str, run->len, case_sens);
+
+    g_string_free (run, TRUE);
+
+    return ok;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+find_index_scan_add (find_index_scan_t * scan, const guint8 * data, gsize len)
+{
+    gsize i;
+
+    for (i = 0; i < len && scan->trigrams->len <= FIND_INDEX_TRIGRAMS_MAX; i++)
+    {
+        guint32 trigram;
+
+        scan->last = ((scan->last << 8) | find_index_fold (data[i])) & 0xFFFFFF;
+        if (++scan->count < 3)
+            continue;
+
+        trigram = scan->last;
+        if ((scan->seen[trigram >> 3] & (1 << (trigram & 7))) == 0)
+        {
+            scan->seen[trigram >> 3] |= 1 << (trigram & 7);
+            g_array_append_val (scan->trigrams, trigram);
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read the file and make its record. Runs in worker thread.
+ *
+ * @return new record or NULL if file can't be read or is changed while it is read
+ */
+
+static find_index_node_t *
+find_index_scan_file (find_index_scan_t * scan, const char *path, time_t now)
+{
+    struct stat st, st2;
+    find_index_node_t *node = NULL;
+    vfs_file_map_t *map;
+    gboolean truncated = FALSE;
+    int fd;
+    guint i;
+
+    fd = open (path, O_RDONLY);
+    if (fd == -1)
+        return NULL;
+
+    if (fstat (fd, &st) != 0 || !S_ISREG (st.st_mode) || st.st_size > FIND_INDEX_FILE_MAX
+        || st.st_mtime + FIND_INDEX_RACY_SEC > now)
+    {
+        close (fd);
+        return NULL;
+    }
+
+    scan->last = 0;
+    scan->count = 0;
+    g_array_set_size (scan->trigrams, 0);
+
+    map = vfs_map_local_file (fd, st.st_size);
+    if (map != NULL)
+    {
+        find_index_scan_add (scan, (const guint8 *) map->data, map->size);
+        /* lost pages are read as zeros: the record would miss trigrams of new content */
+        truncated = map->truncated;
+        vfs_unmap_local_file (map);
+    }
+    else
+    {
+        guint8 buffer[BUF_8K];
+        ssize_t n;
+
+        while (scan->trigrams->len <= FIND_INDEX_TRIGRAMS_MAX
+               && (n = read (fd, buffer, sizeof (buffer))) > 0)
+            find_index_scan_add (scan, buffer, (gsize) n);
+    }
+
+    if (!truncated && fstat (fd, &st2) == 0 && st2.st_size == st.st_size
+        && st2.st_mtime == st.st_mtime && st2.st_ctime == st.st_ctime)
+    {
+        node = g_new0 (find_index_node_t, 1);
+        node->path = g_strdup (path);
+        node->size = st.st_size;
+        node->mtime = st.st_mtime;
+        node->ctime = st.st_ctime;
+        node->ino = st.st_ino;
+
+        if (scan->trigrams->len <= FIND_INDEX_TRIGRAMS_MAX)
+        {
+            node->bits = FIND_INDEX_BITS_MIN;
+            while (node->bits < scan->trigrams->len * FIND_INDEX_BITS_PER_TRIGRAM)
+                node->bits <<= 1;
+            node->filter = g_malloc0 (node->bits / 8);
+
+            for (i = 0; i < scan->trigrams->len; i++)
+            {
+                guint32 trigram;
+                guint j;
+
+                trigram = g_array_index (scan->trigrams, guint32, i);
+                for (j = 0; j < FIND_INDEX_HASHES; j++)
+                {
+                    guint32 bit;
+
+                    bit = find_index_hash (trigram, j) & (node->bits - 1);
+                    node->filter[bit >> 3] |= 1 << (bit & 7);
+                }
+            }
+        }
+    }
+
+    close (fd);
+
+    /* clear bitmap for the next file */
+    for (i = 0; i < scan->trigrams->len; i++)
+    {
+        guint32 trigram;
+
+        trigram = g_array_index (scan->trigrams, guint32, i);
+        scan->seen[trigram >> 3] &= ~(1 << (trigram & 7));
+    }
+
+    return node;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Index queued files. Runs in worker thread. */
+
+static void
+find_index_job_fn (mc_parallel_t * run, guint job, gpointer user_data)
+{
+    find_index_scan_t scan;
+
+    (void) job;
+    (void) user_data;
+
+    scan.seen = g_malloc0 ((1 << 24) / 8);
+    scan.trigrams = g_array_new (FALSE, FALSE, sizeof (guint32));
+
+    while (!mc_parallel_is_cancelled (run))
+    {
+        char *path;
+        find_index_node_t *node;
+
+        G_LOCK (find_index);
+        path = (char *) g_queue_pop_head (&find_index_pending);
+        if (path != NULL)
+            g_hash_table_remove (find_index_pending_set, path);
+        G_UNLOCK (find_index);
+
+        if (path == NULL)
+            break;
+
+        node = find_index_scan_file (&scan, path, time (NULL));
+        g_free (path);
+
+        if (node != NULL)
+        {
+            node->used = TRUE;
+
+            G_LOCK (find_index);
+            g_hash_table_replace (find_index, node->path, node);
+            find_index_dirty = TRUE;
+            G_UNLOCK (find_index);
+        }
+    }
+
+    g_array_free (scan.trigrams, TRUE);
+    g_free (scan.seen);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Make query for content pattern of find file.
+ *
+ * @return query or NULL if index can't be used for this pattern
+ */
+
+find_index_query_t *
+find_index_query_new (const char *pattern, gboolean regexp, gboolean case_sens,
+                      gboolean all_charsets)
+{
+    find_index_query_t *query;
+    gboolean ok;
+
+    /* pattern is recoded to other charsets */
+    if (pattern == NULL || all_charsets)
+        return NULL;
+
+    query = g_new (find_index_query_t, 1);
+    query->trigrams = g_array_new (FALSE, FALSE, sizeof (guint32));
+
+    if (regexp)
+        ok = find_index_regex_literals (pattern, case_sens, query->trigrams);
+    else
+    {
+        find_index_query_add (query->trigrams, pattern, strlen (pattern), case_sens);
+        ok = TRUE;
+    }
+
+    if (!ok || query->trigrams->len == 0)
+    {
+        find_index_query_free (query);
+        return NULL;
+    }
+
+    G_LOCK (find_index);
+    find_index_get ();
+    G_UNLOCK (find_index);
+
+    return query;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+find_index_query_free (find_index_query_t * query)
+{
+    if (query == NULL)
+        return;
+
+    g_array_free (query->trigrams, TRUE);
+    g_free (query);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Check whether the file can contain text matched by query. Files which aren't in the index
+ * or were changed are queued to be indexed by find_index_update(). Can be called by any thread.
+ *
+ * @param query query made by find_index_query_new()
+ * @param path full local path of regular file
+ * @param st result of stat() of the file
+ *
+ * @return FALSE if file surely doesn't contain a match
+ */
+
+gboolean
+find_index_may_match (const find_index_query_t * query, const char *path, const struct stat *st)
+{
+    find_index_node_t *node;
+    gboolean ret = TRUE;
+
+    if (query == NULL || !S_ISREG (st->st_mode))
+        return TRUE;
+
+    G_LOCK (find_index);
+
+    node = (find_index_node_t *) g_hash_table_lookup (find_index_get (), path);
+    if (node != NULL && node->size == st->st_size && node->mtime == st->st_mtime
+        && node->ctime == st->st_ctime && node->ino == st->st_ino)
+    {
+        node->used = TRUE;
+        ret = find_index_node_test (node, query);
+    }
+    else if (st->st_size <= FIND_INDEX_FILE_MAX
+             && g_hash_table_lookup (find_index_pending_set, path) == NULL)
+    {
+        char *p;
+
+        p = g_strdup (path);
+        g_queue_push_tail (&find_index_pending, p);
+        g_hash_table_insert (find_index_pending_set, p, p);
+    }
+
+    G_UNLOCK (find_index);
+
+    return ret;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Start background indexing of queued files if it isn't running. Called by main thread.
+ */
+
+void
+find_index_update (void)
+{
+    gboolean pending;
+
+    if (find_index_job != NULL)
+    {
+        if (!mc_parallel_wait (find_index_job, 0))
+            return;
+
+        mc_parallel_free (find_index_job);
+        find_index_job = NULL;
+    }
+
+    G_LOCK (find_index);
+    pending = !g_queue_is_empty (&find_index_pending);
+    G_UNLOCK (find_index);
+
+    if (pending)
+        find_index_job = mc_parallel_start (find_index_job_fn, NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Stop background indexing, save the index if it was changed and free it.
+ */
+
+void
+find_index_done (void)
+{
+    if (find_index_job != NULL)
+    {
+        mc_parallel_cancel (find_index_job);
+        mc_parallel_free (find_index_job);
+        find_index_job = NULL;
+    }
+
+    if (find_index == NULL)
+        return;
+
+    if (find_index_dirty)
+    {
+        char *name;
+
+        name = mc_config_get_full_path (MC_FINDINDEX_FILE);
+        mc_util_make_backup_if_possible (name, ".tmp");
+
+        if (find_index_save_to (find_index, name) != 0)
+            mc_util_restore_from_backup_if_possible (name, ".tmp");
+        else
+            mc_util_unlink_backup_if_possible (name, ".tmp");
+
+        g_free (name);
+    }
+
+    g_queue_clear_full (&find_index_pending, g_free);
+    g_hash_table_destroy (find_index_pending_set);
+    find_index_pending_set = NULL;
+    g_hash_table_destroy (find_index);
+    find_index = NULL;
+    find_index_dirty = FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
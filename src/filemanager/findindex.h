@@ -0,0 +1,37 @@
+/** \file findindex.h
+ *  \brief Header: index of content of local files for find file
+ */
+
+#ifndef MC__FINDINDEX_H
+#define MC__FINDINDEX_H
+
+#include <sys/stat.h>
+
+#include "lib/global.h"
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/* trigrams which any text matched by pattern contains */
+typedef struct find_index_query_t find_index_query_t;
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+find_index_query_t *find_index_query_new (const char *pattern, gboolean regexp,
+                                          gboolean case_sens, gboolean all_charsets);
+void find_index_query_free (find_index_query_t * query);
+
+gboolean find_index_may_match (const find_index_query_t * query, const char *path,
+                               const struct stat *st);
+
+void find_index_update (void);
+void find_index_done (void);
+
+/*** inline functions ****************************************************************************/
+
+#endif /* MC__FINDINDEX_H */
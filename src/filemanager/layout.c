@@ -1284,6 +1284,8 @@ swap_panels (void)
         panelswap (selected);
         panelswap (is_panelized);
         panelswap (dir_stat);
+        panelswap (revalidate);
+        panelswap (watch);
 #ifdef WITH_TABS
         panelswap (tabs.list);
         panelswap (tabs.current);
@@ -74,6 +74,8 @@
 #include "panelize.h"
 #include "command.h"            /* cmdline */
 #include "dir.h"                /* dir_list_clean() */
+#include "dirsize.h"            /* dir_size_cache_done() */
+#include "findindex.h"          /* find_index_done() */
 
 #include "chmod.h"
 #include "chown.h"
@@ -295,6 +297,9 @@ create_command_menu (void)
     entries = g_list_prepend (entries, menu_entry_create (_("&User menu"), CK_UserMenu));
     entries = g_list_prepend (entries, menu_entry_create (_("&Directory tree"), CK_Tree));
     entries = g_list_prepend (entries, menu_entry_create (_("&Find file"), CK_Find));
+    entries =
+        g_list_prepend (entries,
+                        menu_entry_create (_("Bul&k replace in files"), CK_ReplaceInFiles));
     entries = g_list_prepend (entries, menu_entry_create (_("S&wap panels"), CK_Swap));
     entries = g_list_prepend (entries, menu_entry_create (_("Switch &panels on/off"), CK_Shell));
     entries =
@@ -933,6 +938,8 @@ done_mc (void)
      */
 
     save_setup (auto_save_setup, panels_options.auto_save_setup);
+    dir_size_cache_done ();
+    find_index_done ();
 
     vfs_stamp_path (vfs_get_raw_current_dir ());
 }
@@ -1181,6 +1188,10 @@ midnight_execute_cmd (Widget * sender, long command)
     /* stop quick search before executing any command */
     send_message (current_panel, NULL, MSG_ACTION, CK_SearchStop, NULL);
 
+    /* commands work with whole directories */
+    if (command != CK_ChangePanel)
+        panel_load_finish_all ();
+
     switch (command)
     {
     case CK_ChangePanel:
@@ -1295,6 +1306,9 @@ midnight_execute_cmd (Widget * sender, long command)
     case CK_Find:
         find_cmd ();
         break;
+    case CK_ReplaceInFiles:
+        replace_in_files_cmd ();
+        break;
 #ifdef ENABLE_VFS_FISH
     case CK_ConnectFish:
         fishlink_cmd ();
@@ -1612,16 +1626,27 @@ midnight_callback (Widget * w, Widget * sender, widget_msg_t msg, int parm, void
         return MSG_HANDLED;
 
     case MSG_IDLE:
-        /* We only need the first idle event to show user menu after start */
-        widget_idle (w, FALSE);
+        {
+            static gboolean booted = FALSE;
 
-        if (boot_current_is_left)
-            widget_select (get_panel_widget (0));
-        else
-            widget_select (get_panel_widget (1));
+            /* We only need the first idle event to show user menu after start */
+            if (!booted)
+            {
+                booted = TRUE;
+
+                if (boot_current_is_left)
+                    widget_select (get_panel_widget (0));
+                else
+                    widget_select (get_panel_widget (1));
 
-        if (auto_menu)
-            midnight_execute_cmd (NULL, CK_UserMenu);
+                if (auto_menu)
+                    midnight_execute_cmd (NULL, CK_UserMenu);
+            }
+
+            /* the rest of idle events are used to read panel directories */
+            if (!panel_load_idle ())
+                widget_idle (w, FALSE);
+        }
         return MSG_HANDLED;
 
     case MSG_KEY:
@@ -122,6 +122,11 @@ GList *saved_tabs;
 #define MARKED_SELECTED 3
 #define STATUS          5
 
+/* time to read directory before it is shown first time */
+#define PANEL_LOAD_FIRST_USEC (G_USEC_PER_SEC / 10)
+/* time to read directory on each idle event */
+#define PANEL_LOAD_STEP_USEC (G_USEC_PER_SEC / 25)
+
 /*** file scope type declarations ****************************************************************/
 
 typedef enum
@@ -1507,6 +1512,7 @@ panel_destroy (WPanel * p)
     }
 
     panel_clean_dir (p);
+    dir_watch_free (p->watch);
 
     /* clean history */
     if (p->dir_history != NULL)
@@ -2768,6 +2774,9 @@ do_search (WPanel * panel, int c_code)
 static void
 start_search (WPanel * panel)
 {
+    /* search in the whole directory */
+    panel_load_finish (panel);
+
     if (panel->searching)
     {
         if (panel->selected == panel->dir.len - 1)
@@ -3274,28 +3283,121 @@ subshell_chdir (const vfs_path_t * vpath)
 
 /* --------------------------------------------------------------------------------------------- */
 /**
- * Changes the current directory of the panel.
- * Don't record change in the directory history.
+ * Start to follow changes of panel directory. Should be called before the directory is read.
+ */
+
+static void
+panel_watch_start (WPanel * panel)
+{
+    if (panel->watch != NULL
+        && vfs_path_equal (dir_watch_get_path (panel->watch), panel->cwd_vpath))
+        dir_watch_reset (panel->watch);
+    else
+    {
+        dir_watch_free (panel->watch);
+        panel->watch = dir_watch_new (panel->cwd_vpath);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Apply changes of panel directory to the listing without reading the whole directory.
+ *
+ * @return TRUE if listing is up to date, FALSE if directory should be read again
  */
 
 static gboolean
-_do_panel_cd (WPanel * panel, const vfs_path_t * new_dir_vpath, enum cd_enum cd_type)
+panel_watch_apply (WPanel * panel)
 {
-    vfs_path_t *olddir_vpath;
+    GHashTable *changes;
+    gboolean rescan;
+    int old_selected, old_marked, first;
+    uintmax_t old_total;
+    struct stat st;
+    gboolean ok;
 
-    /* Convert *new_path to a suitable pathname, handle ~user */
-    if (cd_type == cd_parse_command)
-    {
-        const vfs_path_element_t *element;
+    if (panel->watch == NULL || panel->is_panelized || panel->loader != NULL)
+        return FALSE;
 
-        element = vfs_path_get_by_index (new_dir_vpath, 0);
-        if (strcmp (element->path, "-") == 0)
-            new_dir_vpath = panel->lwd_vpath;
-    }
+    /* directory is stat'ed before changes are taken: later changes make it differ */
+    if (mc_stat (panel->cwd_vpath, &st) != 0)
+        return FALSE;
 
-    if (mc_chdir (new_dir_vpath) == -1)
+    dir_watch_poll ();
+    changes = dir_watch_take_changes (panel->watch, &rescan);
+    if (rescan)
+        return FALSE;
+    if (changes == NULL)
+        return TRUE;
+
+    old_selected = panel->selected;
+    old_marked = panel->marked;
+    old_total = panel->total;
+
+    ok = dir_list_update (&panel->dir, panel->cwd_vpath, changes, panel->sort_field->sort_routine,
+                          &panel->sort_info, panel->filter, &panel->selected, &first);
+    g_hash_table_destroy (changes);
+
+    if (!ok)
         return FALSE;
 
+    panel->dir_stat = st;
+
+    /* keep the selected entry at the same place on the screen */
+    panel->top_file += panel->selected - old_selected;
+    adjust_top_file (panel);
+    recalculate_panel_summary (panel);
+
+    /* don't repaint if only invisible entries are changed */
+    if (first < panel->top_file + panel_items (panel) || panel->marked != old_marked
+        || panel->total != old_total)
+        panel->dirty = 1;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Bring listing up to date after changes of directory: apply changes collected by the watch
+ * or read the directory again if they cannot be applied.
+ */
+
+static void
+panel_watch_reload (WPanel * panel)
+{
+    panel_load_finish (panel);
+
+    if (!panel_watch_apply (panel))
+        panel_reload (panel);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Changes of some watched directory are collected: apply them when MC is idle.
+ */
+
+static void
+panel_watch_notify (void)
+{
+    if (midnight_dlg != NULL)
+        widget_idle (WIDGET (midnight_dlg), TRUE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Change current directory of panel and clean the panel.
+ *
+ * @return previous directory of panel on success (should be freed by caller), NULL on failure
+ */
+
+static vfs_path_t *
+panel_chdir (WPanel * panel, const vfs_path_t * new_dir_vpath)
+{
+    vfs_path_t *olddir_vpath;
+
+    if (mc_chdir (new_dir_vpath) == -1)
+        return NULL;
+
     /* Success: save previous directory, shutdown status of previous dir */
     olddir_vpath = vfs_path_clone (panel->cwd_vpath);
     panel_set_lwd (panel, panel->cwd_vpath);
@@ -3309,14 +3411,135 @@ _do_panel_cd (WPanel * panel, const vfs_path_t * new_dir_vpath, enum cd_enum cd_
 
     subshell_chdir (panel->cwd_vpath);
 
-    /* Reload current panel */
     panel_clean_dir (panel);
+    panel_watch_start (panel);
 
-    if (!dir_list_load (&panel->dir, panel->cwd_vpath, panel->sort_field->sort_routine,
-                        &panel->sort_info, panel->filter))
+    return olddir_vpath;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Update panel after a portion of directory was merged into the list.
+ *
+ * @param old_selected index of selected entry before merge
+ */
+
+static void
+panel_load_update (WPanel * panel, int old_selected)
+{
+    /* keep the selected entry at the same place on the screen */
+    panel->top_file += panel->selected - old_selected;
+
+    /* select the file (usually, the directory we came from) if user has not moved yet */
+    if (panel->loader_select != NULL && panel->selected == 0)
+    {
+        int i;
+
+        for (i = 0; i < panel->dir.len; i++)
+            if (strcmp (panel->dir.list[i].fname, panel->loader_select) == 0)
+            {
+                panel->selected = i;
+                panel->top_file = i - (WIDGET (panel)->lines - 2) / 2;
+                MC_PTR_FREE (panel->loader_select);
+                break;
+            }
+    }
+
+    adjust_top_file (panel);
+    panel->dirty = 1;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Remember stat of panel directory at the time its listing is made. Only stat of local
+ * directories is taken: it is used to check listings of local directories for changes.
+ */
+
+static void
+panel_stat_dir (WPanel * panel)
+{
+    if (!vfs_file_is_local (panel->cwd_vpath) || mc_stat (panel->cwd_vpath, &panel->dir_stat) != 0)
+        memset (&panel->dir_stat, 0, sizeof (panel->dir_stat));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Start reading of panel directory in background. The first entries are read at once,
+ * the rest is read on idle events of the main dialog.
+ *
+ * @param select_name name of file to select as soon as it is read
+ */
+
+static void
+panel_load_start (WPanel * panel, const char *select_name)
+{
+    int old_selected = panel->selected;
+
+    panel_stat_dir (panel);
+    panel->loader = dir_list_load_start (&panel->dir, panel->cwd_vpath,
+                                         panel->sort_field->sort_routine, &panel->sort_info,
+                                         panel->filter);
+    if (panel->loader == NULL)
+    {
         message (D_ERROR, MSG_ERROR, _("Cannot read directory contents"));
+        return;
+    }
+
+    if (select_name != NULL)
+    {
+        char *subdir;
+
+        subdir = vfs_strip_suffix_from_filename (x_basename (select_name));
+        panel->loader_select = subdir;
+    }
+
+    if (dir_list_load_step (panel->loader, PANEL_LOAD_FIRST_USEC, &panel->selected))
+        panel_load_finish (panel);
+    else
+    {
+        panel_load_update (panel, old_selected);
+        widget_idle (WIDGET (WIDGET (panel)->owner), TRUE);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Changes the current directory of the panel.
+ * Don't record change in the directory history.
+ */
 
-    try_to_select (panel, get_parent_dir_name (panel->cwd_vpath, olddir_vpath));
+static gboolean
+_do_panel_cd (WPanel * panel, const vfs_path_t * new_dir_vpath, enum cd_enum cd_type)
+{
+    vfs_path_t *olddir_vpath;
+
+    /* Convert *new_path to a suitable pathname, handle ~user */
+    if (cd_type == cd_parse_command)
+    {
+        const vfs_path_element_t *element;
+
+        element = vfs_path_get_by_index (new_dir_vpath, 0);
+        if (strcmp (element->path, "-") == 0)
+            new_dir_vpath = panel->lwd_vpath;
+    }
+
+    olddir_vpath = panel_chdir (panel, new_dir_vpath);
+    if (olddir_vpath == NULL)
+        return FALSE;
+
+    /* Reload current panel */
+
+    if (panels_options.progressive_load)
+        panel_load_start (panel, get_parent_dir_name (panel->cwd_vpath, olddir_vpath));
+    else
+    {
+        panel_stat_dir (panel);
+        if (!dir_list_load (&panel->dir, panel->cwd_vpath, panel->sort_field->sort_routine,
+                            &panel->sort_info, panel->filter))
+            message (D_ERROR, MSG_ERROR, _("Cannot read directory contents"));
+
+        try_to_select (panel, get_parent_dir_name (panel->cwd_vpath, olddir_vpath));
+    }
 
     load_hint (FALSE);
     panel->dirty = 1;
@@ -3443,6 +3666,34 @@ panel_execute_cmd (WPanel * panel, long command)
     if (command != CK_Search)
         stop_search (panel);
 
+    switch (command)
+    {
+    case CK_Up:
+    case CK_Down:
+    case CK_Left:
+    case CK_Right:
+    case CK_Bottom:
+    case CK_Top:
+    case CK_PageDown:
+    case CK_PageUp:
+    case CK_Mark:
+    case CK_MarkUp:
+    case CK_MarkDown:
+    case CK_CdParent:
+    case CK_SearchStop:
+        /* can be done while directory is being loaded */
+        break;
+    case CK_Enter:
+    case CK_CdChild:
+        /* entering of directory drops the loader, other files are handled after loading */
+        if (!(S_ISDIR (selection (panel)->st.st_mode) || link_isdir (selection (panel))))
+            panel_load_finish (panel);
+        break;
+    default:
+        panel_load_finish (panel);
+        break;
+    }
+
     switch (command)
     {
     case CK_Up:
@@ -4042,6 +4293,10 @@ update_one_panel_widget (WPanel * panel, panel_update_flags_t flags, const char
     gboolean free_pointer;
     char *my_current_file = NULL;
 
+    /* settings of listing may be changed: don't take it from the watch */
+    if (panel->watch != NULL && (flags & UP_RELOAD) != 0)
+        dir_watch_set_rescan (panel->watch);
+
     if ((flags & UP_RELOAD) != 0)
     {
         panel->is_panelized = FALSE;
@@ -4061,7 +4316,7 @@ update_one_panel_widget (WPanel * panel, panel_update_flags_t flags, const char
     if (panel->is_panelized)
         reload_panelized (panel);
     else
-        panel_reload (panel);
+        panel_watch_reload (panel);
 
     try_to_select (panel, current_file);
     panel->dirty = 1;
@@ -4264,8 +4519,231 @@ panel_dir_list_callback (dir_list_cb_state_t state, void *data)
     }
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Reload panel if its directory was changed since the listing was made.
+ * Listing is made at the time panel->dir_stat is taken.
+ */
+
+static void
+panel_revalidate (WPanel * panel)
+{
+    struct stat st;
+
+    if (mc_stat (panel->cwd_vpath, &st) != 0 || st.st_ino != panel->dir_stat.st_ino
+        || st.st_dev != panel->dir_stat.st_dev || st.st_mtime != panel->dir_stat.st_mtime
+        || st.st_ctime != panel->dir_stat.st_ctime)
+    {
+        /* don't let fast reload skip it */
+        memset (&panel->dir_stat, 0, sizeof (panel->dir_stat));
+        panel_reload (panel);
+        widget_draw (WIDGET (panel));
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Drop listing of tab.
+ */
+
+static void
+panel_tab_clean (Tab * t)
+{
+    dir_list_free_list (&t->dir);
+    MC_PTR_FREE (t->filter);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Move listing of panel to the tab which is being left. Only listings of local directories
+ * are kept: they can be checked cheaply for changes.
+ *
+ * Panel gets empty listing which should be filled by caller.
+ */
+
+static void
+panel_tab_save (WPanel * panel, Tab * t)
+{
+    panel_tab_clean (t);
+
+    /* listing is checked for changes since it was made, not since the tab was left */
+    if (panel->loader != NULL || panel->is_panelized || !vfs_file_is_local (panel->cwd_vpath)
+        || panel->dir_stat.st_ino == 0)
+        return;
+
+    t->dir_stat = panel->dir_stat;
+
+    t->dir.list = panel->dir.list;
+    t->dir.size = panel->dir.size;
+    t->dir.len = panel->dir.len;
+    t->selected = panel->selected;
+    t->top_file = panel->top_file;
+    t->sort = panel->sort_field->sort_routine;
+    t->sort_info = panel->sort_info;
+    t->filter = g_strdup (panel->filter);
+
+    panel->dir.list = NULL;
+    panel->dir.size = 0;
+    panel->dir.len = 0;
+    dir_list_init (&panel->dir);
+    panel->selected = 0;
+    panel->top_file = 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Show listing of tab in panel without reading the directory. Directory is checked
+ * for changes later, on idle.
+ *
+ * @return TRUE on success, FALSE if tab has no usable listing
+ */
+
+static gboolean
+panel_tab_restore (WPanel * panel, Tab * t)
+{
+    vfs_path_t *olddir_vpath;
+
+    if (t->dir.list == NULL || g_strcmp0 (t->filter, panel->filter) != 0)
+    {
+        panel_tab_clean (t);
+        return FALSE;
+    }
+
+    olddir_vpath = panel_chdir (panel, t->path);
+    if (olddir_vpath == NULL)
+    {
+        panel_tab_clean (t);
+        return FALSE;
+    }
+    vfs_path_free (olddir_vpath);
+
+    /* panel_chdir() has cleaned the panel */
+    panel->dir.list = t->dir.list;
+    panel->dir.size = t->dir.size;
+    panel->dir.len = t->dir.len;
+    panel->selected = MIN (t->selected, panel->dir.len - 1);
+    panel->top_file = t->top_file;
+    panel->dir_stat = t->dir_stat;
+
+    t->dir.list = NULL;
+    t->dir.size = 0;
+    t->dir.len = 0;
+    panel_tab_clean (t);
+
+    if (t->sort != panel->sort_field->sort_routine
+        || t->sort_info.reverse != panel->sort_info.reverse
+        || t->sort_info.case_sensitive != panel->sort_info.case_sensitive
+        || t->sort_info.exec_first != panel->sort_info.exec_first)
+        panel_re_sort (panel);
+
+    adjust_top_file (panel);
+    recalculate_panel_summary (panel);
+
+    load_hint (FALSE);
+    panel->dirty = 1;
+    update_xterm_title_path ();
+    directory_history_add (panel, panel->cwd_vpath);
+
+    panel->revalidate = TRUE;
+    widget_idle (WIDGET (WIDGET (panel)->owner), TRUE);
+
+    return TRUE;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read the rest of the panel directory synchronously.
+ */
+
+void
+panel_load_finish (WPanel * panel)
+{
+    int old_selected = panel->selected;
+
+    if (panel->loader == NULL)
+        return;
+
+    if (!dir_list_load_finish (panel->loader, &panel->selected))
+        message (D_ERROR, MSG_ERROR, _("Cannot read directory contents"));
+    panel->loader = NULL;
+
+    panel_load_update (panel, old_selected);
+    MC_PTR_FREE (panel->loader_select);
+    recalculate_panel_summary (panel);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+panel_load_finish_all (void)
+{
+    int i;
+
+    for (i = 0; i < 2; i++)
+        if (get_panel_type (i) == view_listing)
+            panel_load_finish (PANEL (get_panel_widget (i)));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read next portions of panel directories and apply changes of watched directories.
+ * Called on idle events of the main dialog.
+ *
+ * @return TRUE if any panel directory is still being read, FALSE otherwise
+ */
+
+gboolean
+panel_load_idle (void)
+{
+    gboolean ret = FALSE;
+    int i;
+
+    for (i = 0; i < 2; i++)
+        if (get_panel_type (i) == view_listing)
+        {
+            WPanel *panel;
+            int old_selected;
+
+            panel = PANEL (get_panel_widget (i));
+
+            if (panel->revalidate)
+            {
+                panel->revalidate = FALSE;
+                panel_revalidate (panel);
+            }
+
+            if (panel->loader == NULL)
+            {
+                if (panel->watch != NULL && !panel->is_panelized
+                    && dir_watch_has_changes (panel->watch))
+                {
+                    panel_watch_reload (panel);
+                    if (panel->dirty)
+                        widget_draw (WIDGET (panel));
+                }
+                continue;
+            }
+
+            old_selected = panel->selected;
+
+            if (dir_list_load_step (panel->loader, PANEL_LOAD_STEP_USEC, &panel->selected))
+                panel_load_finish (panel);
+            else
+            {
+                panel_load_update (panel, old_selected);
+                ret = TRUE;
+            }
+
+            widget_draw (WIDGET (panel));
+        }
+
+    mc_refresh ();
+
+    return ret;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 void
@@ -4280,6 +4758,10 @@ try_to_select (WPanel * panel, const char *name)
 void
 panel_clean_dir (WPanel * panel)
 {
+    dir_list_load_abort (panel->loader);
+    panel->loader = NULL;
+    MC_PTR_FREE (panel->loader_select);
+
     panel->top_file = 0;
     panel->selected = 0;
     panel->marked = 0;
@@ -4465,6 +4947,9 @@ panel_sized_with_dir_new (const char *panel_name, int y, int x, int lines, int c
         panel->cwd_vpath = vfs_path_clone (vfs_get_raw_current_dir ());
     }
 
+    panel_watch_start (panel);
+    panel_stat_dir (panel);
+
     /* Load the default format */
     if (!dir_list_load (&panel->dir, panel->cwd_vpath, panel->sort_field->sort_routine,
                         &panel->sort_info, panel->filter))
@@ -4494,6 +4979,9 @@ panel_reload (WPanel * panel)
     struct stat current_stat;
     vfs_path_t *cwd_vpath;
 
+    /* marks are taken from the current list */
+    panel_load_finish (panel);
+
     if (panels_options.fast_reload && stat (vfs_path_as_str (panel->cwd_vpath), &current_stat) == 0
         && current_stat.st_ctime == panel->dir_stat.st_ctime
         && current_stat.st_mtime == panel->dir_stat.st_mtime)
@@ -4507,12 +4995,15 @@ panel_reload (WPanel * panel)
         panel->cwd_vpath = vfs_path_from_str (PATH_SEP_STR);
         panel_clean_dir (panel);
         dir_list_init (&panel->dir);
+        dir_watch_free (panel->watch);
+        panel->watch = NULL;
         return;
     }
 
     panel->cwd_vpath = cwd_vpath;
-    memset (&(panel->dir_stat), 0, sizeof (panel->dir_stat));
     show_dir (panel);
+    panel_watch_start (panel);
+    panel_stat_dir (panel);
 
     if (!dir_list_reload (&panel->dir, panel->cwd_vpath, panel->sort_field->sort_routine,
                           &panel->sort_info, panel->filter))
@@ -4723,6 +5214,9 @@ panel_re_sort (WPanel * panel)
     if (panel == NULL)
         return;
 
+    /* loader merges new entries using the sort order it was started with */
+    panel_load_finish (panel);
+
     filename = g_strdup (selection (panel)->fname);
     unselect_item (panel);
     dir_list_sort (&panel->dir, panel->sort_field->sort_routine, &panel->sort_info);
@@ -4749,6 +5243,8 @@ panel_set_sort_order (WPanel * panel, const panel_field_t * sort_order)
     if (sort_order == NULL)
         return;
 
+    panel_load_finish (panel);
+
     panel->sort_field = sort_order;
 
     /* The directory is already sorted, we have to load the unsorted stuff */
@@ -5055,6 +5551,7 @@ panel_init (void)
         mc_skin_get ("widget-panel", "filename-scroll-right-char", "}");
 
     mc_event_add (MCEVENT_GROUP_FILEMANAGER, "update_panels", event_update_panels, NULL, NULL);
+    dir_watch_set_notify (panel_watch_notify);
     mc_event_add (MCEVENT_GROUP_FILEMANAGER, "panel_save_current_file_to_clip_file",
                   panel_save_current_file_to_clip_file, NULL, NULL);
 }
@@ -5789,6 +6286,7 @@ change_tab (WPanel * p, TabsDirection_t d, GList * tab)
     if (p->tabs.current)
     {
         Tab *t = (Tab *) p->tabs.current->data;
+        Tab *old;
         if (t->path)
         {
             vfs_path_free (t->path);
@@ -5796,6 +6294,7 @@ change_tab (WPanel * p, TabsDirection_t d, GList * tab)
 
         //t->path = (vfs_path_t *) g_memdup(p->cwd_vpath, sizeof(vfs_path_t));
         t->path = vfs_path_clone (p->cwd_vpath);
+        old = t;
 
         if (d == TABDIR_NEXT)
         {
@@ -5821,7 +6320,12 @@ change_tab (WPanel * p, TabsDirection_t d, GList * tab)
         t = (Tab *) p->tabs.current->data;
         if (t->path)
         {
-            do_panel_cd (p, t->path, cd_exact);
+            panel_tab_save (p, old);
+            if (!panel_tab_restore (p, t) && !do_panel_cd (p, t->path, cd_exact))
+            {
+                /* listing of left tab has been moved from panel, read it again */
+                panel_reload (p);
+            }
         }
     }
 }
@@ -5830,6 +6334,7 @@ void
 destroy_tab (Tab * t)
 {
     log4c(log4ccat, LOG4C_PRIORITY_INFO, "destroy");
+    panel_tab_clean (t);
     if (t->path)
     {
         vfs_path_free (t->path);
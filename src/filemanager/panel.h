@@ -15,6 +15,7 @@
 #include "lib/filehighlight.h"
 
 #include "dir.h"                /* dir_list */
+#include "dirwatch.h"           /* dir_watch_t */
 
 /*** typedefs(not structures) and defined constants **********************************************/
 
@@ -112,6 +113,15 @@ typedef struct Tab
 {
     char *name;
     vfs_path_t *path;
+
+    /* listing of inactive tab, it is shown without rereading the directory */
+    dir_list dir;               /* list.list is NULL if there is no listing */
+    int selected;
+    int top_file;
+    GCompareFunc sort;          /* sort order of dir */
+    dir_sort_options_t sort_info;
+    char *filter;
+    struct stat dir_stat;       /* stat of the directory when listing is saved */
 } Tab;
 
 typedef struct TabsInfo
@@ -205,6 +215,11 @@ typedef struct
     int search_chpoint;         /*point after last characters in search_char */
     int content_shift;          /* Number of characters of filename need to skip from left side. */
     int max_shift;              /* Max shift for visible part of current panel */
+
+    dir_list_loader_t *loader;  /* Not NULL while directory is being read in background */
+    char *loader_select;        /* Name of file to select as soon as it is read */
+    gboolean revalidate;        /* listing is taken from tab: compare dir_stat with directory */
+    dir_watch_t *watch;         /* changes of current directory, NULL if they are not followed */
 } WPanel;
 
 /*** global variables defined in .c file *********************************************************/
@@ -267,6 +282,9 @@ void set_panel_dirbox_yoffset(int offset);
 #endif
 
 void panel_clean_dir (WPanel * panel);
+void panel_load_finish (WPanel * panel);
+void panel_load_finish_all (void);
+gboolean panel_load_idle (void);
 
 void panel_reload (WPanel * panel);
 void panel_set_sort_order (WPanel * panel, const panel_field_t * sort_order);
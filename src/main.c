@@ -55,6 +55,8 @@
 #include "lib/fileloc.h"
 #include "lib/strutil.h"
 #include "lib/util.h"
+#include "lib/parallel.h"       /* mc_parallel_deinit() */
+#include "lib/search.h"         /* mc_search_cache_done() */
 #include "lib/vfs/vfs.h"        /* vfs_init(), vfs_shut() */
 
 #include "filemanager/midnight.h"       /* current_panel */
@@ -489,8 +491,12 @@ main (int argc, char *argv[])
     /* Virtual File System shutdown */
     vfs_shut ();
 
+    mc_parallel_deinit ();
+
     flush_extension_file ();    /* does only free memory */
 
+    mc_search_cache_done ();
+
     mc_skin_deinit ();
     tty_colors_done ();
 
@@ -136,6 +136,7 @@ panels_options_t panels_options = {
     .show_dot_files = TRUE,
     .fast_reload = FALSE,
     .fast_reload_msg_shown = FALSE,
+    .progressive_load = TRUE,
     .mark_moves_down = TRUE,
     .reverse_files_only = TRUE,
     .auto_save_setup = FALSE,
@@ -421,6 +422,7 @@ static const struct
 #ifdef USE_INTERNAL_EDIT
     { "editor_backup_extension", &option_backup_ext, "~" },
     { "editor_filesize_threshold", &option_filesize_threshold, "64M" },
+    { "editor_rope_threshold", &option_rope_threshold, "16M" },
     { "editor_stop_format_chars", &option_stop_format_chars, "-+*\\,.;:&>" },
 #endif
     { "mcview_eof", &mcview_show_eof, "" },
@@ -439,6 +441,7 @@ static const struct
     { "show_dot_files", &panels_options.show_dot_files },
     { "fast_reload", &panels_options.fast_reload },
     { "fast_reload_msg_shown", &panels_options.fast_reload_msg_shown },
+    { "progressive_load", &panels_options.progressive_load },
     { "mark_moves_down", &panels_options.mark_moves_down },
     { "reverse_files_only", &panels_options.reverse_files_only },
     { "auto_save_setup_panels", &panels_options.auto_save_setup },
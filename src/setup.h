@@ -59,6 +59,7 @@ typedef struct
     gboolean show_dot_files;    /* If TRUE, show files starting with a dot */
     gboolean fast_reload;       /* If TRUE then use stat() on the cwd to determine directory changes */
     gboolean fast_reload_msg_shown;     /* Have we shown the fast-reload warning in the past? */
+    gboolean progressive_load;  /* If TRUE then show directory while it is being read */
     gboolean mark_moves_down;   /* If TRUE, marking a files moves the cursor down */
     gboolean reverse_files_only;        /* If TRUE, only selection of files is inverted */
     gboolean auto_save_setup;
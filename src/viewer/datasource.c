@@ -228,6 +228,47 @@ mcview_get_ptr_string (WView * view, off_t byte_index)
     return NULL;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get pointer to contiguous data started at byte_index. Data is valid until the next access
+ * to the data source.
+ *
+ * @param view viewer object
+ * @param byte_index offset of data
+ * @param len length of returned data
+ *
+ * @return NULL if there is no data at byte_index
+ */
+
+char *
+mcview_get_block (WView * view, off_t byte_index, size_t * len)
+{
+    char *p = NULL;
+
+    switch (view->datasource)
+    {
+    case DS_STDIO_PIPE:
+    case DS_VFS_PIPE:
+        p = mcview_get_block_growing_buffer (view, byte_index, len);
+        break;
+    case DS_FILE:
+        p = mcview_get_ptr_file (view, byte_index);
+        if (p != NULL)
+            *len = view->ds_file_datalen - (size_t) (byte_index - view->ds_file_offset);
+        break;
+    case DS_STRING:
+        p = mcview_get_ptr_string (view, byte_index);
+        if (p != NULL)
+            *len = view->ds_string_len - (size_t) byte_index;
+        break;
+    case DS_NONE:
+    default:
+        break;
+    }
+
+    return p;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 gboolean
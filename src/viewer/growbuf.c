@@ -290,3 +290,35 @@ mcview_get_ptr_growing_buffer (WView * view, off_t byte_index)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Get pointer to the data started at byte_index up to the end of its page.
+ *
+ * @param view viewer object
+ * @param byte_index offset of data
+ * @param len length of returned data
+ *
+ * @return NULL if there is no data at byte_index
+ */
+
+char *
+mcview_get_block_growing_buffer (WView * view, off_t byte_index, size_t * len)
+{
+    char *p;
+    off_t pageno, pageindex;
+
+    p = mcview_get_ptr_growing_buffer (view, byte_index);
+    if (p == NULL)
+        return NULL;
+
+    pageno = byte_index / VIEW_PAGE_SIZE;
+    pageindex = byte_index % VIEW_PAGE_SIZE;
+
+    if (pageno < (off_t) view->growbuf_blockptr->len - 1)
+        *len = VIEW_PAGE_SIZE - (size_t) pageindex;
+    else
+        *len = view->growbuf_lastindex - (size_t) pageindex;
+
+    return p;
+}
+
+/* --------------------------------------------------------------------------------------------- */
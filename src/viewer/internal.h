@@ -256,6 +256,7 @@ void mcview_update_filesize (WView * view);
 char *mcview_get_ptr_file (WView *, off_t);
 char *mcview_get_ptr_string (WView *, off_t);
 gboolean mcview_get_utf (WView * view, off_t byte_index, int *ch, int *ch_len);
+char *mcview_get_block (WView * view, off_t byte_index, size_t * len);
 gboolean mcview_get_byte_string (WView *, off_t, int *);
 gboolean mcview_get_byte_none (WView *, off_t, int *);
 void mcview_set_byte (WView *, off_t, byte);
@@ -287,6 +288,7 @@ off_t mcview_growbuf_filesize (WView * view);
 void mcview_growbuf_read_until (WView * view, off_t p);
 gboolean mcview_get_byte_growing_buffer (WView * view, off_t p, int *);
 char *mcview_get_ptr_growing_buffer (WView * view, off_t p);
+char *mcview_get_block_growing_buffer (WView * view, off_t byte_index, size_t * len);
 
 /* hex.c: */
 void mcview_display_hex (WView * view);
@@ -340,6 +342,8 @@ int mcview_nroff_seq_prev (mcview_nroff_t *);
 /* search.c: */
 mc_search_cbret_t mcview_search_cmd_callback (const void *user_data, gsize char_offset,
                                               int *current_char);
+mc_search_cbret_t mcview_search_block_cmd_callback (const void *user_data, gsize offset,
+                                                    const char **block, gsize * block_len);
 mc_search_cbret_t mcview_search_update_cmd_callback (const void *user_data, gsize char_offset);
 void mcview_do_search (WView * view, off_t want_search_start);
 
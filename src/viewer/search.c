@@ -47,6 +47,9 @@
 
 /*** file scope macro definitions ****************************************************************/
 
+/* size of block of mapped file given to search engine at once */
+#define MCVIEW_SEARCH_MAP_BLOCK (1024 * 1024)
+
 /*** file scope type declarations ****************************************************************/
 
 typedef struct
@@ -56,6 +59,7 @@ typedef struct
     gboolean first;
     WView *view;
     off_t offset;
+    vfs_file_map_t *map;        /* local file mapped to memory, or NULL */
 } mcview_search_status_msg_t;
 
 /*** file scope variables ************************************************************************/
@@ -131,6 +135,9 @@ mcview_find (mcview_search_status_msg_t * ssm, off_t search_start, off_t search_
     view->search_numNeedSkipChar = 0;
     search_cb_char_curr_index = -1;
 
+    /* nroff sequences are recoded char by char, plain data is searched by blocks */
+    view->search->block_fn = view->mode_flags.nroff ? NULL : mcview_search_block_cmd_callback;
+
     if (mcview_search_options.backwards)
     {
         search_end = mcview_get_filesize (view);
@@ -253,6 +260,36 @@ mcview_search_cmd_callback (const void *user_data, gsize char_offset, int *curre
 
 /* --------------------------------------------------------------------------------------------- */
 
+mc_search_cbret_t
+mcview_search_block_cmd_callback (const void *user_data, gsize offset, const char **block,
+                                  gsize * block_len)
+{
+    const mcview_search_status_msg_t *vsm = (const mcview_search_status_msg_t *) user_data;
+    size_t len = 0;
+
+    if (vsm->map != NULL)
+    {
+        /* file is truncated during the search: the rest of it is lost */
+        if (vsm->map->truncated)
+            return MC_SEARCH_CB_ABORT;
+        if (offset >= vsm->map->size)
+            return MC_SEARCH_CB_NOTFOUND;
+
+        *block = vsm->map->data + offset;
+        *block_len = MIN (vsm->map->size - offset, MCVIEW_SEARCH_MAP_BLOCK);
+        return MC_SEARCH_CB_OK;
+    }
+
+    *block = mcview_get_block (vsm->view, (off_t) offset, &len);
+    if (*block == NULL || len == 0)
+        return MC_SEARCH_CB_NOTFOUND;
+
+    *block_len = len;
+    return MC_SEARCH_CB_OK;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 mc_search_cbret_t
 mcview_search_update_cmd_callback (const void *user_data, gsize char_offset)
 {
@@ -301,6 +338,7 @@ mcview_do_search (WView * view, off_t want_search_start)
     off_t search_start = 0;
     off_t orig_search_start = view->search_start;
     gboolean found = FALSE;
+    gboolean truncated;
 
     size_t match_len;
 
@@ -346,6 +384,11 @@ mcview_do_search (WView * view, off_t want_search_start)
     vsm.first = TRUE;
     vsm.view = view;
     vsm.offset = search_start;
+    vsm.map = NULL;
+
+    /* search in local file without copying of it to the viewer cache */
+    if (view->datasource == DS_FILE)
+        vsm.map = vfs_map_local_file (vfs_get_local_fd (view->ds_file_fd), view->ds_file_filesize);
 
     status_msg_init (STATUS_MSG (&vsm), _("Search"), 1.0, simple_status_msg_init_cb,
                      mcview_search_status_update_cb, NULL);
@@ -421,12 +464,18 @@ mcview_do_search (WView * view, off_t want_search_start)
         }
     }
 
+    truncated = vsm.map != NULL && vsm.map->truncated;
+    vfs_unmap_local_file (vsm.map);
+
     if (!found)
     {
         view->search_start = orig_search_start;
         mcview_update (view);
 
-        if (view->search->error == MC_SEARCH_E_NOTFOUND)
+        if (truncated)
+            query_dialog (_("Search"), _("File was truncated during the search"), D_ERROR, 1,
+                          _("&Dismiss"));
+        else if (view->search->error == MC_SEARCH_E_NOTFOUND)
             query_dialog (_("Search"), _(STR_E_NOTFOUND), D_NORMAL, 1, _("&Dismiss"));
         else if (view->search->error_str != NULL)
             query_dialog (_("Search"), view->search->error_str, D_NORMAL, 1, _("&Dismiss"));
@@ -0,0 +1,210 @@
+/*
+   lib/filehighlight - tests for colors of file names matched by extensions
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "lib/filehighlight"
+
+#include "tests/mctest.h"
+
+#include <unistd.h>
+
+#include "lib/skin.h"
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Mock */
+/* color of group "extN" is N */
+static int
+mc_skin_color_get__mock (const gchar * group, const gchar * name)
+{
+    (void) group;
+
+    return atoi (name + strlen ("ext"));
+}
+
+#define mc_skin_color_get mc_skin_color_get__mock
+
+#include "lib/filehighlight/common.c"
+#include "lib/filehighlight/ini-file-read.c"
+#include "lib/filehighlight/get-color.c"
+
+/* the first rule which matches file name wins */
+static const char *const test_ini =
+    "[ext1]\n"
+    "extensions=tar;tar.gz;gz\n"
+    "[ext2]\n"
+    "extensions=c;h\n"
+    "extensions_case=true\n"
+    "[ext3]\n"
+    "extensions=GZ;C;txt\n"
+    "[ext4]\n"
+    "extensions=txt;md;tar.bz2\n";
+
+static char *ini_file = NULL;
+static mc_fhl_t *fhl = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    int fd;
+
+    str_init_strings (NULL);
+
+    fd = g_file_open_tmp ("mc-fhl-XXXXXX.ini", &ini_file, NULL);
+    close (fd);
+    g_file_set_contents (ini_file, test_ini, -1, NULL);
+
+    fhl = mc_fhl_new (FALSE);
+    mc_fhl_read_ini_file (fhl, ini_file);
+    mc_fhl_parse_ini_file (fhl);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    mc_fhl_free (&fhl);
+
+    unlink (ini_file);
+    MC_PTR_FREE (ini_file);
+
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_mc_fhl_get_color_ext_ds") */
+/* *INDENT-OFF* */
+static const struct test_mc_fhl_get_color_ext_ds
+{
+    const char *fname;
+    int expected_group;         /* 0 if no rule matches */
+} test_mc_fhl_get_color_ext_ds[] =
+{
+    { /* 0. */
+        "a.tar", 1
+    },
+    { /* 1. multiple dots: every suffix after a dot is looked up */
+        "a.b.tar.gz", 1
+    },
+    { /* 2. */
+        "a.tar.bz2", 4
+    },
+    { /* 3. case insensitive rule */
+        "A.TAR.GZ", 1
+    },
+    { /* 4. case sensitive rule */
+        "x.c", 2
+    },
+    { /* 5. case sensitive rule doesn't match, the later case insensitive one does */
+        "x.C", 3
+    },
+    { /* 6. extension of the earlier rule wins */
+        "readme.TXT", 3
+    },
+    { /* 7. */
+        "readme.md", 4
+    },
+    { /* 8. */
+        ".gz", 1
+    },
+    { /* 9. */
+        "gz", 0
+    },
+    { /* 10. */
+        "a.gz.", 0
+    },
+    { /* 11. extension should be the whole suffix */
+        "a.xgz", 0
+    },
+    { /* 12. */
+        "a.gzip", 0
+    },
+};
+/* *INDENT-ON* */
+
+/* @Test(dataSource = "test_mc_fhl_get_color_ext_ds") */
+/* *INDENT-OFF* */
+START_PARAMETRIZED_TEST (test_mc_fhl_get_color_ext, test_mc_fhl_get_color_ext_ds)
+/* *INDENT-ON* */
+{
+    /* given */
+    file_entry_t fe;
+    int actual_color;
+
+    memset (&fe, 0, sizeof (fe));
+    fe.fname = (char *) data->fname;
+    fe.fnamelen = strlen (data->fname);
+    fe.st.st_mode = S_IFREG | 0644;
+
+    /* when */
+    actual_color = mc_fhl_get_color (fhl, &fe);
+
+    /* then */
+    if (data->expected_group == 0)
+    {
+        mctest_assert_int_eq (actual_color, NORMAL_COLOR);
+    }
+    else
+    {
+        mctest_assert_int_eq (actual_color, -data->expected_group);
+    }
+
+    /* color is cached in file entry */
+    mctest_assert_int_eq (mc_fhl_get_color (fhl, &fe), actual_color);
+}
+/* *INDENT-OFF* */
+END_PARAMETRIZED_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    mctest_add_parameterized_test (tc_core, test_mc_fhl_get_color_ext,
+                                   test_mc_fhl_get_color_ext_ds);
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "get_color.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
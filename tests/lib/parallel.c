@@ -0,0 +1,355 @@
+/*
+   lib - tests for running of jobs on the shared worker pool
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/lib"
+
+#include "tests/mctest.h"
+
+#include "lib/parallel.c"
+
+#define TEST_ITEMS 1000
+#define TEST_JOBS 64
+#define TEST_NESTED_JOBS 3
+#define TEST_TIMEOUT_USEC (G_USEC_PER_SEC / 50)
+
+static volatile gint hits[TEST_ITEMS];
+
+#ifdef MC_PARALLEL_THREADS
+/* jobs wait for the gate to be opened by the test */
+static GMutex gate_lock;
+static GCond gate_cond;
+static gboolean gate_open = FALSE;
+
+static volatile gint started = 0;
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+items_job (mc_parallel_t * run, guint job, gpointer user_data)
+{
+    guint jobs = *(const guint *) user_data;
+    gsize i, end;
+
+    (void) run;
+
+    i = mc_parallel_job_start (TEST_ITEMS, jobs, job);
+    end = mc_parallel_job_start (TEST_ITEMS, jobs, job + 1);
+
+    for (; i < end; i++)
+        g_atomic_int_inc (&hits[i]);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef MC_PARALLEL_THREADS
+static void
+gate_job (mc_parallel_t * run, guint job, gpointer user_data)
+{
+    (void) run;
+    (void) job;
+    (void) user_data;
+
+    g_atomic_int_inc (&started);
+
+    g_mutex_lock (&gate_lock);
+    while (!gate_open)
+        g_cond_wait (&gate_cond, &gate_lock);
+    g_mutex_unlock (&gate_lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+open_gate (void)
+{
+    g_mutex_lock (&gate_lock);
+    gate_open = TRUE;
+    g_cond_broadcast (&gate_cond);
+    g_mutex_unlock (&gate_lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+wait_started (gint count)
+{
+    int i;
+
+    for (i = 0; i < 5000 && g_atomic_int_get (&started) < count; i++)
+        g_usleep (1000);
+
+    ck_assert_int_eq (g_atomic_int_get (&started), count);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+typedef struct
+{
+    GThread *outer;
+    GThread *inner[TEST_NESTED_JOBS];
+    guint inner_done;
+} nested_t;
+
+static void
+nested_inner_job (mc_parallel_t * run, guint job, gpointer user_data)
+{
+    nested_t *n = (nested_t *) user_data;
+
+    (void) run;
+
+    n->inner[job] = g_thread_self ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+nested_outer_job (mc_parallel_t * run, guint job, gpointer user_data)
+{
+    nested_t *n = (nested_t *) user_data;
+    mc_parallel_t *inner;
+
+    (void) run;
+    (void) job;
+
+    n->outer = g_thread_self ();
+
+    inner = mc_parallel_run (TEST_NESTED_JOBS, nested_inner_job, n);
+    /* no wait: jobs are run synchronously in the worker */
+    n->inner_done = mc_parallel_get_done (inner);
+    mc_parallel_free (inner);
+}
+#endif /* MC_PARALLEL_THREADS */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    /* use the pool even on uniprocessor */
+    workers = 4;
+
+#ifdef MC_PARALLEL_THREADS
+    started = 0;
+    gate_open = FALSE;
+#endif
+    memset ((void *) hits, 0, sizeof (hits));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+#ifdef MC_PARALLEL_THREADS
+    open_gate ();
+#endif
+    mc_parallel_deinit ();
+    workers = 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_mc_parallel_count_jobs)
+/* *INDENT-ON* */
+{
+    /* given */
+    guint jobs, job;
+    gsize prev_end = 0;
+
+    /* when */
+    jobs = mc_parallel_count_jobs (TEST_ITEMS, 10);
+
+    /* then: not more than 4 jobs per worker */
+    mctest_assert_int_eq (jobs, 16);
+    mctest_assert_int_eq (mc_parallel_count_jobs (TEST_ITEMS, 500), 2);
+    mctest_assert_int_eq (mc_parallel_count_jobs (5, MC_PARALLEL_MIN_CHUNK), 1);
+    mctest_assert_int_eq (mc_parallel_count_jobs (0, MC_PARALLEL_MIN_CHUNK), 1);
+
+    /* parts of items follow each other without gaps */
+    for (job = 0; job < jobs; job++)
+    {
+        mctest_assert_int_eq (mc_parallel_job_start (TEST_ITEMS, jobs, job), prev_end);
+        prev_end = mc_parallel_job_start (TEST_ITEMS, jobs, job + 1);
+    }
+    mctest_assert_int_eq (prev_end, TEST_ITEMS);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_mc_parallel_run)
+/* *INDENT-ON* */
+{
+    /* given */
+    mc_parallel_t *run;
+    guint jobs;
+    int i;
+
+    jobs = mc_parallel_count_jobs (TEST_ITEMS, 10);
+
+    /* when */
+    run = mc_parallel_run (jobs, items_job, &jobs);
+
+    /* then: every item is processed exactly once */
+    mctest_assert_true (mc_parallel_wait (run, -1));
+    mctest_assert_int_eq (mc_parallel_get_done (run), jobs);
+    mctest_assert_false (mc_parallel_is_cancelled (run));
+    mc_parallel_free (run);
+
+    for (i = 0; i < TEST_ITEMS; i++)
+        ck_assert_msg (hits[i] == 1, "item %d is processed %d times", i, hits[i]);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef MC_PARALLEL_THREADS
+/* *INDENT-OFF* */
+START_TEST (test_mc_parallel_cancel)
+/* *INDENT-ON* */
+{
+    /* given */
+    mc_parallel_t *run;
+
+    run = mc_parallel_run (TEST_JOBS, gate_job, NULL);
+    /* every thread of the pool waits in a job */
+    wait_started (MC_PARALLEL_MIN_THREADS);
+
+    /* when */
+    mc_parallel_cancel (run);
+    open_gate ();
+
+    /* then: jobs which are not started yet are skipped, but counted as done */
+    mctest_assert_true (mc_parallel_wait (run, -1));
+    mctest_assert_true (mc_parallel_is_cancelled (run));
+    mctest_assert_int_eq (mc_parallel_get_done (run), TEST_JOBS);
+    mctest_assert_int_eq (g_atomic_int_get (&started), MC_PARALLEL_MIN_THREADS);
+    mc_parallel_free (run);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_mc_parallel_wait_timeout)
+/* *INDENT-ON* */
+{
+    /* given */
+    mc_parallel_t *run;
+    gint64 start;
+
+    run = mc_parallel_run (2, gate_job, NULL);
+    wait_started (2);
+
+    /* when */
+    start = g_get_monotonic_time ();
+
+    /* then: timeout expires while jobs are blocked */
+    mctest_assert_false (mc_parallel_wait (run, TEST_TIMEOUT_USEC));
+    ck_assert_int_ge (g_get_monotonic_time () - start, TEST_TIMEOUT_USEC);
+    mctest_assert_int_eq (mc_parallel_get_done (run), 0);
+
+    /* when */
+    open_gate ();
+
+    /* then */
+    mctest_assert_true (mc_parallel_wait (run, -1));
+    mctest_assert_int_eq (mc_parallel_get_done (run), 2);
+    mc_parallel_free (run);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_mc_parallel_run_in_worker)
+/* *INDENT-ON* */
+{
+    /* given */
+    nested_t n;
+    mc_parallel_t *run;
+    int i;
+
+    memset (&n, 0, sizeof (n));
+
+    /* when */
+    run = mc_parallel_start (nested_outer_job, &n);
+    mctest_assert_true (mc_parallel_wait (run, -1));
+    mc_parallel_free (run);
+
+    /* then: the outer job runs in the pool, the nested ones in the same worker */
+    mctest_assert_ptr_ne (n.outer, g_thread_self ());
+    mctest_assert_int_eq (n.inner_done, TEST_NESTED_JOBS);
+    for (i = 0; i < TEST_NESTED_JOBS; i++)
+        mctest_assert_ptr_eq (n.inner[i], n.outer);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+#endif /* MC_PARALLEL_THREADS */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    tcase_add_test (tc_core, test_mc_parallel_count_jobs);
+    tcase_add_test (tc_core, test_mc_parallel_run);
+#ifdef MC_PARALLEL_THREADS
+    tcase_add_test (tc_core, test_mc_parallel_cancel);
+    tcase_add_test (tc_core, test_mc_parallel_wait_timeout);
+    tcase_add_test (tc_core, test_mc_parallel_run_in_worker);
+#endif
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "parallel.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,327 @@
+/*
+   libmc - benchmark of search engine
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Not a test: it is not run by "make check". Run it with "make bench-search".
+ *
+ * Usage: bench_search [size_in_MiB...]
+ *
+ * Every size is searched with all search types, case sensitive and insensitive,
+ * in one and in all charsets, by every way the data is given to the engine:
+ *   buffer - data in memory, line by line like find does;
+ *   block  - data by contiguous blocks like editor and viewer do;
+ *   char   - data char by char through callback like viewer in nroff mode does.
+ *
+ * Results are printed as tab separated values, one line per run.
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib/global.h"
+#include "lib/strutil.h"
+#include "lib/search.h"
+#ifdef HAVE_CHARSET
+#include "lib/charsets.h"
+#endif
+
+/*** file scope macro definitions ****************************************************************/
+
+/* size of block given to search engine in the "block" mode */
+#define BENCH_BLOCK_SIZE (64 * 1024)
+
+/* distance between needles in corpus */
+#define BENCH_NEEDLE_STEP 4096
+
+/*** file scope type declarations ****************************************************************/
+
+typedef enum
+{
+    BENCH_MODE_BUFFER,
+    BENCH_MODE_BLOCK,
+    BENCH_MODE_CHAR
+} bench_mode_t;
+
+typedef struct
+{
+    mc_search_type_t type;
+    const char *name;
+    const char *pattern;
+} bench_type_t;
+
+typedef struct
+{
+    const char *data;
+    gsize len;
+} bench_corpus_t;
+
+/*** file scope variables ************************************************************************/
+
+static const bench_type_t bench_types[] = {
+    {MC_SEARCH_T_NORMAL, "normal", "needle"},
+    {MC_SEARCH_T_REGEX, "regex", "ne+dle[0-9]?"},
+    {MC_SEARCH_T_HEX, "hex", "6E 65 65 64 6C 65"},
+    {MC_SEARCH_T_GLOB, "glob", "ne?dl*"}
+};
+
+static const char *const bench_modes[] = { "buffer", "block", "char" };
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+/* deterministic text of lowercase words with needles of different case in it */
+static char *
+bench_corpus_new (gsize len)
+{
+    static const char *const needles[] = { "needle", "NEEDLE", "Needle" };
+    char *data;
+    gsize pos = 0, next_needle = BENCH_NEEDLE_STEP, line_len = 0;
+    guint32 seed = 12345;
+    guint n = 0;
+
+    data = g_malloc (len + 1);
+
+    while (pos < len)
+    {
+        gsize word_len, i;
+
+        seed = seed * 1103515245 + 12345;
+
+        if (pos >= next_needle && pos + 6 < len)
+        {
+            memcpy (data + pos, needles[n++ % G_N_ELEMENTS (needles)], 6);
+            pos += 6;
+            line_len += 6;
+            next_needle += BENCH_NEEDLE_STEP;
+        }
+        else
+        {
+            word_len = 1 + (seed >> 16) % 10;
+            for (i = 0; i < word_len && pos < len; i++, pos++, line_len++)
+            {
+                seed = seed * 1103515245 + 12345;
+                data[pos] = 'a' + (seed >> 16) % 26;
+            }
+        }
+
+        if (pos < len)
+        {
+            data[pos++] = line_len > 72 ? '\n' : ' ';
+            if (line_len > 72)
+                line_len = 0;
+        }
+    }
+
+    data[len] = '\0';
+    return data;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static mc_search_cbret_t
+bench_block_fn (const void *user_data, gsize offset, const char **block, gsize * block_len)
+{
+    const bench_corpus_t *corpus = (const bench_corpus_t *) user_data;
+
+    if (offset >= corpus->len)
+        return MC_SEARCH_CB_NOTFOUND;
+
+    *block = corpus->data + offset;
+    *block_len = MIN (corpus->len - offset, BENCH_BLOCK_SIZE);
+    return MC_SEARCH_CB_OK;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static mc_search_cbret_t
+bench_char_fn (const void *user_data, gsize char_offset, int *current_char)
+{
+    const bench_corpus_t *corpus = (const bench_corpus_t *) user_data;
+
+    if (char_offset >= corpus->len)
+        return MC_SEARCH_CB_NOTFOUND;
+
+    *current_char = (unsigned char) corpus->data[char_offset];
+    return MC_SEARCH_CB_OK;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @return number of matches */
+static guint64
+bench_run (mc_search_t * search, const bench_corpus_t * corpus, bench_mode_t mode)
+{
+    guint64 matches = 0;
+    gsize pos = 0;
+    const void *user_data;
+
+    if (mode == BENCH_MODE_BUFFER)
+        user_data = corpus->data;
+    else
+        user_data = corpus;
+
+    search->block_fn = mode == BENCH_MODE_BLOCK ? bench_block_fn : NULL;
+    search->search_fn = mode == BENCH_MODE_CHAR ? bench_char_fn : NULL;
+
+    while (pos < corpus->len)
+    {
+        gsize found_len = 0;
+
+        if (mc_search_run (search, user_data, pos, corpus->len - 1, &found_len))
+        {
+            matches++;
+            pos = (gsize) search->normal_offset + MAX (found_len, 1);
+        }
+        else if (search->error != MC_SEARCH_E_NOTFOUND)
+        {
+            fprintf (stderr, "search error: %s\n",
+                     search->error_str != NULL ? search->error_str : "unknown");
+            break;
+        }
+        else if (mode == BENCH_MODE_BUFFER)
+        {
+            /* data in memory is searched line by line: go to the next one */
+            const char *eol;
+
+            eol = memchr (corpus->data + pos, '\n', corpus->len - pos);
+            if (eol == NULL)
+                break;
+            pos = eol - corpus->data + 1;
+        }
+        else
+            break;
+    }
+
+    return matches;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+bench_one (const bench_corpus_t * corpus, const bench_type_t * type, gboolean case_sensitive,
+           gboolean all_charsets, bench_mode_t mode)
+{
+    mc_search_t *search;
+    gint64 start, usec;
+    guint64 matches;
+    double seconds, mib;
+
+    search = mc_search_new (type->pattern, "UTF-8");
+    search->search_type = type->type;
+    search->is_case_sensitive = case_sensitive;
+#ifdef HAVE_CHARSET
+    search->is_all_charsets = all_charsets;
+#else
+    (void) all_charsets;
+#endif
+
+    start = g_get_monotonic_time ();
+    matches = bench_run (search, corpus, mode);
+    usec = g_get_monotonic_time () - start;
+
+    seconds = MAX (usec, 1) / 1000000.0;
+    mib = corpus->len / (1024.0 * 1024.0);
+
+    printf ("%s\t%s\t%s\t%s\t%" G_GSIZE_FORMAT "\t%.6f\t%.2f\t%" G_GUINT64_FORMAT "\t%.0f\n",
+            bench_modes[mode], type->name, case_sensitive ? "case" : "nocase",
+            all_charsets ? "all" : "one", corpus->len, seconds, mib / seconds, matches,
+            matches / seconds);
+    fflush (stdout);
+
+    mc_search_free (search);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (int argc, char **argv)
+{
+    static const char *const default_sizes[] = { "1", "16" };
+    const char *const *sizes = default_sizes;
+    int sizes_num = G_N_ELEMENTS (default_sizes);
+    int i;
+
+    if (argc > 1)
+    {
+        sizes = (const char *const *) argv + 1;
+        sizes_num = argc - 1;
+    }
+
+    str_init_strings ("UTF-8");
+    mc_global.utf8_display = TRUE;
+#ifdef HAVE_CHARSET
+#ifdef BENCH_SHARE_DIR
+    mc_global.share_data_dir = (char *) BENCH_SHARE_DIR;
+    mc_global.sysconfig_dir = (char *) BENCH_SHARE_DIR;
+#endif
+    load_codepages_list ();
+#endif
+
+    printf ("mode\ttype\tcase\tcharsets\tbytes\tseconds\tmib_per_s\tmatches\tmatches_per_s\n");
+
+    for (i = 0; i < sizes_num; i++)
+    {
+        bench_corpus_t corpus;
+        char *data;
+        gsize t;
+        int mode;
+
+        corpus.len = (gsize) g_ascii_strtoull (sizes[i], NULL, 10) * 1024 * 1024;
+        if (corpus.len == 0)
+        {
+            fprintf (stderr, "invalid size: %s\n", sizes[i]);
+            continue;
+        }
+
+        data = bench_corpus_new (corpus.len);
+        corpus.data = data;
+
+        for (mode = BENCH_MODE_BUFFER; mode <= BENCH_MODE_CHAR; mode++)
+            for (t = 0; t < G_N_ELEMENTS (bench_types); t++)
+            {
+                bench_one (&corpus, &bench_types[t], TRUE, FALSE, (bench_mode_t) mode);
+                bench_one (&corpus, &bench_types[t], FALSE, FALSE, (bench_mode_t) mode);
+#ifdef HAVE_CHARSET
+                bench_one (&corpus, &bench_types[t], TRUE, TRUE, (bench_mode_t) mode);
+                bench_one (&corpus, &bench_types[t], FALSE, TRUE, (bench_mode_t) mode);
+#endif
+            }
+
+        g_free (data);
+    }
+
+#ifdef HAVE_CHARSET
+    free_codepages_list ();
+#endif
+    mc_search_cache_done ();
+    str_uninit_strings ();
+
+    return EXIT_SUCCESS;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,262 @@
+/*
+   lib/search - tests for case mapping and word character tables of charsets
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "lib/search/chartable"
+
+#include "tests/mctest.h"
+
+#include "lib/strutil.h"
+#include "lib/search.h"
+
+#include "internal.h"
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    str_init_strings ("UTF-8");
+    mc_global.utf8_display = TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    mc_search_cache_done ();
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_chartable_change_case_ds") */
+/* *INDENT-OFF* */
+static const struct test_chartable_change_case_ds
+{
+    const char *charset;
+    const char *input;
+    const char *expected_lower;
+    const char *expected_upper;
+} test_chartable_change_case_ds[] =
+{
+    { /* 0. */
+        "CP1251",
+        "\xC0\xE1z\xA8-",
+        "\xE0\xE1z\xB8-",
+        "\xC0\xC1Z\xA8-"
+    },
+    { /* 1. */
+        "KOI8-R",
+        "\xC1\xE2",
+        "\xC1\xC2",
+        "\xE1\xE2"
+    },
+    { /* 2. */
+        /* invalid bytes are kept */
+        "UTF-8",
+        "\xD0\x96x\xFF",
+        "\xD0\xB6x\xFF",
+        "\xD0\x96X\xFF"
+    },
+    { /* 3. */
+        /* character outside of BMP */
+        "utf8",
+        "\xF0\x90\x90\x80",
+        "\xF0\x90\x90\xA8",
+        "\xF0\x90\x90\x80"
+    },
+};
+/* *INDENT-ON* */
+
+/* @Test(dataSource = "test_chartable_change_case_ds") */
+/* *INDENT-OFF* */
+START_PARAMETRIZED_TEST (test_chartable_change_case, test_chartable_change_case_ds)
+/* *INDENT-ON* */
+{
+    /* given */
+    GString *lower, *upper;
+
+    /* when */
+    lower = mc_search__tolower_case_str (data->charset, data->input, strlen (data->input));
+    upper = mc_search__toupper_case_str (data->charset, data->input, strlen (data->input));
+
+    /* then */
+    mctest_assert_str_eq (lower->str, data->expected_lower);
+    mctest_assert_str_eq (upper->str, data->expected_upper);
+
+    g_string_free (lower, TRUE);
+    g_string_free (upper, TRUE);
+}
+/* *INDENT-OFF* */
+END_PARAMETRIZED_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_chartable_flags)
+/* *INDENT-ON* */
+{
+    /* given */
+    const mc_search_chartable_t *cp1251, *utf8;
+    GString *word;
+
+    /* when */
+    cp1251 = mc_search__chartable_get ("cp1251");
+    utf8 = mc_search__chartable_get ("UTF-8");
+    word = mc_search__chartable_word_class (cp1251);
+
+    /* then */
+    mctest_assert_not_null (cp1251);
+    mctest_assert_not_null (utf8);
+    mctest_assert_true ((cp1251 == mc_search__chartable_get ("CP1251")));
+    mctest_assert_null (mc_search__chartable_get ("NO-SUCH-CHARSET"));
+
+    mctest_assert_int_eq (mc_search__chartable_flags (cp1251, 0xC0),
+                          MC_SEARCH_CHAR_WORD | MC_SEARCH_CHAR_ALPHA);
+    mctest_assert_int_eq (mc_search__chartable_flags (cp1251, '5'), MC_SEARCH_CHAR_WORD);
+    mctest_assert_int_eq (mc_search__chartable_flags (cp1251, '_'), MC_SEARCH_CHAR_WORD);
+    mctest_assert_int_eq (mc_search__chartable_flags (cp1251, 0xAB), 0);
+    mctest_assert_true (g_str_has_prefix (word->str, "[\\x30-\\x39\\x41-\\x5A\\x5F\\x61-\\x7A"));
+
+    mctest_assert_int_eq (mc_search__chartable_flags (utf8, 0x4E00),
+                          MC_SEARCH_CHAR_WORD | MC_SEARCH_CHAR_ALPHA);
+    mctest_assert_int_eq (mc_search__chartable_flags (utf8, 0x2603), 0);
+    mctest_assert_int_eq (mc_search__chartable_flags (NULL, 0xB8), 0);
+    /* pages of the same content are shared */
+    mctest_assert_true ((utf8->pages[0x4E] == utf8->pages[0x4F]));
+
+    g_string_free (word, TRUE);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef HAVE_CHARSET
+/* @DataSource("test_chartable_search_ds") */
+/* *INDENT-OFF* */
+static const struct test_chartable_search_ds
+{
+    const char *charset;
+    mc_search_type_t type;
+    gboolean whole_words;
+    const char *pattern;
+    const char *text;
+    off_t expected_offset;
+    gsize expected_len;
+} test_chartable_search_ds[] =
+{
+    { /* 0. */
+        "CP1251", MC_SEARCH_T_NORMAL, FALSE,
+        "\xCF\xF0\xE8",
+        "- \xEF\xD0\xC8",
+        2, 3
+    },
+    { /* 1. */
+        "KOI8-R", MC_SEARCH_T_REGEX, FALSE,
+        "\xE1\xE2+",
+        "x\xC1\xC2\xE2",
+        1, 3
+    },
+    { /* 2. */
+        /* 0xB8 is a letter in CP1251 but is a cedilla in Latin-1 */
+        "CP1251", MC_SEARCH_T_NORMAL, TRUE,
+        "\xE0\xE1",
+        "\xB8\xE0\xE1 \xC0\xC1",
+        4, 2
+    },
+    { /* 3. */
+        "CP1251", MC_SEARCH_T_REGEX, TRUE,
+        "\xE0\xE1",
+        "\xB8\xE0\xE1 \xC0\xC1",
+        4, 2
+    },
+};
+/* *INDENT-ON* */
+
+/* @Test(dataSource = "test_chartable_search_ds") */
+/* *INDENT-OFF* */
+START_PARAMETRIZED_TEST (test_chartable_search, test_chartable_search_ds)
+/* *INDENT-ON* */
+{
+    /* given */
+    mc_search_t *search;
+    gsize found_len = 0;
+    gboolean found;
+
+    search = mc_search_new (data->pattern, data->charset);
+    search->search_type = data->type;
+    search->is_case_sensitive = FALSE;
+    search->whole_words = data->whole_words;
+
+    /* when */
+    found = mc_search_run (search, data->text, 0, strlen (data->text), &found_len);
+
+    /* then */
+    mctest_assert_true (found);
+    mctest_assert_int_eq (search->normal_offset, data->expected_offset);
+    mctest_assert_int_eq (found_len, data->expected_len);
+
+    mc_search_free (search);
+}
+/* *INDENT-OFF* */
+END_PARAMETRIZED_TEST
+/* *INDENT-ON* */
+#endif /* HAVE_CHARSET */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    mctest_add_parameterized_test (tc_core, test_chartable_change_case,
+                                   test_chartable_change_case_ds);
+    tcase_add_test (tc_core, test_chartable_flags);
+#ifdef HAVE_CHARSET
+    mctest_add_parameterized_test (tc_core, test_chartable_search, test_chartable_search_ds);
+#endif
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "chartable.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,356 @@
+/*
+   libmc - checks for search of fixed strings
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "lib/search/normal"
+
+#include "tests/mctest.h"
+
+#include "lib/strutil.h"
+
+#include "normal.c"             /* for testing static functions */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* give out data by short blocks to check matches which cross block boundaries */
+static mc_search_cbret_t
+test_block_fn (const void *user_data, gsize offset, const char **block, gsize * block_len)
+{
+    const char *text = (const char *) user_data;
+    const gsize len = strlen (text);
+
+    if (offset >= len)
+        return MC_SEARCH_CB_NOTFOUND;
+
+    *block = text + offset;
+    *block_len = MIN (3, len - offset);
+    return MC_SEARCH_CB_OK;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* give out data of GString by large blocks */
+static mc_search_cbret_t
+test_string_block_fn (const void *user_data, gsize offset, const char **block, gsize * block_len)
+{
+    const GString *text = (const GString *) user_data;
+
+    if (offset >= text->len)
+        return MC_SEARCH_CB_NOTFOUND;
+
+    *block = text->str + offset;
+    *block_len = MIN (64 * 1024, text->len - offset);
+    return MC_SEARCH_CB_OK;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    str_init_strings ("UTF-8");
+    mc_global.utf8_display = TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_normal_run_literal_ds") */
+/* *INDENT-OFF* */
+static const struct test_normal_run_literal_ds
+{
+    const char *pattern;
+    gboolean case_sensitive;
+    gboolean whole_words;
+    const char *text;
+    gboolean expected_found;
+    off_t expected_offset;
+    gsize expected_len;
+} test_normal_run_literal_ds[] =
+{
+    { /* 0. */
+        "needle", TRUE, FALSE,
+        "haystack with needle and needle",
+        TRUE, 14, 6
+    },
+    { /* 1. */
+        "Needle", TRUE, FALSE,
+        "haystack with needle",
+        FALSE, 0, 0
+    },
+    { /* 2. */
+        "NeEdLe", FALSE, FALSE,
+        "haystack with nEEDLE",
+        TRUE, 14, 6
+    },
+    { /* 3. */
+        "needle", TRUE, TRUE,
+        "needles, _needle, needle",
+        TRUE, 18, 6
+    },
+    { /* 4. */
+        "needle", FALSE, TRUE,
+        "\xd0\xb6needle NEEDLE\xd0\xb6 (Needle)",
+        TRUE, 19, 6
+    },
+    { /* 5. */
+        /* search is done in the first line only like regex search of buffer does */
+        "needle", TRUE, FALSE,
+        "first line\nneedle",
+        FALSE, 0, 0
+    },
+    { /* 6. */
+        "a.b*", TRUE, FALSE,
+        "regex chars: a.b*",
+        TRUE, 13, 4
+    },
+    { /* 7. */
+        "\xd0\xb6\xd0\xb8\xd0\xbb", TRUE, TRUE,
+        "\xd0\xb6\xd0\xb8\xd0\xbb\xd0\xb0 \xd0\xb6\xd0\xb8\xd0\xbb",
+        TRUE, 9, 6
+    },
+};
+/* *INDENT-ON* */
+
+/* @Test(dataSource = "test_normal_run_literal_ds") */
+/* *INDENT-OFF* */
+START_PARAMETRIZED_TEST (test_normal_run_literal, test_normal_run_literal_ds)
+/* *INDENT-ON* */
+{
+    /* given */
+    mc_search_t *search;
+    gsize found_len = 0;
+    gboolean found;
+
+    search = mc_search_new (data->pattern, "UTF-8");
+    search->search_type = MC_SEARCH_T_NORMAL;
+    search->is_case_sensitive = data->case_sensitive;
+    search->whole_words = data->whole_words;
+
+    /* when */
+    found = mc_search_run (search, data->text, 0, strlen (data->text), &found_len);
+
+    /* then */
+    mctest_assert_true (mc_search__normal_all_literal (search));
+    mctest_assert_int_eq (found, data->expected_found);
+    if (data->expected_found)
+    {
+        mctest_assert_int_eq (search->normal_offset, data->expected_offset);
+        mctest_assert_int_eq (found_len, data->expected_len);
+    }
+
+    mc_search_free (search);
+}
+/* *INDENT-OFF* */
+END_PARAMETRIZED_TEST
+/* *INDENT-ON* */
+
+/* @DataSource("test_normal_run_literal_blocks_ds") */
+/* *INDENT-OFF* */
+static const struct test_normal_run_literal_blocks_ds
+{
+    const char *pattern;
+    gboolean whole_words;
+    const char *text;
+    gsize start_search;
+    gboolean expected_found;
+    off_t expected_offset;
+} test_normal_run_literal_blocks_ds[] =
+{
+    { /* 0. */
+        "needle", FALSE,
+        "hay\nhaystack needle",
+        0,
+        TRUE, 13
+    },
+    { /* 1. */
+        "needle", TRUE,
+        "needles\nneedle_\nx needle",
+        0,
+        TRUE, 18
+    },
+    { /* 2. */
+        "needle", FALSE,
+        "needle needle",
+        1,
+        TRUE, 7
+    },
+    { /* 3. */
+        "needle", FALSE,
+        "need\nle",
+        0,
+        FALSE, 0
+    },
+};
+/* *INDENT-ON* */
+
+/* @Test(dataSource = "test_normal_run_literal_blocks_ds") */
+/* *INDENT-OFF* */
+START_PARAMETRIZED_TEST (test_normal_run_literal_blocks, test_normal_run_literal_blocks_ds)
+/* *INDENT-ON* */
+{
+    /* given */
+    mc_search_t *search;
+    gsize found_len = 0;
+    gboolean found;
+
+    search = mc_search_new (data->pattern, "UTF-8");
+    search->search_type = MC_SEARCH_T_NORMAL;
+    search->is_case_sensitive = TRUE;
+    search->whole_words = data->whole_words;
+    search->block_fn = test_block_fn;
+
+    /* when */
+    found = mc_search_run (search, data->text, data->start_search, strlen (data->text),
+                           &found_len);
+
+    /* then */
+    mctest_assert_int_eq (found, data->expected_found);
+    if (data->expected_found)
+    {
+        mctest_assert_int_eq (search->normal_offset, data->expected_offset);
+        mctest_assert_int_eq (found_len, strlen (data->pattern));
+    }
+
+    mc_search_free (search);
+}
+/* *INDENT-OFF* */
+END_PARAMETRIZED_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_normal_run_literal_blocks_long_line)
+/* *INDENT-ON* */
+{
+    /* given */
+    const gsize needle_offset = 2 * MC_SEARCH_LINE_MAX + 10;
+    mc_search_t *search;
+    GString *text;
+    gsize found_len = 0;
+    gboolean found;
+
+    /* binary data without line breaks is searched by parts */
+    text = g_string_sized_new (3 * MC_SEARCH_LINE_MAX);
+    while (text->len < 3 * MC_SEARCH_LINE_MAX)
+        g_string_append_c (text, 'x');
+    memcpy (text->str + needle_offset, "needle", 6);
+
+    search = mc_search_new ("needle", "UTF-8");
+    search->search_type = MC_SEARCH_T_NORMAL;
+    search->is_case_sensitive = TRUE;
+    search->block_fn = test_string_block_fn;
+
+    /* when */
+    found = mc_search_run (search, text, 0, text->len - 1, &found_len);
+
+    /* then */
+    mctest_assert_true (found);
+    mctest_assert_int_eq (search->normal_offset, needle_offset);
+    mctest_assert_int_eq (found_len, 6);
+
+    mc_search_free (search);
+    g_string_free (text, TRUE);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_normal_run_literal_blocks_long_line_cut)
+/* *INDENT-ON* */
+{
+    /* given */
+    const gsize needle_offset = MC_SEARCH_LINE_MAX - 3;
+    mc_search_t *search;
+    GString *text;
+    gsize found_len = 0;
+    gboolean found;
+
+    /* the match crosses the end of the first part of line */
+    text = g_string_sized_new (2 * MC_SEARCH_LINE_MAX);
+    while (text->len < 2 * MC_SEARCH_LINE_MAX)
+        g_string_append_c (text, 'x');
+    memcpy (text->str + needle_offset, "needle", 6);
+
+    search = mc_search_new ("NEEDLE", "UTF-8");
+    search->search_type = MC_SEARCH_T_NORMAL;
+    search->is_case_sensitive = FALSE;
+    search->block_fn = test_string_block_fn;
+
+    /* when */
+    found = mc_search_run (search, text, 0, text->len - 1, &found_len);
+
+    /* then */
+    mctest_assert_true (found);
+    mctest_assert_int_eq (search->normal_offset, needle_offset);
+    mctest_assert_int_eq (found_len, 6);
+
+    mc_search_free (search);
+    g_string_free (text, TRUE);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    mctest_add_parameterized_test (tc_core, test_normal_run_literal, test_normal_run_literal_ds);
+    mctest_add_parameterized_test (tc_core, test_normal_run_literal_blocks,
+                                   test_normal_run_literal_blocks_ds);
+    tcase_add_test (tc_core, test_normal_run_literal_blocks_long_line);
+    tcase_add_test (tc_core, test_normal_run_literal_blocks_long_line_cut);
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "normal_run_literal.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,199 @@
+/*
+   libmc - checks for reuse of prepared search conditions
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "lib/search"
+
+#include "tests/mctest.h"
+
+#include "lib/strutil.h"
+#include "lib/search.h"
+
+#include "internal.h"           /* MC_SEARCH_CACHE */
+
+/* more than size of cache */
+#define TEST_PATTERNS_COUNT 200
+
+/* --------------------------------------------------------------------------------------------- */
+
+static mc_search_t *
+make_search (const char *pattern, mc_search_type_t type, gboolean case_sensitive)
+{
+    mc_search_t *search;
+
+    search = mc_search_new (pattern, "UTF-8");
+    search->search_type = type;
+    search->is_case_sensitive = case_sensitive;
+    mc_search_prepare (search);
+
+    return search;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    str_init_strings ("UTF-8");
+    mc_global.utf8_display = TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    mc_search_cache_done ();
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef MC_SEARCH_CACHE
+/* *INDENT-OFF* */
+START_TEST (test_search_prepare_cache_reuse)
+/* *INDENT-ON* */
+{
+    /* given */
+    mc_search_t *first, *same, *other_case, *other_type;
+    gsize found_len = 0;
+
+    first = make_search ("ne+dle", MC_SEARCH_T_REGEX, TRUE);
+
+    /* when */
+    same = make_search ("ne+dle", MC_SEARCH_T_REGEX, TRUE);
+    other_case = make_search ("ne+dle", MC_SEARCH_T_REGEX, FALSE);
+    other_type = make_search ("ne+dle", MC_SEARCH_T_NORMAL, TRUE);
+
+    /* then */
+    mctest_assert_ptr_eq (same->conditions, first->conditions);
+    mctest_assert_ptr_ne (other_case->conditions, first->conditions);
+    mctest_assert_ptr_ne (other_type->conditions, first->conditions);
+
+    mctest_assert_true (mc_search_run (same, "haystack neeedle", 0, 16, &found_len));
+    mctest_assert_int_eq (mc_search_getstart_result_by_num (same, 0), 9);
+    mctest_assert_int_eq (found_len, 7);
+
+    mc_search_free (first);
+    mc_search_free (same);
+    mc_search_free (other_case);
+    mc_search_free (other_type);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_search_prepare_cache_evict)
+/* *INDENT-ON* */
+{
+    /* given */
+    mc_search_t *first, *again;
+    int i;
+
+    first = make_search ("needle", MC_SEARCH_T_GLOB, TRUE);
+
+    /* when */
+    for (i = 0; i < TEST_PATTERNS_COUNT; i++)
+    {
+        char *pattern;
+
+        pattern = g_strdup_printf ("pattern%d*", i);
+        mc_search_free (make_search (pattern, MC_SEARCH_T_GLOB, TRUE));
+        g_free (pattern);
+    }
+
+    again = make_search ("needle", MC_SEARCH_T_GLOB, TRUE);
+
+    /* then */
+    mctest_assert_ptr_ne (again->conditions, first->conditions);
+
+    mc_search_free (first);
+    mc_search_free (again);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+#endif /* MC_SEARCH_CACHE */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_search_prepare_cache_error)
+/* *INDENT-ON* */
+{
+    /* given */
+    mc_search_t *search;
+    gboolean ok;
+
+    mc_search_free (make_search ("(unclosed", MC_SEARCH_T_REGEX, TRUE));
+
+    /* when */
+    search = mc_search_new ("(unclosed", "UTF-8");
+    search->search_type = MC_SEARCH_T_REGEX;
+    search->is_case_sensitive = TRUE;
+    ok = mc_search_prepare (search);
+
+    /* then */
+    mctest_assert_false (ok);
+    mctest_assert_int_eq (search->error, MC_SEARCH_E_REGEX_COMPILE);
+
+    mc_search_free (search);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+#ifdef MC_SEARCH_CACHE
+    tcase_add_test (tc_core, test_search_prepare_cache_reuse);
+    tcase_add_test (tc_core, test_search_prepare_cache_evict);
+#endif
+    tcase_add_test (tc_core, test_search_prepare_cache_error);
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "search_prepare_cache.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
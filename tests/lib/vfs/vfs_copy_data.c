@@ -0,0 +1,249 @@
+/*
+   lib/vfs - tests for vfs_copy_data() function
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/lib/vfs"
+
+#include "tests/mctest.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "lib/strutil.h"
+#include "lib/vfs/xdirentry.h"
+#include "lib/vfs/path.h"
+
+#include "src/vfs/local/local.c"
+
+#define TEST_HOLE_SIZE (4 * 1024 * 1024)
+
+static char *src_path = NULL;
+static char *dst_path = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    mc_global.timer = mc_timer_new ();
+    str_init_strings (NULL);
+
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+
+    src_path = g_build_filename (g_get_tmp_dir (), "mc-copy-data-src-XXXXXX", (char *) NULL);
+    close (g_mkstemp (src_path));
+    dst_path = g_build_filename (g_get_tmp_dir (), "mc-copy-data-dst-XXXXXX", (char *) NULL);
+    close (g_mkstemp (dst_path));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    unlink (src_path);
+    unlink (dst_path);
+    g_free (src_path);
+    g_free (dst_path);
+
+    vfs_shut ();
+    str_uninit_strings ();
+    mc_timer_destroy (mc_global.timer);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* write "data" + hole + "more data" + hole (if trailing_hole) to the source file */
+static off_t
+make_source (gboolean trailing_hole)
+{
+    off_t size;
+    int fd;
+
+    fd = open (src_path, O_WRONLY | O_TRUNC);
+    ck_assert_int_ne (fd, -1);
+    ck_assert_int_eq (write (fd, "data", 4), 4);
+    ck_assert_int_eq (pwrite (fd, "more data", 9, TEST_HOLE_SIZE), 9);
+    size = TEST_HOLE_SIZE + 9;
+    if (trailing_hole)
+    {
+        size += TEST_HOLE_SIZE;
+        ck_assert_int_eq (ftruncate (fd, size), 0);
+    }
+    close (fd);
+
+    return size;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* copy the whole file like copy_file_file() does */
+static off_t
+copy_file (gboolean sparse, size_t chunk)
+{
+    vfs_path_t *src_vpath, *dst_vpath;
+    vfs_copy_method_t method = VFS_COPY_RANGE;
+    int src_fd, dst_fd;
+    off_t total = 0;
+
+    src_vpath = vfs_path_from_str (src_path);
+    dst_vpath = vfs_path_from_str (dst_path);
+    src_fd = mc_open (src_vpath, O_RDONLY);
+    dst_fd = mc_open (dst_vpath, O_WRONLY | O_TRUNC);
+    ck_assert_int_ne (src_fd, -1);
+    ck_assert_int_ne (dst_fd, -1);
+
+    while (TRUE)
+    {
+        char buf[1024];
+        ssize_t n;
+
+        n = vfs_copy_data (dst_fd, src_fd, chunk, sparse, &method);
+        if (n < 0)
+        {
+            /* no kernel copy here: the rest is copied with a buffer */
+            ck_assert_int_eq (method, VFS_COPY_NONE);
+            n = mc_read (src_fd, buf, sizeof (buf));
+            ck_assert_int_ne (n, -1);
+            if (n > 0)
+                ck_assert_int_eq (mc_write (dst_fd, buf, (size_t) n), n);
+        }
+        if (n == 0)
+            break;
+        total += n;
+    }
+
+    mc_close (src_fd);
+    mc_close (dst_fd);
+    vfs_path_free (src_vpath);
+    vfs_path_free (dst_vpath);
+
+    return total;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+assert_same_content (void)
+{
+    char *src_data, *dst_data;
+    gsize src_len, dst_len;
+
+    ck_assert (g_file_get_contents (src_path, &src_data, &src_len, NULL));
+    ck_assert (g_file_get_contents (dst_path, &dst_data, &dst_len, NULL));
+    mctest_assert_int_eq (dst_len, src_len);
+    ck_assert (memcmp (src_data, dst_data, src_len) == 0);
+    g_free (src_data);
+    g_free (dst_data);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_vfs_copy_data_ds") */
+/* *INDENT-OFF* */
+static const struct test_vfs_copy_data_ds
+{
+    gboolean trailing_hole;
+    gboolean sparse;
+    size_t chunk;
+} test_vfs_copy_data_ds[] =
+{
+    { /* 0 */
+        FALSE,
+        FALSE,
+        8 * 1024 * 1024
+    },
+    { /* 1 */
+        FALSE,
+        TRUE,
+        8 * 1024 * 1024
+    },
+    { /* 2 */
+        TRUE,
+        TRUE,
+        8 * 1024 * 1024
+    },
+    { /* 3 */
+        TRUE,
+        TRUE,
+        1000
+    },
+    { /* 4 */
+        TRUE,
+        FALSE,
+        1000
+    },
+};
+/* *INDENT-ON* */
+
+/* @Test(dataSource = "test_vfs_copy_data_ds") */
+/* *INDENT-OFF* */
+START_PARAMETRIZED_TEST (test_vfs_copy_data, test_vfs_copy_data_ds)
+/* *INDENT-ON* */
+{
+    /* given */
+    off_t size;
+    off_t copied;
+
+    size = make_source (data->trailing_hole);
+
+    /* when */
+    copied = copy_file (data->sparse, data->chunk);
+
+    /* then */
+    mctest_assert_int_eq (copied, size);
+    assert_same_content ();
+}
+/* *INDENT-OFF* */
+END_PARAMETRIZED_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    mctest_add_parameterized_test (tc_core, test_vfs_copy_data, test_vfs_copy_data_ds);
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "vfs_copy_data.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
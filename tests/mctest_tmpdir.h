@@ -0,0 +1,110 @@
+#ifndef MC__TEST_TMPDIR
+#define MC__TEST_TMPDIR
+
+/*
+   Temporary directory for tests which work with real files.
+
+   Include it after tests/mctest.h. Call mctest_tmpdir_create() from @Before
+   and mctest_tmpdir_remove() from @After.
+ */
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* path of temporary directory, valid between mctest_tmpdir_create() and mctest_tmpdir_remove() */
+static char *mctest_tmpdir = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Build path of file in temporary directory.
+ *
+ * @param name file name relative to temporary directory, "" for directory itself
+ *
+ * @return newly allocated path
+ */
+
+static char *
+mctest_tmpdir_path (const char *name)
+{
+    return g_build_filename (mctest_tmpdir, name, (char *) NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+mctest_tmpdir_make_file (const char *name, const char *content)
+{
+    char *path;
+
+    path = mctest_tmpdir_path (name);
+    ck_assert_msg (g_file_set_contents (path, content, -1, NULL), "cannot create %s", path);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+mctest_tmpdir_remove_tree (const char *path)
+{
+    struct stat st;
+
+    if (lstat (path, &st) == 0 && S_ISDIR (st.st_mode))
+    {
+        GDir *dir;
+
+        dir = g_dir_open (path, 0, NULL);
+        if (dir != NULL)
+        {
+            const char *name;
+
+            while ((name = g_dir_read_name (dir)) != NULL)
+            {
+                char *sub_path;
+
+                sub_path = g_build_filename (path, name, (char *) NULL);
+                mctest_tmpdir_remove_tree (sub_path);
+                g_free (sub_path);
+            }
+            g_dir_close (dir);
+        }
+        rmdir (path);
+    }
+    else
+        unlink (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Create empty temporary directory.
+ *
+ * @param prefix beginning of directory name, unique suffix is appended to it
+ */
+
+static void
+mctest_tmpdir_create (const char *prefix)
+{
+    char *template;
+
+    template = g_strconcat (prefix, "-XXXXXX", (char *) NULL);
+    mctest_tmpdir = g_build_filename (g_get_tmp_dir (), template, (char *) NULL);
+    g_free (template);
+
+    ck_assert_msg (g_mkdtemp (mctest_tmpdir) != NULL, "cannot create %s", mctest_tmpdir);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Remove temporary directory with everything what tests created in it.
+ */
+
+static void
+mctest_tmpdir_remove (void)
+{
+    mctest_tmpdir_remove_tree (mctest_tmpdir);
+    MC_PTR_FREE (mctest_tmpdir);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#endif /* MC__TEST_TMPDIR */
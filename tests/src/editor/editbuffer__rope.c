@@ -0,0 +1,450 @@
+/*
+   src/editor - tests for the rope of editor buffer
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/editor"
+
+#include "tests/mctest.h"
+
+#include <unistd.h>
+
+#include "src/editor/edit-impl.h"
+#include "src/editor/editbuffer.h"
+
+/* the same operations are done with gap buffer and rope */
+static edit_buffer_t gap;
+static edit_buffer_t rope;
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+insert_both (int c, gboolean ahead)
+{
+    if (ahead)
+    {
+        edit_buffer_insert_ahead (&gap, c);
+        edit_buffer_insert_ahead (&rope, c);
+    }
+    else
+    {
+        edit_buffer_insert (&gap, c);
+        edit_buffer_insert (&rope, c);
+    }
+
+    if (c == '\n')
+    {
+        gap.lines++;
+        rope.lines++;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+edit_randomly (GRand * rand, int count)
+{
+    static const char chars[] = "abc d\n";
+    int n;
+
+    for (n = 0; n < count; n++)
+    {
+        int op;
+
+        op = g_rand_int_range (rand, 0, 100);
+
+        if (op < 2)
+        {
+            /* jump */
+            off_t to;
+
+            to = g_rand_int_range (rand, 0, (gint32) gap.size + 1);
+            edit_buffer_move_cursor (&gap, to - gap.curs1);
+            edit_buffer_move_cursor (&rope, to - rope.curs1);
+        }
+        else if (op < 40)
+            insert_both (chars[g_rand_int_range (rand, 0, sizeof (chars) - 1)], op < 10);
+        else if (op < 70 && gap.curs2 != 0)
+        {
+            const int c = edit_buffer_delete (&gap);
+
+            mctest_assert_int_eq (edit_buffer_delete (&rope), c);
+            if (c == '\n')
+                gap.lines--;
+        }
+        else if (gap.curs1 != 0)
+        {
+            const int c = edit_buffer_backspace (&gap);
+
+            mctest_assert_int_eq (edit_buffer_backspace (&rope), c);
+            if (c == '\n')
+                gap.lines--;
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+compare_buffers (GRand * rand)
+{
+    off_t i;
+    int n;
+
+    mctest_assert_int_eq (rope.size, gap.size);
+    mctest_assert_int_eq (rope.curs1, gap.curs1);
+    mctest_assert_int_eq (rope.curs2, gap.curs2);
+    mctest_assert_int_eq (edit_rope_lines (rope.rope), gap.lines);
+
+    for (i = 0; i < gap.size; i++)
+        if (edit_buffer_get_byte (&rope, i) != edit_buffer_get_byte (&gap, i))
+            ck_abort_msg ("bytes at %jd are different", (intmax_t) i);
+
+    for (n = 0; n < 300; n++)
+    {
+        off_t pos, pos2;
+        long lines;
+
+        pos = g_rand_int_range (rand, 0, (gint32) gap.size + 1);
+        pos2 = g_rand_int_range (rand, 0, (gint32) gap.size + 1);
+        lines = g_rand_int_range (rand, 0, 50);
+
+        mctest_assert_int_eq (edit_buffer_get_bol (&rope, pos), edit_buffer_get_bol (&gap, pos));
+        mctest_assert_int_eq (edit_buffer_get_eol (&rope, pos), edit_buffer_get_eol (&gap, pos));
+        mctest_assert_int_eq (edit_buffer_count_lines (&rope, pos, pos2),
+                              edit_buffer_count_lines (&gap, pos, pos2));
+        mctest_assert_int_eq (edit_buffer_get_forward_offset (&rope, pos, lines, 0),
+                              edit_buffer_get_forward_offset (&gap, pos, lines, 0));
+        mctest_assert_int_eq (edit_buffer_get_backward_offset (&rope, pos, lines),
+                              edit_buffer_get_backward_offset (&gap, pos, lines));
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    edit_buffer_init (&gap, 0);
+    edit_buffer_init_rope (&rope, 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    edit_buffer_clean (&gap);
+    edit_buffer_clean (&rope);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_rope_edit)
+/* *INDENT-ON* */
+{
+    /* given */
+    static const char chars[] = "abc d\n";
+    GRand *rand;
+    int n;
+
+    rand = g_rand_new_with_seed (1);
+
+    /* when */
+    for (n = 0; n < 200000; n++)
+    {
+        const int c = chars[g_rand_int_range (rand, 0, sizeof (chars) - 1)];
+
+        insert_both (c, FALSE);
+    }
+
+    /* then */
+    compare_buffers (rand);
+
+    /* when */
+    edit_randomly (rand, 200000);
+
+    /* then */
+    compare_buffers (rand);
+
+    /* when: delete all */
+    edit_buffer_move_cursor (&gap, -gap.curs1);
+    edit_buffer_move_cursor (&rope, -rope.curs1);
+    while (rope.curs2 != 0)
+        edit_buffer_delete (&rope);
+
+    /* then */
+    mctest_assert_int_eq (rope.size, 0);
+    mctest_assert_int_eq (edit_rope_lines (rope.rope), 0);
+    mctest_assert_int_eq (edit_buffer_get_eol (&rope, 0), 0);
+    mctest_assert_int_eq (edit_buffer_get_byte (&rope, 0), '\n');
+
+    g_rand_free (rand);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_rope_lines)
+/* *INDENT-ON* */
+{
+    /* given */
+    GString *text;
+    size_t len;
+    const char *block;
+    long i;
+
+    text = g_string_new ("");
+    for (i = 0; i < 100000; i++)
+        g_string_append_printf (text, "line %ld\n", i);
+
+    /* when */
+    edit_rope_append (rope.rope, text->str, text->len);
+    rope.curs2 = rope.size = (off_t) text->len;
+
+    /* then */
+    mctest_assert_int_eq (edit_rope_lines (rope.rope), 100000);
+    mctest_assert_int_eq (edit_rope_get_line_offset (rope.rope, 12345),
+                          strstr (text->str, "line 12345\n") - text->str);
+    mctest_assert_int_eq (edit_rope_count_lines (rope.rope, strstr (text->str, "line 99999\n")
+                                                 - text->str), 99999);
+    mctest_assert_int_eq (edit_buffer_get_forward_offset (&rope, 0, 3, 0),
+                          strstr (text->str, "line 3\n") - text->str);
+
+    block = edit_buffer_get_block (&rope, 3, &len);
+    mctest_assert_not_null (block);
+    mctest_assert_int_eq (strncmp (block, text->str + 3, len), 0);
+
+    g_string_free (text, TRUE);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_rope_mapped)
+/* *INDENT-ON* */
+{
+    /* given */
+    GString *text;
+    char *original;
+    GRand *rand;
+    long i;
+
+    text = g_string_new ("");
+    for (i = 0; i < 300000; i++)
+        g_string_append_printf (text, "line %ld\n", i);
+    original = g_strndup (text->str, text->len);
+
+    rand = g_rand_new_with_seed (2);
+
+    /* when */
+    edit_rope_append_mapped (rope.rope, text->str, text->len / 2);
+    edit_rope_append_mapped (rope.rope, text->str + text->len / 2, text->len - text->len / 2);
+    rope.curs2 = rope.size = (off_t) text->len;
+
+    for (i = 0; i < (long) text->len; i++)
+        edit_buffer_insert (&gap, text->str[i]);
+    edit_buffer_move_cursor (&gap, -gap.curs1);
+    gap.lines = 300000;
+
+    edit_randomly (rand, 20000);
+
+    /* then */
+    compare_buffers (rand);
+    /* mapped text is never changed */
+    mctest_assert_int_eq (memcmp (text->str, original, text->len), 0);
+
+    g_rand_free (rand);
+    g_free (original);
+    g_string_free (text, TRUE);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_rope_mapped_rewritten)
+/* *INDENT-ON* */
+{
+    /* given */
+    GString *text;
+    long i;
+
+    text = g_string_new ("");
+    for (i = 0; i < 300000; i++)
+        g_string_append_printf (text, "line %ld\n", i);
+
+    edit_rope_append_mapped (rope.rope, text->str, text->len);
+    rope.curs2 = rope.size = (off_t) text->len;
+
+    /* when: mapped file is rewritten in place by someone else */
+    for (i = (long) text->len / 2; i < (long) text->len; i++)
+        if (text->str[i] == '\n')
+            text->str[i] = ' ';
+
+    /* then: stale line counters don't lead out of text */
+    for (i = 0; i <= 300000; i += 1000)
+    {
+        off_t offset;
+
+        offset = edit_rope_get_line_offset (rope.rope, i);
+        ck_assert_int_ge (offset, 0);
+        ck_assert_int_le (offset, rope.size);
+    }
+
+    g_string_free (text, TRUE);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_rope_unmap)
+/* *INDENT-ON* */
+{
+    /* given */
+    GString *text;
+    char *name = NULL;
+    int fd;
+    off_t i;
+
+    text = g_string_new ("");
+    for (i = 0; i < 300000; i++)
+        g_string_append_printf (text, "line %jd\n", (intmax_t) i);
+
+    fd = g_file_open_tmp ("mc-rope-XXXXXX", &name, NULL);
+    ck_assert_int_ne (fd, -1);
+    ck_assert_int_eq (write (fd, text->str, text->len), (ssize_t) text->len);
+
+    rope.map = vfs_map_local_file (fd, (off_t) text->len);
+    mctest_assert_not_null (rope.map);
+    edit_rope_append_mapped (rope.rope, rope.map->data, rope.map->size);
+    rope.curs2 = rope.size = (off_t) text->len;
+
+    /* when */
+    mctest_assert_true (edit_buffer_unmap (&rope));
+    /* file is rewritten in place after that */
+    ck_assert_int_eq (pwrite (fd, "xxxxxxxxxx", 10, (off_t) text->len / 2), 10);
+
+    /* then: text is kept in own memory of rope */
+    mctest_assert_null (rope.map);
+    mctest_assert_int_eq (edit_rope_lines (rope.rope), 300000);
+    for (i = 0; i < (off_t) text->len; i++)
+        if (edit_buffer_get_byte (&rope, i) != (unsigned char) text->str[i])
+            ck_abort_msg ("bytes at %jd are different", (intmax_t) i);
+
+    close (fd);
+    unlink (name);
+    g_free (name);
+    g_string_free (text, TRUE);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_rope_unmap_truncated)
+/* *INDENT-ON* */
+{
+    /* given */
+    GString *text;
+    char *name = NULL;
+    int fd;
+    off_t i;
+    vfs_file_map_t *map;
+
+    text = g_string_new ("");
+    for (i = 0; i < 300000; i++)
+        g_string_append_printf (text, "line %jd\n", (intmax_t) i);
+
+    fd = g_file_open_tmp ("mc-rope-XXXXXX", &name, NULL);
+    ck_assert_int_ne (fd, -1);
+    ck_assert_int_eq (write (fd, text->str, text->len), (ssize_t) text->len);
+
+    map = rope.map = vfs_map_local_file (fd, (off_t) text->len);
+    mctest_assert_not_null (rope.map);
+    edit_rope_append_mapped (rope.rope, rope.map->data, rope.map->size);
+    rope.curs2 = rope.size = (off_t) text->len;
+
+    /* when: file is truncated by someone else */
+    ck_assert_int_eq (ftruncate (fd, (off_t) text->len / 2), 0);
+
+    /* then: lost pages aren't copied as text, the file is kept mapped */
+    mctest_assert_false (edit_buffer_unmap (&rope));
+    mctest_assert_ptr_eq (rope.map, map);
+    mctest_assert_true (rope.map->truncated);
+    mctest_assert_int_eq (edit_buffer_get_byte (&rope, 0), 'l');
+
+    close (fd);
+    unlink (name);
+    g_free (name);
+    g_string_free (text, TRUE);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    tcase_add_test (tc_core, test_rope_edit);
+    tcase_add_test (tc_core, test_rope_lines);
+    tcase_add_test (tc_core, test_rope_mapped);
+    tcase_add_test (tc_core, test_rope_mapped_rewritten);
+    tcase_add_test (tc_core, test_rope_unmap);
+    tcase_add_test (tc_core, test_rope_unmap_truncated);
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "editbuffer__rope.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
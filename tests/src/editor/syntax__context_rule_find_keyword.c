@@ -0,0 +1,269 @@
+/*
+   src/editor - tests for choice of syntax keyword with index of first bytes
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/editor"
+
+#include "tests/mctest.h"
+
+#include "src/editor/syntax.c"
+
+static WEdit *test_edit = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* the same as in syntax.c before keywords were indexed */
+static const char *
+xx_strchr (const WEdit * edit, const unsigned char *s, int char_byte)
+{
+    while (*s >= '\005' && xx_tolower (edit, *s) != char_byte)
+        s++;
+
+    return (const char *) s;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find keyword as apply_rules_going_right() did it before keywords were indexed:
+ * look through the first bytes of all keywords of context.
+ */
+
+static int
+old_find_keyword (const WEdit * edit, const context_rule_t * r, off_t i, int c, off_t * end)
+{
+    GString *first_chars;
+    const char *p;
+    int result = 0;
+    guint j;
+
+    /* collect first character of keywords */
+    first_chars = g_string_sized_new (32);
+    g_string_append_c (first_chars, (char) 1);
+    for (j = 1; j < r->keyword->len; j++)
+        g_string_append_c (first_chars,
+                           SYNTAX_KEYWORD (g_ptr_array_index (r->keyword, j))->keyword[0]);
+
+    p = first_chars->str;
+
+    while (*(p = xx_strchr (edit, (const unsigned char *) p + 1, c)) != '\0')
+    {
+        const syntax_keyword_t *k;
+        int count;
+        off_t e;
+
+        count = p - first_chars->str;
+        k = SYNTAX_KEYWORD (g_ptr_array_index (r->keyword, count));
+        e = compare_word_to_right (edit, i, k->keyword, k->whole_word_chars_left,
+                                   k->whole_word_chars_right, k->line_start);
+        if (e > 0)
+        {
+            *end = e;
+            result = count;
+            break;
+        }
+    }
+
+    g_string_free (first_chars, TRUE);
+
+    return result;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+load (const char *syntax, const char *text)
+{
+    FILE *f;
+    char *args[ARGS_LEN];
+
+    f = tmpfile ();
+    fputs (syntax, f);
+    rewind (f);
+    mctest_assert_int_eq (edit_read_syntax_rules (test_edit, f, args, ARGS_LEN - 1), 0);
+    fclose (f);
+
+    for (; *text != '\0'; text++)
+        edit_buffer_insert (&test_edit->buffer, *text);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    str_init_strings (NULL);
+
+    test_edit = g_new0 (WEdit, 1);
+    edit_buffer_init (&test_edit->buffer, 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    if (test_edit->rules != NULL)
+        g_ptr_array_unref (test_edit->rules);
+    destroy_defines (&test_edit->defines);
+    edit_buffer_clean (&test_edit->buffer);
+    MC_PTR_FREE (test_edit);
+
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_context_rule_find_keyword_ds") */
+/* *INDENT-OFF* */
+static const struct test_context_rule_find_keyword_ds
+{
+    const char *syntax;         /* rules without colors: colors aren't allocated */
+    const char *text;
+} test_context_rule_find_keyword_ds[] =
+{
+    { /* 0. definition order: the first matched keyword wins */
+        "context default\n"
+        "    keyword whole if\n"
+        "    keyword whole in\n"
+        "    keyword i\n"
+        "    keyword if\n"
+        "    keyword iff\n"
+        "    keyword linestart #include\n"
+        "    keyword #\n",
+        "if in i iff ifx xif\n#include <x> # #include\n  #include if\n"
+    },
+    { /* 1. keywords which start with wildcard can start at any byte */
+        "context default\n"
+        "    keyword a\n"
+        "    keyword \\[0123456789\\]x\n"
+        "    keyword *end\n"
+        "    keyword +ab\n"
+        "    keyword \\{xy\\}z\n"
+        "    keyword b\n"
+        "    keyword a*z\n"
+        "    keyword c\\{de\\}\n",
+        "ax 12x x backend ab aab xz yz zz b abcz az cd ce cf\n"
+    },
+    { /* 2. case insensitive syntax */
+        "caseinsensitive\n"
+        "context default\n"
+        "    keyword whole IF\n"
+        "    keyword Else\n"
+        "    keyword \\{Xy\\}Z\n"
+        "context /\\* \\*/\n"
+        "    keyword TODO\n"
+        "    keyword fixME\n",
+        "If iF IF if ELSE else elsewhere XZ yz Yz /* todo ToDo FIXme FIXME */ if\n"
+    },
+    { /* 3. empty keyword hides the next ones */
+        "context default\n"
+        "    keyword a\n"
+        "    keyword \\\n"
+        "    keyword b\n"
+        "    keyword *c\n"
+        "context /\\* \\*/\n"
+        "    keyword \\\n"
+        "    keyword TODO\n"
+        "context \" \"\n"
+        "    keyword x\n"
+        "    keyword *y\n"
+        "    keyword \\\n"
+        "    keyword z\n",
+        "a b c abc /* a TODO b */ \"x y z xyz\" a b\n"
+    },
+};
+/* *INDENT-ON* */
+
+/* @Test(dataSource = "test_context_rule_find_keyword_ds") */
+/* *INDENT-OFF* */
+START_PARAMETRIZED_TEST (test_context_rule_find_keyword, test_context_rule_find_keyword_ds)
+/* *INDENT-ON* */
+{
+    /* given */
+    guint n;
+    int found = 0;
+
+    load (data->syntax, data->text);
+
+    for (n = 0; n < test_edit->rules->len; n++)
+    {
+        const context_rule_t *r = CONTEXT_RULE (g_ptr_array_index (test_edit->rules, n));
+        off_t i;
+
+        for (i = 0; i < test_edit->buffer.size; i++)
+        {
+            int c, actual_keyword, expected_keyword;
+            off_t actual_end = 0, expected_end = 0;
+
+            c = xx_tolower (test_edit, edit_buffer_get_byte (&test_edit->buffer, i));
+
+            /* when */
+            actual_keyword = context_rule_find_keyword (test_edit, r, i, c, &actual_end);
+
+            /* then */
+            expected_keyword = old_find_keyword (test_edit, r, i, c, &expected_end);
+            ck_assert_msg (actual_keyword == expected_keyword && actual_end == expected_end,
+                           "context %u, offset %jd: keyword %d ends at %jd, expected %d at %jd",
+                           n, (intmax_t) i, actual_keyword, (intmax_t) actual_end,
+                           expected_keyword, (intmax_t) expected_end);
+
+            if (expected_keyword != 0)
+                found++;
+        }
+    }
+
+    /* keywords are really found in the text */
+    ck_assert_int_gt (found, 0);
+}
+/* *INDENT-OFF* */
+END_PARAMETRIZED_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    mctest_add_parameterized_test (tc_core, test_context_rule_find_keyword,
+                                   test_context_rule_find_keyword_ds);
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "syntax__context_rule_find_keyword.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,324 @@
+/*
+   src/editor - tests for finding of syntax rules with markers
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/editor"
+
+#include "tests/mctest.h"
+
+#include "lib/tty/color-internal.h"     /* use_colors */
+
+#include "src/editor/syntax.c"
+
+/* rules without colors: colors aren't allocated */
+static const char *const test_syntax =
+    "context default\n"
+    "    keyword whole if\n"
+    "    keyword whole while\n"
+    "context /\\* \\*/\n"
+    "    keyword TODO\n"
+    "context \" \"\n";
+
+static WEdit *test_edit = NULL;
+/* rules found from the beginning of text for every byte */
+static edit_syntax_rule_t *expected_rules = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+insert_text (off_t pos, const char *text)
+{
+    edit_buffer_move_cursor (&test_edit->buffer, pos - test_edit->buffer.curs1);
+
+    for (; *text != '\0'; text++)
+    {
+        /* the same as edit_insert() does */
+        edit_syntax_invalidate (test_edit, test_edit->buffer.curs1);
+        test_edit->last_get_rule += (test_edit->last_get_rule > test_edit->buffer.curs1) ? 1 : 0;
+        edit_buffer_insert (&test_edit->buffer, *text);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Make text of code with long comments: rule guessed inside of comment is wrong.
+ */
+
+static void
+make_text (size_t size)
+{
+    GString *text;
+    int n = 0;
+
+    text = g_string_new ("");
+
+    while (text->len < size)
+    {
+        int i;
+
+        for (i = 0; i < 1000; i++)
+            g_string_append_printf (text, "if (x%d) \"while /* %d\" y; /* if */\n", n++, i);
+
+        g_string_append (text, "/*\n");
+        for (i = 0; i < 2000; i++)
+            g_string_append_printf (text, "comment if \"TODO %d\n", n++);
+        g_string_append (text, "*/\n");
+    }
+
+    insert_text (0, text->str);
+    g_string_free (text, TRUE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+scan_rules (void)
+{
+    off_t i;
+
+    g_free (expected_rules);
+    expected_rules = g_new (edit_syntax_rule_t, test_edit->buffer.size);
+
+    memset (&test_edit->rule, 0, sizeof (test_edit->rule));
+    apply_rules_going_right (test_edit, -1);
+
+    for (i = 0; i < test_edit->buffer.size; i++)
+    {
+        apply_rules_going_right (test_edit, i);
+        expected_rules[i] = test_edit->rule;
+    }
+
+    test_edit->last_get_rule = SYNTAX_RULE_UNKNOWN;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+check_rule (off_t i)
+{
+    const edit_syntax_rule_t *expected = &expected_rules[i];
+    const edit_syntax_rule_t *actual = &test_edit->rule;
+
+    edit_get_rule (test_edit, i);
+
+    ck_assert_msg (actual->context == expected->context && actual->_context == expected->_context
+                   && actual->keyword == expected->keyword && actual->border == expected->border
+                   && actual->end == expected->end,
+                   "rule at %jd is context %d, keyword %d, expected context %d, keyword %d",
+                   (intmax_t) i, actual->context, actual->keyword, expected->context,
+                   expected->keyword);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    FILE *f;
+    char *args[ARGS_LEN];
+
+    str_init_strings (NULL);
+    use_colors = TRUE;
+
+    test_edit = g_new0 (WEdit, 1);
+    WIDGET (test_edit)->lines = 25;
+    edit_buffer_init (&test_edit->buffer, 0);
+
+    f = tmpfile ();
+    fputs (test_syntax, f);
+    rewind (f);
+    mctest_assert_int_eq (edit_read_syntax_rules (test_edit, f, args, ARGS_LEN - 1), 0);
+    fclose (f);
+
+    /* rule isn't found for any offset yet */
+    test_edit->last_get_rule = SYNTAX_RULE_UNKNOWN;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    MC_PTR_FREE (expected_rules);
+
+    if (test_edit->syntax_marker != NULL)
+        g_array_free (test_edit->syntax_marker, TRUE);
+    g_ptr_array_unref (test_edit->rules);
+    destroy_defines (&test_edit->defines);
+    edit_buffer_clean (&test_edit->buffer);
+    MC_PTR_FREE (test_edit);
+
+    use_colors = FALSE;
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_edit_get_rule_after_edit_above_markers)
+/* *INDENT-ON* */
+{
+    /* given */
+    off_t i;
+    guint markers;
+
+    make_text (200 * 1024);
+    scan_rules ();
+    for (i = 0; i < test_edit->buffer.size; i++)
+        check_rule (i);
+    markers = test_edit->syntax_marker->len;
+
+    /* when: comment is opened above existing markers */
+    insert_text (50000, "/* ");
+    scan_rules ();
+
+    /* then: markers below the edit point are dropped, rules are the same as from scratch */
+    ck_assert_int_lt (test_edit->syntax_marker->len, markers);
+    for (i = 0; i < test_edit->buffer.size; i += 7)
+        check_rule (i);
+
+    /* when: comment is closed again */
+    insert_text (50010, " */");
+    scan_rules ();
+
+    /* then */
+    for (i = test_edit->buffer.size - 1; i >= 0; i -= 13)
+        check_rule (i);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_edit_get_rule_guess_and_idle)
+/* *INDENT-ON* */
+{
+    /* given */
+    off_t target, i, screen_end;
+    gboolean wrong_guess = FALSE;
+    int n;
+
+    make_text (SYNTAX_GUESS_DISTANCE * 3);
+    scan_rules ();
+
+    /* the last comment line before the end of text */
+    target = edit_buffer_get_bol (&test_edit->buffer, test_edit->buffer.size - 1);
+    while (expected_rules[target].context == 0)
+        target = edit_buffer_get_bol (&test_edit->buffer, target - 1);
+    test_edit->start_display = edit_buffer_get_backward_offset (&test_edit->buffer, target, 10);
+    screen_end =
+        edit_buffer_get_forward_offset (&test_edit->buffer, test_edit->start_display, 25, 0);
+
+    /* when: jump far from the beginning */
+    for (i = test_edit->start_display; i < screen_end; i++)
+    {
+        edit_get_rule (test_edit, i);
+        wrong_guess = wrong_guess || test_edit->rule.context != expected_rules[i].context;
+    }
+
+    /* then: rules are guessed, the text above isn't processed */
+    mctest_assert_true (test_edit->rule_is_guess);
+    mctest_assert_true (wrong_guess);
+    mctest_assert_true ((edit_syntax_last_marker_offset (test_edit) < test_edit->start_display));
+    mctest_assert_true (edit_syntax_idle_pending (test_edit));
+
+    /* when: user does nothing */
+    for (n = 0; n < 1000 && edit_syntax_idle (test_edit); n++)
+        ;
+
+    /* then: exact rules are found and the screen is redrawn */
+    ck_assert_int_lt (n, 1000);
+    mctest_assert_false (edit_syntax_idle_pending (test_edit));
+    mctest_assert_true (((test_edit->force & REDRAW_PAGE) != 0));
+    for (i = test_edit->start_display; i < screen_end; i++)
+        check_rule (i);
+    mctest_assert_false (test_edit->rule_is_guess);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_edit_get_rule_backwards)
+/* *INDENT-ON* */
+{
+    /* given */
+    off_t i;
+    guint markers;
+
+    make_text (200 * 1024);
+    scan_rules ();
+    check_rule (test_edit->buffer.size - 1);
+    markers = test_edit->syntax_marker->len;
+
+    /* when: move backwards across markers */
+    for (i = test_edit->buffer.size - 1; i >= 0; i -= 101)
+        check_rule (i);
+
+    /* then: markers are kept */
+    mctest_assert_int_eq (test_edit->syntax_marker->len, markers);
+
+    /* when: move forward again */
+    for (i = 0; i < test_edit->buffer.size; i += 97)
+        check_rule (i);
+
+    /* then */
+    mctest_assert_int_eq (test_edit->syntax_marker->len, markers);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    tcase_add_test (tc_core, test_edit_get_rule_after_edit_above_markers);
+    tcase_add_test (tc_core, test_edit_get_rule_guess_and_idle);
+    tcase_add_test (tc_core, test_edit_get_rule_backwards);
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "syntax__edit_get_rule.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
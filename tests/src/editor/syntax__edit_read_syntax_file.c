@@ -0,0 +1,340 @@
+/*
+   src/editor - tests for sharing of syntax rules between editors
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/editor"
+
+#include "tests/mctest.h"
+#include "tests/mctest_tmpdir.h"
+
+#include <utime.h>
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @ThenReturnValue */
+static char *mc_config_get_data_path__return_value = NULL;
+
+/* @Mock */
+/* don't touch the home directory of user */
+static const char *
+mc_config_get_data_path__mock (void)
+{
+    return mc_config_get_data_path__return_value;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#define mc_config_get_data_path mc_config_get_data_path__mock
+
+#include "src/editor/syntax.c"
+
+/* rules without colors: colors aren't allocated */
+static const char *const test_rules =
+    "context default\n"
+    "    keyword whole if\n";
+
+static const char *const test_rules_changed =
+    "context default\n"
+    "    keyword whole if\n"
+    "    keyword whole while\n";
+
+static char *syntax_path = NULL;
+static char *old_sysconfig_dir = NULL;
+static char *old_share_data_dir = NULL;
+static WEdit *test_edit1 = NULL;
+static WEdit *test_edit2 = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+make_syntax (const char *global_include)
+{
+    char *rules_path;
+    char *index;
+
+    rules_path = mctest_tmpdir_path ("foo.syntax");
+    index = g_strdup_printf ("%s%s%sfile ..\\*\\\\.foo$ Foo\ninclude %s\n",
+                             global_include != NULL ? "include " : "",
+                             global_include != NULL ? global_include : "",
+                             global_include != NULL ? "\n" : "", rules_path);
+    mctest_tmpdir_make_file ("Syntax", index);
+    g_free (index);
+    g_free (rules_path);
+
+    mctest_tmpdir_make_file ("foo.syntax", test_rules);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+make_dir (const char *name)
+{
+    char *path;
+
+    path = mctest_tmpdir_path (name);
+    ck_assert_msg (mkdir (path, 0700) == 0, "cannot create %s", path);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+load (WEdit * edit)
+{
+    mctest_assert_int_eq (edit_read_syntax_file (edit, NULL, syntax_path, "x.foo", "", NULL), 0);
+    mctest_assert_not_null (edit->rules);
+    mctest_assert_str_eq (edit->syntax_type, "Foo");
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* the same as edit_free_syntax_rules() does, except of freeing of colors which aren't allocated */
+static void
+unload (WEdit * edit)
+{
+    if (edit->rules != NULL)
+    {
+        syntax_definition_release (edit->syntax_type, edit->rules);
+        g_ptr_array_unref (edit->rules);
+        edit->rules = NULL;
+    }
+    MC_PTR_FREE (edit->syntax_type);
+    if (edit->defines != NULL)
+        destroy_defines (&edit->defines);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static guint
+keywords_count (const WEdit * edit)
+{
+    return CONTEXT_RULE (g_ptr_array_index (edit->rules, 0))->keyword->len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    str_init_strings (NULL);
+
+    mctest_tmpdir_create ("mc-syntax");
+    syntax_path = mctest_tmpdir_path ("Syntax");
+
+    /* directories where syntax files are searched */
+    mc_config_get_data_path__return_value = mctest_tmpdir_path ("data");
+    old_sysconfig_dir = mc_global.sysconfig_dir;
+    mc_global.sysconfig_dir = mctest_tmpdir_path ("etc");
+    old_share_data_dir = mc_global.share_data_dir;
+    mc_global.share_data_dir = mctest_tmpdir_path ("share");
+
+    test_edit1 = g_new0 (WEdit, 1);
+    test_edit2 = g_new0 (WEdit, 1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    unload (test_edit1);
+    unload (test_edit2);
+    MC_PTR_FREE (test_edit1);
+    MC_PTR_FREE (test_edit2);
+
+    MC_PTR_FREE (error_file_name);
+    MC_PTR_FREE (syntax_path);
+    MC_PTR_FREE (mc_config_get_data_path__return_value);
+    g_free (mc_global.sysconfig_dir);
+    mc_global.sysconfig_dir = old_sysconfig_dir;
+    g_free (mc_global.share_data_dir);
+    mc_global.share_data_dir = old_share_data_dir;
+    mctest_tmpdir_remove ();
+
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_edit_read_syntax_file_same_type)
+/* *INDENT-ON* */
+{
+    /* given */
+    make_syntax (NULL);
+    load (test_edit1);
+
+    /* when */
+    load (test_edit2);
+
+    /* then: rules are parsed once */
+    mctest_assert_ptr_eq (test_edit2->rules, test_edit1->rules);
+    mctest_assert_int_eq (keywords_count (test_edit2), 2);
+
+    /* when: the first editor is closed */
+    unload (test_edit1);
+
+    /* then: rules are still shared */
+    mctest_assert_not_null (syntax_definitions);
+    load (test_edit1);
+    mctest_assert_ptr_eq (test_edit1->rules, test_edit2->rules);
+
+    /* when: all editors are closed */
+    unload (test_edit1);
+    unload (test_edit2);
+
+    /* then */
+    mctest_assert_null (syntax_definitions);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_edit_read_syntax_file_touched)
+/* *INDENT-ON* */
+{
+    /* given */
+    char *rules_path;
+    struct utimbuf times;
+
+    make_syntax (NULL);
+    load (test_edit1);
+
+    /* when: rules file is changed */
+    mctest_tmpdir_make_file ("foo.syntax", test_rules_changed);
+    rules_path = mctest_tmpdir_path ("foo.syntax");
+    times.actime = times.modtime = time (NULL) - 3600;
+    mctest_assert_int_eq (utime (rules_path, &times), 0);
+    g_free (rules_path);
+    load (test_edit2);
+
+    /* then: rules are parsed again, the old ones are kept by the first editor */
+    mctest_assert_ptr_ne (test_edit2->rules, test_edit1->rules);
+    mctest_assert_int_eq (keywords_count (test_edit1), 2);
+    mctest_assert_int_eq (keywords_count (test_edit2), 3);
+
+    /* when: the first editor is closed */
+    unload (test_edit1);
+    load (test_edit1);
+
+    /* then: the new rules are shared */
+    mctest_assert_ptr_eq (test_edit1->rules, test_edit2->rules);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_edit_read_syntax_file_global_include)
+/* *INDENT-ON* */
+{
+    /* given */
+    char *global_path;
+
+    mctest_tmpdir_make_file ("global.syntax", test_rules);
+    global_path = mctest_tmpdir_path ("global.syntax");
+    make_syntax (global_path);
+    g_free (global_path);
+
+    /* when */
+    load (test_edit1);
+    load (test_edit2);
+
+    /* then: rules read after global include are not shared */
+    mctest_assert_ptr_ne (test_edit2->rules, test_edit1->rules);
+    mctest_assert_null (syntax_definitions);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_edit_read_syntax_file_shadowed)
+/* *INDENT-ON* */
+{
+    /* given: rules are found in the last directory of search path */
+    mctest_tmpdir_make_file ("Syntax", "file ..\\*\\\\.foo$ Foo\ninclude foo.syntax\n");
+    make_dir ("share");
+    make_dir ("share/syntax");
+    mctest_tmpdir_make_file ("share/syntax/foo.syntax", test_rules);
+    load (test_edit1);
+
+    /* when: user creates own rules file */
+    make_dir ("data");
+    make_dir ("data/" EDIT_HOME_DIR);
+    mctest_tmpdir_make_file ("data/" EDIT_HOME_DIR "/foo.syntax", test_rules_changed);
+    load (test_edit2);
+
+    /* then: rules of user are read, the old ones are kept by the first editor */
+    mctest_assert_ptr_ne (test_edit2->rules, test_edit1->rules);
+    mctest_assert_int_eq (keywords_count (test_edit1), 2);
+    mctest_assert_int_eq (keywords_count (test_edit2), 3);
+
+    /* when: the first editor is closed */
+    unload (test_edit1);
+    load (test_edit1);
+
+    /* then: the new rules are shared */
+    mctest_assert_ptr_eq (test_edit1->rules, test_edit2->rules);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    tcase_add_test (tc_core, test_edit_read_syntax_file_same_type);
+    tcase_add_test (tc_core, test_edit_read_syntax_file_touched);
+    tcase_add_test (tc_core, test_edit_read_syntax_file_global_include);
+    tcase_add_test (tc_core, test_edit_read_syntax_file_shadowed);
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "syntax__edit_read_syntax_file.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,359 @@
+/*
+   src/filemanager - tests for loading of directory listings
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include <stdio.h>
+
+#include "src/vfs/local/local.c"
+
+#include "src/filemanager/dir.c"
+
+#include "tests/mctest_tmpdir.h"
+
+/* enough entries to be stat'ed by several jobs */
+#define TEST_FILES (MC_PARALLEL_MIN_CHUNK * 5)
+#define TEST_DIRS 10
+/* enough entries to be read by streaming loader in several portions */
+#define TEST_STREAM_FILES (DIR_LIST_STREAM_CHUNK * 3)
+
+static vfs_path_t *tmp_vpath = NULL;
+static const dir_sort_options_t sort_op = { FALSE, FALSE, TRUE };
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+make_symlink (const char *target, const char *name)
+{
+    char *path;
+
+    path = mctest_tmpdir_path (name);
+    ck_assert_msg (symlink (target, path) == 0, "cannot create %s", path);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+make_dirs (void)
+{
+    int i;
+
+    for (i = 0; i < TEST_DIRS; i++)
+    {
+        char name[16];
+        char *path;
+
+        g_snprintf (name, sizeof (name), "d%02d", i);
+        path = mctest_tmpdir_path (name);
+        ck_assert_msg (mkdir (path, 0700) == 0, "cannot create %s", path);
+        g_free (path);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+make_stream_tree (void)
+{
+    int i;
+
+    /* names aren't created in sort order */
+    for (i = 0; i < TEST_STREAM_FILES; i++)
+    {
+        char name[16];
+
+        g_snprintf (name, sizeof (name), "s%04d", (i * 7919) % TEST_STREAM_FILES);
+        mctest_tmpdir_make_file (name, "");
+    }
+
+    make_dirs ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* files of every kind which is stat'ed in its own way */
+static void
+make_tree (void)
+{
+    int i;
+
+    for (i = 0; i < TEST_FILES; i++)
+    {
+        char name[16], content[16];
+
+        g_snprintf (name, sizeof (name), "f%03d", i);
+        g_snprintf (content, sizeof (content), "%d", i);
+        mctest_tmpdir_make_file (name, content);
+    }
+
+    make_dirs ();
+
+    make_symlink ("d00", "link_dir");
+    make_symlink ("f000", "link_file");
+    make_symlink ("missing", "link_stale");
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Check stat info of every entry against lstat()/stat() and order of entries:
+ * directories and links to them at first, names are in ascending order in both groups.
+ */
+
+static void
+check_list (const dir_list * list, int expected_len)
+{
+    int i;
+
+    mctest_assert_int_eq (list->len, expected_len);
+    mctest_assert_str_eq (list->list[0].fname, "..");
+
+    for (i = 1; i < list->len; i++)
+    {
+        const file_entry_t *fe = &list->list[i];
+        char *path;
+        struct stat st;
+
+        path = mctest_tmpdir_path (fe->fname);
+        ck_assert_msg (lstat (path, &st) == 0, "cannot stat %s", path);
+        ck_assert_msg (fe->st.st_ino == st.st_ino && fe->st.st_mode == st.st_mode
+                       && fe->st.st_size == st.st_size, "wrong stat of %s", fe->fname);
+
+        if (S_ISLNK (st.st_mode))
+        {
+            gboolean stale;
+
+            stale = stat (path, &st) != 0;
+            mctest_assert_int_eq (fe->f.stale_link, stale ? 1 : 0);
+            mctest_assert_int_eq (fe->f.link_to_dir, !stale && S_ISDIR (st.st_mode) ? 1 : 0);
+        }
+        g_free (path);
+
+        if (i > 1)
+        {
+            const file_entry_t *prev = &list->list[i - 1];
+
+            ck_assert_msg (MY_ISDIR (prev) > MY_ISDIR (fe)
+                           || (MY_ISDIR (prev) == MY_ISDIR (fe)
+                               && strcmp (prev->fname, fe->fname) < 0),
+                           "%s is before %s", prev->fname, fe->fname);
+        }
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    mc_global.timer = mc_timer_new ();
+    str_init_strings (NULL);
+
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+
+    mctest_tmpdir_create ("mc-dir-list-load");
+    tmp_vpath = vfs_path_from_str (mctest_tmpdir);
+
+    panels_options.show_dot_files = TRUE;
+    panels_options.show_backups = TRUE;
+    panels_options.mix_all_files = FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    vfs_path_free (tmp_vpath);
+    mctest_tmpdir_remove ();
+
+    mc_parallel_deinit ();
+    vfs_shut ();
+    str_uninit_strings ();
+    mc_timer_destroy (mc_global.timer);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_dir_list_load_local)
+/* *INDENT-ON* */
+{
+    /* given */
+    dir_list list = { NULL, 0, 0, NULL };
+    gboolean ok;
+
+    make_tree ();
+
+    /* when */
+    ok = dir_list_load (&list, tmp_vpath, (GCompareFunc) sort_name, &sort_op, NULL);
+
+    /* then: entries are stat'ed in parallel jobs as lstat() and stat() do */
+    mctest_assert_true (ok);
+    check_list (&list, 1 + TEST_FILES + TEST_DIRS + 3);
+
+    dir_list_free_list (&list);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_dir_list_load_local_filter)
+/* *INDENT-ON* */
+{
+    /* given */
+    dir_list list = { NULL, 0, 0, NULL };
+    gboolean ok;
+
+    make_tree ();
+
+    /* when */
+    ok = dir_list_load (&list, tmp_vpath, (GCompareFunc) sort_name, &sort_op, "f1*");
+
+    /* then: filter is applied to files only, directories and links to them are kept */
+    mctest_assert_true (ok);
+    check_list (&list, 1 + 100 + TEST_DIRS + 1);
+
+    dir_list_free_list (&list);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_dir_list_load_stream)
+/* *INDENT-ON* */
+{
+    /* given */
+    dir_list list = { NULL, 0, 0, NULL };
+    dir_list_loader_t *loader;
+    int tracked = -1, steps = 0, prev_len = 0;
+    char *tracked_name = NULL;
+    gboolean eof = FALSE;
+
+    make_stream_tree ();
+    loader = dir_list_load_start (&list, tmp_vpath, (GCompareFunc) sort_name, &sort_op, NULL);
+    mctest_assert_not_null (loader);
+
+    /* when: one portion is read at once */
+    while (!eof)
+    {
+        eof = dir_list_load_step (loader, 0, &tracked);
+        steps++;
+
+        /* then: the list only grows, the tracked entry is followed */
+        ck_assert_int_ge (list.len, prev_len);
+        prev_len = list.len;
+        if (tracked_name == NULL && list.len > 2)
+        {
+            tracked = list.len / 2;
+            tracked_name = g_strdup (list.list[tracked].fname);
+        }
+        else if (tracked_name != NULL)
+            mctest_assert_str_eq (list.list[tracked].fname, tracked_name);
+    }
+
+    mctest_assert_true (dir_list_load_finish (loader, &tracked));
+
+    /* then */
+    ck_assert_int_gt (steps, 2);
+    mctest_assert_str_eq (list.list[tracked].fname, tracked_name);
+    check_list (&list, 1 + TEST_STREAM_FILES + TEST_DIRS);
+
+    g_free (tracked_name);
+    dir_list_free_list (&list);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_dir_list_load_stream_abort)
+/* *INDENT-ON* */
+{
+    /* given */
+    dir_list list = { NULL, 0, 0, NULL };
+    dir_list_loader_t *loader;
+
+    make_stream_tree ();
+    loader = dir_list_load_start (&list, tmp_vpath, (GCompareFunc) sort_name, &sort_op, NULL);
+    mctest_assert_not_null (loader);
+    mctest_assert_false (dir_list_load_step (loader, 0, NULL));
+
+    /* when */
+    dir_list_load_abort (loader);
+
+    /* then: the first portion is kept sorted */
+    ck_assert_int_gt (list.len, 1);
+    ck_assert_int_lt (list.len, 1 + TEST_STREAM_FILES + TEST_DIRS);
+    check_list (&list, list.len);
+
+    dir_list_free_list (&list);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    tcase_add_test (tc_core, test_dir_list_load_local);
+    tcase_add_test (tc_core, test_dir_list_load_local_filter);
+    tcase_add_test (tc_core, test_dir_list_load_stream);
+    tcase_add_test (tc_core, test_dir_list_load_stream_abort);
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "dir_list_load.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
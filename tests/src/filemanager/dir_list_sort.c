@@ -0,0 +1,222 @@
+/*
+   src/filemanager - tests for dir_list_sort() function
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include "src/filemanager/dir.c"
+
+/* enough entries to split sorting into several jobs */
+#define TEST_ENTRIES (DIR_SORT_MIN_CHUNK * 5 + 7)
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    str_init_strings (NULL);
+    g_random_set_seed (42);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    mc_parallel_deinit ();
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+fill_list (dir_list * list, int count)
+{
+    static const char *const names[] = {
+        "a", "B", "b", ".hidden", "_x", "file.txt", "file.TXT", "archive.tar.gz", "z10", "z9",
+        "very_long_common_prefix_", "very_long_common_prefix_x.c", "ä", "Ä", "A"
+    };
+    int i;
+
+    dir_list_init (list);
+
+    for (i = 0; i < count; i++)
+    {
+        struct stat st;
+        char *name;
+
+        memset (&st, 0, sizeof (st));
+        switch (g_random_int_range (0, 4))
+        {
+        case 0:
+            st.st_mode = S_IFDIR | 0755;
+            break;
+        case 1:
+            st.st_mode = S_IFREG | 0755;
+            break;
+        default:
+            st.st_mode = S_IFREG | 0644;
+            break;
+        }
+        st.st_size = g_random_int_range (0, 8);
+        st.st_mtime = g_random_int_range (0, 8);
+        st.st_ino = g_random_int_range (0, 1000);
+
+        name = g_strdup_printf ("%s%d", names[g_random_int_range (0, G_N_ELEMENTS (names))],
+                                g_random_int_range (0, 100));
+        dir_list_append (list, name, &st, FALSE, FALSE);
+        g_free (name);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_dir_list_sort_ds") */
+/* *INDENT-OFF* */
+static const struct test_dir_list_sort_ds
+{
+    GCompareFunc sort;
+    dir_sort_options_t sort_op;
+    gboolean mix_all_files;
+} test_dir_list_sort_ds[] =
+{
+    { /* 0 */
+        (GCompareFunc) sort_name,
+        { FALSE, FALSE, TRUE },
+        FALSE
+    },
+    { /* 1 */
+        (GCompareFunc) sort_name,
+        { TRUE, TRUE, FALSE },
+        FALSE
+    },
+    { /* 2 */
+        (GCompareFunc) sort_name,
+        { TRUE, FALSE, TRUE },
+        TRUE
+    },
+    { /* 3 */
+        (GCompareFunc) sort_ext,
+        { FALSE, TRUE, TRUE },
+        FALSE
+    },
+    { /* 4 */
+        (GCompareFunc) sort_ext,
+        { TRUE, FALSE, FALSE },
+        TRUE
+    },
+    { /* 5 */
+        (GCompareFunc) sort_size,
+        { FALSE, FALSE, TRUE },
+        FALSE
+    },
+    { /* 6 */
+        (GCompareFunc) sort_time,
+        { TRUE, TRUE, TRUE },
+        FALSE
+    },
+    { /* 7 */
+        (GCompareFunc) sort_vers,
+        { FALSE, FALSE, FALSE },
+        FALSE
+    },
+    { /* 8 */
+        (GCompareFunc) sort_inode,
+        { TRUE, FALSE, TRUE },
+        TRUE
+    },
+};
+/* *INDENT-ON* */
+
+/* @Test(dataSource = "test_dir_list_sort_ds") */
+/* *INDENT-OFF* */
+START_PARAMETRIZED_TEST (test_dir_list_sort, test_dir_list_sort_ds)
+/* *INDENT-ON* */
+{
+    /* given */
+    dir_list actual = { NULL, 0, 0, NULL };
+    dir_list expected = { NULL, 0, 0, NULL };
+    int i;
+
+    panels_options.mix_all_files = data->mix_all_files;
+    fill_list (&actual, TEST_ENTRIES);
+    g_random_set_seed (42);
+    fill_list (&expected, TEST_ENTRIES);
+
+    /* when */
+    dir_list_sort (&actual, data->sort, &data->sort_op);
+
+    /* then */
+    set_sort_options (&data->sort_op);
+    qsort (&expected.list[1], expected.len - 1, sizeof (file_entry_t), data->sort);
+
+    mctest_assert_int_eq (actual.len, expected.len);
+    mctest_assert_str_eq (actual.list[0].fname, "..");
+
+    for (i = 1; i < actual.len; i++)
+    {
+        /* keys are freed after sorting */
+        mctest_assert_null (actual.list[i].sort_key);
+        mctest_assert_null (actual.list[i].second_sort_key);
+        /* entries which are equal by sort order can be swapped */
+        mctest_assert_int_eq (data->sort (&actual.list[i], &expected.list[i]), 0);
+    }
+
+    clean_sort_keys (&actual, 1, actual.len - 1);
+    clean_sort_keys (&expected, 1, expected.len - 1);
+    dir_list_free_list (&expected);
+    dir_list_free_list (&actual);
+}
+/* *INDENT-OFF* */
+END_PARAMETRIZED_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    mctest_add_parameterized_test (tc_core, test_dir_list_sort, test_dir_list_sort_ds);
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "dir_list_sort.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,284 @@
+/*
+   src/filemanager - tests for dir_list_update() function
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include <stdio.h>
+
+#include "src/vfs/local/local.c"
+
+#include "src/filemanager/dir.c"
+
+#include "src/filemanager/dirwatch.h"
+
+#include "tests/mctest_tmpdir.h"
+
+static vfs_path_t *tmp_vpath = NULL;
+static const dir_sort_options_t sort_op = { FALSE, FALSE, TRUE };
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+remove_file (const char *name)
+{
+    char *path;
+
+    path = mctest_tmpdir_path (name);
+    unlink (path);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+rename_file (const char *from, const char *to)
+{
+    char *path_from, *path_to;
+
+    path_from = mctest_tmpdir_path (from);
+    path_to = mctest_tmpdir_path (to);
+    rename (path_from, path_to);
+    g_free (path_from);
+    g_free (path_to);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static GHashTable *
+make_changes (const char *const *names)
+{
+    GHashTable *changes;
+
+    changes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    for (; *names != NULL; names++)
+        g_hash_table_replace (changes, g_strdup (*names), NULL);
+
+    return changes;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+find_entry (const dir_list * list, const char *name)
+{
+    int i;
+
+    for (i = 0; i < list->len; i++)
+        if (strcmp (list->list[i].fname, name) == 0)
+            return i;
+
+    return -1;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    mc_global.timer = mc_timer_new ();
+    str_init_strings (NULL);
+
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+
+    mctest_tmpdir_create ("mc-dir-list-update");
+    tmp_vpath = vfs_path_from_str (mctest_tmpdir);
+
+    mctest_tmpdir_make_file ("a", "");
+    mctest_tmpdir_make_file ("b", "");
+    mctest_tmpdir_make_file ("c", "");
+    mctest_tmpdir_make_file ("f", "");
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    vfs_path_free (tmp_vpath);
+    mctest_tmpdir_remove ();
+
+    vfs_shut ();
+    str_uninit_strings ();
+    mc_timer_destroy (mc_global.timer);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_dir_list_update)
+/* *INDENT-ON* */
+{
+    /* given */
+    static const char *const changed[] = { "a", "b", "c", "d", "e", "missing", NULL };
+    dir_list list = { NULL, 0, 0, NULL };
+    GHashTable *changes;
+    int tracked, first;
+    gboolean ok;
+
+    dir_list_load (&list, tmp_vpath, (GCompareFunc) sort_name, &sort_op, NULL);
+    mctest_assert_int_eq (list.len, 5);
+    list.list[find_entry (&list, "b")].f.marked = 1;
+    tracked = find_entry (&list, "f");
+
+    remove_file ("a");
+    mctest_tmpdir_make_file ("b", "content");
+    rename_file ("c", "e");
+    mctest_tmpdir_make_file ("d", "");
+    changes = make_changes (changed);
+
+    /* when */
+    ok = dir_list_update (&list, tmp_vpath, changes, (GCompareFunc) sort_name, &sort_op, NULL,
+                          &tracked, &first);
+
+    /* then */
+    mctest_assert_true (ok);
+    mctest_assert_int_eq (list.len, 5);
+    mctest_assert_str_eq (list.list[0].fname, "..");
+    mctest_assert_str_eq (list.list[1].fname, "b");
+    mctest_assert_str_eq (list.list[2].fname, "d");
+    mctest_assert_str_eq (list.list[3].fname, "e");
+    mctest_assert_str_eq (list.list[4].fname, "f");
+    mctest_assert_int_eq (list.list[1].f.marked, 1);
+    mctest_assert_int_eq (list.list[1].st.st_size, 7);
+    mctest_assert_int_eq (tracked, 4);
+    mctest_assert_int_eq (first, 1);
+
+    g_hash_table_destroy (changes);
+    dir_list_free_list (&list);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_dir_list_update_removed_tracked)
+/* *INDENT-ON* */
+{
+    /* given */
+    static const char *const changed[] = { "f", NULL };
+    dir_list list = { NULL, 0, 0, NULL };
+    GHashTable *changes;
+    int tracked;
+
+    dir_list_load (&list, tmp_vpath, (GCompareFunc) sort_name, &sort_op, NULL);
+    tracked = find_entry (&list, "f");
+    remove_file ("f");
+    changes = make_changes (changed);
+
+    /* when */
+    dir_list_update (&list, tmp_vpath, changes, (GCompareFunc) sort_name, &sort_op, NULL,
+                     &tracked, NULL);
+
+    /* then */
+    mctest_assert_int_eq (list.len, 4);
+    mctest_assert_int_eq (find_entry (&list, "f"), -1);
+    mctest_assert_int_eq (tracked, 3);
+
+    g_hash_table_destroy (changes);
+    dir_list_free_list (&list);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_dir_list_reload_after_rescan)
+/* *INDENT-ON* */
+{
+    /* given */
+    dir_list list = { NULL, 0, 0, NULL };
+    dir_watch_t *watch;
+    GHashTable *changes;
+    gboolean rescan = FALSE;
+
+    mctest_tmpdir_make_file (".hidden", "");
+    panels_options.show_dot_files = FALSE;
+    dir_list_load (&list, tmp_vpath, (GCompareFunc) sort_name, &sort_op, NULL);
+    mctest_assert_int_eq (find_entry (&list, ".hidden"), -1);
+
+    watch = dir_watch_new (tmp_vpath);
+    if (watch != NULL)
+        dir_watch_poll ();
+
+    /* when: hidden files are toggled as update_one_panel_widget() does with UP_RELOAD */
+    panels_options.show_dot_files = TRUE;
+    if (watch != NULL)
+    {
+        dir_watch_set_rescan (watch);
+        mctest_assert_true (dir_watch_has_changes (watch));
+        changes = dir_watch_take_changes (watch, &rescan);
+        /* directory has no changes, but the listing can't be taken from the watch */
+        mctest_assert_null (changes);
+        mctest_assert_true (rescan);
+    }
+    dir_list_reload (&list, tmp_vpath, (GCompareFunc) sort_name, &sort_op, NULL);
+
+    /* then */
+    mctest_assert_int_ne (find_entry (&list, ".hidden"), -1);
+
+    dir_watch_free (watch);
+    dir_list_free_list (&list);
+    panels_options.show_dot_files = TRUE;
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    tcase_add_test (tc_core, test_dir_list_update);
+    tcase_add_test (tc_core, test_dir_list_update_removed_tracked);
+    tcase_add_test (tc_core, test_dir_list_reload_after_rescan);
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "dir_list_update.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,220 @@
+/*
+   src/filemanager - tests for dir_size_compute() function
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include <unistd.h>
+#include <utime.h>
+
+#include "src/vfs/local/local.c"
+
+#include "src/filemanager/dirsize.c"
+
+#include "tests/mctest_tmpdir.h"
+
+static vfs_path_t *tmp_vpath = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+make_dir (const char *name)
+{
+    char *path;
+
+    path = mctest_tmpdir_path (name);
+    mkdir (path, 0700);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* move mtime of directory to the past to allow caching of it */
+static void
+age_dir (const char *name)
+{
+    char *path;
+    struct utimbuf times;
+
+    times.actime = times.modtime = time (NULL) - 100;
+    path = mctest_tmpdir_path (name);
+    utime (path, &times);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    char *link_path;
+
+    mc_global.timer = mc_timer_new ();
+    str_init_strings (NULL);
+
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+
+    mctest_tmpdir_create ("mc-dir-size");
+    tmp_vpath = vfs_path_from_str (mctest_tmpdir);
+
+    /* f1: 3 bytes, d1/f2: 5 bytes, d1/d2/f3: 7 bytes, l -> d1: 2 bytes */
+    mctest_tmpdir_make_file ("f1", "abc");
+    make_dir ("d1");
+    mctest_tmpdir_make_file ("d1/f2", "abcde");
+    make_dir ("d1/d2");
+    mctest_tmpdir_make_file ("d1/d2/f3", "abcdefg");
+    link_path = mctest_tmpdir_path ("l");
+    ck_assert_int_eq (symlink ("d1", link_path), 0);
+    g_free (link_path);
+
+    age_dir ("d1/d2");
+    age_dir ("d1");
+    age_dir ("");
+
+    /* don't touch the cache of user */
+    dir_size_cache = g_hash_table_new_full (dir_size_node_hash, dir_size_node_equal, NULL,
+                                            dir_size_node_free);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    g_hash_table_destroy (dir_size_cache);
+    dir_size_cache = NULL;
+    dir_size_cache_dirty = FALSE;
+
+    vfs_path_free (tmp_vpath);
+    mctest_tmpdir_remove ();
+
+    mc_parallel_deinit ();
+    vfs_shut ();
+    str_uninit_strings ();
+    mc_timer_destroy (mc_global.timer);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_dir_size_compute)
+/* *INDENT-ON* */
+{
+    /* given */
+    dir_size_t cold = { 0, 0, 0 };
+    dir_size_t warm = { 0, 0, 0 };
+    dir_size_t changed = { 0, 0, 0 };
+    FileProgressStatus ret;
+
+    /* when */
+    ret = dir_size_compute (tmp_vpath, FALSE, &cold, NULL, NULL);
+
+    /* then */
+    mctest_assert_int_eq (ret, FILE_CONT);
+    mctest_assert_int_eq (cold.dir_count, 3);
+    mctest_assert_int_eq (cold.file_count, 4);
+    mctest_assert_int_eq (cold.total, 3 + 5 + 7 + 2);
+    mctest_assert_int_eq (g_hash_table_size (dir_size_cache), 3);
+    mctest_assert_true (dir_size_cache_dirty);
+
+    /* when */
+    dir_size_cache_dirty = FALSE;
+    ret = dir_size_compute (tmp_vpath, FALSE, &warm, NULL, NULL);
+
+    /* then */
+    mctest_assert_int_eq (ret, FILE_CONT);
+    mctest_assert_int_eq (warm.dir_count, cold.dir_count);
+    mctest_assert_int_eq (warm.file_count, cold.file_count);
+    mctest_assert_int_eq (warm.total, cold.total);
+    mctest_assert_false (dir_size_cache_dirty);
+
+    /* when */
+    mctest_tmpdir_make_file ("d1/d2/f4", "abcdefghijk");
+    ret = dir_size_compute (tmp_vpath, FALSE, &changed, NULL, NULL);
+
+    /* then */
+    mctest_assert_int_eq (ret, FILE_CONT);
+    mctest_assert_int_eq (changed.dir_count, 3);
+    mctest_assert_int_eq (changed.file_count, 5);
+    mctest_assert_int_eq (changed.total, cold.total + 11);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_dir_size_compute_follow_symlinks)
+/* *INDENT-ON* */
+{
+    /* given */
+    dir_size_t size = { 0, 0, 0 };
+    FileProgressStatus ret;
+
+    /* when */
+    ret = dir_size_compute (tmp_vpath, TRUE, &size, NULL, NULL);
+
+    /* then */
+    mctest_assert_int_eq (ret, FILE_CONT);
+    mctest_assert_int_eq (size.dir_count, 5);
+    mctest_assert_int_eq (size.file_count, 5);
+    mctest_assert_int_eq (size.total, 3 + (5 + 7) * 2);
+    mctest_assert_int_eq (g_hash_table_size (dir_size_cache), 0);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    tcase_add_test (tc_core, test_dir_size_compute);
+    tcase_add_test (tc_core, test_dir_size_compute_follow_symlinks);
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "dir_size_compute.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
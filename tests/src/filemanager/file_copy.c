@@ -0,0 +1,669 @@
+/*
+   src/filemanager - tests for copying of files
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <utime.h>
+
+#include "lib/widget.h"
+#include "src/filemanager/fileopctx.h"
+
+#include "src/vfs/local/local.c"
+
+/* files of each directory of the tree: more than copy jobs run at the same time */
+#define TEST_FILES 50
+/* buffer of copy pipe: larger than the kernel buffer of FIFO */
+#define TEST_PIPE_BUFSIZE (1024 * 1024)
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @ThenReturnValue */
+static int query_dialog__return_value;
+/* @CapturedValue */
+static int query_dialog__calls;
+
+/* @Mock */
+static int
+query_dialog__mock (const char *header, const char *text, int flags, int count, ...)
+{
+    (void) header;
+    (void) text;
+    (void) flags;
+    (void) count;
+
+    query_dialog__calls++;
+    return query_dialog__return_value;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @ThenReturnValue: the call which returns FILE_ABORT, 0 for none */
+static int check_progress_buttons__abort_at;
+/* @CapturedValue */
+static int check_progress_buttons__calls;
+
+/* @Mock */
+static FileProgressStatus
+check_progress_buttons__mock (file_op_context_t * ctx)
+{
+    (void) ctx;
+
+    check_progress_buttons__calls++;
+    return check_progress_buttons__calls == check_progress_buttons__abort_at ? FILE_ABORT
+        : FILE_CONT;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Mock */
+static void
+do_refresh__mock (void)
+{
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Mock */
+static void
+mc_refresh__mock (void)
+{
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#define query_dialog query_dialog__mock
+#define check_progress_buttons check_progress_buttons__mock
+#define do_refresh do_refresh__mock
+#define mc_refresh mc_refresh__mock
+
+#include "src/filemanager/file.c"
+
+#include "tests/mctest_tmpdir.h"
+
+static file_op_total_context_t *tctx = NULL;
+static file_op_context_t *ctx = NULL;
+static char *src_dir = NULL;
+static char *dst_dir = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+make_files (const char *dir)
+{
+    int i;
+
+    for (i = 0; i < TEST_FILES; i++)
+    {
+        char name[32], *content;
+
+        g_snprintf (name, sizeof (name), "%s/f%02d", dir, i);
+        content = g_strnfill ((gsize) i * 100, (gchar) ('a' + i % 26));
+        mctest_tmpdir_make_file (name, content);
+        g_free (content);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* source tree: two directories with old times, they should be kept by the copy */
+static void
+make_tree (void)
+{
+    struct utimbuf times;
+    char *path;
+
+    ck_assert_msg (mkdir (src_dir, 0750) == 0, "cannot create %s", src_dir);
+    path = mctest_tmpdir_path ("src/sub");
+    ck_assert_msg (mkdir (path, 0750) == 0, "cannot create %s", path);
+
+    make_files ("src");
+    make_files ("src/sub");
+
+    times.actime = times.modtime = time (NULL) - 3600;
+    mctest_assert_int_eq (utime (path, &times), 0);
+    mctest_assert_int_eq (utime (src_dir, &times), 0);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Check target file against source one.
+ *
+ * @return FALSE if target file doesn't exist
+ */
+
+static gboolean
+check_copied (const char *name)
+{
+    char *src, *dst;
+    char *src_content, *dst_content;
+    struct stat src_st, dst_st;
+    gboolean exists;
+
+    src = g_build_filename (src_dir, name, (char *) NULL);
+    dst = g_build_filename (dst_dir, name, (char *) NULL);
+
+    exists = lstat (dst, &dst_st) == 0;
+    if (exists)
+    {
+        mctest_assert_int_eq (lstat (src, &src_st), 0);
+        mctest_assert_int_eq (dst_st.st_mode, src_st.st_mode);
+        ck_assert_msg (dst_st.st_mtime == src_st.st_mtime, "wrong time of %s", dst);
+
+        if (S_ISREG (src_st.st_mode))
+        {
+            mctest_assert_true (g_file_get_contents (src, &src_content, NULL, NULL));
+            mctest_assert_true (g_file_get_contents (dst, &dst_content, NULL, NULL));
+            mctest_assert_str_eq (dst_content, src_content);
+            g_free (src_content);
+            g_free (dst_content);
+        }
+    }
+
+    g_free (src);
+    g_free (dst);
+
+    return exists;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @return number of files of directory which are copied */
+static int
+check_copied_files (const char *dir)
+{
+    int i, copied = 0;
+
+    for (i = 0; i < TEST_FILES; i++)
+    {
+        char name[32];
+        char *path;
+
+        g_snprintf (name, sizeof (name), "f%02d", i);
+        path = g_build_filename (dir, name, (char *) NULL);
+        if (check_copied (path))
+            copied++;
+        g_free (path);
+    }
+
+    return copied;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef COPY_PIPE_THREADS
+static copy_pipe_t *fifo_pipe = NULL;
+static int fifo_read_fd = -1;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* put buffer filled by byte to the pipe */
+static void
+pipe_put_buffer (copy_pipe_t * cp, char c)
+{
+    char *buf;
+
+    buf = copy_pipe_get_buffer (cp);
+    mctest_assert_not_null (buf);
+    memset (buf, c, TEST_PIPE_BUFSIZE);
+    copy_pipe_put (cp, TEST_PIPE_BUFSIZE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Create FIFO in the temporary directory.
+ *
+ * @return VFS descriptor of the writing end, the reading end is in fifo_read_fd
+ */
+
+static int
+open_fifo (void)
+{
+    char *path;
+    vfs_path_t *vpath;
+    int fd;
+
+    path = mctest_tmpdir_path ("fifo");
+    ck_assert_msg (mkfifo (path, 0600) == 0, "cannot create %s", path);
+
+    /* there should be a reader to open FIFO for writing without blocking */
+    fifo_read_fd = open (path, O_RDONLY | O_NONBLOCK);
+    ck_assert_int_ge (fifo_read_fd, 0);
+    vpath = vfs_path_from_str (path);
+    fd = mc_open (vpath, O_WRONLY);
+    ck_assert_int_ge (fd, 0);
+    fcntl (fifo_read_fd, F_SETFL, fcntl (fifo_read_fd, F_GETFL) & ~O_NONBLOCK);
+
+    vfs_path_free (vpath);
+    g_free (path);
+
+    return fd;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* read FIFO after the writer of copy pipe is asked to stop, return number of read bytes */
+static gpointer
+fifo_reader (gpointer data)
+{
+    char buf[BUF_MEDIUM];
+    gsize total = 0;
+    gboolean stop = FALSE;
+    ssize_t n;
+
+    (void) data;
+
+    while (!stop)
+    {
+        g_mutex_lock (&fifo_pipe->lock);
+        stop = fifo_pipe->stop;
+        g_mutex_unlock (&fifo_pipe->lock);
+
+        if (!stop)
+            g_usleep (1000);
+    }
+
+    while ((n = read (fifo_read_fd, buf, sizeof (buf))) > 0)
+        total += (gsize) n;
+
+    return GSIZE_TO_POINTER (total);
+}
+#endif /* COPY_PIPE_THREADS */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    mc_global.timer = mc_timer_new ();
+    str_init_strings (NULL);
+
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+
+    mctest_tmpdir_create ("mc-file-copy");
+    src_dir = mctest_tmpdir_path ("src");
+    dst_dir = mctest_tmpdir_path ("dst");
+
+    tctx = file_op_total_context_new ();
+    ctx = file_op_context_new (OP_COPY);
+
+    query_dialog__return_value = 0;
+    query_dialog__calls = 0;
+    check_progress_buttons__abort_at = 0;
+    check_progress_buttons__calls = 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    dest_dirs = free_linklist (dest_dirs);
+    file_op_context_destroy (ctx);
+    file_op_total_context_destroy (tctx);
+
+#ifdef COPY_PIPE_THREADS
+    copy_pipe_free (fifo_pipe);
+    fifo_pipe = NULL;
+    if (fifo_read_fd >= 0)
+    {
+        close (fifo_read_fd);
+        fifo_read_fd = -1;
+    }
+#endif
+
+    MC_PTR_FREE (src_dir);
+    MC_PTR_FREE (dst_dir);
+    mctest_tmpdir_remove ();
+
+    mc_parallel_deinit ();
+    vfs_shut ();
+    str_uninit_strings ();
+    mc_timer_destroy (mc_global.timer);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_copy_dir_dir_jobs)
+/* *INDENT-ON* */
+{
+    /* given */
+    FileProgressStatus status;
+
+    make_tree ();
+
+    /* when */
+    status = copy_dir_dir (tctx, ctx, src_dir, dst_dir, TRUE, FALSE, FALSE, NULL);
+
+    /* then: every file is copied once and counted */
+    mctest_assert_int_eq (status, FILE_CONT);
+    mctest_assert_int_eq (check_copied_files (""), TEST_FILES);
+    mctest_assert_int_eq (check_copied_files ("sub"), TEST_FILES);
+    mctest_assert_int_eq (tctx->progress_count, 2 * TEST_FILES);
+    mctest_assert_int_eq (query_dialog__calls, 0);
+
+    /* times of directories are set after all their files are copied */
+    mctest_assert_true (check_copied ("sub"));
+    mctest_assert_true (check_copied (""));
+
+    mctest_assert_true (g_queue_is_empty (&copy_jobs));
+    mctest_assert_int_eq (copy_jobs_depth, 0);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_copy_dir_dir_jobs_error)
+/* *INDENT-ON* */
+{
+    /* given */
+    FileProgressStatus status;
+    char *path;
+
+    /* root can read anything */
+    if (geteuid () == 0)
+        return;
+
+    make_tree ();
+    path = mctest_tmpdir_path ("src/f05");
+    mctest_assert_int_eq (chmod (path, 0), 0);
+    g_free (path);
+
+    /* when: user skips the file */
+    query_dialog__return_value = 0;
+    status = copy_dir_dir (tctx, ctx, src_dir, dst_dir, TRUE, FALSE, FALSE, NULL);
+
+    /* then: failed job is copied again in the main thread, which reports the error once */
+    mctest_assert_int_eq (status, FILE_CONT);
+    mctest_assert_int_eq (query_dialog__calls, 1);
+    mctest_assert_false (check_copied ("f05"));
+    mctest_assert_int_eq (check_copied_files (""), TEST_FILES - 1);
+    mctest_assert_int_eq (check_copied_files ("sub"), TEST_FILES);
+    mctest_assert_true (g_queue_is_empty (&copy_jobs));
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_copy_dir_dir_jobs_error_abort)
+/* *INDENT-ON* */
+{
+    /* given */
+    FileProgressStatus status;
+    char *path;
+
+    /* root can read anything */
+    if (geteuid () == 0)
+        return;
+
+    make_tree ();
+    path = mctest_tmpdir_path ("src/f05");
+    mctest_assert_int_eq (chmod (path, 0), 0);
+    g_free (path);
+
+    /* when: user aborts the operation: "Abort" is the 4th button */
+    query_dialog__return_value = 3;
+    status = copy_dir_dir (tctx, ctx, src_dir, dst_dir, TRUE, FALSE, FALSE, NULL);
+
+    /* then: queued jobs are dropped, files which are copied are complete */
+    mctest_assert_int_eq (status, FILE_ABORT);
+    mctest_assert_int_eq (query_dialog__calls, 1);
+    mctest_assert_false (check_copied ("f05"));
+    ck_assert_int_le (check_copied_files ("") + check_copied_files ("sub"), 2 * TEST_FILES - 1);
+    mctest_assert_true (g_queue_is_empty (&copy_jobs));
+    mctest_assert_int_eq (copy_jobs_depth, 0);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_copy_dir_dir_jobs_abort)
+/* *INDENT-ON* */
+{
+    /* given */
+    FileProgressStatus status;
+
+    make_tree ();
+
+    /* when: user presses "Abort" in the progress dialog */
+    check_progress_buttons__abort_at = TEST_FILES / 2;
+    status = copy_dir_dir (tctx, ctx, src_dir, dst_dir, TRUE, FALSE, FALSE, NULL);
+
+    /* then: queued jobs are dropped, running ones are finished: no file is copied partially */
+    mctest_assert_int_eq (status, FILE_ABORT);
+    ck_assert_int_lt (check_copied_files ("") + check_copied_files ("sub"), 2 * TEST_FILES);
+    ck_assert_int_lt (tctx->progress_count, 2 * TEST_FILES);
+    mctest_assert_true (g_queue_is_empty (&copy_jobs));
+    mctest_assert_int_eq (copy_jobs_depth, 0);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef COPY_PIPE_THREADS
+/* *INDENT-OFF* */
+START_TEST (test_copy_pipe_short_write)
+/* *INDENT-ON* */
+{
+    /* given */
+    struct rlimit limit, short_limit;
+    FileProgressStatus status = FILE_CONT;
+    copy_pipe_t *cp;
+    vfs_path_t *vpath;
+    int fd;
+    char *content;
+    gsize len;
+    guint i;
+
+    vpath = vfs_path_build_filename (mctest_tmpdir, "target", (char *) NULL);
+    fd = mc_open (vpath, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    ck_assert_int_ge (fd, 0);
+    cp = copy_pipe_new (fd, TEST_PIPE_BUFSIZE);
+    mctest_assert_not_null (cp);
+
+    /* the second buffer is written partially, then write() fails with EFBIG */
+    signal (SIGXFSZ, SIG_IGN);
+    mctest_assert_int_eq (getrlimit (RLIMIT_FSIZE, &limit), 0);
+    short_limit = limit;
+    short_limit.rlim_cur = TEST_PIPE_BUFSIZE + TEST_PIPE_BUFSIZE / 2;
+    mctest_assert_int_eq (setrlimit (RLIMIT_FSIZE, &short_limit), 0);
+
+    /* when */
+    pipe_put_buffer (cp, 'a');
+    pipe_put_buffer (cp, 'b');
+
+    /* then: the error reaches the reader, the written part of buffer is kept */
+    mctest_assert_false (copy_pipe_finish (cp, FALSE));
+    mctest_assert_null (copy_pipe_get_buffer (cp));
+    mctest_assert_int_eq (cp->filled, 1);
+    mctest_assert_int_eq (cp->done[cp->head], TEST_PIPE_BUFSIZE / 2);
+
+    /* when: the reader writes the rest */
+    mctest_assert_int_eq (setrlimit (RLIMIT_FSIZE, &limit), 0);
+    mctest_assert_true (copy_pipe_drain (ctx, cp, fd, "target", &status));
+    copy_pipe_free (cp);
+    mctest_assert_int_eq (mc_close (fd), 0);
+
+    /* then: data isn't lost or duplicated */
+    mctest_assert_int_eq (status, FILE_CONT);
+    mctest_assert_int_eq (query_dialog__calls, 0);
+    mctest_assert_true (g_file_get_contents (vfs_path_as_str (vpath), &content, &len, NULL));
+    mctest_assert_int_eq (len, 2 * TEST_PIPE_BUFSIZE);
+    for (i = 0; i < len && content[i] == (i < TEST_PIPE_BUFSIZE ? 'a' : 'b'); i++)
+        ;
+    mctest_assert_int_eq (i, len);
+
+    g_free (content);
+    vfs_path_free (vpath);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_copy_pipe_error)
+/* *INDENT-ON* */
+{
+    /* given */
+    FileProgressStatus status = FILE_CONT;
+    copy_pipe_t *cp;
+    int fd;
+    guint i;
+
+    /* nobody reads the FIFO: write() fails with EPIPE */
+    signal (SIGPIPE, SIG_IGN);
+    fd = open_fifo ();
+    close (fifo_read_fd);
+    fifo_read_fd = -1;
+    cp = copy_pipe_new (fd, TEST_PIPE_BUFSIZE);
+    mctest_assert_not_null (cp);
+
+    /* when: the reader waits for a free buffer */
+    for (i = 0; i <= COPY_PIPE_BUFFERS && copy_pipe_get_buffer (cp) != NULL; i++)
+        copy_pipe_put (cp, TEST_PIPE_BUFSIZE);
+
+    /* then: it gets no buffer when the writer has failed */
+    ck_assert_int_le (i, COPY_PIPE_BUFFERS);
+    mctest_assert_true (cp->finished);
+    mctest_assert_true (cp->failed);
+
+    /* when: the reader writes the rest itself, user aborts on error */
+    query_dialog__return_value = 3;
+    mctest_assert_false (copy_pipe_drain (ctx, cp, fd, "fifo", &status));
+
+    /* then: the error is reported once in the main thread */
+    mctest_assert_int_eq (status, FILE_ABORT);
+    mctest_assert_int_eq (query_dialog__calls, 1);
+
+    copy_pipe_free (cp);
+    mc_close (fd);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_copy_pipe_abort_full)
+/* *INDENT-ON* */
+{
+    /* given */
+    struct pollfd pfd;
+    GThread *reader;
+    int fd;
+    guint i;
+    gsize total;
+
+    fd = open_fifo ();
+    fifo_pipe = copy_pipe_new (fd, TEST_PIPE_BUFSIZE);
+    mctest_assert_not_null (fifo_pipe);
+    reader = g_thread_new ("reader", fifo_reader, NULL);
+
+    /* nobody reads the FIFO yet: the writer is blocked on the first buffer */
+    for (i = 0; i < COPY_PIPE_BUFFERS; i++)
+        pipe_put_buffer (fifo_pipe, 'a' + i);
+    pfd.fd = fifo_read_fd;
+    pfd.events = POLLIN;
+    mctest_assert_int_eq (poll (&pfd, 1, 10 * 1000), 1);
+
+    g_mutex_lock (&fifo_pipe->lock);
+    mctest_assert_int_eq (fifo_pipe->filled, COPY_PIPE_BUFFERS);
+    g_mutex_unlock (&fifo_pipe->lock);
+
+    /* when: user aborts copying, the FIFO is read since then */
+    mctest_assert_true (copy_pipe_finish (fifo_pipe, TRUE));
+    mc_close (fd);
+    total = GPOINTER_TO_SIZE (g_thread_join (reader));
+
+    /* then: the writer stops after the buffer being written, the rest is dropped */
+    mctest_assert_true (fifo_pipe->finished);
+    mctest_assert_false (fifo_pipe->failed);
+    mctest_assert_int_eq (fifo_pipe->filled, COPY_PIPE_BUFFERS - 1);
+    mctest_assert_int_eq (total, TEST_PIPE_BUFSIZE);
+    mctest_assert_null (copy_pipe_get_buffer (fifo_pipe));
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+#endif /* COPY_PIPE_THREADS */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    tcase_add_test (tc_core, test_copy_dir_dir_jobs);
+    tcase_add_test (tc_core, test_copy_dir_dir_jobs_error);
+    tcase_add_test (tc_core, test_copy_dir_dir_jobs_error_abort);
+    tcase_add_test (tc_core, test_copy_dir_dir_jobs_abort);
+#ifdef COPY_PIPE_THREADS
+    tcase_add_test (tc_core, test_copy_pipe_short_write);
+    tcase_add_test (tc_core, test_copy_pipe_error);
+    tcase_add_test (tc_core, test_copy_pipe_abort_full);
+#endif
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "file_copy.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
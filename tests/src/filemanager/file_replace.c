@@ -0,0 +1,344 @@
+/*
+   src/filemanager - tests for file_replace() function
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include <unistd.h>
+
+#include "lib/strutil.h"
+
+#include "src/filemanager/filereplace.c"
+
+#include "tests/mctest_tmpdir.h"
+
+/* --------------------------------------------------------------------------------------------- */
+
+static char *
+make_file (const char *name, const char *content)
+{
+    mctest_tmpdir_make_file (name, content);
+    return mctest_tmpdir_path (name);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static char *
+read_file (const char *path)
+{
+    char *content = NULL;
+
+    g_file_get_contents (path, &content, NULL, NULL);
+    return content;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    str_init_strings ("UTF-8");
+    mc_global.utf8_display = TRUE;
+
+    mctest_tmpdir_create ("mc-file-replace");
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    mctest_tmpdir_remove ();
+
+    mc_parallel_deinit ();
+    mc_search_cache_done ();
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_file_replace_ds") */
+/* *INDENT-OFF* */
+static const struct test_file_replace_ds
+{
+    const char *search;
+    const char *replace;
+    mc_search_type_t type;
+    gboolean case_sens;
+    const char *content;
+    const char *expected_content;
+    size_t expected_replaced;
+} test_file_replace_ds[] =
+{
+    { /* 0. */
+        "needle", "pin", MC_SEARCH_T_NORMAL, TRUE,
+        "hay needle hay\nneedle needle\nno Needle\n",
+        "hay pin hay\npin pin\nno Needle\n",
+        3
+    },
+    { /* 1. */
+        "needle", "pin", MC_SEARCH_T_NORMAL, FALSE,
+        "Needle\nlast line needle",
+        "pin\nlast line pin",
+        2
+    },
+    { /* 2. */
+        "([a-z]+)=([0-9]+)", "\\2=\\1", MC_SEARCH_T_REGEX, TRUE,
+        "a=1 bb=22\n# c\n",
+        "1=a 22=bb\n# c\n",
+        2
+    },
+    { /* 3. */
+        /* start of line is matched once per line */
+        "^a", "b", MC_SEARCH_T_REGEX, TRUE,
+        "aaa\nxa\na\n",
+        "baa\nxa\nb\n",
+        2
+    },
+    { /* 4. */
+        "x", "", MC_SEARCH_T_NORMAL, TRUE,
+        "xax\n\nx",
+        "a\n\n",
+        3
+    },
+    { /* 5. */
+        /* search is continued after the first match of line */
+        "^a|b$", "c", MC_SEARCH_T_REGEX, TRUE,
+        "abab\nbab\n",
+        "cbac\nbac\n",
+        3
+    },
+    { /* 6. */
+        /* lookbehind sees the text before the previous match */
+        "(?<=a)a", "b", MC_SEARCH_T_REGEX, TRUE,
+        "aaa\n",
+        "abb\n",
+        2
+    },
+};
+/* *INDENT-ON* */
+
+/* @Test(dataSource = "test_file_replace_ds") */
+/* *INDENT-OFF* */
+START_PARAMETRIZED_TEST (test_file_replace, test_file_replace_ds)
+/* *INDENT-ON* */
+{
+    /* given */
+    GPtrArray *paths;
+    file_replace_options_t options;
+    file_replace_status_t status;
+    FileProgressStatus ret;
+    char *content;
+
+    paths = g_ptr_array_new_with_free_func (g_free);
+    g_ptr_array_add (paths, make_file ("f", data->content));
+
+    options.search = data->search;
+    options.replace = data->replace;
+    options.type = data->type;
+    options.case_sens = data->case_sens;
+    options.whole_words = FALSE;
+
+    /* when */
+    ret = file_replace (paths, &options, &status, NULL, NULL);
+
+    /* then */
+    mctest_assert_int_eq (ret, FILE_CONT);
+    mctest_assert_int_eq (status.files_done, 1);
+    mctest_assert_int_eq (status.files_changed, 1);
+    mctest_assert_int_eq (status.replaced, data->expected_replaced);
+    mctest_assert_int_eq (status.errors, 0);
+    content = read_file ((const char *) g_ptr_array_index (paths, 0));
+    mctest_assert_str_eq (content, data->expected_content);
+
+    g_free (content);
+    file_replace_status_free (&status);
+    g_ptr_array_free (paths, TRUE);
+}
+/* *INDENT-OFF* */
+END_PARAMETRIZED_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_file_replace_many)
+/* *INDENT-ON* */
+{
+    /* given */
+    GPtrArray *paths;
+    file_replace_options_t options;
+    file_replace_status_t status;
+    FileProgressStatus ret;
+    GString *big;
+    struct stat st_before, st_after;
+    char *path, *link_path, *content;
+    int i;
+
+    paths = g_ptr_array_new_with_free_func (g_free);
+
+    /* the first match is far from the start of file */
+    big = g_string_new ("");
+    for (i = 0; i < 20000; i++)
+        g_string_append (big, "some line without anything\n");
+    g_string_append (big, "old\n");
+    g_ptr_array_add (paths, make_file ("big", big->str));
+
+    /* file without matches is not touched */
+    path = make_file ("untouched", "nothing here\n");
+    chmod (path, 0640);
+    ck_assert_int_eq (stat (path, &st_before), 0);
+    g_ptr_array_add (paths, path);
+
+    /* target of symlink is changed */
+    mctest_tmpdir_make_file ("target", "old\n");
+    link_path = mctest_tmpdir_path ("link");
+    ck_assert_int_eq (symlink ("target", link_path), 0);
+    g_ptr_array_add (paths, link_path);
+
+    /* file with hard links is skipped */
+    path = make_file ("hard", "old\n");
+    g_ptr_array_add (paths, path);
+    path = mctest_tmpdir_path ("hard2");
+    ck_assert_int_eq (link ((const char *) g_ptr_array_index (paths, 3), path), 0);
+    g_free (path);
+
+    /* missing file */
+    g_ptr_array_add (paths, mctest_tmpdir_path ("missing"));
+
+    options.search = "old";
+    options.replace = "new";
+    options.type = MC_SEARCH_T_NORMAL;
+    options.case_sens = TRUE;
+    options.whole_words = TRUE;
+
+    /* when */
+    ret = file_replace (paths, &options, &status, NULL, NULL);
+
+    /* then */
+    mctest_assert_int_eq (ret, FILE_CONT);
+    mctest_assert_int_eq (status.files_done, 5);
+    mctest_assert_int_eq (status.files_changed, 2);
+    mctest_assert_int_eq (status.replaced, 2);
+    mctest_assert_int_eq (status.errors, 2);
+    mctest_assert_not_null (status.error);
+
+    content = read_file ((const char *) g_ptr_array_index (paths, 0));
+    g_string_truncate (big, big->len - 4);
+    g_string_append (big, "new\n");
+    mctest_assert_str_eq (content, big->str);
+    g_free (content);
+
+    ck_assert_int_eq (stat ((const char *) g_ptr_array_index (paths, 1), &st_after), 0);
+    mctest_assert_int_eq (st_after.st_ino, st_before.st_ino);
+    mctest_assert_int_eq (st_after.st_mode & 07777, 0640);
+
+    content = read_file ((const char *) g_ptr_array_index (paths, 2));
+    mctest_assert_str_eq (content, "new\n");
+    g_free (content);
+    ck_assert_int_eq (lstat ((const char *) g_ptr_array_index (paths, 2), &st_after), 0);
+    mctest_assert_true (S_ISLNK (st_after.st_mode));
+
+    content = read_file ((const char *) g_ptr_array_index (paths, 3));
+    mctest_assert_str_eq (content, "old\n");
+    g_free (content);
+
+    g_string_free (big, TRUE);
+    file_replace_status_free (&status);
+    g_ptr_array_free (paths, TRUE);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_file_replace_bad_pattern)
+/* *INDENT-ON* */
+{
+    /* given */
+    GPtrArray *paths;
+    file_replace_options_t options;
+    file_replace_status_t status;
+    FileProgressStatus ret;
+    char *content;
+
+    paths = g_ptr_array_new_with_free_func (g_free);
+    g_ptr_array_add (paths, make_file ("f", "(a\n"));
+
+    options.search = "(a";
+    options.replace = "b";
+    options.type = MC_SEARCH_T_REGEX;
+    options.case_sens = TRUE;
+    options.whole_words = FALSE;
+
+    /* when */
+    ret = file_replace (paths, &options, &status, NULL, NULL);
+
+    /* then */
+    mctest_assert_int_eq (ret, FILE_ABORT);
+    mctest_assert_not_null (status.error);
+    mctest_assert_int_eq (status.files_done, 0);
+    content = read_file ((const char *) g_ptr_array_index (paths, 0));
+    mctest_assert_str_eq (content, "(a\n");
+
+    g_free (content);
+    file_replace_status_free (&status);
+    g_ptr_array_free (paths, TRUE);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    mctest_add_parameterized_test (tc_core, test_file_replace, test_file_replace_ds);
+    tcase_add_test (tc_core, test_file_replace_many);
+    tcase_add_test (tc_core, test_file_replace_bad_pattern);
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "file_replace.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,353 @@
+/*
+   src/filemanager - tests for search of files in worker threads
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include "lib/parallel.h"
+#include "lib/vfs/vfs.h"
+
+/* lines of the large file, every third one matches */
+#define TEST_LINES 300
+#define TEST_LINE_LEN 10
+#define TEST_DIRS 5
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @ThenReturnValue */
+static gboolean vfs_map_local_file__disabled;
+
+/* @Mock */
+/* files are read line by line if they can't be mapped */
+static vfs_file_map_t *
+vfs_map_local_file__mock (int fd, off_t size)
+{
+    return vfs_map_local_file__disabled ? NULL : vfs_map_local_file (fd, size);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @ThenReturnValue: search is suspended before workers start */
+static gboolean mc_parallel_run__paused;
+
+/* @Mock */
+static mc_parallel_t *mc_parallel_run__mock (guint jobs, mc_parallel_job_fn job_fn,
+                                             gpointer user_data);
+
+/* --------------------------------------------------------------------------------------------- */
+
+#define vfs_map_local_file vfs_map_local_file__mock
+#define mc_parallel_run mc_parallel_run__mock
+
+#include "src/filemanager/find.c"
+
+#undef mc_parallel_run
+
+#include "tests/mctest_tmpdir.h"
+
+/* --------------------------------------------------------------------------------------------- */
+
+static mc_parallel_t *
+mc_parallel_run__mock (guint jobs, mc_parallel_job_fn job_fn, gpointer user_data)
+{
+    ((find_engine_t *) user_data)->paused = mc_parallel_run__paused;
+
+    return mc_parallel_run (jobs, job_fn, user_data);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+make_tree (void)
+{
+    GString *content;
+    int i;
+
+    content = g_string_new ("");
+    for (i = 0; i < TEST_LINES; i++)
+        g_string_append_printf (content, i % 3 == 0 ? "match %03d\n" : "line  %03d\n", i);
+    mctest_tmpdir_make_file ("many", content->str);
+    g_string_free (content, TRUE);
+
+    for (i = 0; i < TEST_DIRS; i++)
+    {
+        char name[16];
+        char *path;
+
+        g_snprintf (name, sizeof (name), "d%d", i);
+        path = mctest_tmpdir_path (name);
+        ck_assert_msg (mkdir (path, 0700) == 0, "cannot create %s", path);
+        g_free (path);
+
+        g_snprintf (name, sizeof (name), "d%d/f", i);
+        mctest_tmpdir_make_file (name, "no\nmatch\n");
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @return number of results */
+static int
+take_results (find_engine_t * e, GPtrArray * taken)
+{
+    GPtrArray *results;
+    int count = 0;
+
+    while ((results = (GPtrArray *) g_async_queue_try_pop (e->results)) != NULL)
+    {
+        count += results->len;
+        g_ptr_array_add (taken, results);
+    }
+
+    return count;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Check results of the whole tree: results of the large file, which come in several portions,
+ * should be in order of lines.
+ */
+
+static void
+check_results (GPtrArray * taken)
+{
+    int line = 0, files = 0;
+    guint i, j;
+
+    for (i = 0; i < taken->len; i++)
+    {
+        GPtrArray *results = (GPtrArray *) g_ptr_array_index (taken, i);
+
+        for (j = 0; j < results->len; j++)
+        {
+            const find_result_t *r = (const find_result_t *) g_ptr_array_index (results, j);
+            char expected[32];
+
+            if (strcmp (r->dir, mctest_tmpdir) != 0)
+            {
+                mctest_assert_str_eq (r->text, "2:f");
+                files++;
+                continue;
+            }
+
+            /* the first line is number 1, the first matched byte is number 1 */
+            g_snprintf (expected, sizeof (expected), "%d:many", line + 1);
+            mctest_assert_str_eq (r->text, expected);
+            mctest_assert_int_eq (r->start, (gsize) line * TEST_LINE_LEN + 1);
+            mctest_assert_int_eq (r->end - r->start, 5);
+            line += 3;
+        }
+    }
+
+    mctest_assert_int_eq (line, TEST_LINES);
+    mctest_assert_int_eq (files, TEST_DIRS);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    str_init_strings (NULL);
+
+    mctest_tmpdir_create ("mc-find-engine");
+
+    options.file_pattern = TRUE;
+    options.find_recurs = TRUE;
+    options.skip_hidden = FALSE;
+    options.content_first_hit = FALSE;
+    find_pattern = g_strdup ("*");
+    content_pattern = g_strdup ("match");
+
+    vfs_map_local_file__disabled = FALSE;
+    mc_parallel_run__paused = FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    MC_PTR_FREE (find_pattern);
+    MC_PTR_FREE (content_pattern);
+
+    mctest_tmpdir_remove ();
+
+    mc_parallel_deinit ();
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_find_engine_order_ds") */
+/* *INDENT-OFF* */
+static const struct test_find_engine_order_ds
+{
+    gboolean map_disabled;
+} test_find_engine_order_ds[] =
+{
+    { /* 0. mapped files are searched in place */
+        FALSE
+    },
+    { /* 1. files are read line by line */
+        TRUE
+    },
+};
+/* *INDENT-ON* */
+
+/* @Test(dataSource = "test_find_engine_order_ds") */
+/* *INDENT-OFF* */
+START_PARAMETRIZED_TEST (test_find_engine_order, test_find_engine_order_ds)
+/* *INDENT-ON* */
+{
+    /* given */
+    find_engine_t *e;
+    GPtrArray *taken;
+    int count;
+
+    make_tree ();
+    vfs_map_local_file__disabled = data->map_disabled;
+
+    /* when */
+    e = find_engine_new (mctest_tmpdir);
+    if (e == NULL)
+        return;                 /* there are no processors to run workers on */
+
+    mctest_assert_true (mc_parallel_wait (e->run, -1));
+    taken = g_ptr_array_new_with_free_func ((GDestroyNotify) g_ptr_array_unref);
+    count = take_results (e, taken);
+
+    /* then: every match is found once, the large file is passed in two portions */
+    mctest_assert_int_eq (count, TEST_LINES / 3 + TEST_DIRS);
+    mctest_assert_int_eq (taken->len, TEST_DIRS + 2);
+    check_results (taken);
+
+    g_ptr_array_free (taken, TRUE);
+    find_engine_free (e);
+}
+/* *INDENT-OFF* */
+END_PARAMETRIZED_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_find_engine_pause)
+/* *INDENT-ON* */
+{
+    /* given */
+    find_engine_t *e;
+    GPtrArray *taken;
+
+    make_tree ();
+    mc_parallel_run__paused = TRUE;
+    e = find_engine_new (mctest_tmpdir);
+    if (e == NULL)
+        return;                 /* there are no processors to run workers on */
+
+    taken = g_ptr_array_new_with_free_func ((GDestroyNotify) g_ptr_array_unref);
+
+    /* when: search is suspended */
+    mctest_assert_false (mc_parallel_wait (e->run, 100 * 1000));
+
+    /* then: workers wait, nothing is taken from the queue */
+    mctest_assert_int_eq (take_results (e, taken), 0);
+    mctest_assert_int_eq (g_queue_get_length (&e->dirs), 1);
+
+    /* when: search is continued */
+    find_engine_set_paused (e, FALSE);
+    mctest_assert_true (mc_parallel_wait (e->run, -1));
+
+    /* then: the search is finished as if it wasn't suspended */
+    mctest_assert_int_eq (take_results (e, taken), TEST_LINES / 3 + TEST_DIRS);
+    check_results (taken);
+
+    g_ptr_array_free (taken, TRUE);
+    find_engine_free (e);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_find_engine_cancel)
+/* *INDENT-ON* */
+{
+    /* given */
+    find_engine_t *e;
+    GAsyncQueue *results;
+
+    make_tree ();
+    mc_parallel_run__paused = TRUE;
+    e = find_engine_new (mctest_tmpdir);
+    if (e == NULL)
+        return;                 /* there are no processors to run workers on */
+
+    mctest_assert_false (mc_parallel_wait (e->run, 100 * 1000));
+    results = g_async_queue_ref (e->results);
+
+    /* when: user stops the suspended search */
+    find_engine_free (e);
+
+    /* then: waiting workers are woken up and stop without taking anything from the queue */
+    mctest_assert_int_eq (g_async_queue_length (results), 0);
+    g_async_queue_unref (results);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    mctest_add_parameterized_test (tc_core, test_find_engine_order, test_find_engine_order_ds);
+    tcase_add_test (tc_core, test_find_engine_pause);
+    tcase_add_test (tc_core, test_find_engine_cancel);
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "find_engine.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,198 @@
+/*
+   src/filemanager - tests for directories which are skipped by find file
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include "src/filemanager/findignore.c"
+
+static GHashTable *ignore_dirs = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    str_init_strings (NULL);
+
+    ignore_dirs = find_ignore_dirs_new ("foo:/abs/dir::bar/baz/:./qux:");
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    g_hash_table_destroy (ignore_dirs);
+
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_find_ignore_dirs_match_ds") */
+/* *INDENT-OFF* */
+static const struct test_find_ignore_dirs_match_ds
+{
+    const char *dir;
+    gboolean expected_result;
+} test_find_ignore_dirs_match_ds[] =
+{
+    /* relative dir: only its beginning is compared */
+    { /* 0. */
+        "foo", TRUE
+    },
+    { /* 1. */
+        "foo/sub", TRUE
+    },
+    { /* 2. */
+        "foobar", FALSE
+    },
+    { /* 3. */
+        "xfoo", FALSE
+    },
+    { /* 4. */
+        "sub/foo", FALSE
+    },
+    { /* 5. */
+        "bar/baz", TRUE
+    },
+    { /* 6. */
+        "bar", FALSE
+    },
+    { /* 7. */
+        "qux", TRUE
+    },
+    /* absolute dir: absolute ignore dirs at beginning, relative ones at any component */
+    { /* 8. */
+        "/abs/dir", TRUE
+    },
+    { /* 9. */
+        "/abs/dir/sub", TRUE
+    },
+    { /* 10. */
+        "/abs/directory", FALSE
+    },
+    { /* 11. */
+        "/x/abs/dir", FALSE
+    },
+    { /* 12. */
+        "/home/foo", TRUE
+    },
+    { /* 13. */
+        "/home/foo/sub", TRUE
+    },
+    { /* 14. */
+        "/home/xfoo", FALSE
+    },
+    { /* 15. */
+        "/home/foobar/sub", FALSE
+    },
+    { /* 16. */
+        "/home/bar/baz/sub", TRUE
+    },
+    { /* 17. */
+        "/home/bar/sub/baz", FALSE
+    },
+    { /* 18. */
+        "/abs", FALSE
+    },
+};
+/* *INDENT-ON* */
+
+/* @Test(dataSource = "test_find_ignore_dirs_match_ds") */
+/* *INDENT-OFF* */
+START_PARAMETRIZED_TEST (test_find_ignore_dirs_match, test_find_ignore_dirs_match_ds)
+/* *INDENT-ON* */
+{
+    /* given */
+    gboolean actual_result;
+
+    /* when */
+    actual_result = find_ignore_dirs_match (ignore_dirs, data->dir);
+
+    /* then */
+    mctest_assert_int_eq (actual_result, data->expected_result);
+}
+/* *INDENT-OFF* */
+END_PARAMETRIZED_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_find_ignore_dirs_new)
+/* *INDENT-ON* */
+{
+    /* given */
+    GHashTable *dirs;
+
+    /* when */
+    dirs = find_ignore_dirs_new ("::");
+
+    /* then */
+    mctest_assert_null (dirs);
+    mctest_assert_null (find_ignore_dirs_new (""));
+    mctest_assert_null (find_ignore_dirs_new (NULL));
+    mctest_assert_false (find_ignore_dirs_match (NULL, "/abs/dir"));
+
+    /* empty entries are skipped, directories are canonicalized */
+    mctest_assert_int_eq (g_hash_table_size (ignore_dirs), 4);
+    mctest_assert_not_null (g_hash_table_lookup (ignore_dirs, "bar/baz"));
+    mctest_assert_not_null (g_hash_table_lookup (ignore_dirs, "qux"));
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    mctest_add_parameterized_test (tc_core, test_find_ignore_dirs_match,
+                                   test_find_ignore_dirs_match_ds);
+    tcase_add_test (tc_core, test_find_ignore_dirs_new);
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "find_ignore_dirs.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,345 @@
+/*
+   src/filemanager - tests for index of content of files for find file
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include <unistd.h>
+#include <utime.h>
+
+#include "src/filemanager/findindex.c"
+
+#include "tests/mctest_tmpdir.h"
+
+static char *tmp_file = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+static find_index_node_t *
+scan_file (const char *path)
+{
+    find_index_scan_t scan;
+    find_index_node_t *node;
+
+    scan.seen = g_malloc0 ((1 << 24) / 8);
+    scan.trigrams = g_array_new (FALSE, FALSE, sizeof (guint32));
+
+    node = find_index_scan_file (&scan, path, time (NULL));
+
+    g_array_free (scan.trigrams, TRUE);
+    g_free (scan.seen);
+
+    return node;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    struct utimbuf times;
+
+    str_init_strings (NULL);
+
+    mctest_tmpdir_create ("mc-find-index");
+
+    mctest_tmpdir_make_file ("f", "haystack with Needle\nand other hay\n");
+    tmp_file = mctest_tmpdir_path ("f");
+
+    /* file changed just now isn't indexed */
+    times.actime = times.modtime = time (NULL) - 100;
+    utime (tmp_file, &times);
+
+    /* don't touch the index of user */
+    find_index = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, find_index_node_free);
+    find_index_pending_set = g_hash_table_new (g_str_hash, g_str_equal);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    g_queue_clear_full (&find_index_pending, g_free);
+    g_hash_table_destroy (find_index_pending_set);
+    find_index_pending_set = NULL;
+    g_hash_table_destroy (find_index);
+    find_index = NULL;
+    find_index_dirty = FALSE;
+
+    g_free (tmp_file);
+    mctest_tmpdir_remove ();
+
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_find_index_query_ds") */
+/* *INDENT-OFF* */
+static const struct test_find_index_query_ds
+{
+    const char *pattern;
+    gboolean regexp;
+    gboolean case_sens;
+    gboolean all_charsets;
+    gboolean expected_query;
+    gboolean expected_match;
+} test_find_index_query_ds[] =
+{
+    { /* 0. */
+        "Needle", FALSE, TRUE, FALSE,
+        TRUE, TRUE
+    },
+    { /* 1. */
+        "needle", FALSE, FALSE, FALSE,
+        TRUE, TRUE
+    },
+    { /* 2. */
+        "pumpkin pie", FALSE, TRUE, FALSE,
+        TRUE, FALSE
+    },
+    { /* 3. */
+        "with Ne+dle$", TRUE, TRUE, FALSE,
+        TRUE, TRUE
+    },
+    { /* 4. */
+        "pumpkin[0-9]+pie", TRUE, TRUE, FALSE,
+        TRUE, FALSE
+    },
+    { /* 5. */
+        /* any alternative can match */
+        "Needle|pumpkin", TRUE, TRUE, FALSE,
+        FALSE, TRUE
+    },
+    { /* 6. */
+        /* too short */
+        "hy", FALSE, TRUE, FALSE,
+        FALSE, TRUE
+    },
+    { /* 7. */
+        /* pattern is recoded to other charsets */
+        "pumpkin", FALSE, TRUE, TRUE,
+        FALSE, TRUE
+    },
+    { /* 8. */
+        /* ']' of POSIX class doesn't end the class */
+        "with[[:space:]]Needle", TRUE, TRUE, FALSE,
+        TRUE, TRUE
+    },
+    { /* 9. */
+        "pumpkin[[:digit:][.-.]]+pie", TRUE, TRUE, FALSE,
+        TRUE, FALSE
+    },
+    { /* 10. */
+        /* optional multibyte char is dropped as a whole */
+        "Needle\xc3\xa9*", TRUE, TRUE, FALSE,
+        TRUE, TRUE
+    },
+    { /* 11. */
+        "pumpkin\xc3\xa9?pie", TRUE, TRUE, FALSE,
+        TRUE, FALSE
+    },
+};
+/* *INDENT-ON* */
+
+/* @Test(dataSource = "test_find_index_query_ds") */
+/* *INDENT-OFF* */
+START_PARAMETRIZED_TEST (test_find_index_query, test_find_index_query_ds)
+/* *INDENT-ON* */
+{
+    /* given */
+    find_index_query_t *query;
+    find_index_node_t *node;
+    struct stat st;
+    gboolean match;
+
+    node = scan_file (tmp_file);
+    mctest_assert_not_null (node);
+    g_hash_table_replace (find_index, node->path, node);
+    ck_assert_int_eq (stat (tmp_file, &st), 0);
+
+    /* when */
+    query = find_index_query_new (data->pattern, data->regexp, data->case_sens,
+                                  data->all_charsets);
+    match = find_index_may_match (query, tmp_file, &st);
+
+    /* then */
+    mctest_assert_int_eq (query != NULL, data->expected_query);
+    mctest_assert_int_eq (match, data->expected_match);
+    mctest_assert_int_eq (g_queue_get_length (&find_index_pending), 0);
+
+    find_index_query_free (query);
+}
+/* *INDENT-OFF* */
+END_PARAMETRIZED_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_find_index_changed_file)
+/* *INDENT-ON* */
+{
+    /* given */
+    find_index_query_t *query;
+    find_index_node_t *node;
+    struct stat st;
+
+    node = scan_file (tmp_file);
+    mctest_assert_not_null (node);
+    g_hash_table_replace (find_index, node->path, node);
+    query = find_index_query_new ("pumpkin", FALSE, TRUE, FALSE);
+
+    /* when */
+    g_file_set_contents (tmp_file, "pumpkin", -1, NULL);
+    ck_assert_int_eq (stat (tmp_file, &st), 0);
+
+    /* then */
+    mctest_assert_true (find_index_may_match (query, tmp_file, &st));
+    mctest_assert_int_eq (g_queue_get_length (&find_index_pending), 1);
+    mctest_assert_str_eq ((const char *) g_queue_peek_head (&find_index_pending), tmp_file);
+
+    /* queued only once */
+    mctest_assert_true (find_index_may_match (query, tmp_file, &st));
+    mctest_assert_int_eq (g_queue_get_length (&find_index_pending), 1);
+
+    /* just changed file isn't indexed */
+    mctest_assert_null (scan_file (tmp_file));
+
+    find_index_query_free (query);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_find_index_replaced_file)
+/* *INDENT-ON* */
+{
+    /* given */
+    find_index_query_t *query;
+    find_index_node_t *node;
+    struct stat st;
+    struct utimbuf times;
+    char *new_file;
+
+    node = scan_file (tmp_file);
+    mctest_assert_not_null (node);
+    g_hash_table_replace (find_index, node->path, node);
+    query = find_index_query_new ("pumpkin", FALSE, TRUE, FALSE);
+
+    /* when: file is replaced with other one of the same size and mtime */
+    mctest_tmpdir_make_file ("g", "pumpkins with Needle\nand other hay\n");
+    new_file = mctest_tmpdir_path ("g");
+    times.actime = times.modtime = node->mtime;
+    utime (new_file, &times);
+    ck_assert_int_eq (rename (new_file, tmp_file), 0);
+    ck_assert_int_eq (stat (tmp_file, &st), 0);
+    mctest_assert_true ((st.st_size == node->size && st.st_mtime == node->mtime));
+
+    /* then: record of old file isn't used */
+    mctest_assert_true (find_index_may_match (query, tmp_file, &st));
+    mctest_assert_int_eq (g_queue_get_length (&find_index_pending), 1);
+
+    find_index_query_free (query);
+    g_free (new_file);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_find_index_save_load)
+/* *INDENT-ON* */
+{
+    /* given */
+    GHashTable *loaded;
+    find_index_node_t *node, *loaded_node;
+    char *name;
+
+    node = scan_file (tmp_file);
+    mctest_assert_not_null (node);
+    node->used = TRUE;
+    g_hash_table_replace (find_index, node->path, node);
+    name = mctest_tmpdir_path ("index");
+
+    /* when */
+    ck_assert_int_eq (find_index_save_to (find_index, name), 0);
+    loaded = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, find_index_node_free);
+    find_index_load (loaded, name);
+
+    /* then */
+    loaded_node = (find_index_node_t *) g_hash_table_lookup (loaded, tmp_file);
+    mctest_assert_not_null (loaded_node);
+    mctest_assert_int_eq (loaded_node->size, node->size);
+    mctest_assert_int_eq (loaded_node->mtime, node->mtime);
+    mctest_assert_int_eq (loaded_node->ctime, node->ctime);
+    mctest_assert_int_eq (loaded_node->ino, node->ino);
+    mctest_assert_int_eq (loaded_node->bits, node->bits);
+    mctest_assert_int_eq (memcmp (loaded_node->filter, node->filter, node->bits / 8), 0);
+
+    g_hash_table_destroy (loaded);
+    unlink (name);
+    g_free (name);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    mctest_add_parameterized_test (tc_core, test_find_index_query, test_find_index_query_ds);
+    tcase_add_test (tc_core, test_find_index_changed_file);
+    tcase_add_test (tc_core, test_find_index_replaced_file);
+    tcase_add_test (tc_core, test_find_index_save_load);
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "find_index.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,411 @@
+/*
+   src/filemanager - tests for tabs of panel
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include "lib/widget.h"
+#include "src/filemanager/midnight.h"
+
+#include "src/vfs/local/local.c"
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @CapturedValue */
+static int message__calls;
+
+/* @Mock */
+static void
+message__mock (int flags, const char *title, const char *text, ...)
+{
+    (void) flags;
+    (void) title;
+    (void) text;
+
+    message__calls++;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Mock */
+static void
+load_hint__mock (gboolean force)
+{
+    (void) force;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Mock */
+static void
+input_complete_free__mock (WInput * in)
+{
+    (void) in;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Mock */
+/* there is no layout: the only panel is the other one too */
+static WPanel *
+get_other_panel__mock (void)
+{
+    return current_panel;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#define message message__mock
+#define load_hint load_hint__mock
+#define input_complete_free input_complete_free__mock
+#define get_other_panel get_other_panel__mock
+
+#include "src/filemanager/panel.c"
+
+#include "tests/mctest_tmpdir.h"
+
+/* defined in src/main.c */
+log4c_category_t *log4ccat = NULL;
+
+#ifdef WITH_TABS
+static WGroup *owner = NULL;
+static WPanel *panel = NULL;
+static vfs_path_t *one_vpath = NULL;
+static vfs_path_t *two_vpath = NULL;
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef WITH_TABS
+static vfs_path_t *
+make_dir (const char *name, int files)
+{
+    char *path;
+    int i;
+
+    path = mctest_tmpdir_path (name);
+    ck_assert_msg (mkdir (path, 0700) == 0, "cannot create %s", path);
+    g_free (path);
+
+    for (i = 0; i < files; i++)
+    {
+        char file_name[32];
+
+        g_snprintf (file_name, sizeof (file_name), "%s/%s%d", name, name, i);
+        mctest_tmpdir_make_file (file_name, "");
+    }
+
+    return vfs_path_build_filename (mctest_tmpdir, name, (char *) NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+tabs_count (void)
+{
+    GList *t = panel->tabs.list;
+    int count = 0;
+
+    do
+    {
+        count++;
+        t = t->next;
+    }
+    while (t != panel->tabs.list);
+
+    return count;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static Tab *
+tab_by_index (int idx)
+{
+    return (Tab *) get_tab_by_index (panel, idx)->data;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* the second tab shows "two" with its 4th entry selected, the first one shows "one" */
+static void
+make_two_tabs (void)
+{
+    create_tab (panel, TABDIR_LAST, NULL);
+    change_tab (panel, TABDIR_NEXT, NULL);
+    mctest_assert_true (do_panel_cd (panel, two_vpath, cd_exact));
+    panel->selected = 3;
+
+    change_tab (panel, TABDIR_PREV, NULL);
+}
+#endif /* WITH_TABS */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    log4c_init ();
+    log4ccat = log4c_category_get ("debug");
+
+    mc_global.timer = mc_timer_new ();
+    str_init_strings (NULL);
+
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+
+    mctest_tmpdir_create ("mc-panel-tabs");
+
+    panels_options.show_dot_files = TRUE;
+    panels_options.progressive_load = FALSE;
+    panels_options.fast_reload = FALSE;
+    panels_options.auto_save_setup = FALSE;
+    message__calls = 0;
+
+#ifdef WITH_TABS
+    one_vpath = make_dir ("one", 3);
+    two_vpath = make_dir ("two", 5);
+
+    /* panel is created as MC does it: size is set by layout later, nothing is drawn till then */
+    owner = g_new0 (WGroup, 1);
+    group_init (owner, 0, 0, 1, 1, NULL, NULL);
+    panel = panel_with_dir_new ("New Left Panel", one_vpath);
+    group_add_widget (owner, panel);
+    current_panel = panel;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+#ifdef WITH_TABS
+    widget_destroy (WIDGET (owner));
+    current_panel = NULL;
+    vfs_path_free (one_vpath);
+    vfs_path_free (two_vpath);
+#endif
+
+    mctest_tmpdir_remove ();
+
+    vfs_shut ();
+    str_uninit_strings ();
+    mc_timer_destroy (mc_global.timer);
+
+    log4c_fini ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef WITH_TABS
+/* *INDENT-OFF* */
+START_TEST (test_panel_tabs_create_change)
+/* *INDENT-ON* */
+{
+    /* given */
+    mctest_assert_int_eq (tabs_count (), 1);
+    mctest_assert_int_eq (panel->dir.len, 1 + 3);
+
+    /* when */
+    create_tab (panel, TABDIR_LAST, NULL);
+    change_tab (panel, TABDIR_NEXT, NULL);
+
+    /* then: the new tab shows the same directory */
+    mctest_assert_int_eq (tabs_count (), 2);
+    mctest_assert_int_eq (get_tab_index (panel, panel->tabs.current), 1);
+    mctest_assert_int_eq (panel->dir.len, 1 + 3);
+    mctest_assert_true (vfs_path_equal (tab_by_index (0)->path, panel->cwd_vpath));
+
+    /* when */
+    mctest_assert_true (do_panel_cd (panel, two_vpath, cd_exact));
+    change_tab (panel, TABDIR_PREV, NULL);
+
+    /* then: each tab shows its own directory */
+    mctest_assert_int_eq (get_tab_index (panel, panel->tabs.current), 0);
+    mctest_assert_int_eq (panel->dir.len, 1 + 3);
+    mctest_assert_str_eq (panel->dir.list[1].fname, "one0");
+
+    /* when */
+    change_tab (panel, TABDIR_NEXT, NULL);
+
+    /* then */
+    mctest_assert_int_eq (get_tab_index (panel, panel->tabs.current), 1);
+    mctest_assert_int_eq (panel->dir.len, 1 + 5);
+    mctest_assert_str_eq (panel->dir.list[1].fname, "two0");
+    mctest_assert_int_eq (message__calls, 0);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_panel_tabs_kept_listing)
+/* *INDENT-ON* */
+{
+    /* given */
+    Tab *t;
+    file_entry_t *list;
+    struct stat st;
+
+    make_two_tabs ();
+
+    /* then: listing of the left tab is kept with the state of panel */
+    t = tab_by_index (1);
+    list = t->dir.list;
+    mctest_assert_not_null (list);
+    mctest_assert_int_eq (t->dir.len, 1 + 5);
+    mctest_assert_int_eq (t->selected, 3);
+    mctest_assert_ptr_eq (t->sort, panel->sort_field->sort_routine);
+    mctest_assert_null (t->filter);
+    mctest_assert_int_eq (mc_stat (two_vpath, &st), 0);
+    mctest_assert_true ((t->dir_stat.st_ino == st.st_ino && t->dir_stat.st_mtime == st.st_mtime));
+
+    /* when */
+    change_tab (panel, TABDIR_NEXT, NULL);
+
+    /* then: the listing is shown without reading of directory, it is checked on idle */
+    mctest_assert_ptr_eq (panel->dir.list, list);
+    mctest_assert_int_eq (panel->dir.len, 1 + 5);
+    mctest_assert_int_eq (panel->selected, 3);
+    mctest_assert_true (panel->revalidate);
+    mctest_assert_null (t->dir.list);
+    mctest_assert_true (vfs_path_equal (panel->cwd_vpath, t->path));
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_panel_tabs_kept_listing_resorted)
+/* *INDENT-ON* */
+{
+    /* given */
+    make_two_tabs ();
+
+    /* when: sort order is changed in another tab */
+    panel->sort_info.reverse = TRUE;
+    change_tab (panel, TABDIR_NEXT, NULL);
+
+    /* then: the kept listing is sorted again, the selected file is kept */
+    mctest_assert_int_eq (panel->dir.len, 1 + 5);
+    mctest_assert_str_eq (panel->dir.list[1].fname, "two4");
+    mctest_assert_str_eq (panel->dir.list[panel->selected].fname, "two2");
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_panel_tabs_kept_listing_filtered)
+/* *INDENT-ON* */
+{
+    /* given */
+    make_two_tabs ();
+    mctest_tmpdir_make_file ("two/two9", "");
+
+    /* when: filter is changed in another tab */
+    panel->filter = g_strdup ("two*");
+    change_tab (panel, TABDIR_NEXT, NULL);
+
+    /* then: the kept listing is dropped, directory is read again */
+    mctest_assert_int_eq (panel->dir.len, 1 + 6);
+    mctest_assert_null (tab_by_index (1)->dir.list);
+    mctest_assert_false (panel->revalidate);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_panel_tabs_close)
+/* *INDENT-ON* */
+{
+    /* given */
+    make_two_tabs ();
+    change_tab (panel, TABDIR_NEXT, NULL);
+
+    /* when */
+    close_tab (panel);
+
+    /* then: the previous tab is shown */
+    mctest_assert_int_eq (tabs_count (), 1);
+    mctest_assert_ptr_eq (panel->tabs.current, panel->tabs.list);
+    mctest_assert_int_eq (panel->dir.len, 1 + 3);
+    mctest_assert_str_eq (panel->dir.list[1].fname, "one0");
+
+    /* when */
+    close_tab (panel);
+
+    /* then: the only tab isn't closed */
+    mctest_assert_int_eq (tabs_count (), 1);
+    mctest_assert_int_eq (message__calls, 1);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+#endif /* WITH_TABS */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+#ifdef WITH_TABS
+    tcase_add_test (tc_core, test_panel_tabs_create_change);
+    tcase_add_test (tc_core, test_panel_tabs_kept_listing);
+    tcase_add_test (tc_core, test_panel_tabs_kept_listing_resorted);
+    tcase_add_test (tc_core, test_panel_tabs_kept_listing_filtered);
+    tcase_add_test (tc_core, test_panel_tabs_close);
+#endif
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "panel_tabs.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,294 @@
+/*
+   src/filemanager - tests for following changes of panel directory
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include "lib/widget.h"
+#include "src/filemanager/layout.h"
+#include "src/filemanager/midnight.h"
+
+#include "src/vfs/local/local.c"
+
+static WPanel *panel = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @CapturedValue */
+static int message__calls;
+
+/* @Mock */
+static void
+message__mock (int flags, const char *title, const char *text, ...)
+{
+    (void) flags;
+    (void) title;
+    (void) text;
+
+    message__calls++;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Mock */
+static void
+load_hint__mock (gboolean force)
+{
+    (void) force;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Mock */
+static void
+input_complete_free__mock (WInput * in)
+{
+    (void) in;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Mock */
+/* there is no layout: the only panel is the left one */
+static panel_view_mode_t
+get_panel_type__mock (int idx)
+{
+    return idx == 0 ? view_listing : view_nothing;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Mock */
+static Widget *
+get_panel_widget__mock (int idx)
+{
+    return idx == 0 ? WIDGET (panel) : NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Mock */
+static WPanel *
+get_other_panel__mock (void)
+{
+    return panel;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#define message message__mock
+#define load_hint load_hint__mock
+#define input_complete_free input_complete_free__mock
+#define get_panel_type get_panel_type__mock
+#define get_panel_widget get_panel_widget__mock
+#define get_other_panel get_other_panel__mock
+
+#include "src/filemanager/panel.c"
+
+#include "tests/mctest_tmpdir.h"
+
+/* defined in src/main.c */
+log4c_category_t *log4ccat = NULL;
+
+static WGroup *owner = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* panel is created as MC does it: size is set by layout later, nothing is drawn till then */
+static void
+make_panel (void)
+{
+    vfs_path_t *vpath;
+
+    vpath = vfs_path_from_str (mctest_tmpdir);
+    owner = g_new0 (WGroup, 1);
+    group_init (owner, 0, 0, 1, 1, NULL, NULL);
+    panel = panel_with_dir_new ("New Left Panel", vpath);
+    group_add_widget (owner, panel);
+    current_panel = panel;
+    vfs_path_free (vpath);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+find_entry (const char *name)
+{
+    int i;
+
+    for (i = 0; i < panel->dir.len; i++)
+        if (strcmp (panel->dir.list[i].fname, name) == 0)
+            return i;
+
+    return -1;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    log4c_init ();
+    log4ccat = log4c_category_get ("debug");
+
+    mc_global.timer = mc_timer_new ();
+    str_init_strings (NULL);
+
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+
+    mctest_tmpdir_create ("mc-panel-watch");
+    mctest_tmpdir_make_file ("a", "");
+    mctest_tmpdir_make_file ("b", "");
+    mctest_tmpdir_make_file ("c", "");
+    mctest_tmpdir_make_file (".hidden", "");
+
+    panels_options.show_dot_files = TRUE;
+    panels_options.fast_reload = FALSE;
+    panels_options.auto_save_setup = FALSE;
+    message__calls = 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    if (owner != NULL)
+    {
+        widget_destroy (WIDGET (owner));
+        owner = NULL;
+        panel = NULL;
+        current_panel = NULL;
+    }
+
+    mctest_tmpdir_remove ();
+
+    vfs_shut ();
+    str_uninit_strings ();
+    mc_timer_destroy (mc_global.timer);
+
+    log4c_fini ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_panel_watch_idle)
+/* *INDENT-ON* */
+{
+    /* given */
+    char *path;
+    struct stat st;
+
+    make_panel ();
+    if (panel->watch == NULL)
+        return;                 /* changes of directories can't be followed here */
+
+    panel->selected = find_entry ("b");
+    ck_assert_int_gt (panel->selected, 0);
+
+    mctest_tmpdir_make_file ("a0", "");
+    path = mctest_tmpdir_path ("c");
+    unlink (path);
+    g_free (path);
+
+    /* when: changes are collected as the select channel callback does, then applied on idle */
+    dir_watch_poll ();
+    mctest_assert_true (dir_watch_has_changes (panel->watch));
+    mctest_assert_false (panel_load_idle ());
+
+    /* then: the listing is updated in place, the selected file is kept */
+    mctest_assert_false (dir_watch_has_changes (panel->watch));
+    ck_assert_int_ge (find_entry ("a0"), 0);
+    mctest_assert_int_eq (find_entry ("c"), -1);
+    mctest_assert_str_eq (panel->dir.list[panel->selected].fname, "b");
+    mctest_assert_int_eq (mc_stat (panel->cwd_vpath, &st), 0);
+    mctest_assert_true ((panel->dir_stat.st_ino == st.st_ino
+                         && panel->dir_stat.st_mtime == st.st_mtime));
+    mctest_assert_int_eq (message__calls, 0);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* *INDENT-OFF* */
+START_TEST (test_panel_watch_rescan_hidden)
+/* *INDENT-ON* */
+{
+    /* given */
+    panels_options.show_dot_files = FALSE;
+    make_panel ();
+    if (panel->watch == NULL)
+        return;                 /* changes of directories can't be followed here */
+
+    mctest_assert_int_eq (find_entry (".hidden"), -1);
+
+    /* when: hidden files are toggled, update_one_panel_widget() does it with UP_RELOAD */
+    panels_options.show_dot_files = TRUE;
+    dir_watch_set_rescan (panel->watch);
+
+    /* then: the directory has no changes, but the listing isn't taken from the watch,
+       panel_watch_reload() reads the directory again */
+    mctest_assert_true (dir_watch_has_changes (panel->watch));
+    mctest_assert_false (panel_watch_apply (panel));
+    mctest_assert_false (dir_watch_has_changes (panel->watch));
+    mctest_assert_int_eq (find_entry (".hidden"), -1);
+}
+/* *INDENT-OFF* */
+END_TEST
+/* *INDENT-ON* */
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    int number_failed;
+
+    Suite *s = suite_create (TEST_SUITE_NAME);
+    TCase *tc_core = tcase_create ("Core");
+    SRunner *sr;
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    /* Add new tests here: *************** */
+    tcase_add_test (tc_core, test_panel_watch_idle);
+    tcase_add_test (tc_core, test_panel_watch_rescan_hidden);
+    /* *********************************** */
+
+    suite_add_tcase (s, tc_core);
+    sr = srunner_create (s);
+    srunner_set_log (sr, "panel_watch.log");
+    srunner_run_all (sr, CK_ENV);
+    number_failed = srunner_ntests_failed (sr);
+    srunner_free (sr);
+    return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* --------------------------------------------------------------------------------------------- */